@@ -0,0 +1,262 @@
+#pragma once
+/**
+ * @file alignment.hpp
+ * @brief 点集的闭式刚体 / 相似变换对齐（Umeyama SVD 与 Horn 四元数法），互协方差流式累加。
+ *
+ * 对齐只需要两组点的均值、中心化的互协方差和各自的中心化平方和，这些量都可以逐点更新、
+ * 分块后合并，因此不必保存对应点：上亿对点只占用一个约 130 字节的累加器。
+ * 最后在 3x3 矩阵上做一次 SVD（或 4x4 对称特征分解）得到变换。
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "parallel.hpp"
+#include "pose.hpp"
+
+namespace robotics {
+
+/**
+ * @brief 相似变换 p -> scale * R * p + t
+ */
+struct Similarity {
+    Pose transform;
+    double scale { 1.0 };
+
+    Vector3 apply(const Vector3& p) const { return transform.orientation.rotate(p) * scale + transform.position; }
+
+    Pose apply(const Pose& pose) const
+    {
+        return { apply(pose.position), transform.orientation * pose.orientation };
+    }
+};
+
+/**
+ * @brief 对应点对 (source, target) 的流式累加器，求 target ≈ scale * R * source + t
+ *
+ * 保存的是均值和中心化的二阶矩（而不是原始的 Σ s tᵀ），逐点更新用 Welford 形式，
+ * 合并用 Chan 公式。远离原点的坐标（例如 UTM 下的 1e6 m）不会因为大数相减而丢失精度。
+ */
+class AlignmentAccumulator {
+public:
+    /**
+     * @brief 加入一对对应点
+     */
+    void add(const Vector3& source, const Vector3& target)
+    {
+        ++count_;
+        double n = static_cast<double>(count_);
+        Eigen::Vector3d s(source.x, source.y, source.z);
+        Eigen::Vector3d t(target.x, target.y, target.z);
+        Eigen::Vector3d ds = s - mean_source_;
+        Eigen::Vector3d dt = t - mean_target_;
+        mean_source_ += ds / n;
+        mean_target_ += dt / n;
+        cross_ += (t - mean_target_) * ds.transpose();
+        source_ss_ += ds.dot(s - mean_source_);
+        target_ss_ += dt.dot(t - mean_target_);
+    }
+
+    /**
+     * @brief 批量加入 n 对对应点
+     *
+     * 按小块两遍计算（先求块均值，再求块内中心化二阶矩）后合并，内层循环没有除法，
+     * 比逐点 add 快，结果在舍入误差内一致。
+     */
+    void add(const Vector3* source, const Vector3* target, std::size_t n)
+    {
+        constexpr std::size_t kBlock = 1024; // 两遍都在 L1/L2 中完成
+        for (std::size_t first = 0; first < n; first += kBlock) {
+            std::size_t count = std::min(kBlock, n - first);
+            const Vector3* s = source + first;
+            const Vector3* t = target + first;
+
+            Eigen::Vector3d sum_source = Eigen::Vector3d::Zero();
+            Eigen::Vector3d sum_target = Eigen::Vector3d::Zero();
+            for (std::size_t i = 0; i < count; ++i) {
+                sum_source += Eigen::Vector3d(s[i].x, s[i].y, s[i].z);
+                sum_target += Eigen::Vector3d(t[i].x, t[i].y, t[i].z);
+            }
+            AlignmentAccumulator block;
+            block.count_ = count;
+            block.mean_source_ = sum_source / static_cast<double>(count);
+            block.mean_target_ = sum_target / static_cast<double>(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                Eigen::Vector3d ds = Eigen::Vector3d(s[i].x, s[i].y, s[i].z) - block.mean_source_;
+                Eigen::Vector3d dt = Eigen::Vector3d(t[i].x, t[i].y, t[i].z) - block.mean_target_;
+                block.cross_.noalias() += dt * ds.transpose();
+                block.source_ss_ += ds.squaredNorm();
+                block.target_ss_ += dt.squaredNorm();
+            }
+            merge(block);
+        }
+    }
+
+    /**
+     * @brief 合并另一组对应点的累加结果
+     */
+    void merge(const AlignmentAccumulator& other)
+    {
+        if (other.count_ == 0) {
+            return;
+        }
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        double n_a = static_cast<double>(count_);
+        double n_b = static_cast<double>(other.count_);
+        double n = n_a + n_b;
+        Eigen::Vector3d ds = other.mean_source_ - mean_source_;
+        Eigen::Vector3d dt = other.mean_target_ - mean_target_;
+        double w = n_a * n_b / n;
+        cross_ += other.cross_ + w * dt * ds.transpose();
+        source_ss_ += other.source_ss_ + w * ds.squaredNorm();
+        target_ss_ += other.target_ss_ + w * dt.squaredNorm();
+        mean_source_ += ds * (n_b / n);
+        mean_target_ += dt * (n_b / n);
+        count_ += other.count_;
+    }
+
+    std::size_t count() const { return count_; }
+
+    /**
+     * @brief Umeyama 闭式解：对互协方差做 3x3 SVD，行列式为负时翻转最小奇异方向以排除反射
+     * @param with_scale false 时固定 scale = 1 (SE(3))
+     * @throw std::invalid_argument 如果少于 3 对点
+     */
+    Similarity solve(bool with_scale) const
+    {
+        requireEnoughPoints();
+        Eigen::JacobiSVD<Eigen::Matrix3d> svd(cross_, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        Eigen::Vector3d signs(1.0, 1.0, 1.0);
+        if (svd.matrixU().determinant() * svd.matrixV().determinant() < 0.0) {
+            signs(2) = -1.0;
+        }
+        Eigen::Matrix3d rotation = svd.matrixU() * signs.asDiagonal() * svd.matrixV().transpose();
+        return makeSimilarity(rotation, with_scale);
+    }
+
+    /**
+     * @brief Horn 闭式解：旋转是 4x4 对称矩阵 N(Σ) 最大特征值对应的单位四元数
+     *
+     * 与 solve() 的最优解相同，只是换了一种分解；尺度同样取给定旋转下的最小二乘最优值。
+     * @throw std::invalid_argument 如果少于 3 对点
+     */
+    Similarity solveHorn(bool with_scale) const
+    {
+        requireEnoughPoints();
+        Eigen::Matrix3d m = cross_.transpose(); // m(a, b) = Σ s_a t_b
+        Eigen::Matrix4d n;
+        n << m(0, 0) + m(1, 1) + m(2, 2), m(1, 2) - m(2, 1), m(2, 0) - m(0, 2), m(0, 1) - m(1, 0),
+            m(1, 2) - m(2, 1), m(0, 0) - m(1, 1) - m(2, 2), m(0, 1) + m(1, 0), m(2, 0) + m(0, 2),
+            m(2, 0) - m(0, 2), m(0, 1) + m(1, 0), -m(0, 0) + m(1, 1) - m(2, 2), m(1, 2) + m(2, 1),
+            m(0, 1) - m(1, 0), m(2, 0) + m(0, 2), m(1, 2) + m(2, 1), -m(0, 0) - m(1, 1) + m(2, 2);
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> eigen(n);
+        Eigen::Vector4d q = eigen.eigenvectors().col(3); // 特征值升序排列
+        Eigen::Quaterniond rotation(q(0), q(1), q(2), q(3));
+        return makeSimilarity(rotation.normalized().toRotationMatrix(), with_scale);
+    }
+
+    /**
+     * @brief 任意相似变换在已累加点对上的均方根残差 sqrt(Σ‖scale R s + t - t_i‖² / n)，不需要再遍历数据
+     */
+    double rmsResidual(const Similarity& similarity) const
+    {
+        if (count_ == 0) {
+            return 0.0;
+        }
+        const Quaternion& q = similarity.transform.orientation;
+        Eigen::Matrix3d rotation = Eigen::Quaterniond(q.w, q.x, q.y, q.z).toRotationMatrix();
+        const Vector3& p = similarity.transform.position;
+        double s = similarity.scale;
+        Eigen::Vector3d offset = s * rotation * mean_source_ + Eigen::Vector3d(p.x, p.y, p.z) - mean_target_;
+        double n = static_cast<double>(count_);
+        double sum = s * s * source_ss_ + target_ss_ - 2.0 * s * rotation.cwiseProduct(cross_).sum()
+            + n * offset.squaredNorm();
+        return std::sqrt(std::max(0.0, sum) / n);
+    }
+
+private:
+    void requireEnoughPoints() const
+    {
+        if (count_ < 3) {
+            throw std::invalid_argument("Alignment needs at least 3 corresponding points");
+        }
+    }
+
+    Similarity makeSimilarity(const Eigen::Matrix3d& rotation, bool with_scale) const
+    {
+        // 给定 R 时最优尺度为 tr(Rᵀ Σ) / Σ‖s - s̄‖²
+        double scale = with_scale && source_ss_ > 0.0 ? rotation.cwiseProduct(cross_).sum() / source_ss_ : 1.0;
+        Eigen::Vector3d translation = mean_target_ - scale * rotation * mean_source_;
+
+        Eigen::Quaterniond q(rotation);
+        Similarity result;
+        result.transform.orientation = { q.w(), q.x(), q.y(), q.z() };
+        result.transform.orientation.normalize();
+        result.transform.position = { translation.x(), translation.y(), translation.z() };
+        result.scale = scale;
+        return result;
+    }
+
+    std::size_t count_ { 0 };
+    Eigen::Vector3d mean_source_ { Eigen::Vector3d::Zero() };
+    Eigen::Vector3d mean_target_ { Eigen::Vector3d::Zero() };
+    Eigen::Matrix3d cross_ { Eigen::Matrix3d::Zero() }; // Σ (t - t̄)(s - s̄)ᵀ
+    double source_ss_ { 0.0 }; // Σ ‖s - s̄‖²
+    double target_ss_ { 0.0 }; // Σ ‖t - t̄‖²
+};
+
+/**
+ * @brief 并行累加 n 对对应点：把 [0, n) 切成固定数量的块，body(lo, hi, accumulator) 负责把块内的点加入
+ *
+ * 点可以在 body 中现场生成或从文件读出，不需要整体放在内存里。
+ * 块的划分只取决于 n，合并按块顺序进行，所以结果与线程数无关、逐位可复现。
+ */
+template <typename Body>
+AlignmentAccumulator accumulateAlignment(ThreadPool& pool, std::size_t n, Body&& body)
+{
+    constexpr std::size_t kChunks = 256;
+    std::size_t chunks = std::min(kChunks, std::max<std::size_t>(n, 1));
+    std::vector<AlignmentAccumulator> partial(chunks);
+    pool.parallelFor(0, chunks, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; ++c) {
+            body(n * c / chunks, n * (c + 1) / chunks, partial[c]);
+        }
+    }, 1);
+    AlignmentAccumulator result;
+    for (const AlignmentAccumulator& p : partial) {
+        result.merge(p);
+    }
+    return result;
+}
+
+inline AlignmentAccumulator accumulateAlignment(const Vector3* source, const Vector3* target, std::size_t n,
+    ThreadPool& pool)
+{
+    return accumulateAlignment(pool, n, [&](std::size_t lo, std::size_t hi, AlignmentAccumulator& accumulator) {
+        accumulator.add(source + lo, target + lo, hi - lo);
+    });
+}
+
+/**
+ * @brief Umeyama 对齐：求使 target ≈ scale * R * source + t 的最小二乘相似变换
+ * @param with_scale false 时固定 scale = 1 (SE(3))
+ * @throw std::invalid_argument 如果点数不同或少于 3 个
+ */
+inline Similarity umeyamaAlignment(const std::vector<Vector3>& source, const std::vector<Vector3>& target,
+    bool with_scale)
+{
+    if (source.size() != target.size()) {
+        throw std::invalid_argument("Source and target must have the same number of points");
+    }
+    AlignmentAccumulator accumulator;
+    accumulator.add(source.data(), target.data(), source.size());
+    return accumulator.solve(with_scale);
+}
+
+} // namespace robotics
@@ -0,0 +1,605 @@
+#pragma once
+/**
+ * @file alloc_tracker.hpp
+ * @brief 可选的堆分配追踪器：全局 operator new/delete 替换 + 按作用域统计。
+ *
+ * 用法：在**唯一一个**翻译单元中，包含本头文件之前定义 PRESLAM_ALLOC_TRACKING，
+ * 即可安装分配钩子（本项目每个实验都是单文件程序，直接在 main.cpp 中定义即可）。
+ * 未定义该宏时，AllocScope 仍可编译，但所有计数保持为 0。
+ *
+ * 在 glibc 上还会同时替换 malloc/free 系列函数，因此 Eigen 的 aligned_malloc
+ * （直接调用 std::malloc，不经过 operator new）也会被统计。
+ */
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+#if defined(__GLIBC__) || defined(__linux__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+namespace robotics {
+
+/**
+ * @brief 作用域的分配策略
+ */
+enum class AllocPolicy {
+    Track, // 仅统计
+    Forbid // 声明为零分配：作用域内的任何分配都记为违规
+};
+
+/**
+ * @brief 某个命名作用域的累计统计（所有线程、所有进入次数之和）
+ */
+struct AllocScopeReport {
+    const char* name { nullptr };
+    bool forbid { false };
+    std::size_t entries { 0 }; // 进入次数
+    std::size_t allocations { 0 }; // 分配次数
+    std::size_t deallocations { 0 }; // 释放次数
+    std::size_t bytes { 0 }; // 请求的总字节数
+    std::size_t peak_bytes { 0 }; // 单次进入内堆内存净增长的峰值
+    std::size_t violations { 0 }; // Forbid 作用域内发生的分配次数
+};
+
+/**
+ * @brief 全进程的分配统计
+ */
+struct AllocGlobalStats {
+    std::size_t allocations { 0 };
+    std::size_t deallocations { 0 };
+    std::size_t bytes { 0 };
+    std::size_t live_bytes { 0 };
+    std::size_t peak_live_bytes { 0 };
+};
+
+class AllocScope;
+
+namespace detail {
+
+    inline constexpr std::size_t kMaxAllocScopes = 64;
+
+    struct AllocSlot {
+        std::atomic<const char*> name { nullptr };
+        std::atomic<bool> forbid { false };
+        std::atomic<std::size_t> entries { 0 };
+        std::atomic<std::size_t> allocations { 0 };
+        std::atomic<std::size_t> deallocations { 0 };
+        std::atomic<std::size_t> bytes { 0 };
+        std::atomic<std::size_t> peak_bytes { 0 };
+        std::atomic<std::size_t> violations { 0 };
+    };
+
+    // 全部为常量初始化，分配钩子在静态构造之前被调用也是安全的
+    inline AllocSlot g_alloc_slots[kMaxAllocScopes];
+    inline std::atomic<std::size_t> g_total_allocations { 0 };
+    inline std::atomic<std::size_t> g_total_deallocations { 0 };
+    inline std::atomic<std::size_t> g_total_bytes { 0 };
+    inline std::atomic<std::ptrdiff_t> g_live_bytes { 0 };
+    inline std::atomic<std::ptrdiff_t> g_peak_live_bytes { 0 };
+    inline std::atomic<int> g_strict { -1 }; // -1 表示尚未读取环境变量
+
+    inline thread_local AllocScope* t_current_scope = nullptr;
+    inline thread_local AllocScope* t_forbidding_scope = nullptr;
+
+    inline void atomicMax(std::atomic<std::size_t>& target, std::size_t value) noexcept
+    {
+        std::size_t current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+    }
+
+    inline void atomicMax(std::atomic<std::ptrdiff_t>& target, std::ptrdiff_t value) noexcept
+    {
+        std::ptrdiff_t current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+    }
+
+    /**
+     * @brief 按名字查找或登记作用域槽位（无锁，不分配内存）
+     */
+    inline AllocSlot* findAllocSlot(const char* name, bool forbid) noexcept
+    {
+        for (auto& slot : g_alloc_slots) {
+            const char* existing = slot.name.load(std::memory_order_acquire);
+            if (existing == nullptr) {
+                if (slot.name.compare_exchange_strong(existing, name, std::memory_order_acq_rel)) {
+                    slot.forbid.store(forbid, std::memory_order_relaxed);
+                    return &slot;
+                }
+            }
+            if (existing == name || std::strcmp(existing, name) == 0) {
+                return &slot;
+            }
+        }
+        return nullptr; // 槽位用尽时该作用域不参与汇总
+    }
+
+    /**
+     * @brief 查询分配块的实际可用字节数，用于释放时扣减存活内存
+     */
+    inline std::size_t usableSize(void* ptr) noexcept
+    {
+#if defined(__GLIBC__) || defined(__linux__)
+        return ::malloc_usable_size(ptr);
+#elif defined(__APPLE__)
+        return ::malloc_size(ptr);
+#else
+        (void)ptr;
+        return 0; // 平台不支持时仅统计次数与请求字节数
+#endif
+    }
+
+    inline void recordAllocation(std::size_t requested, std::size_t usable) noexcept;
+    inline void recordDeallocation(std::size_t usable) noexcept;
+
+} // namespace detail
+
+/**
+ * @brief 追踪器的全局开关与报告
+ */
+class AllocTracker {
+public:
+    /**
+     * @brief 当前翻译单元是否安装了分配钩子
+     */
+    static constexpr bool enabled() noexcept
+    {
+#ifdef PRESLAM_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief 严格模式：Forbid 作用域内一旦分配立即打印并 abort，用于把"零分配"当作测试断言
+     *
+     * 默认值取自环境变量 PRESLAM_ALLOC_STRICT（非空且不为 "0" 即开启）。
+     */
+    static bool strict() noexcept
+    {
+        int value = detail::g_strict.load(std::memory_order_relaxed);
+        if (value < 0) {
+            const char* env = std::getenv("PRESLAM_ALLOC_STRICT");
+            value = (env != nullptr && env[0] != '\0' && std::strcmp(env, "0") != 0) ? 1 : 0;
+            detail::g_strict.store(value, std::memory_order_relaxed);
+        }
+        return value == 1;
+    }
+
+    static void setStrict(bool strict) noexcept { detail::g_strict.store(strict ? 1 : 0, std::memory_order_relaxed); }
+
+    static AllocGlobalStats global() noexcept
+    {
+        AllocGlobalStats stats;
+        stats.allocations = detail::g_total_allocations.load(std::memory_order_relaxed);
+        stats.deallocations = detail::g_total_deallocations.load(std::memory_order_relaxed);
+        stats.bytes = detail::g_total_bytes.load(std::memory_order_relaxed);
+        std::ptrdiff_t live = detail::g_live_bytes.load(std::memory_order_relaxed);
+        stats.live_bytes = live > 0 ? static_cast<std::size_t>(live) : 0;
+        std::ptrdiff_t peak = detail::g_peak_live_bytes.load(std::memory_order_relaxed);
+        stats.peak_live_bytes = peak > 0 ? static_cast<std::size_t>(peak) : 0;
+        return stats;
+    }
+
+    /**
+     * @brief 拷贝所有已登记作用域的统计
+     * @param out 输出数组
+     * @param capacity 输出数组容量
+     * @return std::size_t 写入的条目数
+     */
+    static std::size_t scopeReports(AllocScopeReport* out, std::size_t capacity) noexcept
+    {
+        std::size_t count = 0;
+        for (auto& slot : detail::g_alloc_slots) {
+            const char* name = slot.name.load(std::memory_order_acquire);
+            if (name == nullptr || count == capacity) {
+                break;
+            }
+            AllocScopeReport& r = out[count++];
+            r.name = name;
+            r.forbid = slot.forbid.load(std::memory_order_relaxed);
+            r.entries = slot.entries.load(std::memory_order_relaxed);
+            r.allocations = slot.allocations.load(std::memory_order_relaxed);
+            r.deallocations = slot.deallocations.load(std::memory_order_relaxed);
+            r.bytes = slot.bytes.load(std::memory_order_relaxed);
+            r.peak_bytes = slot.peak_bytes.load(std::memory_order_relaxed);
+            r.violations = slot.violations.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    /**
+     * @brief 所有 Forbid 作用域累计的违规次数
+     */
+    static std::size_t totalViolations() noexcept
+    {
+        std::size_t total = 0;
+        for (auto& slot : detail::g_alloc_slots) {
+            total += slot.violations.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 清零所有统计（已登记的作用域名保留）
+     */
+    static void reset() noexcept
+    {
+        for (auto& slot : detail::g_alloc_slots) {
+            slot.entries = 0;
+            slot.allocations = 0;
+            slot.deallocations = 0;
+            slot.bytes = 0;
+            slot.peak_bytes = 0;
+            slot.violations = 0;
+        }
+        detail::g_total_allocations = 0;
+        detail::g_total_deallocations = 0;
+        detail::g_total_bytes = 0;
+        detail::g_peak_live_bytes = detail::g_live_bytes.load();
+    }
+
+    /**
+     * @brief 以表格形式输出所有作用域的统计
+     */
+    static void report(std::ostream& os)
+    {
+        AllocScopeReport reports[detail::kMaxAllocScopes];
+        std::size_t count = scopeReports(reports, detail::kMaxAllocScopes);
+
+        if (!enabled()) {
+            os << "(allocation tracking disabled: define PRESLAM_ALLOC_TRACKING)\n";
+        }
+        os << std::left << std::setw(40) << "Scope" << std::right
+           << std::setw(9) << "Entries" << std::setw(10) << "Allocs" << std::setw(10) << "Frees"
+           << std::setw(14) << "Bytes" << std::setw(12) << "Peak" << std::setw(8) << "Alloc/E"
+           << "  Status\n";
+        for (std::size_t i = 0; i < count; ++i) {
+            const AllocScopeReport& r = reports[i];
+            double per_entry = r.entries > 0 ? static_cast<double>(r.allocations) / r.entries : 0.0;
+            os << std::left << std::setw(40) << r.name << std::right
+               << std::setw(9) << r.entries << std::setw(10) << r.allocations << std::setw(10) << r.deallocations
+               << std::setw(14) << r.bytes << std::setw(12) << r.peak_bytes
+               << std::setw(8) << std::fixed << std::setprecision(1) << per_entry << std::defaultfloat << "  ";
+            if (r.forbid) {
+                if (r.violations == 0) {
+                    os << "alloc-free OK";
+                } else {
+                    os << "VIOLATED x" << r.violations;
+                }
+            }
+            os << '\n';
+        }
+        AllocGlobalStats g = global();
+        os << "Global: " << g.allocations << " allocs, " << g.deallocations << " frees, "
+           << g.bytes << " bytes requested, peak live " << g.peak_live_bytes << " bytes\n";
+    }
+};
+
+/**
+ * @brief RAII 作用域：在其生命周期内统计本线程的分配
+ *
+ * 统计归属于本线程最内层的作用域，退出时并入外层作用域（即外层统计是包含性的）。
+ * 其他线程上的分配不会计入，因此并行代码需要在每个工作线程内各自建立作用域。
+ * name 必须是生命期足够长的字符串（通常是字面量）。
+ */
+class AllocScope {
+public:
+    explicit AllocScope(const char* name, AllocPolicy policy = AllocPolicy::Track) noexcept
+        : slot_(detail::findAllocSlot(name, policy == AllocPolicy::Forbid))
+        , name_(name)
+        , policy_(policy)
+        , parent_(detail::t_current_scope)
+        , prev_forbidding_(detail::t_forbidding_scope)
+    {
+        detail::t_current_scope = this;
+        if (policy_ == AllocPolicy::Forbid) {
+            AllocTracker::strict(); // 提前读取环境变量，钩子内不再调用 getenv
+            detail::t_forbidding_scope = this;
+        }
+    }
+
+    ~AllocScope()
+    {
+        detail::t_current_scope = parent_;
+        detail::t_forbidding_scope = prev_forbidding_;
+
+        if (slot_ != nullptr) {
+            slot_->entries.fetch_add(1, std::memory_order_relaxed);
+            slot_->allocations.fetch_add(allocations_, std::memory_order_relaxed);
+            slot_->deallocations.fetch_add(deallocations_, std::memory_order_relaxed);
+            slot_->bytes.fetch_add(bytes_, std::memory_order_relaxed);
+            slot_->violations.fetch_add(violations_, std::memory_order_relaxed);
+            detail::atomicMax(slot_->peak_bytes, peak_);
+        }
+
+        if (parent_ != nullptr) {
+            parent_->allocations_ += allocations_;
+            parent_->deallocations_ += deallocations_;
+            parent_->bytes_ += bytes_;
+            std::ptrdiff_t nested_peak = parent_->live_ + static_cast<std::ptrdiff_t>(peak_);
+            if (nested_peak > static_cast<std::ptrdiff_t>(parent_->peak_)) {
+                parent_->peak_ = static_cast<std::size_t>(nested_peak);
+            }
+            parent_->live_ += live_;
+        }
+    }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+    std::size_t allocations() const noexcept { return allocations_; }
+    std::size_t deallocations() const noexcept { return deallocations_; }
+    std::size_t bytes() const noexcept { return bytes_; }
+    std::size_t peakBytes() const noexcept { return peak_; }
+    std::size_t violations() const noexcept { return violations_; }
+
+private:
+    friend void detail::recordAllocation(std::size_t, std::size_t) noexcept;
+    friend void detail::recordDeallocation(std::size_t) noexcept;
+
+    void onAllocate(std::size_t requested, std::size_t usable) noexcept
+    {
+        ++allocations_;
+        bytes_ += requested;
+        live_ += static_cast<std::ptrdiff_t>(usable);
+        if (live_ > static_cast<std::ptrdiff_t>(peak_)) {
+            peak_ = static_cast<std::size_t>(live_);
+        }
+    }
+
+    void onDeallocate(std::size_t usable) noexcept
+    {
+        ++deallocations_;
+        live_ -= static_cast<std::ptrdiff_t>(usable);
+    }
+
+    void onViolation(std::size_t requested) noexcept
+    {
+        ++violations_;
+        if (AllocTracker::strict()) {
+            // 只使用不分配内存的输出函数
+            std::fputs("[alloc_tracker] allocation inside allocation-free scope '", stderr);
+            std::fputs(name_, stderr);
+            std::fprintf(stderr, "' (%zu bytes)\n", requested);
+            std::abort();
+        }
+    }
+
+    detail::AllocSlot* slot_;
+    const char* name_;
+    AllocPolicy policy_;
+    AllocScope* parent_;
+    AllocScope* prev_forbidding_;
+    std::size_t allocations_ { 0 };
+    std::size_t deallocations_ { 0 };
+    std::size_t bytes_ { 0 };
+    std::size_t peak_ { 0 };
+    std::size_t violations_ { 0 };
+    std::ptrdiff_t live_ { 0 };
+};
+
+namespace detail {
+
+    inline void recordAllocation(std::size_t requested, std::size_t usable) noexcept
+    {
+        g_total_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_total_bytes.fetch_add(requested, std::memory_order_relaxed);
+        std::ptrdiff_t live = g_live_bytes.fetch_add(static_cast<std::ptrdiff_t>(usable), std::memory_order_relaxed)
+            + static_cast<std::ptrdiff_t>(usable);
+        atomicMax(g_peak_live_bytes, live);
+
+        if (AllocScope* scope = t_current_scope) {
+            scope->onAllocate(requested, usable);
+        }
+        if (AllocScope* forbidding = t_forbidding_scope) {
+            forbidding->onViolation(requested);
+        }
+    }
+
+    inline void recordDeallocation(std::size_t usable) noexcept
+    {
+        g_total_deallocations.fetch_add(1, std::memory_order_relaxed);
+        g_live_bytes.fetch_sub(static_cast<std::ptrdiff_t>(usable), std::memory_order_relaxed);
+        if (AllocScope* scope = t_current_scope) {
+            scope->onDeallocate(usable);
+        }
+    }
+
+} // namespace detail
+
+} // namespace robotics
+
+#define PRESLAM_ALLOC_CONCAT_IMPL(a, b) a##b
+#define PRESLAM_ALLOC_CONCAT(a, b) PRESLAM_ALLOC_CONCAT_IMPL(a, b)
+/** @brief 统计当前块内的分配 */
+#define PRESLAM_ALLOC_SCOPE(name) \
+    ::robotics::AllocScope PRESLAM_ALLOC_CONCAT(preslam_alloc_scope_, __LINE__)(name)
+/** @brief 声明当前块为零分配 */
+#define PRESLAM_NO_ALLOC_SCOPE(name) \
+    ::robotics::AllocScope PRESLAM_ALLOC_CONCAT(preslam_alloc_scope_, __LINE__)(name, ::robotics::AllocPolicy::Forbid)
+
+// ---------------------------------------------------------------------------
+// 钩子定义：只在定义了 PRESLAM_ALLOC_TRACKING 的那个翻译单元中展开
+// ---------------------------------------------------------------------------
+#ifdef PRESLAM_ALLOC_TRACKING
+
+#if defined(__GLIBC__)
+#define PRESLAM_ALLOC_INTERPOSE_MALLOC 1
+
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size) noexcept
+{
+    void* ptr = __libc_malloc(size);
+    if (ptr != nullptr) {
+        robotics::detail::recordAllocation(size, robotics::detail::usableSize(ptr));
+    }
+    return ptr;
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    void* ptr = __libc_calloc(count, size);
+    if (ptr != nullptr) {
+        robotics::detail::recordAllocation(count * size, robotics::detail::usableSize(ptr));
+    }
+    return ptr;
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+    std::size_t old_usable = ptr != nullptr ? robotics::detail::usableSize(ptr) : 0;
+    void* result = __libc_realloc(ptr, size);
+    if (ptr != nullptr && (result != nullptr || size == 0)) {
+        robotics::detail::recordDeallocation(old_usable);
+    }
+    if (result != nullptr) {
+        robotics::detail::recordAllocation(size, robotics::detail::usableSize(result));
+    }
+    return result;
+}
+
+void free(void* ptr) noexcept
+{
+    if (ptr != nullptr) {
+        robotics::detail::recordDeallocation(robotics::detail::usableSize(ptr));
+        __libc_free(ptr);
+    }
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    void* ptr = __libc_memalign(alignment, size);
+    if (ptr != nullptr) {
+        robotics::detail::recordAllocation(size, robotics::detail::usableSize(ptr));
+    }
+    return ptr;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept
+{
+    void* ptr = memalign(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+} // extern "C"
+#else
+#define PRESLAM_ALLOC_INTERPOSE_MALLOC 0
+#endif
+
+namespace robotics::detail {
+
+inline void* trackedNew(std::size_t size, std::size_t alignment) noexcept
+{
+    size = size == 0 ? 1 : size;
+    void* ptr = nullptr;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ptr = std::malloc(size);
+    } else if (::posix_memalign(&ptr, alignment, size) != 0) {
+        ptr = nullptr;
+    }
+#if !PRESLAM_ALLOC_INTERPOSE_MALLOC
+    // 未替换 malloc 的平台在这里记录；glibc 上 malloc 钩子已经记过一次
+    if (ptr != nullptr) {
+        recordAllocation(size, usableSize(ptr));
+    }
+#endif
+    return ptr;
+}
+
+inline void trackedDelete(void* ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+#if !PRESLAM_ALLOC_INTERPOSE_MALLOC
+    recordDeallocation(usableSize(ptr));
+#endif
+    std::free(ptr);
+}
+
+} // namespace robotics::detail
+
+void* operator new(std::size_t size)
+{
+    void* ptr = robotics::detail::trackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return robotics::detail::trackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return robotics::detail::trackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* ptr = robotics::detail::trackedNew(size, static_cast<std::size_t>(alignment));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return robotics::detail::trackedNew(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return robotics::detail::trackedNew(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete[](void* ptr) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { robotics::detail::trackedDelete(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { robotics::detail::trackedDelete(ptr); }
+
+#endif // PRESLAM_ALLOC_TRACKING
@@ -0,0 +1,244 @@
+#pragma once
+/**
+ * @file correction.hpp
+ * @brief 回环后把关键帧的修正传播到稠密轨迹：关键帧之间插值修正，批量左乘到每个位姿上。
+ *
+ * 位姿图优化只改变关键帧。关键帧 k 的修正是 C_k = T_k' T_k⁻¹（世界系下的左乘修正），
+ * 两个关键帧之间时间为 t 的稠密位姿被改写为 T' = C(t) T，其中
+ *
+ *     C(t) = interpolateTimedPose(corrections, t)
+ *
+ * 即位置线性插值、姿态 SLERP。第一个关键帧之前、最后一个之后的位姿取端点的修正（整体刚体平移）。
+ * 同一区间的位姿连续存放，交给 kernels::correct_poses_kernel（标量 / AVX2）一次处理，
+ * 区间常量（SLERP 的角度等）每个区间只算一次；两端修正都是单位变换的区间直接跳过。
+ *
+ * 支持 a3 插值器使用的容器：std::vector（可用线程池并行）、std::list、以时间戳为键的 std::map，
+ * 以及 TrajectoryStore 的写事务（按块并行，只复制真正被修改的块）。位姿须按时间戳排序。
+ */
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "kernels.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "trajectory_store.hpp"
+
+namespace robotics {
+
+/**
+ * @brief 由优化前后的关键帧位姿计算修正 C_k = T_k' T_k⁻¹
+ * @param before 优化前的关键帧（带时间戳）
+ * @param after 优化后的关键帧位姿，与 before 一一对应；与优化前逐位相同的关键帧得到单位修正
+ * @throw std::invalid_argument 如果两者长度不同
+ */
+inline std::vector<TimedPose> keyframeCorrections(const std::vector<TimedPose>& before,
+    const std::vector<Pose>& after)
+{
+    if (before.size() != after.size()) {
+        throw std::invalid_argument("Keyframe counts before and after optimization differ");
+    }
+    std::vector<TimedPose> corrections(before.size());
+    auto same = [](const Pose& a, const Pose& b) {
+        return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z
+            && a.orientation.w == b.orientation.w && a.orientation.x == b.orientation.x
+            && a.orientation.y == b.orientation.y && a.orientation.z == b.orientation.z;
+    };
+    for (std::size_t k = 0; k < before.size(); ++k) {
+        // 未被优化改变的关键帧（固定节点、回环之前的部分）给出严格的单位修正，使对应区间可以跳过
+        Pose correction;
+        if (!same(after[k], before[k].pose)) {
+            correction = after[k] * before[k].pose.inverse();
+            correction.orientation.normalize();
+        }
+        corrections[k] = { before[k].time_stamp, correction };
+    }
+    return corrections;
+}
+
+/**
+ * @brief 预处理后的关键帧修正：每个相邻关键帧对一个区间
+ */
+class CorrectionSchedule {
+public:
+    using Kernel = void (*)(const kernels::CorrectionSegment&, TimedPose*, std::size_t);
+
+    // 连续存放的位姿按固定大小分块处理：同一个位姿总是落在 SIMD 通道或标量尾部的同一位置，结果与线程数无关
+    static constexpr std::size_t kBlockSize = 4096;
+
+    /**
+     * @param corrections 按时间戳严格递增的关键帧修正
+     * @throw std::invalid_argument 如果为空或时间戳不严格递增
+     */
+    explicit CorrectionSchedule(const std::vector<TimedPose>& corrections)
+    {
+        if (corrections.empty()) {
+            throw std::invalid_argument("Correction sequence is empty");
+        }
+        if (corrections.size() == 1) {
+            // 只有一个关键帧：整条轨迹使用同一个修正，区间长度任取
+            const TimedPose& only = corrections.front();
+            segments_.push_back(kernels::makeCorrectionSegment(only.time_stamp, only.pose, only.time_stamp + 1.0,
+                only.pose));
+        }
+        for (std::size_t k = 0; k + 1 < corrections.size(); ++k) {
+            if (!(corrections[k].time_stamp < corrections[k + 1].time_stamp)) {
+                throw std::invalid_argument("Correction timestamps must be strictly increasing");
+            }
+            segments_.push_back(kernels::makeCorrectionSegment(corrections[k].time_stamp, corrections[k].pose,
+                corrections[k + 1].time_stamp, corrections[k + 1].pose));
+        }
+        active_before_.assign(segments_.size() + 1, 0);
+        for (std::size_t s = 0; s < segments_.size(); ++s) {
+            active_before_[s + 1] = active_before_[s] + (segments_[s].identity ? 0 : 1);
+        }
+    }
+
+    const std::vector<kernels::CorrectionSegment>& segments() const { return segments_; }
+
+    /**
+     * @brief 时间 t 使用的区间：[t_s, t_{s+1})，两端的区间向外延伸
+     */
+    std::size_t segmentFor(double time) const
+    {
+        auto it = std::upper_bound(segments_.begin() + 1, segments_.end(), time,
+            [](double t, const kernels::CorrectionSegment& segment) { return t < segment.start_time; });
+        return static_cast<std::size_t>(it - segments_.begin()) - 1;
+    }
+
+    /**
+     * @brief 区间 [first, last] 中是否有需要改写的区间
+     */
+    bool anyActive(std::size_t first, std::size_t last) const
+    {
+        return active_before_[last + 1] > active_before_[first];
+    }
+
+    /**
+     * @brief 修正连续存放的 n 个位姿：按区间切成若干段，每段调用一次内核
+     * @param kernel 默认为分派选中的实现，也可以指定 correct_poses_kernel 的某个实现
+     */
+    void apply(TimedPose* poses, std::size_t n, Kernel kernel = kernels::correctPoses) const
+    {
+        std::size_t i = 0;
+        while (i < n) {
+            std::size_t s = segmentFor(poses[i].time_stamp);
+            std::size_t j = n;
+            if (s + 1 < segments_.size()) {
+                double next = segments_[s + 1].start_time;
+                j = static_cast<std::size_t>(std::partition_point(poses + i, poses + n,
+                                                 [&](const TimedPose& p) { return p.time_stamp < next; })
+                    - poses);
+            }
+            if (!segments_[s].identity) {
+                kernel(segments_[s], poses + i, j - i);
+            }
+            i = j;
+        }
+    }
+
+private:
+    std::vector<kernels::CorrectionSegment> segments_;
+    std::vector<std::size_t> active_before_; // 前 s 个区间中非单位修正的个数
+};
+
+/**
+ * @brief 串行地修正 std::vector 中的全部位姿
+ * @throw std::invalid_argument 如果 corrections 为空或时间戳不严格递增
+ */
+inline void propagateCorrections(std::vector<TimedPose>& poses, const std::vector<TimedPose>& corrections)
+{
+    CorrectionSchedule schedule(corrections);
+    for (std::size_t lo = 0; lo < poses.size(); lo += CorrectionSchedule::kBlockSize) {
+        schedule.apply(poses.data() + lo, std::min(CorrectionSchedule::kBlockSize, poses.size() - lo));
+    }
+}
+
+/**
+ * @brief 并行修正：固定大小的块分给线程池，每块内部按区间调用内核，结果与串行版本逐位相同
+ */
+inline void propagateCorrections(std::vector<TimedPose>& poses, const std::vector<TimedPose>& corrections,
+    ThreadPool& pool)
+{
+    CorrectionSchedule schedule(corrections);
+    const std::size_t block = CorrectionSchedule::kBlockSize;
+    pool.parallelFor(0, (poses.size() + block - 1) / block, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t b = lo; b < hi; ++b) {
+            schedule.apply(poses.data() + b * block, std::min(block, poses.size() - b * block));
+        }
+    }, 1);
+}
+
+namespace detail {
+
+    /**
+     * @brief 逐个修正节点式容器中的位姿：按时间顺序沿区间游走，不必每个位姿都二分查找
+     */
+    template <typename Range, typename Get>
+    void propagateEach(Range& poses, const std::vector<TimedPose>& corrections, Get get)
+    {
+        CorrectionSchedule schedule(corrections);
+        const auto& segments = schedule.segments();
+        std::size_t s = poses.empty() ? 0 : schedule.segmentFor(get(*poses.begin()).time_stamp);
+        for (auto& element : poses) {
+            TimedPose& pose = get(element);
+            while (s + 1 < segments.size() && segments[s + 1].start_time <= pose.time_stamp) {
+                ++s;
+            }
+            if (!segments[s].identity) {
+                kernels::correctPoses(segments[s], &pose, 1);
+            }
+        }
+    }
+
+} // namespace detail
+
+/**
+ * @brief 修正 std::list 中的位姿
+ */
+inline void propagateCorrections(std::list<TimedPose>& poses, const std::vector<TimedPose>& corrections)
+{
+    detail::propagateEach(poses, corrections, [](TimedPose& pose) -> TimedPose& { return pose; });
+}
+
+/**
+ * @brief 修正以时间戳为键的 std::map 中的位姿（键不变）
+ */
+inline void propagateCorrections(std::map<double, TimedPose>& poses, const std::vector<TimedPose>& corrections)
+{
+    detail::propagateEach(poses, corrections,
+        [](std::pair<const double, TimedPose>& entry) -> TimedPose& { return entry.second; });
+}
+
+/**
+ * @brief 在 TrajectoryStore 的写事务中修正全部位姿，各块并行
+ *
+ * 只落在单位修正区间内的块不会被复制，仍与旧版本共享（例如回环之前、固定的第一个关键帧附近的轨迹）。
+ * @return 被改写（复制）的块数
+ */
+inline std::size_t propagateCorrections(TrajectoryStore::Transaction& transaction,
+    const std::vector<TimedPose>& corrections, ThreadPool& pool)
+{
+    CorrectionSchedule schedule(corrections);
+    std::vector<char> touched(transaction.chunkCount(), 0);
+    pool.parallelFor(0, transaction.chunkCount(), [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c < hi; ++c) {
+            std::size_t first = c * transaction.chunkSize();
+            std::size_t last = std::min(first + transaction.chunkSize(), transaction.size()) - 1;
+            if (!schedule.anyActive(schedule.segmentFor(transaction[first].time_stamp),
+                    schedule.segmentFor(transaction[last].time_stamp))) {
+                continue;
+            }
+            std::span<TimedPose> chunk = transaction.writableChunk(c);
+            schedule.apply(chunk.data(), chunk.size());
+            touched[c] = 1;
+        }
+    }, 1);
+    return static_cast<std::size_t>(std::count(touched.begin(), touched.end(), 1));
+}
+
+} // namespace robotics
@@ -0,0 +1,332 @@
+#pragma once
+/**
+ * @file dispatch.hpp
+ * @brief 运行时 CPU 特性检测与内核分派注册表。
+ *
+ * 同一个二进制要部署在指令集不同的机器上：内核的各个实现（标量 / AVX2 / AVX-512）都编译进程序，
+ * 启动时用 cpuid 检测一次 CPU 特性，每个内核选出可用的最佳实现。
+ *
+ * 环境变量覆盖（用于测试与排查）：
+ *   PRESLAM_ISA=scalar|avx2|avx512        所有内核可使用的最高指令集
+ *   PRESLAM_KERNEL_<NAME>=scalar|avx2|... 指定某个内核的实现，NAME 为大写的内核名，如 PRESLAM_KERNEL_DISTANCE
+ * 请求的实现在当前 CPU 上不可用时回退到最佳可用实现，并在报告中注明原因。
+ */
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PRESLAM_X86_DISPATCH 1
+#include <cpuid.h>
+#endif
+
+namespace robotics {
+
+/**
+ * @brief 内核实现所需的指令集级别（按能力递增）
+ */
+enum class IsaLevel {
+    Scalar = 0,
+    AVX2 = 1, // AVX2 + FMA
+    AVX512 = 2, // AVX-512F
+};
+
+inline const char* isaName(IsaLevel level)
+{
+    switch (level) {
+    case IsaLevel::AVX2:
+        return "avx2";
+    case IsaLevel::AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @brief 解析指令集名称（大小写不敏感）
+ */
+inline std::optional<IsaLevel> parseIsa(std::string name)
+{
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (name == "scalar") {
+        return IsaLevel::Scalar;
+    }
+    if (name == "avx2") {
+        return IsaLevel::AVX2;
+    }
+    if (name == "avx512" || name == "avx512f") {
+        return IsaLevel::AVX512;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief 检测到的 CPU 特性
+ *
+ * AVX 类特性除了 cpuid 位，还要求操作系统通过 XSAVE 保存对应的寄存器状态（XGETBV）。
+ */
+struct CpuFeatures {
+    bool sse42 { false };
+    bool avx { false };
+    bool avx2 { false };
+    bool fma { false };
+    bool avx512f { false };
+
+    IsaLevel maxIsa() const
+    {
+        if (avx512f && avx2 && fma) {
+            return IsaLevel::AVX512;
+        }
+        if (avx2 && fma) {
+            return IsaLevel::AVX2;
+        }
+        return IsaLevel::Scalar;
+    }
+};
+
+namespace detail {
+
+    inline CpuFeatures detectCpuFeatures()
+    {
+        CpuFeatures features;
+#ifdef PRESLAM_X86_DISPATCH
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return features;
+        }
+        features.sse42 = (ecx & (1u << 20)) != 0;
+        bool osxsave = (ecx & (1u << 27)) != 0;
+        bool cpu_avx = (ecx & (1u << 28)) != 0;
+        bool cpu_fma = (ecx & (1u << 12)) != 0;
+
+        unsigned long long xcr0 = 0;
+        if (osxsave) {
+            unsigned lo = 0, hi = 0;
+            __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            xcr0 = (static_cast<unsigned long long>(hi) << 32) | lo;
+        }
+        bool os_ymm = (xcr0 & 0x6) == 0x6; // XMM + YMM 状态
+        bool os_zmm = (xcr0 & 0xe6) == 0xe6; // 另加 opmask 与 ZMM 状态
+
+        features.avx = cpu_avx && os_ymm;
+        features.fma = cpu_fma && os_ymm;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            features.avx2 = (ebx & (1u << 5)) != 0 && os_ymm;
+            features.avx512f = (ebx & (1u << 16)) != 0 && os_zmm;
+        }
+#endif
+        return features;
+    }
+
+    inline std::string environmentKey(const std::string& kernel)
+    {
+        std::string key = "PRESLAM_KERNEL_";
+        for (unsigned char c : kernel) {
+            key += std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_';
+        }
+        return key;
+    }
+
+} // namespace detail
+
+/**
+ * @brief 进程内只检测一次的 CPU 特性
+ */
+inline const CpuFeatures& cpuFeatures()
+{
+    static const CpuFeatures features = detail::detectCpuFeatures();
+    return features;
+}
+
+/**
+ * @brief 内核可使用的最高指令集：CPU 支持的最高级别，再受 PRESLAM_ISA 限制
+ */
+inline IsaLevel allowedIsa()
+{
+    static const IsaLevel level = [] {
+        IsaLevel supported = cpuFeatures().maxIsa();
+        if (const char* value = std::getenv("PRESLAM_ISA")) {
+            std::optional<IsaLevel> requested = parseIsa(value);
+            if (!requested) {
+                std::cerr << "Warning: ignoring unknown PRESLAM_ISA=" << value << std::endl;
+            } else if (*requested > supported) {
+                std::cerr << "Warning: PRESLAM_ISA=" << value << " is not supported by this CPU, using "
+                          << isaName(supported) << std::endl;
+            } else {
+                return *requested;
+            }
+        }
+        return supported;
+    }();
+    return level;
+}
+
+/**
+ * @brief 已选定的内核实现的全局登记，用于报告
+ */
+class KernelRegistry {
+public:
+    struct Entry {
+        std::string kernel;
+        std::string selected;
+        std::vector<std::string> available; // 编译进程序的全部实现
+        std::string reason;
+    };
+
+    static KernelRegistry& instance()
+    {
+        static KernelRegistry registry;
+        return registry;
+    }
+
+    void record(Entry entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(std::move(entry));
+    }
+
+    std::vector<Entry> entries() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_;
+    }
+
+    /**
+     * @brief 打印 CPU 特性与每个内核选中的实现
+     */
+    void report(std::ostream& out) const
+    {
+        const CpuFeatures& f = cpuFeatures();
+        out << "CPU features:";
+        out << (f.sse42 ? " sse4.2" : "") << (f.avx ? " avx" : "") << (f.avx2 ? " avx2" : "") << (f.fma ? " fma" : "")
+            << (f.avx512f ? " avx512f" : "");
+        out << "\nAllowed ISA:  " << isaName(allowedIsa());
+        if (const char* value = std::getenv("PRESLAM_ISA")) {
+            out << " (PRESLAM_ISA=" << value << ")";
+        }
+        out << "\n\n"
+            << std::left << std::setw(24) << "Kernel" << std::setw(10) << "Selected" << std::setw(24) << "Available"
+            << "Reason" << std::endl;
+        for (const Entry& entry : entries()) {
+            std::string available;
+            for (const std::string& name : entry.available) {
+                available += (available.empty() ? "" : " ") + name;
+            }
+            out << std::setw(24) << entry.kernel << std::setw(10) << entry.selected << std::setw(24) << available
+                << entry.reason << std::endl;
+        }
+        out << std::right;
+    }
+
+private:
+    KernelRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+template <typename Signature>
+class DispatchedKernel;
+
+/**
+ * @brief 一个按指令集分派的内核
+ *
+ * 构造时（通常是静态初始化期间）选出实现并登记到 KernelRegistry，之后的调用只是一次间接函数调用。
+ * supportedVariants() 暴露当前 CPU 能运行的全部实现，供差分测试逐个与标量版本比较。
+ */
+template <typename R, typename... Args>
+class DispatchedKernel<R(Args...)> {
+public:
+    using Function = R (*)(Args...);
+
+    struct Variant {
+        IsaLevel isa;
+        Function function;
+    };
+
+    /**
+     * @param name 内核名（小写，环境变量中转为大写）
+     * @param variants 各实现，必须包含一个 Scalar 实现
+     */
+    DispatchedKernel(std::string name, std::initializer_list<Variant> variants)
+        : name_(std::move(name))
+        , variants_(variants)
+    {
+        std::sort(variants_.begin(), variants_.end(),
+            [](const Variant& a, const Variant& b) { return a.isa < b.isa; });
+        select();
+    }
+
+    // selected_ 指向 variants_ 内部，不可复制
+    DispatchedKernel(const DispatchedKernel&) = delete;
+    DispatchedKernel& operator=(const DispatchedKernel&) = delete;
+
+    R operator()(Args... args) const { return selected_->function(args...); }
+
+    const std::string& name() const { return name_; }
+    IsaLevel selectedIsa() const { return selected_->isa; }
+
+    /**
+     * @brief 当前 CPU 能运行的全部实现（不受环境变量限制）
+     */
+    std::vector<Variant> supportedVariants() const
+    {
+        std::vector<Variant> result;
+        for (const Variant& variant : variants_) {
+            if (variant.isa <= cpuFeatures().maxIsa()) {
+                result.push_back(variant);
+            }
+        }
+        return result;
+    }
+
+private:
+    void select()
+    {
+        IsaLevel limit = allowedIsa();
+        std::string reason = limit == cpuFeatures().maxIsa() ? "best supported" : "capped by PRESLAM_ISA";
+
+        std::string key = detail::environmentKey(name_);
+        if (const char* value = std::getenv(key.c_str())) {
+            std::optional<IsaLevel> requested = parseIsa(value);
+            auto it = std::find_if(variants_.begin(), variants_.end(),
+                [&](const Variant& v) { return requested && v.isa == *requested; });
+            if (it == variants_.end()) {
+                reason = key + "=" + value + " has no such variant";
+            } else if (it->isa > cpuFeatures().maxIsa()) {
+                reason = key + "=" + value + " not supported by CPU";
+            } else {
+                limit = it->isa;
+                reason = key + "=" + value;
+            }
+        }
+
+        selected_ = &variants_.front();
+        for (const Variant& variant : variants_) {
+            if (variant.isa <= limit) {
+                selected_ = &variant;
+            }
+        }
+
+        KernelRegistry::Entry entry { name_, isaName(selected_->isa), {}, reason };
+        for (const Variant& variant : variants_) {
+            entry.available.push_back(isaName(variant.isa));
+        }
+        KernelRegistry::instance().record(std::move(entry));
+    }
+
+    std::string name_;
+    std::vector<Variant> variants_;
+    const Variant* selected_ { nullptr };
+};
+
+} // namespace robotics
@@ -0,0 +1,256 @@
+#pragma once
+/**
+ * @file dual_quaternion.hpp
+ * @brief 单位对偶四元数表示的位姿：与 Pose 互相转换、复合、作用于点，以及两种插值。
+ *
+ * σ = r + ε d，r 是姿态四元数，d = ½ (0, t) ⊗ r。interpolatePose 把平移线性插值、姿态 SLERP 分开做，
+ * 轨迹不是螺旋运动，且每次调用要 acos 和 sin。这里提供：
+ *
+ * - sclerp：螺旋线性插值 a ⊗ (a⁻¹ b)^t，沿两个位姿之间的螺旋运动匀速前进，
+ *   与 SE(3) 测地线 a · Exp(t · Log(a⁻¹ b)) 相同，姿态部分就是精确的 SLERP；
+ * - dlb：对偶四元数线性混合 normalize((1 - t) a + t b)，只有乘加和一次开方。
+ *   姿态部分等于 nlerp，与 sclerp 的偏差随区间内的转角 θ 按 O(θ²) 减小，对高频采样的稠密去畸变足够精确；
+ * - kernels::deskewPoints：同一区间内的 n 个点，各自按自己的插值因子做 DLB 并变换，AVX2 实现一次处理 4 个点。
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "kernels.hpp"
+#include "pose.hpp"
+
+#ifdef PRESLAM_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace robotics {
+
+/**
+ * @brief 单位对偶四元数 σ = real + ε dual，表示刚体变换 T(p) = R p + t
+ */
+struct DualQuaternion {
+    Quaternion real;
+    Quaternion dual { 0.0, 0.0, 0.0, 0.0 };
+
+    /**
+     * @param pose 姿态须为单位四元数
+     */
+    static DualQuaternion fromPose(const Pose& pose)
+    {
+        const Quaternion& r = pose.orientation;
+        Quaternion t { 0.0, pose.position.x, pose.position.y, pose.position.z };
+        return { r, t * r * 0.5 };
+    }
+
+    // 平移 t = 2 (d ⊗ r*) 的虚部
+    Vector3 translation() const
+    {
+        Vector3 rv { real.x, real.y, real.z };
+        Vector3 dv { dual.x, dual.y, dual.z };
+        return (dv * real.w - rv * dual.w + rv.cross(dv)) * 2.0;
+    }
+
+    Pose toPose() const { return { translation(), real }; }
+
+    // 复合：先作用 other，再作用 this（与 Pose::operator* 相同）
+    DualQuaternion operator*(const DualQuaternion& other) const
+    {
+        return { real * other.real, real * other.dual + dual * other.real };
+    }
+
+    // 单位对偶四元数的逆
+    DualQuaternion conjugate() const { return { real.conjugate(), dual.conjugate() }; }
+
+    Vector3 transformPoint(const Vector3& point) const { return real.rotate(point) + translation(); }
+
+    /**
+     * @brief 投影回单位对偶四元数：|real| = 1，且 real · dual = 0
+     */
+    void normalize()
+    {
+        double norm = std::sqrt(real.w * real.w + real.x * real.x + real.y * real.y + real.z * real.z);
+        if (norm > 1e-10) {
+            real = real * (1.0 / norm);
+            dual = dual * (1.0 / norm);
+        }
+        double projection = real.w * dual.w + real.x * dual.x + real.y * dual.y + real.z * dual.z;
+        dual = dual + real * -projection;
+    }
+
+    /**
+     * @brief 幂 σ^t：沿 σ 的螺旋运动走 t 倍，转角和沿轴的位移都乘以 t
+     *
+     * 写成 σ = cos(θ̂/2) + sin(θ̂/2) l̂（对偶角 θ̂ = θ + ε d，对偶轴 l̂ = l + ε m）后消去 l、d、m：
+     * real' = (cos(tθ/2), k r.v)，dual' = (t k d.w, k d.v + f d.w r.v)，
+     * 其中 k = sin(tθ/2) / sin(θ/2)，f = (k cos(θ/2) - t cos(tθ/2)) / sin²(θ/2)。
+     * 转角很小时 k、f 改用级数，纯平移也不需要单独处理。σ 须为单位对偶四元数，real.w < 0 时走长路径。
+     */
+    DualQuaternion pow(double t) const
+    {
+        double sin_half = std::sqrt(real.x * real.x + real.y * real.y + real.z * real.z);
+        double half = std::atan2(sin_half, real.w);
+        double cos_t = std::cos(t * half);
+        double k, f;
+        if (sin_half < 1e-4) {
+            k = t * (1.0 + (1.0 - t * t) * half * half / 6.0);
+            f = t * (t * t - 1.0) / 3.0;
+        } else {
+            k = std::sin(t * half) / sin_half;
+            f = (k * real.w - t * cos_t) / (sin_half * sin_half);
+        }
+        double g = f * dual.w;
+        return {
+            { cos_t, k * real.x, k * real.y, k * real.z },
+            { t * k * dual.w, k * dual.x + g * real.x, k * dual.y + g * real.y, k * dual.z + g * real.z }
+        };
+    }
+};
+
+/**
+ * @brief 对偶四元数线性混合（DLB）：normalize((1 - t) a + t b)，b 先翻到与 a 同一半球
+ * @param t 插值因子，会被截断到 [0, 1]
+ */
+inline DualQuaternion dlb(const DualQuaternion& a, const DualQuaternion& b, double t)
+{
+    t = std::clamp(t, 0.0, 1.0);
+    double dot = a.real.w * b.real.w + a.real.x * b.real.x + a.real.y * b.real.y + a.real.z * b.real.z;
+    double wa = 1.0 - t;
+    double wb = dot < 0.0 ? -t : t;
+    DualQuaternion result { a.real * wa + b.real * wb, a.dual * wa + b.dual * wb };
+    result.normalize();
+    return result;
+}
+
+/**
+ * @brief 螺旋线性插值（ScLERP）：a ⊗ (a⁻¹ b)^t，走两个半球中较短的螺旋
+ * @param t 插值因子，会被截断到 [0, 1]
+ */
+inline DualQuaternion sclerp(const DualQuaternion& a, DualQuaternion b, double t)
+{
+    t = std::clamp(t, 0.0, 1.0);
+    double dot = a.real.w * b.real.w + a.real.x * b.real.x + a.real.y * b.real.y + a.real.z * b.real.z;
+    if (dot < 0.0) {
+        b = { b.real * -1.0, b.dual * -1.0 };
+    }
+    return a * (a.conjugate() * b).pow(t);
+}
+
+namespace kernels {
+
+    namespace detail {
+
+        // --- 区间内的 DLB 去畸变 p' = dlb(a, b, s) p ---
+
+        inline void deskewPointsScalar(const DualQuaternion& start, const DualQuaternion& end, const double* factors,
+            const Vector3* in, Vector3* out, std::size_t n)
+        {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = dlb(start, end, factors[i]).transformPoint(in[i]);
+            }
+        }
+
+#ifdef PRESLAM_X86_DISPATCH
+        /**
+         * @brief AVX2 去畸变：4 个点各自混合出对偶四元数，归一化后直接作用于点，不经过旋转矩阵
+         */
+        __attribute__((target("avx2,fma"))) inline void deskewPointsAvx2(const DualQuaternion& start,
+            const DualQuaternion& end, const double* factors, const Vector3* in, Vector3* out, std::size_t n)
+        {
+            double dot = start.real.w * end.real.w + start.real.x * end.real.x + start.real.y * end.real.y
+                + start.real.z * end.real.z;
+            double sign = dot < 0.0 ? -1.0 : 1.0;
+            const double a[8] = { start.real.w, start.real.x, start.real.y, start.real.z, start.dual.w, start.dual.x,
+                start.dual.y, start.dual.z };
+            const double b[8] = { sign * end.real.w, sign * end.real.x, sign * end.real.y, sign * end.real.z,
+                sign * end.dual.w, sign * end.dual.x, sign * end.dual.y, sign * end.dual.z };
+            __m256d va[8], vb[8];
+            for (int k = 0; k < 8; ++k) {
+                va[k] = _mm256_set1_pd(a[k]);
+                vb[k] = _mm256_set1_pd(b[k]);
+            }
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d two = _mm256_set1_pd(2.0);
+
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256d t = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(factors + i), zero), one);
+                __m256d wa = _mm256_sub_pd(one, t);
+                __m256d q[8];
+                for (int k = 0; k < 8; ++k) {
+                    q[k] = _mm256_fmadd_pd(vb[k], t, _mm256_mul_pd(va[k], wa));
+                }
+
+                // 归一化：r /= |r|，d /= |r|，再去掉 d 在 r 上的分量
+                __m256d norm2 = _mm256_fmadd_pd(q[0], q[0],
+                    _mm256_fmadd_pd(q[1], q[1], _mm256_fmadd_pd(q[2], q[2], _mm256_mul_pd(q[3], q[3]))));
+                __m256d inv = _mm256_div_pd(one, _mm256_sqrt_pd(norm2));
+                for (int k = 0; k < 8; ++k) {
+                    q[k] = _mm256_mul_pd(q[k], inv);
+                }
+                __m256d projection = _mm256_fmadd_pd(q[0], q[4],
+                    _mm256_fmadd_pd(q[1], q[5], _mm256_fmadd_pd(q[2], q[6], _mm256_mul_pd(q[3], q[7]))));
+                for (int k = 0; k < 4; ++k) {
+                    q[4 + k] = _mm256_fnmadd_pd(projection, q[k], q[4 + k]);
+                }
+                const __m256d &rw = q[0], &rx = q[1], &ry = q[2], &rz = q[3];
+                const __m256d &dw = q[4], &dx = q[5], &dy = q[6], &dz = q[7];
+
+                // t = 2 (r.w d.v - d.w r.v + r.v × d.v)
+                __m256d tx = _mm256_fmsub_pd(ry, dz, _mm256_mul_pd(rz, dy));
+                __m256d ty = _mm256_fmsub_pd(rz, dx, _mm256_mul_pd(rx, dz));
+                __m256d tz = _mm256_fmsub_pd(rx, dy, _mm256_mul_pd(ry, dx));
+                tx = _mm256_mul_pd(two, _mm256_fmadd_pd(rw, dx, _mm256_fnmadd_pd(dw, rx, tx)));
+                ty = _mm256_mul_pd(two, _mm256_fmadd_pd(rw, dy, _mm256_fnmadd_pd(dw, ry, ty)));
+                tz = _mm256_mul_pd(two, _mm256_fmadd_pd(rw, dz, _mm256_fnmadd_pd(dw, rz, tz)));
+
+                // p' = p + r.w e + r.v × e + t，e = 2 (r.v × p)（与 Quaternion::rotate 相同）
+                __m256d px, py, pz;
+                loadPoints4(in + i, px, py, pz);
+                __m256d ex = _mm256_mul_pd(two, _mm256_fmsub_pd(ry, pz, _mm256_mul_pd(rz, py)));
+                __m256d ey = _mm256_mul_pd(two, _mm256_fmsub_pd(rz, px, _mm256_mul_pd(rx, pz)));
+                __m256d ez = _mm256_mul_pd(two, _mm256_fmsub_pd(rx, py, _mm256_mul_pd(ry, px)));
+                __m256d ox = _mm256_add_pd(_mm256_fmadd_pd(rw, ex, px), _mm256_fmsub_pd(ry, ez, _mm256_mul_pd(rz, ey)));
+                __m256d oy = _mm256_add_pd(_mm256_fmadd_pd(rw, ey, py), _mm256_fmsub_pd(rz, ex, _mm256_mul_pd(rx, ez)));
+                __m256d oz = _mm256_add_pd(_mm256_fmadd_pd(rw, ez, pz), _mm256_fmsub_pd(rx, ey, _mm256_mul_pd(ry, ex)));
+                storePoints4(out + i, _mm256_add_pd(ox, tx), _mm256_add_pd(oy, ty), _mm256_add_pd(oz, tz));
+            }
+            if (i < n) {
+                deskewPointsScalar(start, end, factors + i, in + i, out + i, n - i);
+            }
+        }
+#endif
+
+    } // namespace detail
+
+    /**
+     * @brief 区间去畸变内核：out[i] = dlb(start, end, factors[i]) * in[i]
+     */
+    inline const DispatchedKernel<void(const DualQuaternion&, const DualQuaternion&, const double*, const Vector3*,
+        Vector3*, std::size_t)>
+        deskew_points_kernel {
+            "deskew_points",
+            {
+                { IsaLevel::Scalar, detail::deskewPointsScalar },
+#ifdef PRESLAM_X86_DISPATCH
+                { IsaLevel::AVX2, detail::deskewPointsAvx2 },
+#endif
+            }
+        };
+
+    /**
+     * @brief 把同一位姿区间内的 n 个点各自变换到自己时刻的位姿下：out[i] = dlb(start, end, factors[i]) * in[i]
+     * @param factors 每个点在区间内的插值因子 (t_i - t_start) / (t_end - t_start)，会被截断到 [0, 1]
+     * @param in 与 out 可以相同
+     */
+    inline void deskewPoints(const DualQuaternion& start, const DualQuaternion& end, const double* factors,
+        const Vector3* in, Vector3* out, std::size_t n)
+    {
+        deskew_points_kernel(start, end, factors, in, out, n);
+    }
+
+} // namespace kernels
+
+} // namespace robotics
@@ -0,0 +1,223 @@
+#pragma once
+/**
+ * @file ekf.hpp
+ * @brief 定长的扩展卡尔曼滤波 / 误差状态滤波：协方差只算下三角，更新用 Joseph 形式，热路径上没有堆分配。
+ *
+ * 状态维数 N 与测量维数 M 都是模板参数，所有矩阵都是 Eigen 的定长类型（例如误差状态 INS 的 N = 15，
+ * GNSS 位置、轮速计速度的 M = 3），分解用与 a0 solveWithLLT 相同的 Eigen::LLT，只是换成定长矩阵，
+ * 不经过 MatrixXd 和 SolveResult。
+ *
+ * 协方差在预测和更新中都只计算下三角，最后镜像到上三角，所以 P 总是严格对称。更新采用 Joseph 形式
+ *
+ *     P ← (I - K H) P (I - K H)ᵀ + K R Kᵀ
+ *
+ * 它对增益 K 的误差只有二阶敏感，测量远比先验精确时也不会像 P - K H P 那样因抵消失去正定性。
+ * 这里按 B = (I - K H) P = P - K (H P)、P ← B - (B Hᵀ - K R) Kᵀ 的顺序计算，代价为 O(N² M)，
+ * 不做 N x N 的完整矩阵乘法。
+ *
+ * 噪声互不相关的多个测量可以依次更新（与把它们堆成一个大测量的结果相同），
+ * 每次只分解 M x M 的新息协方差。
+ */
+#include <Eigen/Cholesky>
+#include <Eigen/Dense>
+#include <cstddef>
+#include <limits>
+
+namespace robotics::ekf {
+
+template <int N>
+using VectorNd = Eigen::Matrix<double, N, 1>;
+
+template <int N>
+using MatrixNd = Eigen::Matrix<double, N, N>;
+
+/**
+ * @brief 一次更新的结果
+ */
+struct UpdateResult {
+    bool accepted { false }; // 新息协方差不正定或超过门限时为 false，此时状态与协方差不变
+    double nis { 0.0 }; // 归一化新息平方 νᵀ S⁻¹ ν，服从自由度为 M 的 χ² 分布
+};
+
+/**
+ * @brief 在线性化点上求值的测量：残差 r = z - h(x̄)、雅可比 H = ∂h/∂δx 与测量噪声 R
+ */
+template <int M, int N>
+struct Measurement {
+    VectorNd<M> residual { VectorNd<M>::Zero() };
+    Eigen::Matrix<double, M, N> jacobian { Eigen::Matrix<double, M, N>::Zero() };
+    MatrixNd<M> noise { MatrixNd<M>::Identity() };
+};
+
+/**
+ * @brief 误差状态滤波器：只维护误差状态 δx 的协方差，修正量由调用者注入名义状态
+ *
+ * 注入后误差状态归零。需要考虑注入对协方差的影响（例如姿态误差的重置雅可比 G）时，
+ * 调用 predict(G, 0)。
+ */
+template <int N>
+class ErrorStateFilter {
+public:
+    static_assert(N > 0, "ErrorStateFilter needs a fixed state dimension");
+
+    using State = VectorNd<N>;
+    using Covariance = MatrixNd<N>;
+
+    explicit ErrorStateFilter(const Covariance& covariance = Covariance::Identity())
+        : covariance_(0.5 * (covariance + covariance.transpose()))
+    {
+    }
+
+    const Covariance& covariance() const { return covariance_; }
+
+    /**
+     * @brief 协方差预测 P ← F P Fᵀ + Q，只算下三角
+     */
+    void predict(const Covariance& transition, const Covariance& process_noise)
+    {
+        // P 对称，所以 P Fᵀ 的第 i 列就是 F P 的第 i 行；按列取点积，访问都是连续的
+        const Covariance pft = covariance_ * transition.transpose();
+        const Covariance ft = transition.transpose();
+        for (int j = 0; j < N; ++j) {
+            for (int i = j; i < N; ++i) {
+                covariance_(i, j) = pft.col(i).dot(ft.col(j)) + process_noise(i, j);
+            }
+        }
+        mirrorLower();
+    }
+
+    /**
+     * @brief 用一个测量更新，修正量累加到 correction 上
+     *
+     * 新息按 ν = r - H · correction 计算，所以 correction 为零时就是普通的 EKF 更新；
+     * 依次处理同一线性化点上的多个测量时，每个测量都看到前面测量带来的修正。
+     * @param gate NIS 的门限（例如 χ²(M) 的 99% 分位数），超过时拒绝该测量
+     */
+    template <int M>
+    UpdateResult update(const VectorNd<M>& residual, const Eigen::Matrix<double, M, N>& jacobian,
+        const MatrixNd<M>& noise, State& correction, double gate = std::numeric_limits<double>::infinity())
+    {
+        using Gain = Eigen::Matrix<double, M, N>; // 按 Kᵀ 存放，第 i 列是 K 的第 i 行
+
+        const Gain hp = jacobian * covariance_; // H P = (P Hᵀ)ᵀ
+        MatrixNd<M> innovation_covariance = noise;
+        innovation_covariance.noalias() += hp * jacobian.transpose();
+        const Eigen::LLT<MatrixNd<M>> llt(innovation_covariance);
+        if (llt.info() != Eigen::Success) {
+            return { false, std::numeric_limits<double>::quiet_NaN() };
+        }
+
+        const VectorNd<M> innovation = residual - jacobian * correction;
+        const double nis = llt.matrixL().solve(innovation).squaredNorm();
+        if (!(nis <= gate)) {
+            return { false, nis };
+        }
+        const Gain gain_t = llt.solve(hp); // Kᵀ = S⁻¹ H P
+        correction.noalias() += gain_t.transpose() * innovation;
+
+        // Joseph 形式：B = P - K (H P)，P ← B - (B Hᵀ - K R) Kᵀ，只算下三角
+        Covariance b = covariance_;
+        b.noalias() -= gain_t.transpose() * hp;
+        Gain gt = jacobian * b.transpose(); // (B Hᵀ)ᵀ
+        gt.noalias() -= noise * gain_t; // R 对称
+        for (int j = 0; j < N; ++j) {
+            for (int i = j; i < N; ++i) {
+                covariance_(i, j) = b(i, j) - gt.col(i).dot(gain_t.col(j));
+            }
+        }
+        mirrorLower();
+        return { true, nis };
+    }
+
+    template <int M>
+    UpdateResult update(const Measurement<M, N>& measurement, State& correction,
+        double gate = std::numeric_limits<double>::infinity())
+    {
+        return update<M>(measurement.residual, measurement.jacobian, measurement.noise, correction, gate);
+    }
+
+    /**
+     * @brief 依次用 count 个噪声互不相关的测量更新，修正量累加到 correction 上
+     * @param results 可为空；否则写入每个测量的结果
+     * @return std::size_t 被接受的测量个数
+     */
+    template <int M>
+    std::size_t update(const Measurement<M, N>* measurements, std::size_t count, State& correction,
+        double gate = std::numeric_limits<double>::infinity(), UpdateResult* results = nullptr)
+    {
+        std::size_t accepted = 0;
+        for (std::size_t k = 0; k < count; ++k) {
+            UpdateResult result = update<M>(measurements[k], correction, gate);
+            accepted += result.accepted ? 1 : 0;
+            if (results != nullptr) {
+                results[k] = result;
+            }
+        }
+        return accepted;
+    }
+
+private:
+    void mirrorLower() { covariance_.template triangularView<Eigen::StrictlyUpper>() = covariance_.transpose(); }
+
+    Covariance covariance_;
+};
+
+/**
+ * @brief 状态在向量空间中的扩展卡尔曼滤波器：状态与协方差一起维护，修正量直接加到状态上
+ */
+template <int N>
+class ExtendedKalmanFilter {
+public:
+    using State = VectorNd<N>;
+    using Covariance = MatrixNd<N>;
+
+    ExtendedKalmanFilter(const State& state, const Covariance& covariance)
+        : state_(state)
+        , filter_(covariance)
+    {
+    }
+
+    const State& state() const { return state_; }
+    const Covariance& covariance() const { return filter_.covariance(); }
+
+    /**
+     * @brief 预测：状态换成过程模型的输出 f(x)，协方差按其雅可比 F 传播
+     */
+    void predict(const State& predicted_state, const Covariance& transition, const Covariance& process_noise)
+    {
+        state_ = predicted_state;
+        filter_.predict(transition, process_noise);
+    }
+
+    /**
+     * @param residual z - h(x)，在当前状态上求值
+     */
+    template <int M>
+    UpdateResult update(const VectorNd<M>& residual, const Eigen::Matrix<double, M, N>& jacobian,
+        const MatrixNd<M>& noise, double gate = std::numeric_limits<double>::infinity())
+    {
+        State correction = State::Zero();
+        UpdateResult result = filter_.template update<M>(residual, jacobian, noise, correction, gate);
+        state_ += correction;
+        return result;
+    }
+
+    /**
+     * @brief 同一线性化点上的一批互不相关的测量，依次更新后一次性修正状态
+     */
+    template <int M>
+    std::size_t update(const Measurement<M, N>* measurements, std::size_t count,
+        double gate = std::numeric_limits<double>::infinity(), UpdateResult* results = nullptr)
+    {
+        State correction = State::Zero();
+        std::size_t accepted = filter_.template update<M>(measurements, count, correction, gate, results);
+        state_ += correction;
+        return accepted;
+    }
+
+private:
+    State state_;
+    ErrorStateFilter<N> filter_;
+};
+
+} // namespace robotics::ekf
@@ -0,0 +1,268 @@
+#pragma once
+/**
+ * @file imu_preintegration.hpp
+ * @brief 流形上的 IMU 预积分（Forster 等，"On-Manifold Preintegration for Real-Time Visual-Inertial Odometry"）。
+ *
+ * 两个关键帧之间的原始 IMU 采样被积分成一个与起点状态无关的相对运动 (ΔR, Δv, Δp)，
+ * 同时递推其 9x9 协方差与对零偏的雅可比。优化中零偏估计改变时，用一阶修正
+ * ΔR(b) ≈ ΔR(b̄) Exp(∂ΔR/∂bg δbg) 等代替重新积分：每个区间只需几次 3x3 运算，
+ * 而重新积分在 1 kHz 下每 0.1 s 的区间就要处理 100 个采样。
+ *
+ * 状态误差的顺序为 [δθ, δv, δp]，零偏顺序为 [bg, ba]。
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "lie.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+
+namespace robotics::imu {
+
+/**
+ * @brief 一个 IMU 采样（机体系下的角速度与比力）
+ */
+struct ImuSample {
+    double time { 0.0 }; // 秒
+    Vector3 gyro; // rad/s
+    Vector3 accel; // m/s^2，比力（静止时约为 -g）
+};
+
+struct ImuBias {
+    Vector3 gyro;
+    Vector3 accel;
+};
+
+/**
+ * @brief 连续时间白噪声密度，离散化时方差为 density² / dt
+ */
+struct ImuNoise {
+    double gyro_noise_density { 1.7e-4 }; // rad/s/√Hz
+    double accel_noise_density { 2.0e-3 }; // m/s²/√Hz
+};
+
+/**
+ * @brief 导航状态：世界系下的位姿与速度
+ */
+struct NavState {
+    Pose pose;
+    Vector3 velocity;
+};
+
+using Matrix9d = Eigen::Matrix<double, 9, 9>;
+using Vector9d = Eigen::Matrix<double, 9, 1>;
+
+/**
+ * @brief 两个关键帧之间的预积分量
+ */
+class PreintegratedImu {
+public:
+    PreintegratedImu() = default;
+
+    /**
+     * @param bias 积分时使用的零偏（线性化点）
+     */
+    explicit PreintegratedImu(const ImuBias& bias, const ImuNoise& noise = {})
+        : bias_(bias)
+        , noise_(noise)
+    {
+    }
+
+    /**
+     * @brief 积分一个采样，测量在 [t, t + dt) 内视为常值
+     * @throw std::invalid_argument 如果 dt 不为正
+     */
+    void integrate(const Vector3& gyro, const Vector3& accel, double dt)
+    {
+        if (!(dt > 0.0)) {
+            throw std::invalid_argument("IMU integration step must be positive");
+        }
+        const Eigen::Vector3d a = lie::toEigen(accel - bias_.accel);
+        const Vector3 omega_dt = (gyro - bias_.gyro) * dt;
+        const Quaternion step = lie::exp(omega_dt);
+        const Eigen::Matrix3d step_t = lie::rotationMatrix(step).transpose();
+        const Eigen::Matrix3d right_jacobian = lie::rightJacobian(omega_dt);
+        const Eigen::Matrix3d r = lie::rotationMatrix(delta_rotation_);
+        const Eigen::Matrix3d r_skew_a = r * lie::skew(a);
+        const double dt2 = dt * dt;
+
+        // 协方差：Σ ← A Σ Aᵀ + B Σg Bᵀ + C Σa Cᵀ，其中
+        //   A = [ΔRkᵀ 0 0; -ΔR[a]×dt I 0; -½ΔR[a]×dt² I·dt I]，B = [Jr·dt; 0; 0]，C = [0; ΔR·dt; ½ΔR·dt²]
+        // A 大部分是单位块，按块左乘、右乘，避免两次完整的 9x9 矩阵乘法
+        const Eigen::Matrix3d f10 = -r_skew_a * dt;
+        const Eigen::Matrix3d f20 = 0.5 * dt * f10;
+        Matrix9d rows = covariance_;
+        rows.middleRows<3>(6) += f20 * covariance_.topRows<3>() + dt * covariance_.middleRows<3>(3);
+        rows.middleRows<3>(3) += f10 * covariance_.topRows<3>();
+        rows.topRows<3>() = step_t * covariance_.topRows<3>();
+        covariance_ = rows;
+        covariance_.middleCols<3>(6) += rows.leftCols<3>() * f20.transpose() + dt * rows.middleCols<3>(3);
+        covariance_.middleCols<3>(3) += rows.leftCols<3>() * f10.transpose();
+        covariance_.leftCols<3>() = rows.leftCols<3>() * step_t.transpose();
+        // ΔR ΔRᵀ = I，所以加速度计噪声只落在对角块上
+        double gyro_var = noise_.gyro_noise_density * noise_.gyro_noise_density / dt;
+        double accel_var = noise_.accel_noise_density * noise_.accel_noise_density / dt;
+        covariance_.block<3, 3>(0, 0) += gyro_var * dt2 * right_jacobian * right_jacobian.transpose();
+        covariance_.block<3, 3>(3, 3).diagonal().array() += accel_var * dt2;
+        covariance_.block<3, 3>(3, 6).diagonal().array() += 0.5 * accel_var * dt2 * dt;
+        covariance_.block<3, 3>(6, 3).diagonal().array() += 0.5 * accel_var * dt2 * dt;
+        covariance_.block<3, 3>(6, 6).diagonal().array() += 0.25 * accel_var * dt2 * dt2;
+
+        // 零偏雅可比：p、v 使用更新前的 ΔR 与 ∂ΔR/∂bg
+        dp_dba_ += dv_dba_ * dt - 0.5 * r * dt2;
+        dp_dbg_ += dv_dbg_ * dt - 0.5 * r_skew_a * dr_dbg_ * dt2;
+        dv_dba_ -= r * dt;
+        dv_dbg_ -= r_skew_a * dr_dbg_ * dt;
+        dr_dbg_ = step_t * dr_dbg_ - right_jacobian * dt;
+
+        // 预积分量本身
+        Vector3 rotated = delta_rotation_.rotate(lie::fromEigen(a));
+        delta_position_ = delta_position_ + delta_velocity_ * dt + rotated * (0.5 * dt2);
+        delta_velocity_ = delta_velocity_ + rotated * dt;
+        delta_rotation_ = delta_rotation_ * step;
+        delta_rotation_.normalize();
+        delta_time_ += dt;
+    }
+
+    /**
+     * @brief 积分 [t0, t1] 内的采样：每个采样保持到下一个采样的时间戳，两端按区间截断
+     * @param samples 按时间排序的采样，第一个采样的时间不晚于 t0
+     * @throw std::invalid_argument 如果区间为空或采样没有覆盖 t0
+     */
+    void integrate(const std::vector<ImuSample>& samples, double t0, double t1)
+    {
+        if (!(t1 > t0)) {
+            throw std::invalid_argument("Preintegration interval must have positive length");
+        }
+        auto first = std::upper_bound(samples.begin(), samples.end(), t0,
+            [](double t, const ImuSample& s) { return t < s.time; });
+        if (first == samples.begin()) {
+            throw std::invalid_argument("IMU samples do not cover the start of the interval");
+        }
+        for (auto it = first - 1; it != samples.end() && it->time < t1; ++it) {
+            double start = std::max(it->time, t0);
+            double end = std::next(it) == samples.end() ? t1 : std::min(std::next(it)->time, t1);
+            if (end > start) {
+                integrate(it->gyro, it->accel, end - start);
+            }
+        }
+    }
+
+    const ImuBias& bias() const { return bias_; }
+    double deltaTime() const { return delta_time_; }
+    const Quaternion& deltaRotation() const { return delta_rotation_; }
+    const Vector3& deltaVelocity() const { return delta_velocity_; }
+    const Vector3& deltaPosition() const { return delta_position_; }
+    const Matrix9d& covariance() const { return covariance_; }
+
+    const Eigen::Matrix3d& dRotationDGyroBias() const { return dr_dbg_; }
+    const Eigen::Matrix3d& dVelocityDGyroBias() const { return dv_dbg_; }
+    const Eigen::Matrix3d& dVelocityDAccelBias() const { return dv_dba_; }
+    const Eigen::Matrix3d& dPositionDGyroBias() const { return dp_dbg_; }
+    const Eigen::Matrix3d& dPositionDAccelBias() const { return dp_dba_; }
+
+    // --- 一阶零偏修正：不重新积分 ---
+
+    Quaternion deltaRotation(const ImuBias& bias) const
+    {
+        Eigen::Vector3d dbg = lie::toEigen(bias.gyro - bias_.gyro);
+        Quaternion q = delta_rotation_ * lie::exp(lie::fromEigen(dr_dbg_ * dbg));
+        q.normalize();
+        return q;
+    }
+
+    Vector3 deltaVelocity(const ImuBias& bias) const
+    {
+        Eigen::Vector3d dbg = lie::toEigen(bias.gyro - bias_.gyro);
+        Eigen::Vector3d dba = lie::toEigen(bias.accel - bias_.accel);
+        return delta_velocity_ + lie::fromEigen(dv_dbg_ * dbg + dv_dba_ * dba);
+    }
+
+    Vector3 deltaPosition(const ImuBias& bias) const
+    {
+        Eigen::Vector3d dbg = lie::toEigen(bias.gyro - bias_.gyro);
+        Eigen::Vector3d dba = lie::toEigen(bias.accel - bias_.accel);
+        return delta_position_ + lie::fromEigen(dp_dbg_ * dbg + dp_dba_ * dba);
+    }
+
+    /**
+     * @brief 由起点状态预测终点状态
+     * @param gravity 世界系重力加速度，例如 (0, 0, -9.81)
+     */
+    NavState predict(const NavState& start, const ImuBias& bias, const Vector3& gravity) const
+    {
+        const Quaternion& r = start.pose.orientation;
+        const double dt = delta_time_;
+        NavState end;
+        end.pose.orientation = r * deltaRotation(bias);
+        end.pose.orientation.normalize();
+        end.velocity = start.velocity + gravity * dt + r.rotate(deltaVelocity(bias));
+        end.pose.position = start.pose.position + start.velocity * dt + gravity * (0.5 * dt * dt)
+            + r.rotate(deltaPosition(bias));
+        return end;
+    }
+
+    /**
+     * @brief 预积分残差 [r_ΔR, r_Δv, r_Δp]，用于优化中的 IMU 因子
+     */
+    Vector9d residual(const NavState& start, const NavState& end, const ImuBias& bias, const Vector3& gravity) const
+    {
+        const Quaternion r_inverse = start.pose.orientation.conjugate();
+        const double dt = delta_time_;
+        Vector3 rotation_error = lie::log(deltaRotation(bias).conjugate() * r_inverse * end.pose.orientation);
+        Vector3 velocity_error = r_inverse.rotate(end.velocity - start.velocity - gravity * dt) - deltaVelocity(bias);
+        Vector3 position_error
+            = r_inverse.rotate(end.pose.position - start.pose.position - start.velocity * dt
+                  - gravity * (0.5 * dt * dt))
+            - deltaPosition(bias);
+        Vector9d result;
+        result << lie::toEigen(rotation_error), lie::toEigen(velocity_error), lie::toEigen(position_error);
+        return result;
+    }
+
+private:
+    ImuBias bias_;
+    ImuNoise noise_;
+    double delta_time_ { 0.0 };
+    Quaternion delta_rotation_;
+    Vector3 delta_velocity_;
+    Vector3 delta_position_;
+    Matrix9d covariance_ { Matrix9d::Zero() };
+    Eigen::Matrix3d dr_dbg_ { Eigen::Matrix3d::Zero() };
+    Eigen::Matrix3d dv_dbg_ { Eigen::Matrix3d::Zero() };
+    Eigen::Matrix3d dv_dba_ { Eigen::Matrix3d::Zero() };
+    Eigen::Matrix3d dp_dbg_ { Eigen::Matrix3d::Zero() };
+    Eigen::Matrix3d dp_dba_ { Eigen::Matrix3d::Zero() };
+};
+
+/**
+ * @brief 批量预积分相邻关键帧之间的所有区间
+ *
+ * 各区间互不依赖，在线程池上并行；每个区间的结果与单独调用 integrate 逐位相同。
+ * @param keyframe_times 严格递增的关键帧时间，返回 keyframe_times.size() - 1 个区间
+ * @param biases 每个区间的线性化零偏；只有一个元素时所有区间共用
+ * @throw std::invalid_argument 如果零偏个数不匹配或某个区间无法积分
+ */
+inline std::vector<PreintegratedImu> preintegrateKeyframes(const std::vector<ImuSample>& samples,
+    const std::vector<double>& keyframe_times, const std::vector<ImuBias>& biases, const ImuNoise& noise,
+    ThreadPool& pool)
+{
+    std::size_t intervals = keyframe_times.size() < 2 ? 0 : keyframe_times.size() - 1;
+    if (biases.size() != 1 && biases.size() != intervals) {
+        throw std::invalid_argument("Expected one bias or one bias per keyframe interval");
+    }
+    std::vector<PreintegratedImu> result(intervals);
+    pool.parallelFor(0, intervals, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t k = lo; k < hi; ++k) {
+            PreintegratedImu preintegrated(biases.size() == 1 ? biases[0] : biases[k], noise);
+            preintegrated.integrate(samples, keyframe_times[k], keyframe_times[k + 1]);
+            result[k] = preintegrated;
+        }
+    }, 1);
+    return result;
+}
+
+} // namespace robotics::imu
@@ -0,0 +1,164 @@
+#pragma once
+/**
+ * @file interpolation.hpp
+ * @brief 位姿时间插值的库版本（与 a2 modern 的数学完全相同）以及批量插值。
+ *
+ * a2/a3 中的函数定义在带 main() 的实验文件里，其他模块无法复用；
+ * 这里提供可被任何实验包含的实现，并增加面向大批量查询的接口。
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "pose.hpp"
+
+namespace robotics {
+
+/**
+ * @brief 四元数球面线性插值（最短路径，接近时退化为归一化线性插值）
+ * @param q1 起始四元数
+ * @param q2 结束四元数
+ * @param t 插值因子 (0.0-1.0)
+ */
+inline Quaternion slerp(const Quaternion& q1, Quaternion q2, double t)
+{
+    double dot = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+    if (dot < 0.0) {
+        q2 = { -q2.w, -q2.x, -q2.y, -q2.z };
+        dot = -dot;
+    }
+    if (dot > 0.9995) {
+        Quaternion result {
+            q1.w * (1.0 - t) + q2.w * t,
+            q1.x * (1.0 - t) + q2.x * t,
+            q1.y * (1.0 - t) + q2.y * t,
+            q1.z * (1.0 - t) + q2.z * t
+        };
+        result.normalize();
+        return result;
+    }
+    double angle = std::acos(dot);
+    double sin_angle = std::sin(angle);
+    double factor1 = std::sin((1.0 - t) * angle) / sin_angle;
+    double factor2 = std::sin(t * angle) / sin_angle;
+    return {
+        q1.w * factor1 + q2.w * factor2,
+        q1.x * factor1 + q2.x * factor2,
+        q1.y * factor1 + q2.y * factor2,
+        q1.z * factor1 + q2.z * factor2
+    };
+}
+
+/**
+ * @brief 位姿插值：位置线性插值，姿态 SLERP（与 a2 interpolatePoseModern 相同）
+ * @param t 插值因子，会被截断到 [0, 1]
+ */
+inline Pose interpolatePose(const Pose& pose1, const Pose& pose2, double t)
+{
+    t = std::clamp(t, 0.0, 1.0);
+    Vector3 position = pose1.position * (1.0 - t) + pose2.position * t;
+    return { position, slerp(pose1.orientation, pose2.orientation, t) };
+}
+
+/**
+ * @brief 二分查找 target_time 所在区间的左端点索引 i，使 poses[i].t <= target < poses[i+1].t
+ *
+ * target_time 等于最后一个时间戳时返回 size() - 1。Timed 为任何带 time_stamp 成员的类型（TimedPose 等）。
+ * @throw std::invalid_argument 如果序列为空
+ * @throw std::out_of_range 如果目标时间超出范围
+ */
+template <typename Timed>
+std::size_t findSegmentIndex(const std::vector<Timed>& poses, double target_time)
+{
+    if (poses.empty()) {
+        throw std::invalid_argument("Pose sequence is empty");
+    }
+    if (target_time < poses.front().time_stamp || target_time > poses.back().time_stamp) {
+        throw std::out_of_range("Target time is outside the range of pose timestamps");
+    }
+    auto comp = [](double time, const Timed& pose) { return time < pose.time_stamp; };
+    auto it = std::upper_bound(poses.begin(), poses.end(), target_time, comp);
+    return static_cast<std::size_t>(std::distance(poses.begin(), it)) - 1;
+}
+
+/**
+ * @brief 在区间 [i, i+1] 上插值（i 为 findSegmentIndex 的结果）
+ */
+inline TimedPose interpolateInSegment(const std::vector<TimedPose>& poses, std::size_t i, double target_time)
+{
+    if (i + 1 >= poses.size() || poses[i].time_stamp == target_time) {
+        return { target_time, poses[i].pose };
+    }
+    const TimedPose& p1 = poses[i];
+    const TimedPose& p2 = poses[i + 1];
+    double t = (target_time - p1.time_stamp) / (p2.time_stamp - p1.time_stamp);
+    return { target_time, interpolatePose(p1.pose, p2.pose, t) };
+}
+
+/**
+ * @brief 根据时间插值位姿（与 a2 interpolateTimedPoseModern 结果一致）
+ */
+inline TimedPose interpolateTimedPose(const std::vector<TimedPose>& poses, double target_time)
+{
+    return interpolateInSegment(poses, findSegmentIndex(poses, target_time), target_time);
+}
+
+/**
+ * @brief 串行批量插值
+ *
+ * 若查询时间单调不减（传感器时间戳通常如此），只在第一个查询做二分查找，
+ * 之后沿轨迹向前游走，总代价 O(n + m)；否则每个查询独立二分查找。
+ *
+ * @param poses 按时间戳排序的位姿序列
+ * @param times 查询时间，长度为 m
+ * @param out 输出，长度至少为 m
+ * @throw std::out_of_range 如果任一查询时间超出范围
+ */
+inline void interpolateTimedPoses(const std::vector<TimedPose>& poses, const double* times, std::size_t count,
+    TimedPose* out)
+{
+    if (count == 0) {
+        return;
+    }
+    std::size_t segment = findSegmentIndex(poses, times[0]);
+    out[0] = interpolateInSegment(poses, segment, times[0]);
+    for (std::size_t k = 1; k < count; ++k) {
+        double target = times[k];
+        if (target < times[k - 1] || target > poses.back().time_stamp) {
+            segment = findSegmentIndex(poses, target); // 乱序或越界：退回二分查找（越界时抛出）
+        } else {
+            while (segment + 1 < poses.size() && poses[segment + 1].time_stamp <= target) {
+                ++segment;
+            }
+        }
+        out[k] = interpolateInSegment(poses, segment, target);
+    }
+}
+
+/**
+ * @brief 批量插值的 std::vector 便捷接口
+ */
+inline std::vector<TimedPose> interpolateTimedPoses(const std::vector<TimedPose>& poses,
+    const std::vector<double>& times)
+{
+    std::vector<TimedPose> out(times.size());
+    interpolateTimedPoses(poses, times.data(), times.size(), out.data());
+    return out;
+}
+
+/**
+ * @brief 并行批量插值：查询被切块分给线程池，每块内部沿用串行的游走策略
+ */
+inline void interpolateTimedPoses(const std::vector<TimedPose>& poses, const double* times, std::size_t count,
+    TimedPose* out, ThreadPool& pool)
+{
+    pool.parallelFor(0, count, [&](std::size_t lo, std::size_t hi) {
+        interpolateTimedPoses(poses, times + lo, hi - lo, out + lo);
+    });
+}
+
+} // namespace robotics
@@ -0,0 +1,270 @@
+#pragma once
+/**
+ * @file interpolation_cache.hpp
+ * @brief 插值结果缓存：按量化后的时间戳缓存位姿，读取无锁，按时间范围失效。
+ *
+ * 相机、LiDAR、雷达的投影常在几乎相同的时刻各自请求一次位姿，每次都重复一遍二分查找和 SLERP。
+ * 把查询时间量化到 resolution 的整数倍后，这些请求落在同一个键上，只需插值一次。
+ *
+ * - 容量固定（2 的幂）、直接映射：键的哈希决定唯一的槽位，冲突时新结果覆盖旧结果；
+ * - 每个槽位是一个 seqlock：读者只做几次原子读取，检查序号前后一致，不加锁也不写共享内存；
+ *   写者用 CAS 抢占槽位，抢不到就放弃插入（缓存只是加速，丢一次插入无妨）；
+ * - 失效不扫描槽位：时间轴按 invalidation_granularity 分桶，每个桶（哈希到固定大小的表）记录一个版本号。
+ *   条目带着计算它时的轨迹版本，版本低于所在桶的版本即视为失效。这样即使读者在写者失效之后
+ *   才插入由旧快照算出的结果，也不会被后来的查询读到。
+ *
+ * 返回的位姿对应量化后的时间（time_stamp 为 key * resolution），与精确时间的差异不超过速度 × resolution / 2。
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "pose.hpp"
+#include "trajectory_store.hpp"
+
+namespace robotics {
+
+struct InterpolationCacheOptions {
+    double resolution { 1e-4 }; // 量化步长（秒）
+    std::size_t capacity { 1 << 14 }; // 槽位数，向上取整到 2 的幂
+    double invalidation_granularity { 0.5 }; // 失效的时间粒度（秒）
+    std::size_t invalidation_buckets { 1 << 12 }; // 失效桶表的大小，向上取整到 2 的幂
+};
+
+class InterpolationCache {
+public:
+    using Options = InterpolationCacheOptions;
+
+    /**
+     * @throw std::invalid_argument 如果 resolution 或 invalidation_granularity 不为正，或容量为 0
+     */
+    explicit InterpolationCache(const Options& options = {})
+        : options_(options)
+    {
+        if (!(options.resolution > 0.0) || !(options.invalidation_granularity > 0.0) || options.capacity == 0
+            || options.invalidation_buckets == 0) {
+            throw std::invalid_argument("Cache resolution, granularity and sizes must be positive");
+        }
+        slot_mask_ = std::bit_ceil(options.capacity) - 1;
+        bucket_mask_ = std::bit_ceil(options.invalidation_buckets) - 1;
+        slots_ = std::make_unique<Slot[]>(slot_mask_ + 1);
+        buckets_ = std::make_unique<std::atomic<std::uint64_t>[]>(bucket_mask_ + 1);
+    }
+
+    const Options& options() const { return options_; }
+    std::size_t capacity() const { return slot_mask_ + 1; }
+
+    std::int64_t quantize(double time) const { return std::llround(time / options_.resolution); }
+    double keyTime(std::int64_t key) const { return static_cast<double>(key) * options_.resolution; }
+
+    /**
+     * @brief 查找键对应的有效结果；槽位被其他键占用、正在被写或已失效时返回空
+     */
+    std::optional<Pose> find(std::int64_t key) const
+    {
+        const Slot& slot = slots_[slotIndex(key)];
+        std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0 || slot.key.load(std::memory_order_relaxed) != key) {
+            return std::nullopt;
+        }
+        std::uint64_t version = slot.version.load(std::memory_order_relaxed);
+        double v[7];
+        for (int k = 0; k < 7; ++k) {
+            v[k] = slot.values[k].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            return std::nullopt;
+        }
+        if (version < buckets_[bucketIndex(keyTime(key))].load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        return Pose { Vector3 { v[0], v[1], v[2] }, Quaternion { v[3], v[4], v[5], v[6] } };
+    }
+
+    /**
+     * @brief 插入由版本 version 的轨迹算出的结果；槽位正被另一个线程写入时放弃
+     */
+    void insert(std::int64_t key, const Pose& pose, std::uint64_t version)
+    {
+        Slot& slot = slots_[slotIndex(key)];
+        std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) != 0
+            || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire,
+                std::memory_order_relaxed)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        const double v[7] = { pose.position.x, pose.position.y, pose.position.z, pose.orientation.w,
+            pose.orientation.x, pose.orientation.y, pose.orientation.z };
+        slot.key.store(key, std::memory_order_relaxed);
+        slot.version.store(version, std::memory_order_relaxed);
+        for (int k = 0; k < 7; ++k) {
+            slot.values[k].store(v[k], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 使时间范围 [begin, end] 内、由低于 version 的轨迹算出的结果失效
+     *
+     * 应在新版本发布之后调用。范围跨越的桶数超过桶表大小时，整个缓存失效。
+     */
+    void invalidate(double begin, double end, std::uint64_t version)
+    {
+        double first = std::floor((begin - options_.resolution) / options_.invalidation_granularity);
+        double last = std::floor((end + options_.resolution) / options_.invalidation_granularity);
+        if (!(last - first < static_cast<double>(bucket_mask_))) {
+            for (std::size_t b = 0; b <= bucket_mask_; ++b) {
+                raise(buckets_[b], version);
+            }
+            return;
+        }
+        for (auto b = static_cast<std::int64_t>(first); b <= static_cast<std::int64_t>(last); ++b) {
+            raise(buckets_[hashIndex(static_cast<std::uint64_t>(b), bucket_mask_)], version);
+        }
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> sequence { 0 }; // 奇数表示正在写
+        std::atomic<std::int64_t> key { std::numeric_limits<std::int64_t>::min() };
+        std::atomic<std::uint64_t> version { 0 };
+        std::array<std::atomic<double>, 7> values {}; // position xyz + orientation wxyz
+    };
+
+    static std::size_t hashIndex(std::uint64_t value, std::size_t mask)
+    {
+        return static_cast<std::size_t>((value * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    std::size_t slotIndex(std::int64_t key) const { return hashIndex(static_cast<std::uint64_t>(key), slot_mask_); }
+
+    std::size_t bucketIndex(double time) const
+    {
+        auto b = static_cast<std::int64_t>(std::floor(time / options_.invalidation_granularity));
+        return hashIndex(static_cast<std::uint64_t>(b), bucket_mask_);
+    }
+
+    static void raise(std::atomic<std::uint64_t>& bucket, std::uint64_t version)
+    {
+        std::uint64_t current = bucket.load(std::memory_order_relaxed);
+        while (current < version
+            && !bucket.compare_exchange_weak(current, version, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    Options options_;
+    std::size_t slot_mask_ { 0 };
+    std::size_t bucket_mask_ { 0 };
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> buckets_;
+};
+
+/**
+ * @brief 带缓存的 TrajectoryStore：查询先查缓存，未命中时在当前快照上插值并写回；提交时自动失效受影响的范围
+ *
+ * 命中时不取快照（libstdc++ 的 atomic<shared_ptr> 内部带一个小锁），只读缓存槽位和记录的时间范围。
+ * 受影响的范围由事务中被复制的块推出：块内位姿的时间范围，向两侧各扩展到相邻的位姿（区间跨块时同样受影响）。
+ * 追加会复制最后一块或新建块，因此也被覆盖。对存储的写入必须经过 commit()，否则缓存不会失效。
+ */
+class CachedTrajectory {
+public:
+    explicit CachedTrajectory(TrajectoryStore& store, const InterpolationCacheOptions& options = {})
+        : store_(store)
+        , cache_(options)
+    {
+        updateRange(store_.snapshot());
+    }
+
+    InterpolationCache& cache() { return cache_; }
+
+    /**
+     * @brief 量化时间上的位姿，time_stamp 为量化后的时间
+     *
+     * 量化后的时间落在轨迹范围之外（原时间在范围内，距端点不到 resolution / 2）时，直接在原时间上插值，不缓存。
+     * @param hit 可选，返回是否命中缓存
+     * @throw std::invalid_argument 如果轨迹为空
+     * @throw std::out_of_range 如果时间超出范围
+     */
+    TimedPose interpolate(double time, bool* hit = nullptr)
+    {
+        double first = first_time_.load(std::memory_order_acquire);
+        double last = last_time_.load(std::memory_order_acquire);
+        std::int64_t key = cache_.quantize(time);
+        double quantized = cache_.keyTime(key);
+        if (!(quantized >= first && quantized <= last)) {
+            if (hit) {
+                *hit = false;
+            }
+            return store_.snapshot().interpolate(time); // 轨迹为空或越界时由快照抛出
+        }
+        std::optional<Pose> cached = cache_.find(key);
+        if (hit) {
+            *hit = cached.has_value();
+        }
+        if (cached) {
+            return { quantized, *cached };
+        }
+        TrajectoryStore::Snapshot snapshot = store_.snapshot();
+        TimedPose result = snapshot.interpolate(quantized);
+        cache_.insert(key, result.pose, snapshot.version());
+        return result;
+    }
+
+    /**
+     * @brief 提交事务并使受影响的时间范围失效
+     * @return 新版本号
+     */
+    std::uint64_t commit(TrajectoryStore::Transaction& transaction)
+    {
+        std::vector<std::pair<double, double>> ranges;
+        std::size_t size = transaction.size(), chunk_size = transaction.chunkSize();
+        for (std::size_t c = 0; c < transaction.chunkCount(); ++c) {
+            if (!transaction.isModified(c)) {
+                continue;
+            }
+            std::size_t first = c * chunk_size, last = std::min(first + chunk_size, size) - 1;
+            double begin = transaction[first > 0 ? first - 1 : first].time_stamp;
+            double end = transaction[last + 1 < size ? last + 1 : last].time_stamp;
+            if (!ranges.empty() && begin <= ranges.back().second) {
+                ranges.back().second = end;
+            } else {
+                ranges.emplace_back(begin, end);
+            }
+        }
+        std::uint64_t version = transaction.commit();
+        for (const auto& [begin, end] : ranges) {
+            cache_.invalidate(begin, end, version);
+        }
+        updateRange(store_.snapshot());
+        return version;
+    }
+
+private:
+    void updateRange(const TrajectoryStore::Snapshot& snapshot)
+    {
+        bool empty = snapshot.empty();
+        first_time_.store(empty ? std::numeric_limits<double>::infinity() : snapshot[0].time_stamp,
+            std::memory_order_release);
+        last_time_.store(empty ? -std::numeric_limits<double>::infinity() : snapshot[snapshot.size() - 1].time_stamp,
+            std::memory_order_release);
+    }
+
+    TrajectoryStore& store_;
+    InterpolationCache cache_;
+    std::atomic<double> first_time_ { 0.0 };
+    std::atomic<double> last_time_ { 0.0 };
+};
+
+} // namespace robotics
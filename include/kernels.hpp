@@ -0,0 +1,575 @@
+#pragma once
+/**
+ * @file kernels.hpp
+ * @brief 经 dispatch.hpp 分派的数值内核：N 维欧氏距离、批量点变换、四元数数组的归一化、按区间插值的位姿修正。
+ *
+ * 每个内核提供标量实现和 SIMD 实现（GCC/Clang 的 target 属性，不需要全局 -mavx2），
+ * 运行时按 CPU 选择。标量实现是参考版本，a8 差分测试会把其余实现逐个与它比较。
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "interpolation.hpp"
+#include "pose.hpp"
+
+#ifdef PRESLAM_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace robotics::kernels {
+
+namespace detail {
+
+    // --- 欧氏距离 ---
+
+    inline double distanceScalar(const double* a, const double* b, std::size_t n)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double diff = a[i] - b[i];
+            sum += diff * diff;
+        }
+        return std::sqrt(sum);
+    }
+
+#ifdef PRESLAM_X86_DISPATCH
+    __attribute__((target("avx2,fma"))) inline double distanceAvx2(const double* a, const double* b, std::size_t n)
+    {
+        // 两个累加器隐藏 FMA 的延迟
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+            __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+            acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+            acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+        }
+        if (i + 4 <= n) {
+            __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+            acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+            i += 4;
+        }
+        __m256d acc = _mm256_add_pd(acc0, acc1);
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        for (; i < n; ++i) {
+            double diff = a[i] - b[i];
+            sum += diff * diff;
+        }
+        return std::sqrt(sum);
+    }
+
+    __attribute__((target("avx512f"))) inline double distanceAvx512(const double* a, const double* b, std::size_t n)
+    {
+        __m512d acc0 = _mm512_setzero_pd();
+        __m512d acc1 = _mm512_setzero_pd();
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+            __m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8));
+            acc0 = _mm512_fmadd_pd(d0, d0, acc0);
+            acc1 = _mm512_fmadd_pd(d1, d1, acc1);
+        }
+        for (; i < n; i += 8) {
+            // 尾部用掩码加载，越界的通道读为 0
+            __mmask8 mask = n - i >= 8 ? 0xff : static_cast<__mmask8>((1u << (n - i)) - 1);
+            __m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+            acc0 = _mm512_fmadd_pd(d, d, acc0);
+        }
+        return std::sqrt(_mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)));
+    }
+#endif
+
+    // --- 点变换 p' = R p + t ---
+
+    inline void transformPointsScalar(const Pose& pose, const Vector3* in, Vector3* out, std::size_t n)
+    {
+        const RotationMatrix rotation(pose.orientation);
+        const std::array<double, 9>& r = rotation.m;
+        const Vector3& t = pose.position;
+        for (std::size_t i = 0; i < n; ++i) {
+            Vector3 p = in[i]; // 允许 in == out
+            out[i] = {
+                r[0] * p.x + r[1] * p.y + r[2] * p.z + t.x,
+                r[3] * p.x + r[4] * p.y + r[5] * p.z + t.y,
+                r[6] * p.x + r[7] * p.y + r[8] * p.z + t.z
+            };
+        }
+    }
+
+#ifdef PRESLAM_X86_DISPATCH
+    static_assert(sizeof(Vector3) == 3 * sizeof(double), "AoS point shuffles assume packed Vector3");
+
+    /**
+     * @brief 读入 4 个 AoS 点并转成 SoA 的 X/Y/Z
+     *
+     * 4 个 AoS 点正好是 3 个 ymm：[x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3]，用 128 位通道重排 + shuffle 拆开。
+     */
+    __attribute__((target("avx2"))) inline void loadPoints4(const Vector3* in, __m256d& x, __m256d& y, __m256d& z)
+    {
+        const double* src = &in->x;
+        __m256d a = _mm256_loadu_pd(src);
+        __m256d b = _mm256_loadu_pd(src + 4);
+        __m256d c = _mm256_loadu_pd(src + 8);
+
+        __m256d p = _mm256_permute2f128_pd(a, b, 0x30); // x0 y0 x2 y2
+        __m256d q = _mm256_permute2f128_pd(a, c, 0x21); // z0 x1 z2 x3
+        __m256d s = _mm256_permute2f128_pd(b, c, 0x30); // y1 z1 y3 z3
+        x = _mm256_shuffle_pd(p, q, 0b1010);
+        y = _mm256_shuffle_pd(p, s, 0b0101);
+        z = _mm256_shuffle_pd(q, s, 0b1010);
+    }
+
+    /**
+     * @brief loadPoints4 的逆：按相反的顺序把 SoA 的 X/Y/Z 写回 4 个 AoS 点
+     */
+    __attribute__((target("avx2"))) inline void storePoints4(Vector3* out, __m256d x, __m256d y, __m256d z)
+    {
+        __m256d p = _mm256_shuffle_pd(x, y, 0b0000); // x0 y0 x2 y2
+        __m256d q = _mm256_shuffle_pd(z, x, 0b1010); // z0 x1 z2 x3
+        __m256d s = _mm256_shuffle_pd(y, z, 0b1111); // y1 z1 y3 z3
+        double* dst = &out->x;
+        _mm256_storeu_pd(dst, _mm256_permute2f128_pd(p, q, 0x20));
+        _mm256_storeu_pd(dst + 4, _mm256_permute2f128_pd(s, p, 0x30));
+        _mm256_storeu_pd(dst + 8, _mm256_permute2f128_pd(q, s, 0x31));
+    }
+
+    /**
+     * @brief AVX2 点变换：每次处理 4 个点，转成 SoA 后做 9 次 FMA
+     */
+    __attribute__((target("avx2,fma"))) inline void transformPointsAvx2(const Pose& pose, const Vector3* in,
+        Vector3* out, std::size_t n)
+    {
+        const RotationMatrix rotation(pose.orientation);
+        const std::array<double, 9>& r = rotation.m;
+        const Vector3& t = pose.position;
+        __m256d r00 = _mm256_set1_pd(r[0]), r01 = _mm256_set1_pd(r[1]), r02 = _mm256_set1_pd(r[2]);
+        __m256d r10 = _mm256_set1_pd(r[3]), r11 = _mm256_set1_pd(r[4]), r12 = _mm256_set1_pd(r[5]);
+        __m256d r20 = _mm256_set1_pd(r[6]), r21 = _mm256_set1_pd(r[7]), r22 = _mm256_set1_pd(r[8]);
+        __m256d tx = _mm256_set1_pd(t.x), ty = _mm256_set1_pd(t.y), tz = _mm256_set1_pd(t.z);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d x, y, z;
+            loadPoints4(in + i, x, y, z);
+
+            __m256d ox = _mm256_fmadd_pd(r00, x, _mm256_fmadd_pd(r01, y, _mm256_fmadd_pd(r02, z, tx)));
+            __m256d oy = _mm256_fmadd_pd(r10, x, _mm256_fmadd_pd(r11, y, _mm256_fmadd_pd(r12, z, ty)));
+            __m256d oz = _mm256_fmadd_pd(r20, x, _mm256_fmadd_pd(r21, y, _mm256_fmadd_pd(r22, z, tz)));
+            storePoints4(out + i, ox, oy, oz);
+        }
+        if (i < n) {
+            transformPointsScalar(pose, in + i, out + i, n - i);
+        }
+    }
+#endif
+
+    // --- 四元数归一化 ---
+
+    inline void normalizeQuaternionsScalar(Quaternion* q, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            q[i].normalize();
+        }
+    }
+
+    inline void renormalizeQuaternionsScalar(Quaternion* q, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            q[i].renormalize();
+        }
+    }
+
+#ifdef PRESLAM_X86_DISPATCH
+    static_assert(sizeof(Quaternion) == 4 * sizeof(double), "normalizeQuaternionsAvx2 assumes packed Quaternion");
+
+    /**
+     * @brief 4x4 double 转置（自逆）：行 [a b c d] 变为列
+     */
+    __attribute__((target("avx2,fma"))) inline void transpose4(__m256d& r0, __m256d& r1, __m256d& r2, __m256d& r3)
+    {
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+        r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+        r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+        r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+
+    /**
+     * @brief 4 个 SoA 四元数归一化，与 Quaternion::normalize 相同：模长不超过 1e-10 的通道变成单位四元数（无分支）
+     *
+     * 没有用 float 的 rsqrt 近似加牛顿迭代：达到 double 精度要迭代三次，依赖链比 sqrt + div 长，实测反而更慢。
+     */
+    __attribute__((target("avx2,fma"))) inline void normalizeAvx2(__m256d& w, __m256d& x, __m256d& y, __m256d& z)
+    {
+        __m256d norm2 = _mm256_fmadd_pd(w, w, _mm256_fmadd_pd(x, x, _mm256_fmadd_pd(y, y, _mm256_mul_pd(z, z))));
+        __m256d valid = _mm256_cmp_pd(norm2, _mm256_set1_pd(1e-20), _CMP_GT_OQ);
+        __m256d inv = _mm256_and_pd(valid, _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(norm2)));
+        w = _mm256_blendv_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(w, inv), valid);
+        x = _mm256_mul_pd(x, inv);
+        y = _mm256_mul_pd(y, inv);
+        z = _mm256_mul_pd(z, inv);
+    }
+
+    /**
+     * @brief 4 个 SoA 四元数的一阶重新归一化，与 Quaternion::renormalize 相同
+     */
+    __attribute__((target("avx2,fma"))) inline void renormalizeAvx2(__m256d& w, __m256d& x, __m256d& y, __m256d& z)
+    {
+        __m256d norm2 = _mm256_fmadd_pd(w, w, _mm256_fmadd_pd(x, x, _mm256_fmadd_pd(y, y, _mm256_mul_pd(z, z))));
+        __m256d scale = _mm256_fnmadd_pd(_mm256_set1_pd(0.5), norm2, _mm256_set1_pd(1.5));
+        w = _mm256_mul_pd(w, scale);
+        x = _mm256_mul_pd(x, scale);
+        y = _mm256_mul_pd(y, scale);
+        z = _mm256_mul_pd(z, scale);
+    }
+
+    /**
+     * @brief AoS 四元数数组的归一化：4 个四元数正好是 4 个 ymm，转置成 SoA 处理后再转置写回
+     */
+    template <bool FirstOrder>
+    __attribute__((target("avx2,fma"))) inline void scaleQuaternionsAvx2(Quaternion* q, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            double* base = &q[i].w;
+            __m256d w = _mm256_loadu_pd(base), x = _mm256_loadu_pd(base + 4), y = _mm256_loadu_pd(base + 8),
+                    z = _mm256_loadu_pd(base + 12);
+            transpose4(w, x, y, z);
+            if constexpr (FirstOrder) {
+                renormalizeAvx2(w, x, y, z);
+            } else {
+                normalizeAvx2(w, x, y, z);
+            }
+            transpose4(w, x, y, z);
+            _mm256_storeu_pd(base, w);
+            _mm256_storeu_pd(base + 4, x);
+            _mm256_storeu_pd(base + 8, y);
+            _mm256_storeu_pd(base + 12, z);
+        }
+        if (i < n) {
+            if constexpr (FirstOrder) {
+                renormalizeQuaternionsScalar(q + i, n - i);
+            } else {
+                normalizeQuaternionsScalar(q + i, n - i);
+            }
+        }
+    }
+
+    inline void normalizeQuaternionsAvx2(Quaternion* q, std::size_t n) { scaleQuaternionsAvx2<false>(q, n); }
+
+    inline void renormalizeQuaternionsAvx2(Quaternion* q, std::size_t n) { scaleQuaternionsAvx2<true>(q, n); }
+#endif
+
+} // namespace detail
+
+/**
+ * @brief 一个关键帧区间上的修正，由 makeCorrectionSegment 预先算好逐区间的常量
+ *
+ * 区间内时间为 t 的位姿被左乘 C(t) = interpolatePose(start, end, (t - start_time) / (end_time - start_time))，
+ * 插值因子被截断到 [0, 1]。
+ */
+struct CorrectionSegment {
+    double start_time { 0.0 };
+    double end_time { 1.0 };
+    Pose start;
+    Pose end; // 姿态已翻到与 start 同一半球
+    bool identity { false }; // 两端都是单位变换，整个区间可以跳过
+    bool nlerp { true }; // 与 slerp 相同的阈值：两端姿态很接近时退化为归一化线性插值
+    double angle { 0.0 };
+    double inv_sin_angle { 0.0 };
+};
+
+/**
+ * @param start_time 必须小于 end_time
+ */
+inline CorrectionSegment makeCorrectionSegment(double start_time, const Pose& start, double end_time,
+    const Pose& end)
+{
+    CorrectionSegment segment;
+    segment.start_time = start_time;
+    segment.end_time = end_time;
+    segment.start = start;
+    segment.end = end;
+    const Quaternion& q1 = start.orientation;
+    Quaternion& q2 = segment.end.orientation;
+    double dot = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+    if (dot < 0.0) {
+        q2 = { -q2.w, -q2.x, -q2.y, -q2.z };
+        dot = -dot;
+    }
+    auto is_identity = [](const Pose& p) {
+        return p.position.x == 0.0 && p.position.y == 0.0 && p.position.z == 0.0 && std::fabs(p.orientation.w) == 1.0
+            && p.orientation.x == 0.0 && p.orientation.y == 0.0 && p.orientation.z == 0.0;
+    };
+    segment.identity = is_identity(start) && is_identity(end);
+    segment.nlerp = dot > 0.9995;
+    if (!segment.nlerp) {
+        segment.angle = std::acos(dot);
+        segment.inv_sin_angle = 1.0 / std::sin(segment.angle);
+    }
+    return segment;
+}
+
+namespace detail {
+
+    inline void correctPosesScalar(const CorrectionSegment& segment, TimedPose* poses, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            double s = (poses[i].time_stamp - segment.start_time) / (segment.end_time - segment.start_time);
+            poses[i].pose = interpolatePose(segment.start, segment.end, s) * poses[i].pose;
+            poses[i].pose.orientation.renormalize(); // 反复修正的轨迹不会漂离单位球
+        }
+    }
+
+#ifdef PRESLAM_X86_DISPATCH
+    static_assert(sizeof(TimedPose) == 8 * sizeof(double), "correctPosesAvx2 assumes packed TimedPose");
+
+    /**
+     * @brief x ∈ [0, π/2] 上的 sin，奇次 Taylor 多项式到 x^17，截断误差小于 5e-14
+     */
+    __attribute__((target("avx2,fma"))) inline __m256d sinQuarterTurn(__m256d x)
+    {
+        __m256d x2 = _mm256_mul_pd(x, x);
+        __m256d p = _mm256_set1_pd(1.0 / 355687428096000.0);
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(-1.0 / 1307674368000.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(1.0 / 6227020800.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(-1.0 / 39916800.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(1.0 / 362880.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(-1.0 / 5040.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(1.0 / 120.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(-1.0 / 6.0));
+        p = _mm256_fmadd_pd(p, x2, _mm256_set1_pd(1.0));
+        return _mm256_mul_pd(p, x);
+    }
+
+    /**
+     * @brief AVX2 位姿修正：每次处理 4 个位姿
+     *
+     * 一个 TimedPose 正好是两个 ymm：[t px py pz] [qw qx qy qz]。4 个位姿的 8 个 ymm 经两次 4x4 转置变成 SoA，
+     * 每个通道独立地计算插值因子、插值出修正（SLERP 的两个 sin 用多项式计算）并左乘，再转置写回。
+     * 区间的模式（nlerp / slerp）对所有通道相同，分支在循环外。
+     */
+    __attribute__((target("avx2,fma"))) inline void correctPosesAvx2(const CorrectionSegment& segment,
+        TimedPose* poses, std::size_t n)
+    {
+        const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0), two = _mm256_set1_pd(2.0);
+        const __m256d t0 = _mm256_set1_pd(segment.start_time);
+        const __m256d duration = _mm256_set1_pd(segment.end_time - segment.start_time);
+        const Pose& a = segment.start;
+        const Pose& b = segment.end;
+        const __m256d apx = _mm256_set1_pd(a.position.x), apy = _mm256_set1_pd(a.position.y),
+                      apz = _mm256_set1_pd(a.position.z);
+        const __m256d bpx = _mm256_set1_pd(b.position.x), bpy = _mm256_set1_pd(b.position.y),
+                      bpz = _mm256_set1_pd(b.position.z);
+        const __m256d aqw = _mm256_set1_pd(a.orientation.w), aqx = _mm256_set1_pd(a.orientation.x),
+                      aqy = _mm256_set1_pd(a.orientation.y), aqz = _mm256_set1_pd(a.orientation.z);
+        const __m256d bqw = _mm256_set1_pd(b.orientation.w), bqx = _mm256_set1_pd(b.orientation.x),
+                      bqy = _mm256_set1_pd(b.orientation.y), bqz = _mm256_set1_pd(b.orientation.z);
+        const __m256d angle = _mm256_set1_pd(segment.angle), inv_sin = _mm256_set1_pd(segment.inv_sin_angle);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            double* base = &poses[i].time_stamp;
+            __m256d t = _mm256_loadu_pd(base), px = _mm256_loadu_pd(base + 8), py = _mm256_loadu_pd(base + 16),
+                    pz = _mm256_loadu_pd(base + 24);
+            __m256d qw = _mm256_loadu_pd(base + 4), qx = _mm256_loadu_pd(base + 12), qy = _mm256_loadu_pd(base + 20),
+                    qz = _mm256_loadu_pd(base + 28);
+            transpose4(t, px, py, pz);
+            transpose4(qw, qx, qy, qz);
+
+            __m256d s = _mm256_div_pd(_mm256_sub_pd(t, t0), duration);
+            s = _mm256_max_pd(_mm256_min_pd(s, one), zero);
+            __m256d r = _mm256_sub_pd(one, s);
+
+            // 修正 C(s)：位置线性插值，姿态 nlerp 或 slerp
+            __m256d cx = _mm256_fmadd_pd(bpx, s, _mm256_mul_pd(apx, r));
+            __m256d cy = _mm256_fmadd_pd(bpy, s, _mm256_mul_pd(apy, r));
+            __m256d cz = _mm256_fmadd_pd(bpz, s, _mm256_mul_pd(apz, r));
+            __m256d f1 = r, f2 = s;
+            if (!segment.nlerp) {
+                f1 = _mm256_mul_pd(sinQuarterTurn(_mm256_mul_pd(r, angle)), inv_sin);
+                f2 = _mm256_mul_pd(sinQuarterTurn(_mm256_mul_pd(s, angle)), inv_sin);
+            }
+            __m256d cw = _mm256_fmadd_pd(bqw, f2, _mm256_mul_pd(aqw, f1));
+            __m256d ux = _mm256_fmadd_pd(bqx, f2, _mm256_mul_pd(aqx, f1));
+            __m256d uy = _mm256_fmadd_pd(bqy, f2, _mm256_mul_pd(aqy, f1));
+            __m256d uz = _mm256_fmadd_pd(bqz, f2, _mm256_mul_pd(aqz, f1));
+            if (segment.nlerp) {
+                normalizeAvx2(cw, ux, uy, uz);
+            }
+
+            // 位置：rotate(c, p) + c.p，其中 v' = v + w * (2 u x v) + u x (2 u x v)
+            __m256d ex = _mm256_mul_pd(two, _mm256_fmsub_pd(uy, pz, _mm256_mul_pd(uz, py)));
+            __m256d ey = _mm256_mul_pd(two, _mm256_fmsub_pd(uz, px, _mm256_mul_pd(ux, pz)));
+            __m256d ez = _mm256_mul_pd(two, _mm256_fmsub_pd(ux, py, _mm256_mul_pd(uy, px)));
+            __m256d ox = _mm256_add_pd(_mm256_fmadd_pd(cw, ex, px), _mm256_fmsub_pd(uy, ez, _mm256_mul_pd(uz, ey)));
+            __m256d oy = _mm256_add_pd(_mm256_fmadd_pd(cw, ey, py), _mm256_fmsub_pd(uz, ex, _mm256_mul_pd(ux, ez)));
+            __m256d oz = _mm256_add_pd(_mm256_fmadd_pd(cw, ez, pz), _mm256_fmsub_pd(ux, ey, _mm256_mul_pd(uy, ex)));
+            px = _mm256_add_pd(ox, cx);
+            py = _mm256_add_pd(oy, cy);
+            pz = _mm256_add_pd(oz, cz);
+
+            // 姿态：c * q
+            __m256d nw = _mm256_sub_pd(_mm256_mul_pd(cw, qw),
+                _mm256_fmadd_pd(ux, qx, _mm256_fmadd_pd(uy, qy, _mm256_mul_pd(uz, qz))));
+            __m256d nx = _mm256_fmadd_pd(cw, qx, _mm256_fmadd_pd(ux, qw, _mm256_fmsub_pd(uy, qz, _mm256_mul_pd(uz, qy))));
+            __m256d ny = _mm256_fmadd_pd(cw, qy, _mm256_fmadd_pd(uy, qw, _mm256_fmsub_pd(uz, qx, _mm256_mul_pd(ux, qz))));
+            __m256d nz = _mm256_fmadd_pd(cw, qz, _mm256_fmadd_pd(uz, qw, _mm256_fmsub_pd(ux, qy, _mm256_mul_pd(uy, qx))));
+            renormalizeAvx2(nw, nx, ny, nz);
+
+            transpose4(t, px, py, pz);
+            transpose4(nw, nx, ny, nz);
+            _mm256_storeu_pd(base, t);
+            _mm256_storeu_pd(base + 4, nw);
+            _mm256_storeu_pd(base + 8, px);
+            _mm256_storeu_pd(base + 12, nx);
+            _mm256_storeu_pd(base + 16, py);
+            _mm256_storeu_pd(base + 20, ny);
+            _mm256_storeu_pd(base + 24, pz);
+            _mm256_storeu_pd(base + 28, nz);
+        }
+        if (i < n) {
+            correctPosesScalar(segment, poses + i, n - i);
+        }
+    }
+#endif
+
+} // namespace detail
+
+/**
+ * @brief N 维欧氏距离内核
+ */
+inline const DispatchedKernel<double(const double*, const double*, std::size_t)> distance_kernel {
+    "distance",
+    {
+        { IsaLevel::Scalar, detail::distanceScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::distanceAvx2 },
+        { IsaLevel::AVX512, detail::distanceAvx512 },
+#endif
+    }
+};
+
+/**
+ * @brief 批量刚体变换内核
+ */
+inline const DispatchedKernel<void(const Pose&, const Vector3*, Vector3*, std::size_t)> transform_points_kernel {
+    "transform_points",
+    {
+        { IsaLevel::Scalar, detail::transformPointsScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::transformPointsAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 四元数数组的归一化内核，结果与逐个 Quaternion::normalize 相差几个 ulp
+ */
+inline const DispatchedKernel<void(Quaternion*, std::size_t)> normalize_quaternions_kernel {
+    "normalize_quaternions",
+    {
+        { IsaLevel::Scalar, detail::normalizeQuaternionsScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::normalizeQuaternionsAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 四元数数组的一阶重新归一化内核（Quaternion::renormalize）
+ */
+inline const DispatchedKernel<void(Quaternion*, std::size_t)> renormalize_quaternions_kernel {
+    "renormalize_quaternions",
+    {
+        { IsaLevel::Scalar, detail::renormalizeQuaternionsScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::renormalizeQuaternionsAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 位姿修正内核：对同一区间内的 n 个位姿做 T' = C(t) * T，结果的姿态做一阶重新归一化
+ */
+inline const DispatchedKernel<void(const CorrectionSegment&, TimedPose*, std::size_t)> correct_poses_kernel {
+    "correct_poses",
+    {
+        { IsaLevel::Scalar, detail::correctPosesScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::correctPosesAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 两个 N 维点之间的欧氏距离
+ */
+inline double euclideanDistance(const double* a, const double* b, std::size_t n)
+{
+    return distance_kernel(a, b, n);
+}
+
+/**
+ * @brief 两个 N 维点之间的欧氏距离（与 a1 接口相同）
+ * @throw std::invalid_argument 如果两个点的维度不相同
+ */
+inline double euclideanDistance(const std::vector<double>& p1, const std::vector<double>& p2)
+{
+    if (p1.size() != p2.size()) {
+        throw std::invalid_argument("Points must have the same dimension.");
+    }
+    return distance_kernel(p1.data(), p2.data(), p1.size());
+}
+
+/**
+ * @brief 对 n 个点做刚体变换 out[i] = R(pose) * in[i] + t(pose)，in 与 out 可以相同
+ * @param pose 变换，姿态须为单位四元数
+ */
+inline void transformPoints(const Pose& pose, const Vector3* in, Vector3* out, std::size_t n)
+{
+    transform_points_kernel(pose, in, out, n);
+}
+
+inline std::vector<Vector3> transformPoints(const Pose& pose, const std::vector<Vector3>& points)
+{
+    std::vector<Vector3> out(points.size());
+    transform_points_kernel(pose, points.data(), out.data(), points.size());
+    return out;
+}
+
+/**
+ * @brief 把 n 个四元数归一化（模长不超过 1e-10 的变成单位四元数）
+ */
+inline void normalizeQuaternions(Quaternion* q, std::size_t n)
+{
+    normalize_quaternions_kernel(q, n);
+}
+
+/**
+ * @brief 把 n 个已知接近单位长度的四元数拉回单位球（一阶，|q|² = 1 + δ 时残差约 3δ²/8）
+ */
+inline void renormalizeQuaternions(Quaternion* q, std::size_t n)
+{
+    renormalize_quaternions_kernel(q, n);
+}
+
+/**
+ * @brief 对同一修正区间内的 n 个位姿做 T' = C(t) * T（区间之外的时间取端点的修正）
+ */
+inline void correctPoses(const CorrectionSegment& segment, TimedPose* poses, std::size_t n)
+{
+    correct_poses_kernel(segment, poses, n);
+}
+
+} // namespace robotics::kernels
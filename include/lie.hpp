@@ -0,0 +1,206 @@
+#pragma once
+/**
+ * @file lie.hpp
+ * @brief SO(3) / SE(3) 上的常用运算：指数/对数映射、反对称矩阵、伴随、左右雅可比及其逆。
+ *
+ * 旋转仍用 pose.hpp 的 Quaternion 表示，雅可比等线性代数量用 Eigen 的定长矩阵。
+ * 约定 Exp(φ + δφ) ≈ Exp(φ) Exp(Jr(φ) δφ) ≈ Exp(Jl(φ) δφ) Exp(φ)。
+ * SE(3) 的切向量为 ξ = [φ; ρ]，旋转在前（与 imu 误差状态的顺序一致）。
+ */
+#include <Eigen/Dense>
+#include <cmath>
+
+#include "pose.hpp"
+
+namespace robotics::lie {
+
+inline Eigen::Vector3d toEigen(const Vector3& v) { return { v.x, v.y, v.z }; }
+
+inline Vector3 fromEigen(const Eigen::Vector3d& v) { return { v.x(), v.y(), v.z() }; }
+
+/**
+ * @brief 反对称矩阵 [v]×，满足 [v]× u = v × u
+ */
+inline Eigen::Matrix3d skew(const Eigen::Vector3d& v)
+{
+    Eigen::Matrix3d m;
+    m << 0.0, -v.z(), v.y(),
+        v.z(), 0.0, -v.x(),
+        -v.y(), v.x(), 0.0;
+    return m;
+}
+
+/**
+ * @brief 单位四元数对应的旋转矩阵
+ */
+inline Eigen::Matrix3d rotationMatrix(const Quaternion& q)
+{
+    return Eigen::Quaterniond(q.w, q.x, q.y, q.z).toRotationMatrix();
+}
+
+/**
+ * @brief 指数映射 Exp(φ)
+ */
+inline Quaternion exp(const Vector3& phi)
+{
+    return Quaternion::fromRotationVector(phi);
+}
+
+/**
+ * @brief 对数映射 Log(q)，返回的旋转向量模长在 [0, π]
+ */
+inline Vector3 log(const Quaternion& q)
+{
+    return q.toRotationVector();
+}
+
+/**
+ * @brief 右雅可比 Jr(φ) = I - (1 - cos θ)/θ² [φ]× + (θ - sin θ)/θ³ [φ]×²
+ */
+inline Eigen::Matrix3d rightJacobian(const Vector3& phi)
+{
+    Eigen::Matrix3d k = skew(toEigen(phi));
+    double theta = phi.norm();
+    if (theta < 1e-5) {
+        return Eigen::Matrix3d::Identity() - 0.5 * k + k * k / 6.0;
+    }
+    double theta2 = theta * theta;
+    return Eigen::Matrix3d::Identity() - (1.0 - std::cos(theta)) / theta2 * k
+        + (theta - std::sin(theta)) / (theta2 * theta) * k * k;
+}
+
+/**
+ * @brief 右雅可比的逆 Jr⁻¹(φ) = I + ½[φ]× + (1/θ² - (1 + cos θ)/(2θ sin θ)) [φ]×²
+ */
+inline Eigen::Matrix3d rightJacobianInverse(const Vector3& phi)
+{
+    Eigen::Matrix3d k = skew(toEigen(phi));
+    double theta = phi.norm();
+    if (theta < 1e-5) {
+        return Eigen::Matrix3d::Identity() + 0.5 * k + k * k / 12.0;
+    }
+    // (1 + cos θ) / sin θ 写成 cot(θ/2)，θ 接近 π 时不会出现 0/0
+    double cot_half = std::cos(0.5 * theta) / std::sin(0.5 * theta);
+    return Eigen::Matrix3d::Identity() + 0.5 * k + (1.0 / (theta * theta) - cot_half / (2.0 * theta)) * k * k;
+}
+
+/**
+ * @brief 左雅可比 Jl(φ) = Jr(-φ)
+ */
+inline Eigen::Matrix3d leftJacobian(const Vector3& phi)
+{
+    return rightJacobian(phi * -1.0);
+}
+
+inline Eigen::Matrix3d leftJacobianInverse(const Vector3& phi)
+{
+    return rightJacobianInverse(phi * -1.0);
+}
+
+// --- SE(3) ---
+
+using Vector6d = Eigen::Matrix<double, 6, 1>;
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+/**
+ * @brief SE(3) 指数映射：R = Exp(φ)，t = Jl(φ) ρ
+ */
+inline Pose expSE3(const Vector6d& xi)
+{
+    Vector3 phi = fromEigen(xi.head<3>());
+    return { fromEigen(leftJacobian(phi) * xi.tail<3>()), exp(phi) };
+}
+
+/**
+ * @brief SE(3) 对数映射，expSE3 的逆
+ */
+inline Vector6d logSE3(const Pose& pose)
+{
+    Vector3 phi = log(pose.orientation);
+    Vector6d xi;
+    xi << toEigen(phi), leftJacobianInverse(phi) * toEigen(pose.position);
+    return xi;
+}
+
+/**
+ * @brief 伴随矩阵 Ad(T) = [R 0; [t]×R R]，满足 T Exp(ξ) T⁻¹ = Exp(Ad(T) ξ)
+ */
+inline Matrix6d adjoint(const Pose& pose)
+{
+    Eigen::Matrix3d r = rotationMatrix(pose.orientation);
+    Matrix6d ad = Matrix6d::Zero();
+    ad.block<3, 3>(0, 0) = r;
+    ad.block<3, 3>(3, 0) = skew(toEigen(pose.position)) * r;
+    ad.block<3, 3>(3, 3) = r;
+    return ad;
+}
+
+namespace detail {
+
+    /**
+     * @brief SE(3) 左雅可比的耦合块 Q(φ, ρ)（Barfoot, "State Estimation for Robotics", 式 7.86）
+     */
+    inline Eigen::Matrix3d se3CouplingBlock(const Eigen::Vector3d& phi, const Eigen::Vector3d& rho)
+    {
+        const Eigen::Matrix3d p = skew(phi);
+        const Eigen::Matrix3d r = skew(rho);
+        const double theta = phi.norm();
+        double a, b, c;
+        if (theta < 1e-3) {
+            // 系数的泰勒展开，截断误差 O(θ⁴)
+            double theta2 = theta * theta;
+            a = 1.0 / 6.0 - theta2 / 120.0;
+            b = 1.0 / 24.0 - theta2 / 720.0;
+            c = 1.0 / 120.0 - theta2 / 2520.0;
+        } else {
+            double theta2 = theta * theta;
+            double s = std::sin(theta), co = std::cos(theta);
+            a = (theta - s) / (theta2 * theta);
+            b = (theta2 + 2.0 * co - 2.0) / (2.0 * theta2 * theta2);
+            c = (2.0 * theta - 3.0 * s + theta * co) / (2.0 * theta2 * theta2 * theta);
+        }
+        const Eigen::Matrix3d pr = p * r;
+        const Eigen::Matrix3d rp = r * p;
+        const Eigen::Matrix3d prp = pr * p;
+        return 0.5 * r + a * (pr + rp + prp) + b * (p * pr + rp * p - 3.0 * prp) + c * (prp * p + p * prp);
+    }
+
+} // namespace detail
+
+/**
+ * @brief SE(3) 左雅可比 [Jl(φ) 0; Q(φ, ρ) Jl(φ)]
+ */
+inline Matrix6d leftJacobianSE3(const Vector6d& xi)
+{
+    Vector3 phi = fromEigen(xi.head<3>());
+    Eigen::Matrix3d j = leftJacobian(phi);
+    Matrix6d result = Matrix6d::Zero();
+    result.block<3, 3>(0, 0) = j;
+    result.block<3, 3>(3, 0) = detail::se3CouplingBlock(xi.head<3>(), xi.tail<3>());
+    result.block<3, 3>(3, 3) = j;
+    return result;
+}
+
+inline Matrix6d leftJacobianInverseSE3(const Vector6d& xi)
+{
+    Vector3 phi = fromEigen(xi.head<3>());
+    Eigen::Matrix3d j_inverse = leftJacobianInverse(phi);
+    Matrix6d result = Matrix6d::Zero();
+    result.block<3, 3>(0, 0) = j_inverse;
+    result.block<3, 3>(3, 0)
+        = -j_inverse * detail::se3CouplingBlock(xi.head<3>(), xi.tail<3>()) * j_inverse;
+    result.block<3, 3>(3, 3) = j_inverse;
+    return result;
+}
+
+inline Matrix6d rightJacobianSE3(const Vector6d& xi)
+{
+    return leftJacobianSE3(-xi);
+}
+
+inline Matrix6d rightJacobianInverseSE3(const Vector6d& xi)
+{
+    return leftJacobianInverseSE3(-xi);
+}
+
+} // namespace robotics::lie
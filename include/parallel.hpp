@@ -0,0 +1,272 @@
+#pragma once
+/**
+ * @file parallel.hpp
+ * @brief 项目共用的并行执行工具：可指定线程数的 parallel_for_each（源自 a4）与常驻线程池。
+ *
+ * a4 中的实现总是使用 std::thread::hardware_concurrency() 个线程，无法做扩展性测试；
+ * 这里把线程数作为参数（0 表示硬件线程数），并提供一个可复用线程的 ThreadPool，
+ * 供批量插值、批量求解等模块使用。
+ */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace robotics {
+
+/**
+ * @brief 硬件支持的线程数（至少为 1）
+ */
+inline unsigned hardwareThreads()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+/**
+ * @brief 每个块一个 std::thread 的并行 for_each（a4 traditional 的可配置版本）
+ * @param num_threads 使用的线程数，0 表示 hardwareThreads()
+ */
+template <typename Iterator, typename Function>
+void parallel_for_each(Iterator begin, Iterator end, Function func, unsigned num_threads = 0)
+{
+    num_threads = num_threads > 0 ? num_threads : hardwareThreads();
+    size_t total_size = std::distance(begin, end);
+
+    // 如果元素太少或只有一个线程，不使用并行
+    if (num_threads == 1 || total_size < num_threads * 4) {
+        std::for_each(begin, end, func);
+        return;
+    }
+
+    size_t block_size = total_size / num_threads;
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+
+    auto worker = [&func](Iterator block_begin, Iterator block_end) {
+        std::for_each(block_begin, block_end, func);
+    };
+
+    Iterator block_begin = begin;
+    for (unsigned i = 0; i < num_threads - 1; ++i) {
+        Iterator block_end = block_begin;
+        std::advance(block_end, block_size);
+        threads.emplace_back(worker, block_begin, block_end);
+        block_begin = block_end;
+    }
+
+    // 在当前线程处理最后一块
+    worker(block_begin, end);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief 基于 std::async 的并行 for_each（a4 modern 的可配置版本）
+ * @param num_threads 使用的线程数，0 表示 hardwareThreads()
+ */
+template <typename Iterator, typename Function>
+void parallel_for_each_async(Iterator begin, Iterator end, Function func, unsigned num_threads = 0)
+{
+    num_threads = num_threads > 0 ? num_threads : hardwareThreads();
+    size_t total_size = std::distance(begin, end);
+
+    if (num_threads == 1 || total_size < num_threads * 4) {
+        std::for_each(begin, end, func);
+        return;
+    }
+
+    size_t block_size = total_size / num_threads;
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_threads - 1);
+
+    auto worker = [&func](Iterator block_begin, Iterator block_end) {
+        std::for_each(block_begin, block_end, func);
+    };
+
+    Iterator block_begin = begin;
+    for (unsigned i = 0; i < num_threads - 1; ++i) {
+        Iterator block_end = block_begin;
+        std::advance(block_end, block_size);
+        futures.push_back(std::async(std::launch::async, worker, block_begin, block_end));
+        block_begin = block_end;
+    }
+
+    worker(block_begin, end);
+
+    // get() 而不是 wait()：把工作线程中的异常传播给调用者
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+/**
+ * @brief 常驻线程池
+ *
+ * size() 个线程中包含调用线程本身：构造时创建 size() - 1 个工作线程，
+ * parallelFor 时调用线程也参与计算，因此 ThreadPool(1) 完全串行、没有任何同步开销。
+ */
+class ThreadPool {
+public:
+    /**
+     * @param num_threads 总线程数（含调用线程），0 表示 hardwareThreads()
+     */
+    explicit ThreadPool(unsigned num_threads = 0)
+        : size_(num_threads > 0 ? num_threads : hardwareThreads())
+    {
+        workers_.reserve(size_ - 1);
+        for (unsigned i = 0; i + 1 < size_; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return size_; }
+
+    /**
+     * @brief 提交一个异步任务
+     * @return std::future 任务的返回值
+     */
+    template <typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<F>>
+    {
+        using ReturnType = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<F>(f));
+        std::future<ReturnType> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([task] { (*task)(); });
+        }
+        condition_.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief 把区间 [begin, end) 切成若干块并行执行 body(lo, hi)
+     *
+     * 块通过原子计数器动态分配（负载不均时自动平衡），调用线程同时参与计算。
+     * 任意块抛出的第一个异常会在所有块结束后于调用线程重新抛出。
+     *
+     * @param grain 每块的最小元素数，0 表示自动（约为每线程 8 块）
+     */
+    template <typename Body>
+    void parallelFor(std::size_t begin, std::size_t end, Body&& body, std::size_t grain = 0)
+    {
+        if (end <= begin) {
+            return;
+        }
+        std::size_t total = end - begin;
+        if (grain == 0) {
+            grain = std::max<std::size_t>(1, total / (static_cast<std::size_t>(size_) * 8));
+        }
+        std::size_t chunks = (total + grain - 1) / grain;
+        if (size_ == 1 || chunks == 1) {
+            body(begin, end);
+            return;
+        }
+
+        // 状态放在堆上：迟到的辅助任务只会读到"已无剩余块"并立即返回，
+        // 因此调用者只需等待所有块完成，不必等待辅助任务退出（嵌套调用也不会死锁）
+        struct SharedState {
+            std::atomic<std::size_t> next_chunk { 0 };
+            std::atomic<std::size_t> completed { 0 };
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<SharedState>();
+
+        auto run_chunks = [state, begin, end, grain, chunks, &body] {
+            for (;;) {
+                std::size_t chunk = state->next_chunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk >= chunks) {
+                    return;
+                }
+                std::size_t lo = begin + chunk * grain;
+                std::size_t hi = std::min(end, lo + grain);
+                try {
+                    body(lo, hi);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) {
+                        state->error = std::current_exception();
+                    }
+                }
+                if (state->completed.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->done.notify_one();
+                }
+            }
+        };
+
+        std::size_t helpers = std::min<std::size_t>(size_ - 1, chunks - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (std::size_t i = 0; i < helpers; ++i) {
+                tasks_.emplace(run_chunks);
+            }
+        }
+        condition_.notify_all();
+
+        run_chunks();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&state, chunks] { return state->completed.load(std::memory_order_acquire) == chunks; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+private:
+    void workerLoop()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    unsigned size_;
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_ { false };
+};
+
+} // namespace robotics
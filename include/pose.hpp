@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <cmath>
 
 namespace robotics {
@@ -36,6 +37,24 @@ struct Vector3 {
     {
         return { x * scalar, y * scalar, z * scalar };
     }
+
+    // 点积
+    double dot(const Vector3& other) const
+    {
+        return x * other.x + y * other.y + z * other.z;
+    }
+
+    // 叉积
+    Vector3 cross(const Vector3& other) const
+    {
+        return { y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x };
+    }
+
+    // 模长
+    double norm() const
+    {
+        return std::sqrt(x * x + y * y + z * z);
+    }
 };
 
 /**
@@ -73,6 +92,22 @@ struct Quaternion {
         }
     }
 
+    /**
+     * @brief 一阶重新归一化：乘以 (3 - |q|²) / 2，只用乘加，没有开方、除法和分支
+     *
+     * 相当于以 1 为初值对 1/|q| 做一次牛顿迭代，用于已知接近单位长度的四元数（例如长串复合后的舍入漂移）：
+     * |q|² = 1 + δ 时结果的模长为 1 - 3δ²/8 + O(δ³)。
+     * 偏离单位较远时（|δ| 超过约 1e-4）应使用 normalize()。
+     */
+    void renormalize()
+    {
+        double scale = 0.5 * (3.0 - (w * w + x * x + y * y + z * z));
+        w *= scale;
+        x *= scale;
+        y *= scale;
+        z *= scale;
+    }
+
     // 四元数乘法
     Quaternion operator*(const Quaternion& q) const
     {
@@ -95,6 +130,191 @@ struct Quaternion {
     {
         return { w + q.w, x + q.x, y + q.y, z + q.z };
     }
+
+    // 共轭（对单位四元数即为逆）
+    Quaternion conjugate() const
+    {
+        return { w, -x, -y, -z };
+    }
+
+    // 单位四元数表示的旋转角 [0, pi]（q 与 -q 给出相同结果）
+    double angle() const
+    {
+        return 2.0 * std::atan2(std::sqrt(x * x + y * y + z * z), std::fabs(w));
+    }
+
+    // 用单位四元数旋转向量: v' = q * v * q^-1
+    Vector3 rotate(const Vector3& v) const
+    {
+        // t = 2 * (u x v), v' = v + w * t + u x t，其中 u 为虚部
+        Vector3 u { x, y, z };
+        Vector3 t = u.cross(v) * 2.0;
+        return v + t * w + u.cross(t);
+    }
+
+    // 由旋转向量（轴 * 角度）构造单位四元数，即 SO(3) 指数映射
+    static Quaternion fromRotationVector(const Vector3& v)
+    {
+        double angle = v.norm();
+        if (angle < 1e-8) {
+            // 小角度时使用一阶近似，避免除以零
+            Quaternion q { 1.0, 0.5 * v.x, 0.5 * v.y, 0.5 * v.z };
+            q.normalize();
+            return q;
+        }
+        double s = std::sin(0.5 * angle) / angle;
+        return { std::cos(0.5 * angle), v.x * s, v.y * s, v.z * s };
+    }
+
+    // 对数映射：单位四元数对应的旋转向量，模长在 [0, π]（q 与 -q 给出相同结果）
+    Vector3 toRotationVector() const
+    {
+        double sign = w < 0.0 ? -1.0 : 1.0;
+        Vector3 v { sign * x, sign * y, sign * z };
+        double sin_half = v.norm();
+        double cos_half = sign * w;
+        if (sin_half < 1e-8) {
+            return v * (2.0 / cos_half); // θ/sin(θ/2) 的小角度极限为 2/w
+        }
+        return v * (2.0 * std::atan2(sin_half, cos_half) / sin_half);
+    }
+
+    // 转为 ZYX 欧拉角 (roll, pitch, yaw)，fromEuler 的逆；pitch 在 [-π/2, π/2]，roll、yaw 在 (-π, π]
+    Vector3 toEuler() const
+    {
+        // 展开 fromEuler（半角）可得
+        //   (w + y, x - z) = (cos(p/2) + sin(p/2)) (cos((r - y)/2), sin((r - y)/2))
+        //   (w - y, x + z) = (cos(p/2) - sin(p/2)) (cos((r + y)/2), sin((r + y)/2))
+        // 两个模长之积为 cos(p)。r - y 与 r + y 各由一次 atan2 得到，pitch 接近 ±π/2 时其中一个模长趋于 0，
+        // 对应的和/差不再确定，但它对旋转的影响也按同样的比例缩小，返回的角度总能在舍入误差内还原旋转；
+        // 不对 sin(p) 求 asin，也不对 q 的模长做假设
+        double sum_norm = std::sqrt((w + y) * (w + y) + (x - z) * (x - z));
+        double diff_norm = std::sqrt((w - y) * (w - y) + (x + z) * (x + z));
+        double difference = 2.0 * std::atan2(x - z, w + y); // r - y
+        double sum = 2.0 * std::atan2(x + z, w - y); // r + y
+        auto wrap = [](double angle) {
+            return angle > M_PI ? angle - 2.0 * M_PI : (angle <= -M_PI ? angle + 2.0 * M_PI : angle);
+        };
+        return {
+            wrap(0.5 * (sum + difference)),
+            std::atan2(2.0 * (w * y - z * x), sum_norm * diff_norm),
+            wrap(0.5 * (sum - difference))
+        };
+    }
+
+    // 由 ZYX 欧拉角（roll 绕 X，pitch 绕 Y，yaw 绕 Z）构造单位四元数
+    static Quaternion fromEuler(double roll, double pitch, double yaw)
+    {
+        double cr = std::cos(0.5 * roll), sr = std::sin(0.5 * roll);
+        double cp = std::cos(0.5 * pitch), sp = std::sin(0.5 * pitch);
+        double cy = std::cos(0.5 * yaw), sy = std::sin(0.5 * yaw);
+        return {
+            cr * cp * cy + sr * sp * sy,
+            sr * cp * cy - cr * sp * sy,
+            cr * sp * cy + sr * cp * sy,
+            cr * cp * sy - sr * sp * cy
+        };
+    }
+};
+
+/**
+ * @brief 3x3 旋转矩阵（行主序）
+ */
+struct RotationMatrix {
+    std::array<double, 9> m { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+
+    RotationMatrix() = default;
+
+    // 由单位四元数构造
+    explicit RotationMatrix(const Quaternion& q)
+    {
+        double xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        double xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        double wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        m = {
+            1.0 - 2.0 * (yy + zz), 2.0 * (xy - wz), 2.0 * (xz + wy),
+            2.0 * (xy + wz), 1.0 - 2.0 * (xx + zz), 2.0 * (yz - wx),
+            2.0 * (xz - wy), 2.0 * (yz + wx), 1.0 - 2.0 * (xx + yy)
+        };
+    }
+
+    double operator()(int row, int col) const { return m[3 * row + col]; }
+
+    // 转回单位四元数，返回 w >= 0 的一支
+    Quaternion toQuaternion() const
+    {
+        // Shepperd 方法：在迹和三个对角元中取最大者，由它开方得到绝对值最大的分量（不小于 1/2），
+        // 其余分量由非对角元的和/差除以它得到，任何旋转都不会对接近 0 的数开方或相除
+        double trace = (m[0] + m[4]) + m[8];
+        double largest;
+        int which;
+        if (trace >= m[0] && trace >= m[4] && trace >= m[8]) {
+            largest = trace;
+            which = 0;
+        } else if (m[0] >= m[4] && m[0] >= m[8]) {
+            largest = m[0];
+            which = 1;
+        } else if (m[4] >= m[8]) {
+            largest = m[4];
+            which = 2;
+        } else {
+            largest = m[8];
+            which = 3;
+        }
+        double big = 0.5 * std::sqrt(1.0 + (2.0 * largest - trace));
+        double s = 0.25 / big;
+        double a = (m[7] - m[5]) * s, b = (m[2] - m[6]) * s, c = (m[3] - m[1]) * s;
+        double d = (m[1] + m[3]) * s, e = (m[2] + m[6]) * s, f = (m[5] + m[7]) * s;
+        Quaternion q;
+        switch (which) {
+        case 0:
+            q = { big, a, b, c };
+            break;
+        case 1:
+            q = { a, big, d, e };
+            break;
+        case 2:
+            q = { b, d, big, f };
+            break;
+        default:
+            q = { c, e, f, big };
+            break;
+        }
+        return q.w < 0.0 ? q * -1.0 : q;
+    }
+
+    Vector3 operator*(const Vector3& v) const
+    {
+        return {
+            m[0] * v.x + m[1] * v.y + m[2] * v.z,
+            m[3] * v.x + m[4] * v.y + m[5] * v.z,
+            m[6] * v.x + m[7] * v.y + m[8] * v.z
+        };
+    }
+
+    RotationMatrix operator*(const RotationMatrix& other) const
+    {
+        RotationMatrix result;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                result.m[3 * r + c] = m[3 * r] * other.m[c] + m[3 * r + 1] * other.m[3 + c]
+                    + m[3 * r + 2] * other.m[6 + c];
+            }
+        }
+        return result;
+    }
+
+    // 转置（对旋转矩阵即为逆）
+    RotationMatrix transpose() const
+    {
+        RotationMatrix result;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                result.m[3 * r + c] = m[3 * c + r];
+            }
+        }
+        return result;
+    }
 };
 
 /**
@@ -111,6 +331,25 @@ struct Pose {
         , orientation(orient)
     {
     }
+
+    // 位姿复合 this * other：先应用 other，再应用 this
+    Pose operator*(const Pose& other) const
+    {
+        return { orientation.rotate(other.position) + position, orientation * other.orientation };
+    }
+
+    // 逆变换（姿态须为单位四元数）
+    Pose inverse() const
+    {
+        Quaternion inv = orientation.conjugate();
+        return { inv.rotate(position) * -1.0, inv };
+    }
+
+    // 变换一个点: R * p + t
+    Vector3 transform(const Vector3& p) const
+    {
+        return orientation.rotate(p) + position;
+    }
 };
 
 /**
@@ -0,0 +1,242 @@
+#pragma once
+/**
+ * @file pose_covariance.hpp
+ * @brief 带 6x6 协方差的位姿插值：均值与 interpolation.hpp 相同，协方差经流形上的一阶传播得到。
+ *
+ * 协方差定义在右扰动 T = T̄ Exp(ξ)、ξ = [δθ; δρ] 上（与 lie.hpp 一致）。把插值写成
+ * T(t) = f(T0, T1, t)，在两个端点处线性化得到 δ(t) ≈ A δ0 + B δ1，于是
+ *
+ *     Σ(t) = A Σ0 Aᵀ + B Σ1 Bᵀ
+ *
+ * 端点的协方差视为互不相关（各自的边缘协方差）。对同一个平滑器中相邻、强相关的位姿，
+ * 这会高估中间时刻的不确定性，但不会低估。
+ *
+ * Decoupled 模型的均值用 interpolatePose，其 slerp 在转角小于约 3.6° 时退化为 nlerp；
+ * 协方差仍按 SLERP 的雅可比传播，两者只差 O(θ²)（相对误差不超过 4e-3）。
+ *
+ * 关键帧的协方差可以用 float 的上三角压缩存储（84 字节，double 完整矩阵为 288 字节），
+ * 计算时展开成 double。
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "interpolation.hpp"
+#include "lie.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+
+namespace robotics {
+
+using Matrix6d = lie::Matrix6d;
+
+/**
+ * @brief 对称 6x6 矩阵的上三角压缩存储（按行，21 个元素）
+ */
+template <typename Scalar>
+struct PackedCovariance {
+    std::array<Scalar, 21> upper {};
+
+    static PackedCovariance pack(const Matrix6d& matrix)
+    {
+        PackedCovariance packed;
+        std::size_t k = 0;
+        for (int i = 0; i < 6; ++i) {
+            for (int j = i; j < 6; ++j) {
+                packed.upper[k++] = static_cast<Scalar>(0.5 * (matrix(i, j) + matrix(j, i)));
+            }
+        }
+        return packed;
+    }
+
+    Matrix6d unpack() const
+    {
+        Matrix6d matrix;
+        std::size_t k = 0;
+        for (int i = 0; i < 6; ++i) {
+            for (int j = i; j < 6; ++j) {
+                matrix(i, j) = matrix(j, i) = static_cast<double>(upper[k++]);
+            }
+        }
+        return matrix;
+    }
+};
+
+/**
+ * @brief 带协方差的位姿
+ */
+struct PoseWithCovariance {
+    Pose pose;
+    Matrix6d covariance { Matrix6d::Zero() };
+};
+
+/**
+ * @brief 带时间戳和压缩协方差的位姿，Scalar 为协方差的存储精度（double 或 float）
+ */
+template <typename Scalar = double>
+struct TimedPoseWithCovariance {
+    double time_stamp { 0.0 };
+    Pose pose;
+    PackedCovariance<Scalar> covariance;
+};
+
+/**
+ * @brief 插值模型
+ */
+enum class CovarianceModel {
+    Decoupled, // 位置线性插值、姿态 SLERP，均值与 interpolatePose 完全相同
+    SE3, // SE(3) 测地线 T0 Exp(t ξ)，平移随旋转走螺旋线
+};
+
+namespace detail {
+
+    /**
+     * @brief 一个区间上与 t 无关的量：相对运动及其雅可比的逆，批量查询落在同一区间时复用
+     */
+    class CovarianceSegment {
+    public:
+        CovarianceSegment(const Pose& start, const Matrix6d& start_covariance, const Pose& end,
+            const Matrix6d& end_covariance, CovarianceModel model)
+            : start_(start)
+            , end_(end)
+            , start_covariance_(start_covariance)
+            , end_covariance_(end_covariance)
+            , model_(model)
+        {
+            if (model_ == CovarianceModel::Decoupled) {
+                Quaternion relative = start.orientation.conjugate() * end.orientation;
+                phi_ = lie::log(relative);
+                relative_rotation_ = lie::rotationMatrix(relative);
+                jl_inverse_ = lie::leftJacobianInverse(phi_);
+                jr_inverse_ = lie::rightJacobianInverse(phi_);
+            } else {
+                xi_ = lie::logSE3(start.inverse() * end);
+                jl_inverse_se3_ = lie::leftJacobianInverseSE3(xi_);
+                jr_inverse_se3_ = lie::rightJacobianInverseSE3(xi_);
+            }
+        }
+
+        PoseWithCovariance evaluate(double t) const
+        {
+            t = std::clamp(t, 0.0, 1.0);
+            PoseWithCovariance result;
+            Matrix6d a = Matrix6d::Zero();
+            Matrix6d b = Matrix6d::Zero();
+            if (model_ == CovarianceModel::Decoupled) {
+                result.pose = interpolatePose(start_, end_, t);
+                Vector3 t_phi = phi_ * t;
+                Eigen::Matrix3d back = lie::rotationMatrix(lie::exp(t_phi * -1.0)); // R(t)ᵀ R0
+                Eigen::Matrix3d jr = lie::rightJacobian(t_phi);
+                a.block<3, 3>(0, 0) = back - t * jr * jl_inverse_;
+                b.block<3, 3>(0, 0) = t * jr * jr_inverse_;
+                // 位置不受端点姿态影响；δρ 在各自的机体系下表示，需要转到 R(t) 下
+                a.block<3, 3>(3, 3) = (1.0 - t) * back;
+                b.block<3, 3>(3, 3) = t * back * relative_rotation_;
+            } else {
+                lie::Vector6d t_xi = t * xi_;
+                result.pose = start_ * lie::expSE3(t_xi);
+                Matrix6d jr = lie::rightJacobianSE3(t_xi);
+                a = lie::adjoint(lie::expSE3(-t_xi)) - t * jr * jl_inverse_se3_;
+                b = t * jr * jr_inverse_se3_;
+            }
+            result.covariance = a * start_covariance_ * a.transpose() + b * end_covariance_ * b.transpose();
+            return result;
+        }
+
+    private:
+        Pose start_;
+        Pose end_;
+        Matrix6d start_covariance_;
+        Matrix6d end_covariance_;
+        CovarianceModel model_;
+        // Decoupled
+        Vector3 phi_;
+        Eigen::Matrix3d relative_rotation_;
+        Eigen::Matrix3d jl_inverse_;
+        Eigen::Matrix3d jr_inverse_;
+        // SE3
+        lie::Vector6d xi_;
+        Matrix6d jl_inverse_se3_;
+        Matrix6d jr_inverse_se3_;
+    };
+
+} // namespace detail
+
+/**
+ * @brief 在两个带协方差的位姿之间插值
+ * @param t 插值因子，会被截断到 [0, 1]
+ */
+inline PoseWithCovariance interpolatePoseWithCovariance(const PoseWithCovariance& start,
+    const PoseWithCovariance& end, double t, CovarianceModel model = CovarianceModel::Decoupled)
+{
+    return detail::CovarianceSegment(start.pose, start.covariance, end.pose, end.covariance, model).evaluate(t);
+}
+
+/**
+ * @brief 串行批量插值：查询时间单调时沿轨迹游走，同一区间内的查询共用区间的预计算
+ * @throw std::out_of_range 如果任一查询时间超出范围
+ */
+template <typename Scalar, typename OutScalar>
+void interpolateTimedPosesWithCovariance(const std::vector<TimedPoseWithCovariance<Scalar>>& poses,
+    const double* times, std::size_t count, TimedPoseWithCovariance<OutScalar>* out,
+    CovarianceModel model = CovarianceModel::Decoupled)
+{
+    std::size_t cached = poses.size(); // 当前 segment 对应的区间，poses.size() 表示尚未构造
+    std::optional<detail::CovarianceSegment> segment_cache;
+    std::size_t segment = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        double target = times[k];
+        if (k == 0 || target < times[k - 1] || target > poses.back().time_stamp) {
+            segment = findSegmentIndex(poses, target); // 乱序或越界：退回二分查找（越界时抛出）
+        } else {
+            while (segment + 1 < poses.size() && poses[segment + 1].time_stamp <= target) {
+                ++segment;
+            }
+        }
+        out[k].time_stamp = target;
+        if (segment + 1 >= poses.size() || poses[segment].time_stamp == target) {
+            out[k].pose = poses[segment].pose;
+            out[k].covariance = PackedCovariance<OutScalar>::pack(poses[segment].covariance.unpack());
+            continue;
+        }
+        if (cached != segment) {
+            segment_cache.emplace(poses[segment].pose, poses[segment].covariance.unpack(), poses[segment + 1].pose,
+                poses[segment + 1].covariance.unpack(), model);
+            cached = segment;
+        }
+        double t = (target - poses[segment].time_stamp) / (poses[segment + 1].time_stamp - poses[segment].time_stamp);
+        PoseWithCovariance result = segment_cache->evaluate(t);
+        out[k].pose = result.pose;
+        out[k].covariance = PackedCovariance<OutScalar>::pack(result.covariance);
+    }
+}
+
+/**
+ * @brief 单次查询
+ */
+template <typename Scalar>
+PoseWithCovariance interpolateTimedPoseWithCovariance(const std::vector<TimedPoseWithCovariance<Scalar>>& poses,
+    double target_time, CovarianceModel model = CovarianceModel::Decoupled)
+{
+    TimedPoseWithCovariance<double> out;
+    interpolateTimedPosesWithCovariance(poses, &target_time, 1, &out, model);
+    return { out.pose, out.covariance.unpack() };
+}
+
+/**
+ * @brief 并行批量插值：查询被切块分给线程池，每块内部沿用串行的游走策略
+ */
+template <typename Scalar, typename OutScalar>
+void interpolateTimedPosesWithCovariance(const std::vector<TimedPoseWithCovariance<Scalar>>& poses,
+    const double* times, std::size_t count, TimedPoseWithCovariance<OutScalar>* out, ThreadPool& pool,
+    CovarianceModel model = CovarianceModel::Decoupled)
+{
+    pool.parallelFor(0, count, [&](std::size_t lo, std::size_t hi) {
+        interpolateTimedPosesWithCovariance(poses, times + lo, hi - lo, out + lo, model);
+    });
+}
+
+} // namespace robotics
@@ -0,0 +1,599 @@
+#pragma once
+/**
+ * @file pose_graph.hpp
+ * @brief SE(3) 位姿图优化：相对位姿边、鲁棒核、Gauss-Newton / Levenberg-Marquardt，稀疏 Cholesky 求解。
+ *
+ * 迭代之间图的结构不变，与结构有关的工作只在第一次 optimize（或图结构改变后）做一次：
+ * - 自由节点按节点级（6x6 块）的 AMD 排序编号，组装出的 Hessian 本身就是填充较少的顺序，
+ *   求解器不再排序，排序的图也比标量级小 36 倍；
+ * - Hessian 下三角的稀疏模式按块直接生成，每条边记下其非对角块在列中的位置；
+ * - 边按“不共享自由节点”贪心着色，同一颜色的边并行地把贡献直接写进 Hessian，
+ *   不需要锁或原子操作；每个块的累加顺序固定（颜色顺序、颜色内按边的顺序），结果与线程数无关；
+ * - 符号分解 analyzePattern 只做一次，之后每次迭代（以及 LM 拒绝一步后调整阻尼）只做数值分解。
+ */
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "lie.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+
+namespace robotics::graph {
+
+using Matrix6d = lie::Matrix6d;
+using Vector6d = lie::Vector6d;
+
+/**
+ * @brief 相对位姿边：measurement ≈ T_from⁻¹ T_to
+ */
+struct Edge {
+    std::size_t from { 0 };
+    std::size_t to { 0 };
+    Pose measurement;
+    Matrix6d information { Matrix6d::Identity() }; // 残差 [δθ; δρ] 的信息矩阵
+};
+
+/**
+ * @brief 边的残差 e = Log(Z⁻¹ T_from⁻¹ T_to)，旋转在前（lie.hpp 的约定）
+ */
+inline Vector6d edgeResidual(const Pose& from, const Pose& to, const Pose& measurement)
+{
+    return lie::logSE3(measurement.inverse() * (from.inverse() * to));
+}
+
+enum class RobustKernel {
+    None,
+    Huber,
+    Cauchy,
+};
+
+/**
+ * @brief 作用在 χ² = eᵀΩe 上的鲁棒损失 ρ(χ²)，delta 以马氏距离 χ 为单位
+ */
+struct RobustLoss {
+    RobustKernel kernel { RobustKernel::None };
+    double delta { 1.0 };
+
+    double cost(double chi2) const
+    {
+        double d2 = delta * delta;
+        switch (kernel) {
+        case RobustKernel::Huber:
+            return chi2 <= d2 ? chi2 : 2.0 * delta * std::sqrt(chi2) - d2;
+        case RobustKernel::Cauchy:
+            return d2 * std::log1p(chi2 / d2);
+        default:
+            return chi2;
+        }
+    }
+
+    /**
+     * @brief ρ'(χ²)：迭代重加权最小二乘中这条边信息矩阵的缩放系数
+     */
+    double weight(double chi2) const
+    {
+        double d2 = delta * delta;
+        switch (kernel) {
+        case RobustKernel::Huber:
+            return chi2 <= d2 ? 1.0 : delta / std::sqrt(chi2);
+        case RobustKernel::Cauchy:
+            return 1.0 / (1.0 + chi2 / d2);
+        default:
+            return 1.0;
+        }
+    }
+};
+
+/**
+ * @brief 位姿图：节点为世界系下的位姿，边为相对位姿观测
+ */
+class PoseGraph {
+public:
+    std::size_t addNode(const Pose& pose, bool fixed = false)
+    {
+        poses_.push_back(pose);
+        fixed_.push_back(fixed);
+        return poses_.size() - 1;
+    }
+
+    /**
+     * @throw std::out_of_range 如果端点不存在
+     * @throw std::invalid_argument 如果两个端点相同
+     */
+    void addEdge(const Edge& edge)
+    {
+        if (edge.from >= poses_.size() || edge.to >= poses_.size()) {
+            throw std::out_of_range("Edge references a node that does not exist");
+        }
+        if (edge.from == edge.to) {
+            throw std::invalid_argument("Edge must connect two different nodes");
+        }
+        edges_.push_back(edge);
+    }
+
+    void setFixed(std::size_t node, bool fixed = true) { fixed_.at(node) = fixed; }
+
+    bool isFixed(std::size_t node) const { return fixed_.at(node); }
+
+    std::size_t nodeCount() const { return poses_.size(); }
+    std::size_t edgeCount() const { return edges_.size(); }
+
+    const std::vector<Pose>& poses() const { return poses_; }
+    std::vector<Pose>& poses() { return poses_; }
+    const std::vector<Edge>& edges() const { return edges_; }
+    const std::vector<bool>& fixedFlags() const { return fixed_; }
+
+private:
+    std::vector<Pose> poses_;
+    std::vector<Edge> edges_;
+    std::vector<bool> fixed_;
+};
+
+enum class Method {
+    GaussNewton,
+    LevenbergMarquardt,
+};
+
+struct OptimizerOptions {
+    Method method { Method::LevenbergMarquardt };
+    RobustLoss loss;
+    int max_iterations { 30 };
+    double initial_lambda { 1e-5 }; // LM 阻尼，作用在 Hessian 对角线上：H + λ diag(H)
+    double function_tolerance { 1e-6 }; // 代价的相对下降小于该值时停止
+};
+
+struct IterationSummary {
+    double cost { 0.0 }; // 迭代结束时的代价（拒绝的一步不改变代价）
+    double lambda { 0.0 }; // 这一步使用的阻尼
+    bool accepted { true };
+    double assemble_ms { 0.0 }; // 拒绝的一步沿用上次的 Hessian，为 0
+    double solve_ms { 0.0 }; // 数值分解与回代
+};
+
+struct OptimizationSummary {
+    double initial_cost { 0.0 };
+    double final_cost { 0.0 };
+    bool converged { false };
+    double analyze_ms { 0.0 }; // 结构分析（排序、稀疏模式、着色、符号分解），结构不变时为 0
+    std::size_t colors { 0 };
+    std::size_t hessian_nonzeros { 0 }; // 下三角
+    std::size_t factor_nonzeros { 0 };
+    std::vector<IterationSummary> iterations;
+};
+
+/**
+ * @brief 位姿图优化器
+ *
+ * 位姿在右扰动 T ← T Exp(δ) 下线性化。没有固定节点时固定节点 0 以消除规范自由度。
+ * 优化器保存对图的引用和与结构有关的缓存；向图中加边或改变固定节点后，下一次 optimize 会重新分析。
+ */
+class PoseGraphOptimizer {
+public:
+    explicit PoseGraphOptimizer(PoseGraph& graph, OptimizerOptions options = {})
+        : graph_(graph)
+        , options_(options)
+    {
+    }
+
+    const OptimizerOptions& options() const { return options_; }
+    void setOptions(const OptimizerOptions& options) { options_ = options; }
+
+    /**
+     * @brief 当前位姿下的代价 ½ Σ ρ(eᵀΩe)
+     */
+    double cost(ThreadPool& pool) const { return totalCost(graph_.poses(), pool); }
+
+    /**
+     * @brief 优化图中的位姿，结果直接写回 graph.poses()
+     * @throw std::runtime_error Gauss-Newton 遇到非正定的 Hessian（例如存在没有固定节点的连通分量）
+     */
+    OptimizationSummary optimize(ThreadPool& pool)
+    {
+        OptimizationSummary summary;
+        if (structureChanged()) {
+            summary.analyze_ms = elapsedMs([&] { analyze(); });
+        }
+        summary.colors = color_start_.empty() ? 0 : color_start_.size() - 1;
+        summary.hessian_nonzeros = static_cast<std::size_t>(hessian_.nonZeros());
+
+        const bool damped = options_.method == Method::LevenbergMarquardt;
+        std::vector<Pose>& poses = graph_.poses();
+        std::vector<Pose> candidate(poses.size());
+        double current = totalCost(poses, pool);
+        summary.initial_cost = current;
+        double lambda = damped ? options_.initial_lambda : 0.0;
+        bool assembled = false;
+
+        for (int iteration = 0; iteration < options_.max_iterations && !diagonal_offset_.empty(); ++iteration) {
+            IterationSummary step;
+            step.lambda = lambda;
+            if (!assembled) {
+                step.assemble_ms = elapsedMs([&] { assemble(poses, pool); });
+                assembled = true;
+            }
+            bool factorized = false;
+            step.solve_ms = elapsedMs([&] {
+                setDamping(lambda);
+                solver_.factorize(hessian_);
+                factorized = solver_.info() == Eigen::Success;
+                if (factorized) {
+                    update_ = solver_.solve(-gradient_);
+                }
+            });
+            if (!factorized && !damped) {
+                throw std::runtime_error("Pose graph Hessian is not positive definite");
+            }
+            double next = current;
+            if (factorized) {
+                applyUpdate(poses, candidate, pool);
+                next = totalCost(candidate, pool);
+            }
+            if (factorized && (!damped || next < current)) {
+                double decrease = (current - next) / std::max(current, 1e-300);
+                poses.swap(candidate);
+                current = next;
+                assembled = false;
+                lambda = std::max(lambda / 10.0, 1e-12);
+                step.cost = current;
+                summary.iterations.push_back(step);
+                if (decrease < options_.function_tolerance) {
+                    summary.converged = decrease >= 0.0;
+                    break;
+                }
+            } else {
+                // 拒绝：只加大阻尼重新做数值分解，Hessian 不必重新组装
+                lambda *= 10.0;
+                step.accepted = false;
+                step.cost = current;
+                summary.iterations.push_back(step);
+                if (lambda > 1e12) {
+                    break;
+                }
+            }
+        }
+        setDamping(0.0);
+        summary.final_cost = current;
+        if (!diagonal_offset_.empty()) {
+            summary.factor_nonzeros = static_cast<std::size_t>(solver_.matrixL().nestedExpression().nonZeros());
+        }
+        return summary;
+    }
+
+private:
+    /**
+     * @brief 一条参与组装的边：端点的变量块编号（固定节点为 -1）与非对角块在其块列中的位置
+     */
+    struct EdgeSlot {
+        std::size_t edge { 0 };
+        std::int64_t from { -1 };
+        std::int64_t to { -1 };
+        std::int64_t cross { -1 };
+    };
+
+    template <typename F>
+    static double elapsedMs(F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    bool structureChanged() const
+    {
+        return !analyzed_ || structure_edges_ != graph_.edgeCount() || structure_fixed_ != graph_.fixedFlags();
+    }
+
+    void analyze()
+    {
+        const std::size_t nodes = graph_.nodeCount();
+        const std::vector<Edge>& edges = graph_.edges();
+        bool any_fixed = std::find(graph_.fixedFlags().begin(), graph_.fixedFlags().end(), true)
+            != graph_.fixedFlags().end();
+        auto is_fixed = [&](std::size_t node) { return graph_.isFixed(node) || (!any_fixed && node == 0); };
+
+        // 1. 自由节点的块级 AMD 排序
+        std::vector<int> free_index(nodes, -1);
+        int free_count = 0;
+        for (std::size_t i = 0; i < nodes; ++i) {
+            if (!is_fixed(i)) {
+                free_index[i] = free_count++;
+            }
+        }
+        std::vector<Eigen::Triplet<double>> pattern_entries;
+        pattern_entries.reserve(static_cast<std::size_t>(free_count) + edges.size());
+        for (int i = 0; i < free_count; ++i) {
+            pattern_entries.emplace_back(i, i, 1.0);
+        }
+        for (const Edge& edge : edges) {
+            int a = free_index[edge.from], b = free_index[edge.to];
+            if (a >= 0 && b >= 0) {
+                pattern_entries.emplace_back(std::max(a, b), std::min(a, b), 1.0);
+            }
+        }
+        Eigen::SparseMatrix<double> block_pattern(free_count, free_count);
+        block_pattern.setFromTriplets(pattern_entries.begin(), pattern_entries.end());
+        std::vector<int> rank(free_count);
+        if (free_count > 0) {
+            Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> order; // order[新编号] = 旧编号
+            Eigen::AMDOrdering<int>()(block_pattern, order);
+            for (int k = 0; k < free_count; ++k) {
+                rank[order.indices()(k)] = k;
+            }
+        }
+        variable_.assign(nodes, -1);
+        for (std::size_t i = 0; i < nodes; ++i) {
+            if (free_index[i] >= 0) {
+                variable_[i] = rank[free_index[i]];
+            }
+        }
+
+        // 2. 非对角块 (r, c)，r > c，按列排序去重
+        std::vector<std::pair<std::int64_t, std::int64_t>> blocks; // (c, r)
+        blocks.reserve(edges.size());
+        for (const Edge& edge : edges) {
+            std::int64_t a = variable_[edge.from], b = variable_[edge.to];
+            if (a >= 0 && b >= 0) {
+                blocks.emplace_back(std::min(a, b), std::max(a, b));
+            }
+        }
+        std::sort(blocks.begin(), blocks.end());
+        blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+        std::vector<std::size_t> column_start(static_cast<std::size_t>(free_count) + 1, 0);
+        for (const auto& block : blocks) {
+            ++column_start[block.first + 1];
+        }
+        for (int c = 0; c < free_count; ++c) {
+            column_start[c + 1] += column_start[c];
+        }
+
+        // 3. 标量下三角模式：每列先是对角块的下半部分，再是按行排列的非对角块
+        const std::int64_t n = 6 * static_cast<std::int64_t>(free_count);
+        hessian_ = Eigen::SparseMatrix<double>(n, n);
+        std::vector<int> outer(n + 1, 0);
+        for (int c = 0; c < free_count; ++c) {
+            int off_blocks = static_cast<int>(column_start[c + 1] - column_start[c]);
+            for (int k = 0; k < 6; ++k) {
+                outer[6 * c + k + 1] = outer[6 * c + k] + (6 - k) + 6 * off_blocks;
+            }
+        }
+        hessian_.resizeNonZeros(outer[n]);
+        std::copy(outer.begin(), outer.end(), hessian_.outerIndexPtr());
+        int* inner = hessian_.innerIndexPtr();
+        for (int c = 0; c < free_count; ++c) {
+            for (int k = 0; k < 6; ++k) {
+                int position = outer[6 * c + k];
+                for (int m = k; m < 6; ++m) {
+                    inner[position++] = 6 * c + m;
+                }
+                for (std::size_t b = column_start[c]; b < column_start[c + 1]; ++b) {
+                    for (int m = 0; m < 6; ++m) {
+                        inner[position++] = static_cast<int>(6 * blocks[b].second + m);
+                    }
+                }
+            }
+        }
+        std::fill(hessian_.valuePtr(), hessian_.valuePtr() + hessian_.nonZeros(), 0.0);
+        diagonal_offset_.assign(outer.begin(), outer.end() - 1); // 每列第一个元素就是对角元
+        diagonal_.resize(n);
+        gradient_.resize(n);
+
+        // 4. 边的槽位与贪心着色
+        std::vector<EdgeSlot> slots;
+        std::vector<std::size_t> color_of;
+        std::vector<std::vector<std::uint32_t>> node_colors(free_count);
+        std::size_t colors = 0;
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            EdgeSlot slot;
+            slot.edge = e;
+            slot.from = variable_[edges[e].from];
+            slot.to = variable_[edges[e].to];
+            if (slot.from < 0 && slot.to < 0) {
+                continue; // 两端都固定，只贡献常数代价
+            }
+            if (slot.from >= 0 && slot.to >= 0) {
+                std::pair<std::int64_t, std::int64_t> key { std::min(slot.from, slot.to),
+                    std::max(slot.from, slot.to) };
+                auto it = std::lower_bound(blocks.begin() + column_start[key.first],
+                    blocks.begin() + column_start[key.first + 1], key);
+                slot.cross = static_cast<std::int64_t>(it - blocks.begin()) - column_start[key.first];
+            }
+            auto used = [&](std::uint32_t color) {
+                for (std::int64_t v : { slot.from, slot.to }) {
+                    if (v >= 0) {
+                        const auto& list = node_colors[v];
+                        if (std::find(list.begin(), list.end(), color) != list.end()) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            };
+            std::uint32_t color = 0;
+            while (used(color)) {
+                ++color;
+            }
+            for (std::int64_t v : { slot.from, slot.to }) {
+                if (v >= 0) {
+                    node_colors[v].push_back(color);
+                }
+            }
+            colors = std::max<std::size_t>(colors, color + 1);
+            slots.push_back(slot);
+            color_of.push_back(color);
+        }
+        color_start_.assign(colors + 1, 0);
+        for (std::size_t color : color_of) {
+            ++color_start_[color + 1];
+        }
+        for (std::size_t c = 0; c < colors; ++c) {
+            color_start_[c + 1] += color_start_[c];
+        }
+        slots_.resize(slots.size());
+        std::vector<std::size_t> fill(color_start_.begin(), color_start_.end() - 1);
+        for (std::size_t s = 0; s < slots.size(); ++s) {
+            slots_[fill[color_of[s]]++] = slots[s]; // 颜色内保持边的原始顺序
+        }
+
+        // 5. 符号分解
+        if (n > 0) {
+            solver_.analyzePattern(hessian_);
+        }
+        analyzed_ = true;
+        structure_edges_ = graph_.edgeCount();
+        structure_fixed_ = graph_.fixedFlags();
+    }
+
+    /**
+     * @brief 下三角块 (r, c) 中第 k 列的起点；position 为非对角块在块列中的序号，对角块为 -1
+     */
+    double* blockColumn(std::int64_t c, std::int64_t position, int k)
+    {
+        double* column = hessian_.valuePtr() + hessian_.outerIndexPtr()[6 * c + k];
+        return position < 0 ? column - k : column + (6 - k) + 6 * position;
+    }
+
+    void addDiagonalBlock(std::int64_t c, const Matrix6d& block)
+    {
+        for (int k = 0; k < 6; ++k) {
+            double* column = blockColumn(c, -1, k);
+            for (int m = k; m < 6; ++m) {
+                column[m] += block(m, k);
+            }
+        }
+    }
+
+    void addOffDiagonalBlock(std::int64_t c, std::int64_t position, const Matrix6d& block)
+    {
+        for (int k = 0; k < 6; ++k) {
+            double* column = blockColumn(c, position, k);
+            for (int m = 0; m < 6; ++m) {
+                column[m] += block(m, k);
+            }
+        }
+    }
+
+    void accumulate(const EdgeSlot& slot, const std::vector<Pose>& poses)
+    {
+        const Edge& edge = graph_.edges()[slot.edge];
+        const Pose& from = poses[edge.from];
+        const Pose& to = poses[edge.to];
+        Vector6d e = edgeResidual(from, to, edge.measurement);
+        Matrix6d w = options_.loss.weight(e.dot(edge.information * e)) * edge.information;
+        // e(T_from Exp(δi), T_to Exp(δj)) ≈ e - Jr⁻¹(e) Ad(T_to⁻¹ T_from) δi + Jr⁻¹(e) δj
+        Matrix6d j_to = lie::rightJacobianInverseSE3(e);
+        Matrix6d j_from = -j_to * lie::adjoint(to.inverse() * from);
+        Vector6d we = w * e;
+        Matrix6d w_from = w * j_from;
+        if (slot.from >= 0) {
+            addDiagonalBlock(slot.from, j_from.transpose() * w_from);
+            gradient_.segment<6>(6 * slot.from) += j_from.transpose() * we;
+        }
+        if (slot.to >= 0) {
+            addDiagonalBlock(slot.to, j_to.transpose() * w * j_to);
+            gradient_.segment<6>(6 * slot.to) += j_to.transpose() * we;
+        }
+        if (slot.cross >= 0) {
+            Matrix6d to_from = j_to.transpose() * w_from; // H(to, from)
+            if (slot.to > slot.from) {
+                addOffDiagonalBlock(slot.from, slot.cross, to_from);
+            } else {
+                addOffDiagonalBlock(slot.to, slot.cross, to_from.transpose());
+            }
+        }
+    }
+
+    void assemble(const std::vector<Pose>& poses, ThreadPool& pool)
+    {
+        double* values = hessian_.valuePtr();
+        pool.parallelFor(0, static_cast<std::size_t>(hessian_.nonZeros()), [&](std::size_t lo, std::size_t hi) {
+            std::fill(values + lo, values + hi, 0.0);
+        });
+        gradient_.setZero();
+        for (std::size_t color = 0; color + 1 < color_start_.size(); ++color) {
+            pool.parallelFor(color_start_[color], color_start_[color + 1], [&](std::size_t lo, std::size_t hi) {
+                for (std::size_t s = lo; s < hi; ++s) {
+                    accumulate(slots_[s], poses);
+                }
+            });
+        }
+        for (std::size_t j = 0; j < diagonal_offset_.size(); ++j) {
+            diagonal_(j) = values[diagonal_offset_[j]];
+        }
+    }
+
+    /**
+     * @brief 对角线设为 diag(H)(1 + λ)，λ = 0 时恢复原值
+     */
+    void setDamping(double lambda)
+    {
+        double* values = hessian_.valuePtr();
+        for (std::size_t j = 0; j < diagonal_offset_.size(); ++j) {
+            values[diagonal_offset_[j]] = diagonal_(j) + lambda * std::max(diagonal_(j), 1e-9);
+        }
+    }
+
+    void applyUpdate(const std::vector<Pose>& poses, std::vector<Pose>& candidate, ThreadPool& pool) const
+    {
+        pool.parallelFor(0, poses.size(), [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                if (variable_[i] < 0) {
+                    candidate[i] = poses[i];
+                    continue;
+                }
+                candidate[i] = poses[i] * lie::expSE3(update_.segment<6>(6 * variable_[i]));
+                candidate[i].orientation.normalize();
+            }
+        });
+    }
+
+    double totalCost(const std::vector<Pose>& poses, ThreadPool& pool) const
+    {
+        // 固定分块、按块顺序求和：与线程数无关
+        constexpr std::size_t kChunks = 64;
+        const std::vector<Edge>& edges = graph_.edges();
+        std::size_t n = edges.size();
+        std::vector<double> partial(kChunks, 0.0);
+        pool.parallelFor(0, kChunks, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c) {
+                for (std::size_t e = n * c / kChunks; e < n * (c + 1) / kChunks; ++e) {
+                    Vector6d r = edgeResidual(poses[edges[e].from], poses[edges[e].to], edges[e].measurement);
+                    partial[c] += options_.loss.cost(r.dot(edges[e].information * r));
+                }
+            }
+        }, 1);
+        double sum = 0.0;
+        for (double p : partial) {
+            sum += p;
+        }
+        return 0.5 * sum;
+    }
+
+    PoseGraph& graph_;
+    OptimizerOptions options_;
+
+    bool analyzed_ { false };
+    std::size_t structure_edges_ { 0 };
+    std::vector<bool> structure_fixed_;
+    std::vector<std::int64_t> variable_; // 节点 -> 变量块编号，固定节点为 -1
+    std::vector<EdgeSlot> slots_; // 按颜色分组
+    std::vector<std::size_t> color_start_;
+    std::vector<int> diagonal_offset_;
+
+    Eigen::SparseMatrix<double> hessian_; // 下三角
+    Eigen::VectorXd diagonal_; // 未加阻尼的对角线
+    Eigen::VectorXd gradient_;
+    Eigen::VectorXd update_;
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::NaturalOrdering<int>> solver_;
+};
+
+} // namespace robotics::graph
@@ -0,0 +1,670 @@
+#pragma once
+/**
+ * @file rotation_kernels.hpp
+ * @brief 旋转表示之间的批量转换内核：四元数 ↔ 旋转矩阵、四元数 ↔ 旋转向量、四元数 ↔ ZYX 欧拉角。
+ *
+ * 数据按分量分开存放（SoA）：一个 ymm 正好装下 4 个元素的同一分量，读写都是连续的整块加载，不需要转置。
+ * 每个内核的参数是分量指针数组，in[k][i] 是第 i 个元素的第 k 个分量：
+ *   四元数 (w, x, y, z)，旋转矩阵按行主序的 9 个元素，旋转向量 (x, y, z)，欧拉角 (roll, pitch, yaw)。
+ *
+ * 标量实现逐个元素调用 pose.hpp 中的转换函数，是参考版本。AVX2 实现：
+ * - 纯代数的转换（四元数 → 矩阵、矩阵 → 四元数）与标量实现的运算顺序相同，且编译时不开 FMA，结果逐位相同；
+ * - 矩阵 → 四元数用 Shepperd 方法，四种情况的分量都算出来，按通道用比较掩码和 blendv 选择，没有分支；
+ * - sin/cos/atan2 用 Cephes 的多项式/有理逼近，与 libm 相差几个 ulp。
+ */
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "pose.hpp"
+
+#ifdef PRESLAM_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace robotics {
+
+/**
+ * @brief 按分量存放的一组四元数
+ */
+struct QuaternionSoA {
+    std::vector<double> w, x, y, z;
+
+    QuaternionSoA() = default;
+    explicit QuaternionSoA(const std::vector<Quaternion>& quaternions)
+    {
+        resize(quaternions.size());
+        for (std::size_t i = 0; i < quaternions.size(); ++i) {
+            set(i, quaternions[i]);
+        }
+    }
+
+    std::size_t size() const { return w.size(); }
+
+    void resize(std::size_t n)
+    {
+        w.resize(n);
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+    }
+
+    Quaternion operator[](std::size_t i) const { return { w[i], x[i], y[i], z[i] }; }
+
+    void set(std::size_t i, const Quaternion& q)
+    {
+        w[i] = q.w;
+        x[i] = q.x;
+        y[i] = q.y;
+        z[i] = q.z;
+    }
+
+    std::array<const double*, 4> data() const { return { w.data(), x.data(), y.data(), z.data() }; }
+    std::array<double*, 4> data() { return { w.data(), x.data(), y.data(), z.data() }; }
+};
+
+/**
+ * @brief 按分量存放的一组三维向量（旋转向量或欧拉角）
+ */
+struct Vector3SoA {
+    std::vector<double> x, y, z;
+
+    Vector3SoA() = default;
+    explicit Vector3SoA(const std::vector<Vector3>& vectors)
+    {
+        resize(vectors.size());
+        for (std::size_t i = 0; i < vectors.size(); ++i) {
+            set(i, vectors[i]);
+        }
+    }
+
+    std::size_t size() const { return x.size(); }
+
+    void resize(std::size_t n)
+    {
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+    }
+
+    Vector3 operator[](std::size_t i) const { return { x[i], y[i], z[i] }; }
+
+    void set(std::size_t i, const Vector3& v)
+    {
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+
+    std::array<const double*, 3> data() const { return { x.data(), y.data(), z.data() }; }
+    std::array<double*, 3> data() { return { x.data(), y.data(), z.data() }; }
+};
+
+/**
+ * @brief 按元素存放的一组旋转矩阵：m[k] 是所有矩阵的第 k 个元素（行主序）
+ */
+struct RotationMatrixSoA {
+    std::array<std::vector<double>, 9> m;
+
+    std::size_t size() const { return m[0].size(); }
+
+    void resize(std::size_t n)
+    {
+        for (auto& element : m) {
+            element.resize(n);
+        }
+    }
+
+    RotationMatrix operator[](std::size_t i) const
+    {
+        RotationMatrix r;
+        for (int k = 0; k < 9; ++k) {
+            r.m[k] = m[k][i];
+        }
+        return r;
+    }
+
+    void set(std::size_t i, const RotationMatrix& r)
+    {
+        for (int k = 0; k < 9; ++k) {
+            m[k][i] = r.m[k];
+        }
+    }
+
+    std::array<const double*, 9> data() const
+    {
+        std::array<const double*, 9> result;
+        for (int k = 0; k < 9; ++k) {
+            result[k] = m[k].data();
+        }
+        return result;
+    }
+
+    std::array<double*, 9> data()
+    {
+        std::array<double*, 9> result;
+        for (int k = 0; k < 9; ++k) {
+            result[k] = m[k].data();
+        }
+        return result;
+    }
+};
+
+} // namespace robotics
+
+namespace robotics::kernels {
+
+/**
+ * @brief 批量转换内核的签名：in / out 是分量指针数组，转换 n 个元素
+ */
+using RotationConversion = void(const double* const* in, double* const* out, std::size_t n);
+
+namespace detail {
+
+    // --- 标量参考实现 ---
+
+    inline void quaternionToMatrixScalar(const double* const* q, double* const* r, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            RotationMatrix matrix(Quaternion { q[0][i], q[1][i], q[2][i], q[3][i] });
+            for (int k = 0; k < 9; ++k) {
+                r[k][i] = matrix.m[k];
+            }
+        }
+    }
+
+    inline void matrixToQuaternionScalar(const double* const* r, double* const* q, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            RotationMatrix matrix;
+            for (int k = 0; k < 9; ++k) {
+                matrix.m[k] = r[k][i];
+            }
+            Quaternion result = matrix.toQuaternion();
+            q[0][i] = result.w;
+            q[1][i] = result.x;
+            q[2][i] = result.y;
+            q[3][i] = result.z;
+        }
+    }
+
+    inline void rotationVectorToQuaternionScalar(const double* const* v, double* const* q, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            Quaternion result = Quaternion::fromRotationVector({ v[0][i], v[1][i], v[2][i] });
+            q[0][i] = result.w;
+            q[1][i] = result.x;
+            q[2][i] = result.y;
+            q[3][i] = result.z;
+        }
+    }
+
+    inline void quaternionToRotationVectorScalar(const double* const* q, double* const* v, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            Vector3 result = Quaternion { q[0][i], q[1][i], q[2][i], q[3][i] }.toRotationVector();
+            v[0][i] = result.x;
+            v[1][i] = result.y;
+            v[2][i] = result.z;
+        }
+    }
+
+    inline void eulerToQuaternionScalar(const double* const* e, double* const* q, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            Quaternion result = Quaternion::fromEuler(e[0][i], e[1][i], e[2][i]);
+            q[0][i] = result.w;
+            q[1][i] = result.x;
+            q[2][i] = result.y;
+            q[3][i] = result.z;
+        }
+    }
+
+    inline void quaternionToEulerScalar(const double* const* q, double* const* e, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            Vector3 result = Quaternion { q[0][i], q[1][i], q[2][i], q[3][i] }.toEuler();
+            e[0][i] = result.x;
+            e[1][i] = result.y;
+            e[2][i] = result.z;
+        }
+    }
+
+#ifdef PRESLAM_X86_DISPATCH
+    /**
+     * @brief 向量化主循环之后剩下的 n 个元素交给标量实现
+     */
+    template <std::size_t In, std::size_t Out>
+    void convertTail(RotationConversion* scalar, const double* const* in, double* const* out, std::size_t offset,
+        std::size_t n)
+    {
+        std::array<const double*, In> tail_in;
+        std::array<double*, Out> tail_out;
+        for (std::size_t k = 0; k < In; ++k) {
+            tail_in[k] = in[k] + offset;
+        }
+        for (std::size_t k = 0; k < Out; ++k) {
+            tail_out[k] = out[k] + offset;
+        }
+        scalar(tail_in.data(), tail_out.data(), n);
+    }
+
+    /**
+     * @brief 4 个通道的 sin 与 cos（Cephes sin.c）
+     *
+     * 按 k = round(|x| / (π/2)) 约化到 r = |x| - k π/2 ∈ [-π/4, π/4]，π/2 拆成三段（Cody-Waite），
+     * |x| < 2^20 时约化没有可见的舍入误差。r 上的 sin、cos 是两个 6 项多项式，再按 k mod 4 交换和变号。
+     */
+    __attribute__((target("avx2,fma"))) inline void sinCosAvx2(__m256d x, __m256d& sin_x, __m256d& cos_x)
+    {
+        const __m256d sign_bit = _mm256_set1_pd(-0.0);
+        __m256d ax = _mm256_andnot_pd(sign_bit, x);
+        __m256d k = _mm256_round_pd(_mm256_mul_pd(ax, _mm256_set1_pd(0.63661977236758134308)),
+            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d r = _mm256_fnmadd_pd(k, _mm256_set1_pd(1.57079632673412561417e+00), ax);
+        r = _mm256_fnmadd_pd(k, _mm256_set1_pd(6.07710050630396597660e-11), r);
+        r = _mm256_fnmadd_pd(k, _mm256_set1_pd(2.02226624879595063154e-21), r);
+        __m256d z = _mm256_mul_pd(r, r);
+
+        __m256d ps = _mm256_set1_pd(1.58962301576546568060e-10);
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(-2.50507477628578072866e-8));
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(2.75573136213857245213e-6));
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(-1.98412698295895385996e-4));
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(8.33333333332211858878e-3));
+        ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(-1.66666666666666307295e-1));
+        __m256d s = _mm256_fmadd_pd(_mm256_mul_pd(r, z), ps, r);
+
+        __m256d pc = _mm256_set1_pd(-1.13585365213876817300e-11);
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(2.08757008419747316778e-9));
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(-2.75573141792967388112e-7));
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(2.48015872888517045348e-5));
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(-1.38888888888730564116e-3));
+        pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(4.16666666666665929218e-2));
+        __m256d c = _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+        // k mod 4：奇数象限交换 sin/cos，象限 2、3 的 sin 变号，象限 1、2 的 cos 变号
+        __m256d quadrant = _mm256_fnmadd_pd(_mm256_set1_pd(4.0),
+            _mm256_floor_pd(_mm256_mul_pd(k, _mm256_set1_pd(0.25))), k);
+        __m256d upper = _mm256_cmp_pd(quadrant, _mm256_set1_pd(2.0), _CMP_GE_OQ);
+        __m256d odd = _mm256_cmp_pd(_mm256_sub_pd(quadrant, _mm256_and_pd(upper, _mm256_set1_pd(2.0))),
+            _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+        __m256d sin_r = _mm256_blendv_pd(s, c, odd);
+        __m256d cos_r = _mm256_blendv_pd(c, s, odd);
+        sin_x = _mm256_xor_pd(sin_r, _mm256_xor_pd(_mm256_and_pd(upper, sign_bit), _mm256_and_pd(x, sign_bit)));
+        cos_x = _mm256_xor_pd(cos_r, _mm256_and_pd(_mm256_xor_pd(upper, odd), sign_bit));
+    }
+
+    /**
+     * @brief 4 个通道的 atan2(y, x)（Cephes atan.c），符号零和象限的处理与 std::atan2 相同
+     *
+     * 先求 t = min(|x|, |y|) / max(|x|, |y|) ∈ [0, 1] 的 atan，t > 0.66 时改求 π/4 + atan((t - 1) / (t + 1))，
+     * 逼近是 4/5 次的有理函数；再按 |y| > |x|、x 的符号、y 的符号映射到所在象限。
+     */
+    __attribute__((target("avx2,fma"))) inline __m256d atan2Avx2(__m256d y, __m256d x)
+    {
+        const __m256d sign_bit = _mm256_set1_pd(-0.0), one = _mm256_set1_pd(1.0);
+        const __m256d more_bits = _mm256_set1_pd(6.123233995736765886130e-17); // π/2 超出双精度的部分
+        __m256d ax = _mm256_andnot_pd(sign_bit, x);
+        __m256d ay = _mm256_andnot_pd(sign_bit, y);
+        __m256d num = _mm256_min_pd(ax, ay);
+        __m256d den = _mm256_max_pd(ax, ay);
+        __m256d t = _mm256_div_pd(num, den);
+        t = _mm256_blendv_pd(t, _mm256_setzero_pd(), _mm256_cmp_pd(den, _mm256_setzero_pd(), _CMP_EQ_OQ));
+
+        __m256d big = _mm256_cmp_pd(t, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+        __m256d u = _mm256_blendv_pd(t, _mm256_div_pd(_mm256_sub_pd(t, one), _mm256_add_pd(t, one)), big);
+        __m256d z = _mm256_mul_pd(u, u);
+        __m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.615753718733365076637e1));
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-7.500855792314704667340e1));
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.228866684490136173410e2));
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-6.485021904942025371773e1));
+        __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+        q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.650270098316988542046e2));
+        q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.328810604912902668951e2));
+        q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.853903996359136964868e2));
+        q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.945506571482613964425e2));
+        __m256d a = _mm256_fmadd_pd(_mm256_mul_pd(u, z), _mm256_div_pd(p, q), u);
+        a = _mm256_blendv_pd(a,
+            _mm256_add_pd(_mm256_set1_pd(7.85398163397448309616e-1),
+                _mm256_fmadd_pd(_mm256_set1_pd(0.5), more_bits, a)),
+            big);
+
+        // |y| > |x|：π/2 - a；x 为负（含 -0）：π - a；最后带上 y 的符号
+        a = _mm256_blendv_pd(a,
+            _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.57079632679489661923), a), more_bits),
+            _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+        a = _mm256_blendv_pd(a,
+            _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(3.14159265358979323846), a),
+                _mm256_add_pd(more_bits, more_bits)),
+            x);
+        return _mm256_xor_pd(a, _mm256_and_pd(y, sign_bit));
+    }
+
+    /**
+     * @brief 把 (-2π, 2π] 内的角度折回 (-π, π]
+     */
+    __attribute__((target("avx2,fma"))) inline __m256d wrapAngleAvx2(__m256d angle)
+    {
+        const __m256d pi = _mm256_set1_pd(M_PI), two_pi = _mm256_set1_pd(2.0 * M_PI);
+        angle = _mm256_blendv_pd(angle, _mm256_sub_pd(angle, two_pi), _mm256_cmp_pd(angle, pi, _CMP_GT_OQ));
+        return _mm256_blendv_pd(angle, _mm256_add_pd(angle, two_pi),
+            _mm256_cmp_pd(angle, _mm256_set1_pd(-M_PI), _CMP_LE_OQ));
+    }
+
+    // 只开 AVX2 不开 FMA：编译器不会把乘加合并成 FMA（包括内联进来的标量尾部），与标量实现逐位相同
+    __attribute__((target("avx2"))) inline void quaternionToMatrixAvx2(const double* const* q,
+        double* const* r, std::size_t n)
+    {
+        const __m256d one = _mm256_set1_pd(1.0), two = _mm256_set1_pd(2.0);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d w = _mm256_loadu_pd(q[0] + i), x = _mm256_loadu_pd(q[1] + i), y = _mm256_loadu_pd(q[2] + i),
+                    z = _mm256_loadu_pd(q[3] + i);
+            __m256d xx = _mm256_mul_pd(x, x), yy = _mm256_mul_pd(y, y), zz = _mm256_mul_pd(z, z);
+            __m256d xy = _mm256_mul_pd(x, y), xz = _mm256_mul_pd(x, z), yz = _mm256_mul_pd(y, z);
+            __m256d wx = _mm256_mul_pd(w, x), wy = _mm256_mul_pd(w, y), wz = _mm256_mul_pd(w, z);
+            _mm256_storeu_pd(r[0] + i, _mm256_sub_pd(one, _mm256_mul_pd(two, _mm256_add_pd(yy, zz))));
+            _mm256_storeu_pd(r[1] + i, _mm256_mul_pd(two, _mm256_sub_pd(xy, wz)));
+            _mm256_storeu_pd(r[2] + i, _mm256_mul_pd(two, _mm256_add_pd(xz, wy)));
+            _mm256_storeu_pd(r[3] + i, _mm256_mul_pd(two, _mm256_add_pd(xy, wz)));
+            _mm256_storeu_pd(r[4] + i, _mm256_sub_pd(one, _mm256_mul_pd(two, _mm256_add_pd(xx, zz))));
+            _mm256_storeu_pd(r[5] + i, _mm256_mul_pd(two, _mm256_sub_pd(yz, wx)));
+            _mm256_storeu_pd(r[6] + i, _mm256_mul_pd(two, _mm256_sub_pd(xz, wy)));
+            _mm256_storeu_pd(r[7] + i, _mm256_mul_pd(two, _mm256_add_pd(yz, wx)));
+            _mm256_storeu_pd(r[8] + i, _mm256_sub_pd(one, _mm256_mul_pd(two, _mm256_add_pd(xx, yy))));
+        }
+        if (i < n) {
+            convertTail<4, 9>(quaternionToMatrixScalar, q, r, i, n - i);
+        }
+    }
+
+    /**
+     * @brief AVX2 Shepperd 方法：与 RotationMatrix::toQuaternion 的选择顺序和运算顺序相同（同样不开 FMA）
+     */
+    __attribute__((target("avx2"))) inline void matrixToQuaternionAvx2(const double* const* r,
+        double* const* q, std::size_t n)
+    {
+        const __m256d one = _mm256_set1_pd(1.0), two = _mm256_set1_pd(2.0), half = _mm256_set1_pd(0.5);
+        const __m256d quarter = _mm256_set1_pd(0.25), sign_bit = _mm256_set1_pd(-0.0);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d m[9];
+            for (int k = 0; k < 9; ++k) {
+                m[k] = _mm256_loadu_pd(r[k] + i);
+            }
+            __m256d trace = _mm256_add_pd(_mm256_add_pd(m[0], m[4]), m[8]);
+
+            // 与标量实现的 if / else if 链相同：c0 迹最大，c1 m00 最大，c2 m11 最大，其余为 m22
+            __m256d c0 = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(trace, m[0], _CMP_GE_OQ),
+                                           _mm256_cmp_pd(trace, m[4], _CMP_GE_OQ)),
+                _mm256_cmp_pd(trace, m[8], _CMP_GE_OQ));
+            __m256d c1 = _mm256_andnot_pd(c0,
+                _mm256_and_pd(_mm256_cmp_pd(m[0], m[4], _CMP_GE_OQ), _mm256_cmp_pd(m[0], m[8], _CMP_GE_OQ)));
+            __m256d c2 = _mm256_andnot_pd(_mm256_or_pd(c0, c1), _mm256_cmp_pd(m[4], m[8], _CMP_GE_OQ));
+            __m256d largest = _mm256_blendv_pd(
+                _mm256_blendv_pd(_mm256_blendv_pd(m[8], m[4], c2), m[0], c1), trace, c0);
+
+            __m256d big = _mm256_mul_pd(half,
+                _mm256_sqrt_pd(_mm256_add_pd(one, _mm256_sub_pd(_mm256_mul_pd(two, largest), trace))));
+            __m256d s = _mm256_div_pd(quarter, big);
+            __m256d a = _mm256_mul_pd(_mm256_sub_pd(m[7], m[5]), s);
+            __m256d b = _mm256_mul_pd(_mm256_sub_pd(m[2], m[6]), s);
+            __m256d c = _mm256_mul_pd(_mm256_sub_pd(m[3], m[1]), s);
+            __m256d d = _mm256_mul_pd(_mm256_add_pd(m[1], m[3]), s);
+            __m256d e = _mm256_mul_pd(_mm256_add_pd(m[2], m[6]), s);
+            __m256d f = _mm256_mul_pd(_mm256_add_pd(m[5], m[7]), s);
+
+            // 各分量按情况 (c0, c1, c2, c3) 取值：
+            //   w: big a b c   x: a big d e   y: b d big f   z: c e f big
+            __m256d w = _mm256_blendv_pd(_mm256_blendv_pd(_mm256_blendv_pd(c, b, c2), a, c1), big, c0);
+            __m256d x = _mm256_blendv_pd(_mm256_blendv_pd(_mm256_blendv_pd(e, d, c2), big, c1), a, c0);
+            __m256d y = _mm256_blendv_pd(_mm256_blendv_pd(_mm256_blendv_pd(f, big, c2), d, c1), b, c0);
+            __m256d z = _mm256_blendv_pd(_mm256_blendv_pd(_mm256_blendv_pd(big, f, c2), e, c1), c, c0);
+
+            // 取 w >= 0 的一支
+            __m256d flip = _mm256_and_pd(_mm256_cmp_pd(w, _mm256_setzero_pd(), _CMP_LT_OQ), sign_bit);
+            _mm256_storeu_pd(q[0] + i, _mm256_xor_pd(w, flip));
+            _mm256_storeu_pd(q[1] + i, _mm256_xor_pd(x, flip));
+            _mm256_storeu_pd(q[2] + i, _mm256_xor_pd(y, flip));
+            _mm256_storeu_pd(q[3] + i, _mm256_xor_pd(z, flip));
+        }
+        if (i < n) {
+            convertTail<9, 4>(matrixToQuaternionScalar, r, q, i, n - i);
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) inline void rotationVectorToQuaternionAvx2(const double* const* v,
+        double* const* q, std::size_t n)
+    {
+        const __m256d half = _mm256_set1_pd(0.5), one = _mm256_set1_pd(1.0);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_loadu_pd(v[0] + i), y = _mm256_loadu_pd(v[1] + i), z = _mm256_loadu_pd(v[2] + i);
+            __m256d angle = _mm256_sqrt_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+            __m256d sin_half, cos_half;
+            sinCosAvx2(_mm256_mul_pd(half, angle), sin_half, cos_half);
+            __m256d s = _mm256_div_pd(sin_half, angle);
+
+            // 小角度：(1, v / 2) 归一化，与 fromRotationVector 相同
+            __m256d hx = _mm256_mul_pd(half, x), hy = _mm256_mul_pd(half, y), hz = _mm256_mul_pd(half, z);
+            __m256d norm = _mm256_sqrt_pd(_mm256_add_pd(
+                _mm256_add_pd(_mm256_add_pd(one, _mm256_mul_pd(hx, hx)), _mm256_mul_pd(hy, hy)),
+                _mm256_mul_pd(hz, hz)));
+            __m256d small = _mm256_cmp_pd(angle, _mm256_set1_pd(1e-8), _CMP_LT_OQ);
+            _mm256_storeu_pd(q[0] + i, _mm256_blendv_pd(cos_half, _mm256_div_pd(one, norm), small));
+            _mm256_storeu_pd(q[1] + i, _mm256_blendv_pd(_mm256_mul_pd(x, s), _mm256_div_pd(hx, norm), small));
+            _mm256_storeu_pd(q[2] + i, _mm256_blendv_pd(_mm256_mul_pd(y, s), _mm256_div_pd(hy, norm), small));
+            _mm256_storeu_pd(q[3] + i, _mm256_blendv_pd(_mm256_mul_pd(z, s), _mm256_div_pd(hz, norm), small));
+        }
+        if (i < n) {
+            convertTail<3, 4>(rotationVectorToQuaternionScalar, v, q, i, n - i);
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) inline void quaternionToRotationVectorAvx2(const double* const* q,
+        double* const* v, std::size_t n)
+    {
+        const __m256d two = _mm256_set1_pd(2.0), sign_bit = _mm256_set1_pd(-0.0);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d w = _mm256_loadu_pd(q[0] + i);
+            // q 与 -q 表示同一旋转，取 w >= 0 的一支
+            __m256d flip = _mm256_and_pd(_mm256_cmp_pd(w, _mm256_setzero_pd(), _CMP_LT_OQ), sign_bit);
+            w = _mm256_xor_pd(w, flip);
+            __m256d x = _mm256_xor_pd(_mm256_loadu_pd(q[1] + i), flip);
+            __m256d y = _mm256_xor_pd(_mm256_loadu_pd(q[2] + i), flip);
+            __m256d z = _mm256_xor_pd(_mm256_loadu_pd(q[3] + i), flip);
+            __m256d sin_half = _mm256_sqrt_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+            __m256d scale = _mm256_div_pd(_mm256_mul_pd(two, atan2Avx2(sin_half, w)), sin_half);
+            scale = _mm256_blendv_pd(scale, _mm256_div_pd(two, w),
+                _mm256_cmp_pd(sin_half, _mm256_set1_pd(1e-8), _CMP_LT_OQ));
+            _mm256_storeu_pd(v[0] + i, _mm256_mul_pd(x, scale));
+            _mm256_storeu_pd(v[1] + i, _mm256_mul_pd(y, scale));
+            _mm256_storeu_pd(v[2] + i, _mm256_mul_pd(z, scale));
+        }
+        if (i < n) {
+            convertTail<4, 3>(quaternionToRotationVectorScalar, q, v, i, n - i);
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) inline void eulerToQuaternionAvx2(const double* const* e,
+        double* const* q, std::size_t n)
+    {
+        const __m256d half = _mm256_set1_pd(0.5);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d sr, cr, sp, cp, sy, cy;
+            sinCosAvx2(_mm256_mul_pd(half, _mm256_loadu_pd(e[0] + i)), sr, cr);
+            sinCosAvx2(_mm256_mul_pd(half, _mm256_loadu_pd(e[1] + i)), sp, cp);
+            sinCosAvx2(_mm256_mul_pd(half, _mm256_loadu_pd(e[2] + i)), sy, cy);
+            __m256d crcp = _mm256_mul_pd(cr, cp), srsp = _mm256_mul_pd(sr, sp);
+            __m256d srcp = _mm256_mul_pd(sr, cp), crsp = _mm256_mul_pd(cr, sp);
+            _mm256_storeu_pd(q[0] + i, _mm256_add_pd(_mm256_mul_pd(crcp, cy), _mm256_mul_pd(srsp, sy)));
+            _mm256_storeu_pd(q[1] + i, _mm256_sub_pd(_mm256_mul_pd(srcp, cy), _mm256_mul_pd(crsp, sy)));
+            _mm256_storeu_pd(q[2] + i, _mm256_add_pd(_mm256_mul_pd(crsp, cy), _mm256_mul_pd(srcp, sy)));
+            _mm256_storeu_pd(q[3] + i, _mm256_sub_pd(_mm256_mul_pd(crcp, sy), _mm256_mul_pd(srsp, cy)));
+        }
+        if (i < n) {
+            convertTail<3, 4>(eulerToQuaternionScalar, e, q, i, n - i);
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) inline void quaternionToEulerAvx2(const double* const* q,
+        double* const* e, std::size_t n)
+    {
+        const __m256d half = _mm256_set1_pd(0.5), two = _mm256_set1_pd(2.0);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d w = _mm256_loadu_pd(q[0] + i), x = _mm256_loadu_pd(q[1] + i), y = _mm256_loadu_pd(q[2] + i),
+                    z = _mm256_loadu_pd(q[3] + i);
+            // 与 Quaternion::toEuler 相同：r - y、r + y 各一次 atan2，pitch 由 sin(p) 与两个模长之积求 atan2
+            __m256d wpy = _mm256_add_pd(w, y), wmy = _mm256_sub_pd(w, y);
+            __m256d xmz = _mm256_sub_pd(x, z), xpz = _mm256_add_pd(x, z);
+            __m256d sum_norm = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(wpy, wpy), _mm256_mul_pd(xmz, xmz)));
+            __m256d diff_norm = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(wmy, wmy), _mm256_mul_pd(xpz, xpz)));
+            __m256d difference = _mm256_mul_pd(two, atan2Avx2(xmz, wpy));
+            __m256d sum = _mm256_mul_pd(two, atan2Avx2(xpz, wmy));
+            __m256d sin_pitch = _mm256_mul_pd(two, _mm256_sub_pd(_mm256_mul_pd(w, y), _mm256_mul_pd(z, x)));
+            __m256d pitch = atan2Avx2(sin_pitch, _mm256_mul_pd(sum_norm, diff_norm));
+            __m256d roll = wrapAngleAvx2(_mm256_mul_pd(half, _mm256_add_pd(sum, difference)));
+            __m256d yaw = wrapAngleAvx2(_mm256_mul_pd(half, _mm256_sub_pd(sum, difference)));
+            _mm256_storeu_pd(e[0] + i, roll);
+            _mm256_storeu_pd(e[1] + i, pitch);
+            _mm256_storeu_pd(e[2] + i, yaw);
+        }
+        if (i < n) {
+            convertTail<4, 3>(quaternionToEulerScalar, q, e, i, n - i);
+        }
+    }
+#endif
+
+} // namespace detail
+
+/**
+ * @brief 四元数 (w, x, y, z) → 旋转矩阵（行主序 9 个元素）
+ */
+inline const DispatchedKernel<RotationConversion> quaternion_to_matrix_kernel {
+    "quaternion_to_matrix",
+    {
+        { IsaLevel::Scalar, detail::quaternionToMatrixScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::quaternionToMatrixAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 旋转矩阵 → 四元数（Shepperd 方法，w >= 0）
+ */
+inline const DispatchedKernel<RotationConversion> matrix_to_quaternion_kernel {
+    "matrix_to_quaternion",
+    {
+        { IsaLevel::Scalar, detail::matrixToQuaternionScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::matrixToQuaternionAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 旋转向量 → 四元数（指数映射）
+ */
+inline const DispatchedKernel<RotationConversion> rotation_vector_to_quaternion_kernel {
+    "rotation_vector_to_quaternion",
+    {
+        { IsaLevel::Scalar, detail::rotationVectorToQuaternionScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::rotationVectorToQuaternionAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 四元数 → 旋转向量（对数映射，模长在 [0, π]）
+ */
+inline const DispatchedKernel<RotationConversion> quaternion_to_rotation_vector_kernel {
+    "quaternion_to_rotation_vector",
+    {
+        { IsaLevel::Scalar, detail::quaternionToRotationVectorScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::quaternionToRotationVectorAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief ZYX 欧拉角 (roll, pitch, yaw) → 四元数
+ */
+inline const DispatchedKernel<RotationConversion> euler_to_quaternion_kernel {
+    "euler_to_quaternion",
+    {
+        { IsaLevel::Scalar, detail::eulerToQuaternionScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::eulerToQuaternionAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 四元数 → ZYX 欧拉角 (roll, pitch, yaw)，pitch 在 [-π/2, π/2]
+ */
+inline const DispatchedKernel<RotationConversion> quaternion_to_euler_kernel {
+    "quaternion_to_euler",
+    {
+        { IsaLevel::Scalar, detail::quaternionToEulerScalar },
+#ifdef PRESLAM_X86_DISPATCH
+        { IsaLevel::AVX2, detail::quaternionToEulerAvx2 },
+#endif
+    }
+};
+
+/**
+ * @brief 单位四元数 → 旋转矩阵，out 调整为相同大小
+ */
+inline void quaternionsToMatrices(const QuaternionSoA& in, RotationMatrixSoA& out)
+{
+    out.resize(in.size());
+    quaternion_to_matrix_kernel(in.data().data(), out.data().data(), in.size());
+}
+
+/**
+ * @brief 旋转矩阵 → 单位四元数（w >= 0），out 调整为相同大小
+ */
+inline void matricesToQuaternions(const RotationMatrixSoA& in, QuaternionSoA& out)
+{
+    out.resize(in.size());
+    matrix_to_quaternion_kernel(in.data().data(), out.data().data(), in.size());
+}
+
+inline void rotationVectorsToQuaternions(const Vector3SoA& in, QuaternionSoA& out)
+{
+    out.resize(in.size());
+    rotation_vector_to_quaternion_kernel(in.data().data(), out.data().data(), in.size());
+}
+
+inline void quaternionsToRotationVectors(const QuaternionSoA& in, Vector3SoA& out)
+{
+    out.resize(in.size());
+    quaternion_to_rotation_vector_kernel(in.data().data(), out.data().data(), in.size());
+}
+
+/**
+ * @param in 每个元素为 (roll, pitch, yaw)
+ */
+inline void eulerToQuaternions(const Vector3SoA& in, QuaternionSoA& out)
+{
+    out.resize(in.size());
+    euler_to_quaternion_kernel(in.data().data(), out.data().data(), in.size());
+}
+
+inline void quaternionsToEuler(const QuaternionSoA& in, Vector3SoA& out)
+{
+    out.resize(in.size());
+    quaternion_to_euler_kernel(in.data().data(), out.data().data(), in.size());
+}
+
+} // namespace robotics::kernels
@@ -0,0 +1,183 @@
+#pragma once
+/**
+ * @file time_bucket_index.hpp
+ * @brief 均匀时间分桶索引：按 floor((t - t0) / dt) 直接定位区间，平均 O(1) 的时间查找。
+ *
+ * 大多数轨迹来自固定频率的源（IMU、轮速计、相机），时间戳只有很小的抖动和偶尔的丢帧，
+ * 每次查找都做一遍二分查找（a2/a3、interpolation.hpp）是浪费。
+ *
+ * 桶 b 记录时间键小于 b 的最后一个位姿的下标，查询时间键为 b 的区间左端点一定落在 [buckets[b], buckets[b+1]] 中：
+ * 范围很短（频率稳定时通常只有 0-1 个位姿）就向前线性扫描，否则在这个范围内二分查找，
+ * 因此突发的密集采样不会让查找退化成线性。时间键只依赖同一个浮点表达式，保证单调，结果与 findSegmentIndex 逐位相同。
+ *
+ * 索引不持有位姿，只记录已索引的个数；追加位姿后调用 extend() 增量地补上新的桶。
+ * 时间跨度相对位姿数过大（长时间的间隙、离群的时间戳）时，桶的宽度自动加倍并重建，桶数保持在 O(n)。
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "interpolation.hpp"
+#include "pose.hpp"
+
+namespace robotics {
+
+class TimeBucketIndex {
+public:
+    static constexpr std::size_t kMaxScan = 8; // 候选范围超过这个长度时改用二分查找
+    static constexpr std::size_t kBucketsPerPose = 4; // 桶数上限：kMinBuckets + kBucketsPerPose × 位姿数
+    static constexpr std::size_t kMinBuckets = 1024;
+
+    /**
+     * @param period 桶的宽度（秒），通常取标称采样周期
+     * @throw std::invalid_argument 如果 period 不是正的有限值
+     */
+    explicit TimeBucketIndex(double period)
+    {
+        if (!(period > 0.0) || !std::isfinite(period)) {
+            throw std::invalid_argument("Bucket period must be positive and finite");
+        }
+        period_ = period;
+        inv_period_ = 1.0 / period;
+    }
+
+    /**
+     * @brief 由位姿建立索引，桶宽取 estimatePeriod(poses)
+     */
+    template <typename Timed>
+    explicit TimeBucketIndex(const std::vector<Timed>& poses)
+        : TimeBucketIndex(estimatePeriod(poses))
+    {
+        extend(poses);
+    }
+
+    /**
+     * @brief 由前 samples 个相邻时间差的中位数估计采样周期（对丢帧和抖动不敏感）
+     * @throw std::invalid_argument 如果不足两个不同的时间戳
+     */
+    template <typename Timed>
+    static double estimatePeriod(const std::vector<Timed>& poses, std::size_t samples = 1024)
+    {
+        std::vector<double> gaps;
+        for (std::size_t i = 1; i < poses.size() && i <= samples; ++i) {
+            double gap = poses[i].time_stamp - poses[i - 1].time_stamp;
+            if (gap > 0.0) {
+                gaps.push_back(gap);
+            }
+        }
+        if (gaps.empty()) {
+            throw std::invalid_argument("At least two distinct timestamps are needed to estimate the period");
+        }
+        auto middle = gaps.begin() + static_cast<std::ptrdiff_t>(gaps.size() / 2);
+        std::nth_element(gaps.begin(), middle, gaps.end());
+        return *middle;
+    }
+
+    double period() const { return period_; }
+    std::size_t size() const { return indexed_; }
+    std::size_t bucketCount() const { return buckets_.size(); }
+
+    /**
+     * @brief 索引 poses 中新追加的位姿（下标 size() 及之后）
+     * @throw std::invalid_argument 如果 poses 比已索引的还短，或时间戳没有排序
+     */
+    template <typename Timed>
+    void extend(const std::vector<Timed>& poses)
+    {
+        if (poses.size() < indexed_) {
+            throw std::invalid_argument("Pose sequence is shorter than the indexed part");
+        }
+        if (indexed_ == 0 && !poses.empty()) {
+            origin_ = poses.front().time_stamp;
+            buckets_.assign(1, 0);
+            indexed_ = 1;
+        }
+        for (; indexed_ < poses.size(); ++indexed_) {
+            double time = poses[indexed_].time_stamp;
+            if (time < poses[indexed_ - 1].time_stamp) {
+                throw std::invalid_argument("Pose timestamps must be sorted");
+            }
+            double key = keyOf(time);
+            double limit = static_cast<double>(kMinBuckets + kBucketsPerPose * (indexed_ + 1));
+            if (!(key < limit)) {
+                coarsen(poses, key / limit);
+                key = keyOf(time);
+            }
+            // 键落在 (上一个位姿的键, key] 的桶，其“键更小的最后一个位姿”都是 indexed_ - 1
+            buckets_.resize(static_cast<std::size_t>(key) + 1, indexed_ - 1);
+        }
+    }
+
+    /**
+     * @brief 与 findSegmentIndex(poses, target_time) 相同：返回 i 使 poses[i].t <= target < poses[i+1].t
+     * @param poses 建立索引的同一个序列，追加之后必须已调用 extend()
+     * @throw std::invalid_argument 如果序列为空或索引没有覆盖全部位姿
+     * @throw std::out_of_range 如果目标时间超出范围
+     */
+    template <typename Timed>
+    std::size_t findSegmentIndex(const std::vector<Timed>& poses, double target_time) const
+    {
+        if (poses.empty()) {
+            throw std::invalid_argument("Pose sequence is empty");
+        }
+        if (poses.size() != indexed_) {
+            throw std::invalid_argument("Time index is out of date; call extend() after appending");
+        }
+        if (target_time < poses.front().time_stamp || target_time > poses.back().time_stamp) {
+            throw std::out_of_range("Target time is outside the range of pose timestamps");
+        }
+        auto b = static_cast<std::size_t>(keyOf(target_time));
+        std::size_t lo = buckets_[b];
+        std::size_t hi = b + 1 < buckets_.size() ? buckets_[b + 1] : indexed_ - 1;
+        if (hi - lo > kMaxScan) {
+            auto comp = [](double time, const Timed& pose) { return time < pose.time_stamp; };
+            auto it = std::upper_bound(poses.begin() + static_cast<std::ptrdiff_t>(lo + 1),
+                poses.begin() + static_cast<std::ptrdiff_t>(hi + 1), target_time, comp);
+            return static_cast<std::size_t>(it - poses.begin()) - 1;
+        }
+        while (lo < hi && poses[lo + 1].time_stamp <= target_time) {
+            ++lo;
+        }
+        return lo;
+    }
+
+private:
+    double keyOf(double time) const { return std::floor((time - origin_) * inv_period_); }
+
+    /**
+     * @brief 桶宽至少乘以 factor（取 2 的幂），按新的宽度重建已索引的部分
+     */
+    template <typename Timed>
+    void coarsen(const std::vector<Timed>& poses, double factor)
+    {
+        while (factor > 1.0) {
+            period_ *= 2.0;
+            factor *= 0.5;
+        }
+        period_ *= 2.0;
+        inv_period_ = 1.0 / period_;
+        buckets_.assign(1, 0);
+        for (std::size_t i = 1; i < indexed_; ++i) {
+            buckets_.resize(static_cast<std::size_t>(keyOf(poses[i].time_stamp)) + 1, i - 1);
+        }
+    }
+
+    double period_ { 0.0 };
+    double inv_period_ { 0.0 };
+    double origin_ { 0.0 }; // 第一个位姿的时间戳
+    std::size_t indexed_ { 0 };
+    std::vector<std::size_t> buckets_;
+};
+
+/**
+ * @brief 用分桶索引定位区间后插值（与 interpolateTimedPose 逐位相同）
+ */
+inline TimedPose interpolateTimedPose(const std::vector<TimedPose>& poses, const TimeBucketIndex& index,
+    double target_time)
+{
+    return interpolateInSegment(poses, index.findSegmentIndex(poses, target_time), target_time);
+}
+
+} // namespace robotics
@@ -0,0 +1,284 @@
+#pragma once
+/**
+ * @file trajectory_metrics.hpp
+ * @brief 轨迹评估：按时间戳关联、SE(3)/Sim(3) 对齐（alignment.hpp）、绝对轨迹误差 (ATE) 与相对位姿误差 (RPE)。
+ *
+ * 所有统计量都是流式的（Welford 更新 + Chan 合并），并行时每个块维护自己的统计量，
+ * 最后按块的顺序合并，因此结果与线程数无关、可复现。
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+#include "alignment.hpp"
+#include "interpolation.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+
+namespace robotics::metrics {
+
+/**
+ * @brief 流式统计量：均值、方差、均方根、最小值、最大值
+ */
+class RunningStats {
+public:
+    void add(double value)
+    {
+        ++count_;
+        double delta = value - mean_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (value - mean_);
+        sum_squares_ += value * value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    /**
+     * @brief 合并另一组样本的统计量（Chan 等人的并行方差公式）
+     */
+    void merge(const RunningStats& other)
+    {
+        if (other.count_ == 0) {
+            return;
+        }
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        double n_a = static_cast<double>(count_);
+        double n_b = static_cast<double>(other.count_);
+        double n = n_a + n_b;
+        double delta = other.mean_ - mean_;
+        mean_ += delta * n_b / n;
+        m2_ += other.m2_ + delta * delta * n_a * n_b / n;
+        sum_squares_ += other.sum_squares_;
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::size_t count() const { return count_; }
+    double mean() const { return count_ ? mean_ : 0.0; }
+    double variance() const { return count_ > 1 ? m2_ / static_cast<double>(count_) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double rmse() const { return count_ ? std::sqrt(sum_squares_ / static_cast<double>(count_)) : 0.0; }
+    double min() const { return count_ ? min_ : 0.0; }
+    double max() const { return count_ ? max_ : 0.0; }
+
+private:
+    std::size_t count_ { 0 };
+    double mean_ { 0.0 };
+    double m2_ { 0.0 };
+    double sum_squares_ { 0.0 };
+    double min_ { std::numeric_limits<double>::infinity() };
+    double max_ { -std::numeric_limits<double>::infinity() };
+};
+
+/**
+ * @brief 按时间戳关联后的位姿对
+ */
+struct AssociatedPoses {
+    std::vector<double> times;
+    std::vector<Pose> estimate;
+    std::vector<Pose> reference; // 参考轨迹在 times 处的插值
+};
+
+enum class AlignmentMode {
+    None,
+    SE3, // 旋转 + 平移
+    Sim3, // 旋转 + 平移 + 尺度（单目 VO）
+};
+
+enum class SegmentUnit {
+    Meters, // 按参考轨迹的累计路程
+    Seconds, // 按时间
+};
+
+struct AteResult {
+    Similarity alignment;
+    RunningStats translation; // 米
+    RunningStats rotation; // 度
+};
+
+struct RpeResult {
+    double segment_length { 0.0 };
+    RunningStats translation; // 米
+    RunningStats rotation; // 度
+};
+
+namespace detail {
+
+    /**
+     * @brief 把 [0, n) 切成固定数量的块并行统计，按块顺序合并
+     *
+     * 块的划分只取决于 n，与线程数无关，因此合并顺序固定、结果可复现。
+     */
+    template <typename Body>
+    void chunkedStats(ThreadPool& pool, std::size_t n, RunningStats& a, RunningStats& b, Body&& body)
+    {
+        constexpr std::size_t kChunks = 64;
+        std::size_t chunks = std::min(kChunks, std::max<std::size_t>(n, 1));
+        std::vector<RunningStats> local_a(chunks), local_b(chunks);
+        pool.parallelFor(0, chunks, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c) {
+                body(n * c / chunks, n * (c + 1) / chunks, local_a[c], local_b[c]);
+            }
+        }, 1);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            a.merge(local_a[c]);
+            b.merge(local_b[c]);
+        }
+    }
+
+    inline double radiansToDegrees(double radians) { return radians * 180.0 / std::numbers::pi; }
+
+} // namespace detail
+
+/**
+ * @brief 按时间戳关联估计轨迹与参考轨迹
+ *
+ * 在参考轨迹上批量插值出每个估计时间戳处的位姿；超出参考轨迹时间范围的估计位姿被丢弃。
+ * @param estimate 按时间戳排序的估计轨迹
+ * @param reference 按时间戳排序的参考（真值）轨迹
+ */
+inline AssociatedPoses associateByTimestamp(const std::vector<TimedPose>& estimate,
+    const std::vector<TimedPose>& reference, ThreadPool& pool)
+{
+    AssociatedPoses result;
+    if (estimate.empty() || reference.empty()) {
+        return result;
+    }
+    double t0 = reference.front().time_stamp;
+    double t1 = reference.back().time_stamp;
+    for (const TimedPose& p : estimate) {
+        if (p.time_stamp >= t0 && p.time_stamp <= t1) {
+            result.times.push_back(p.time_stamp);
+            result.estimate.push_back(p.pose);
+        }
+    }
+    std::vector<TimedPose> interpolated(result.times.size());
+    interpolateTimedPoses(reference, result.times.data(), result.times.size(), interpolated.data(), pool);
+    result.reference.reserve(interpolated.size());
+    for (const TimedPose& p : interpolated) {
+        result.reference.push_back(p.pose);
+    }
+    return result;
+}
+
+/**
+ * @brief 绝对轨迹误差：对齐后逐位姿的平移误差与旋转误差
+ * @throw std::invalid_argument 如果需要对齐而关联上的位姿少于 3 个
+ */
+inline AteResult absoluteTrajectoryError(const AssociatedPoses& poses, AlignmentMode mode, ThreadPool& pool)
+{
+    AteResult result;
+    if (mode != AlignmentMode::None) {
+        AlignmentAccumulator accumulator = accumulateAlignment(pool, poses.estimate.size(),
+            [&](std::size_t lo, std::size_t hi, AlignmentAccumulator& local) {
+                for (std::size_t i = lo; i < hi; ++i) {
+                    local.add(poses.estimate[i].position, poses.reference[i].position);
+                }
+            });
+        result.alignment = accumulator.solve(mode == AlignmentMode::Sim3);
+    }
+    detail::chunkedStats(pool, poses.estimate.size(), result.translation, result.rotation,
+        [&](std::size_t lo, std::size_t hi, RunningStats& translation, RunningStats& rotation) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                Pose aligned = result.alignment.apply(poses.estimate[i]);
+                translation.add((aligned.position - poses.reference[i].position).norm());
+                Quaternion error = poses.reference[i].orientation.conjugate() * aligned.orientation;
+                rotation.add(detail::radiansToDegrees(error.angle()));
+            }
+        });
+    return result;
+}
+
+/**
+ * @brief 对估计轨迹施加对齐变换（参考轨迹不变）
+ */
+inline AssociatedPoses applyAlignment(AssociatedPoses poses, const Similarity& alignment)
+{
+    for (Pose& pose : poses.estimate) {
+        pose = alignment.apply(pose);
+    }
+    return poses;
+}
+
+/**
+ * @brief 沿轨迹的累计量：路程（米）或时间（秒），单调不减
+ */
+inline std::vector<double> cumulativeMeasure(const AssociatedPoses& poses, SegmentUnit unit)
+{
+    std::vector<double> measure(poses.times.size(), 0.0);
+    for (std::size_t i = 1; i < measure.size(); ++i) {
+        measure[i] = unit == SegmentUnit::Seconds
+            ? poses.times[i] - poses.times[0]
+            : measure[i - 1] + (poses.reference[i].position - poses.reference[i - 1].position).norm();
+    }
+    return measure;
+}
+
+/**
+ * @brief 位姿对 (i, j) 的相对位姿误差 E = (ref_i^-1 ref_j)^-1 (est_i^-1 est_j)
+ */
+inline Pose relativePoseError(const AssociatedPoses& poses, std::size_t i, std::size_t j)
+{
+    Pose delta_reference = poses.reference[i].inverse() * poses.reference[j];
+    Pose delta_estimate = poses.estimate[i].inverse() * poses.estimate[j];
+    return delta_reference.inverse() * delta_estimate;
+}
+
+/**
+ * @brief 多个段长度上的相对位姿误差
+ *
+ * 对每个起点 i，取第一个满足 measure[j] >= measure[i] + L 的 j 组成位姿对。
+ * measure 单调，j 随 i 单调不减：每个块只对块首做一次二分查找，之后双指针前进，
+ * 每个段长度的总代价为 O(n)，而不是枚举所有位姿对的 O(n^2)。
+ *
+ * RPE 对估计轨迹的全局刚体变换不变；尺度不确定的估计（单目）应先用 applyAlignment 施加 Sim(3) 对齐。
+ *
+ * @param segment_lengths 段长度（必须为正），单位由 unit 决定
+ * @throw std::invalid_argument 如果某个段长度不为正
+ */
+inline std::vector<RpeResult> relativePoseError(const AssociatedPoses& poses,
+    const std::vector<double>& segment_lengths, SegmentUnit unit, ThreadPool& pool)
+{
+    for (double length : segment_lengths) {
+        if (!(length > 0.0)) {
+            throw std::invalid_argument("RPE segment lengths must be positive");
+        }
+    }
+    std::vector<double> measure = cumulativeMeasure(poses, unit);
+    std::vector<RpeResult> results;
+    for (double length : segment_lengths) {
+        RpeResult result;
+        result.segment_length = length;
+        detail::chunkedStats(pool, measure.size(), result.translation, result.rotation,
+            [&](std::size_t lo, std::size_t hi, RunningStats& translation, RunningStats& rotation) {
+                if (lo >= hi) {
+                    return;
+                }
+                auto j = static_cast<std::size_t>(
+                    std::lower_bound(measure.begin(), measure.end(), measure[lo] + length) - measure.begin());
+                for (std::size_t i = lo; i < hi; ++i) {
+                    while (j < measure.size() && measure[j] < measure[i] + length) {
+                        ++j;
+                    }
+                    if (j >= measure.size()) {
+                        break; // 之后的起点也找不到终点
+                    }
+                    Pose error = relativePoseError(poses, i, j);
+                    translation.add(error.position.norm());
+                    rotation.add(detail::radiansToDegrees(error.orientation.angle()));
+                }
+            });
+        results.push_back(result);
+    }
+    return results;
+}
+
+} // namespace robotics::metrics
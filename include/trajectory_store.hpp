@@ -0,0 +1,320 @@
+#pragma once
+/**
+ * @file trajectory_store.hpp
+ * @brief 版本化的轨迹存储：写时复制的定长分块 + 原子发布的不可变快照（MVCC）。
+ *
+ * 回环修正要改写大量位姿，而此时读者仍在旧轨迹上插值。把整条 std::vector<TimedPose>
+ * 复制一份再在锁内替换，既要付出完整复制的代价，也会在替换时阻塞读者。这里的做法是：
+ *
+ * - 轨迹被切成定长的块（最后一块可以不满），每个版本只是一组指向不可变块的 shared_ptr；
+ * - 读者用 snapshot() 原子地取得当前版本并持有它，之后的读取不加锁，也不受写者影响；
+ * - 写者在事务中修改：第一次写某个块时复制该块，没有改动的块与旧版本共享；
+ *   commit() 原子地发布新版本。旧版本在最后一个持有它的快照释放后自动回收。
+ *
+ * 同一时刻只有一个事务（写者之间用互斥量串行化），读者从不等待写者。
+ */
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "interpolation.hpp"
+#include "pose.hpp"
+
+namespace robotics {
+
+class TrajectoryStore {
+public:
+    using Chunk = std::vector<TimedPose>;
+
+private:
+    /**
+     * @brief 一个已发布的版本，发布后不再修改
+     */
+    struct Version {
+        std::uint64_t number { 0 };
+        std::size_t size { 0 };
+        std::size_t chunk_size { 0 };
+        unsigned chunk_shift { 0 }; // chunk_size = 1 << chunk_shift，下标换算只需移位和掩码
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        std::vector<double> chunk_start_times; // 每块第一个位姿的时间戳，用于二分查找
+    };
+
+public:
+    static constexpr std::size_t kDefaultChunkSize = 4096; // 约 224 KiB，改写一个块的代价与 L2 相当
+
+    /**
+     * @brief 不可变的快照：持有期间内容不变，可在任意线程中无锁读取
+     */
+    class Snapshot {
+    public:
+        std::uint64_t version() const { return version_->number; }
+        std::size_t size() const { return version_->size; }
+        bool empty() const { return version_->size == 0; }
+
+        const TimedPose& operator[](std::size_t i) const
+        {
+            return (*version_->chunks[i >> version_->chunk_shift])[i & (version_->chunk_size - 1)];
+        }
+
+        std::size_t chunkCount() const { return version_->chunks.size(); }
+        std::span<const TimedPose> chunk(std::size_t c) const { return *version_->chunks[c]; }
+
+        /**
+         * @brief 第 c 块是否与另一个快照共享同一份内存（未被改写）
+         */
+        bool sharesChunk(const Snapshot& other, std::size_t c) const
+        {
+            return c < chunkCount() && c < other.chunkCount() && version_->chunks[c] == other.version_->chunks[c];
+        }
+
+        std::vector<TimedPose> toVector() const
+        {
+            std::vector<TimedPose> poses;
+            poses.reserve(size());
+            for (const auto& chunk : version_->chunks) {
+                poses.insert(poses.end(), chunk->begin(), chunk->end());
+            }
+            return poses;
+        }
+
+        /**
+         * @brief 与 findSegmentIndex 相同的语义：返回 i 使 poses[i].t <= target < poses[i+1].t
+         * @throw std::invalid_argument 如果轨迹为空
+         * @throw std::out_of_range 如果目标时间超出范围
+         */
+        std::size_t findSegmentIndex(double target_time) const
+        {
+            if (empty()) {
+                throw std::invalid_argument("Pose sequence is empty");
+            }
+            const auto& starts = version_->chunk_start_times;
+            const Chunk& last = *version_->chunks.back();
+            if (target_time < starts.front() || target_time > last.back().time_stamp) {
+                throw std::out_of_range("Target time is outside the range of pose timestamps");
+            }
+            std::size_t c = static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), target_time)
+                                - starts.begin())
+                - 1;
+            const Chunk& chunk = *version_->chunks[c];
+            auto comp = [](double time, const TimedPose& pose) { return time < pose.time_stamp; };
+            auto it = std::upper_bound(chunk.begin(), chunk.end(), target_time, comp);
+            return c * version_->chunk_size + static_cast<std::size_t>(it - chunk.begin()) - 1;
+        }
+
+        /**
+         * @brief 根据时间插值（与 interpolateTimedPose 在同样内容的 vector 上逐位相同）
+         */
+        TimedPose interpolate(double target_time) const
+        {
+            return interpolateAt(findSegmentIndex(target_time), target_time);
+        }
+
+        /**
+         * @brief 批量插值：查询时间单调时沿轨迹游走（跨块也一样），否则逐个二分查找
+         * @throw std::out_of_range 如果任一查询时间超出范围
+         */
+        void interpolate(const double* times, std::size_t count, TimedPose* out) const
+        {
+            std::size_t segment = 0;
+            for (std::size_t k = 0; k < count; ++k) {
+                double target = times[k];
+                if (k == 0 || target < times[k - 1] || target > (*this)[size() - 1].time_stamp) {
+                    segment = findSegmentIndex(target);
+                } else {
+                    while (segment + 1 < size() && (*this)[segment + 1].time_stamp <= target) {
+                        ++segment;
+                    }
+                }
+                out[k] = interpolateAt(segment, target);
+            }
+        }
+
+    private:
+        friend class TrajectoryStore;
+
+        explicit Snapshot(std::shared_ptr<const Version> version)
+            : version_(std::move(version))
+        {
+        }
+
+        TimedPose interpolateAt(std::size_t i, double target_time) const
+        {
+            const TimedPose& p1 = (*this)[i];
+            if (i + 1 >= size() || p1.time_stamp == target_time) {
+                return { target_time, p1.pose };
+            }
+            const TimedPose& p2 = (*this)[i + 1];
+            double t = (target_time - p1.time_stamp) / (p2.time_stamp - p1.time_stamp);
+            return { target_time, interpolatePose(p1.pose, p2.pose, t) };
+        }
+
+        std::shared_ptr<const Version> version_;
+    };
+
+    /**
+     * @brief 写事务：在当前版本的基础上修改和追加，commit() 时一次性发布
+     *
+     * 事务存在期间持有写锁，其他事务的 begin() 会等待；读者不受影响。未提交就析构的事务丢弃全部修改。
+     * 不同的块可以由不同线程同时调用 writableChunk()（例如按块并行地应用修正），
+     * 同一个块不能。修改不应打乱时间戳的顺序。
+     */
+    class Transaction {
+    public:
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+        Transaction(Transaction&&) = default;
+
+        std::size_t size() const { return size_; }
+        std::size_t chunkCount() const { return chunks_.size(); }
+        std::size_t chunkSize() const { return chunk_size_; }
+
+        const TimedPose& operator[](std::size_t i) const
+        {
+            return (*chunks_[i >> chunk_shift_])[i & (chunk_size_ - 1)];
+        }
+
+        /**
+         * @brief 可写的第 c 块；第一次调用时复制该块，之后直接返回副本
+         */
+        std::span<TimedPose> writableChunk(std::size_t c)
+        {
+            if (!writable_[c]) {
+                auto copy = std::make_shared<Chunk>(*chunks_[c]);
+                writable_[c] = copy.get();
+                chunks_[c] = std::move(copy);
+            }
+            return *writable_[c];
+        }
+
+        /**
+         * @brief 第 c 块是否已在本事务中复制（被修改或追加过）
+         */
+        bool isModified(std::size_t c) const { return writable_[c] != nullptr; }
+
+        /**
+         * @throw std::out_of_range 如果 i >= size()
+         */
+        TimedPose& at(std::size_t i)
+        {
+            if (i >= size_) {
+                throw std::out_of_range("Trajectory index out of range");
+            }
+            return writableChunk(i >> chunk_shift_)[i & (chunk_size_ - 1)];
+        }
+
+        /**
+         * @throw std::invalid_argument 如果时间戳早于当前最后一个位姿
+         */
+        void append(const TimedPose& pose)
+        {
+            if (size_ > 0 && pose.time_stamp < (*this)[size_ - 1].time_stamp) {
+                throw std::invalid_argument("Appended pose is older than the last pose");
+            }
+            if (chunks_.empty() || chunks_.back()->size() == chunk_size_) {
+                auto chunk = std::make_shared<Chunk>();
+                chunk->reserve(chunk_size_);
+                writable_.push_back(chunk.get());
+                chunks_.push_back(std::move(chunk));
+            }
+            writableChunk(chunks_.size() - 1); // 最后一个不满的块可能仍与旧版本共享
+            writable_.back()->push_back(pose);
+            ++size_;
+        }
+
+        /**
+         * @brief 发布新版本并结束事务（释放写锁）
+         * @return 新版本号
+         */
+        std::uint64_t commit()
+        {
+            auto version = std::make_shared<Version>();
+            version->number = base_number_ + 1;
+            version->size = size_;
+            version->chunk_size = chunk_size_;
+            version->chunk_shift = chunk_shift_;
+            version->chunk_start_times.reserve(chunks_.size());
+            for (const auto& chunk : chunks_) {
+                version->chunk_start_times.push_back(chunk->front().time_stamp);
+            }
+            version->chunks.assign(chunks_.begin(), chunks_.end());
+            store_->current_.store(std::move(version));
+            chunks_.clear();
+            writable_.clear();
+            lock_.unlock();
+            return base_number_ + 1;
+        }
+
+    private:
+        friend class TrajectoryStore;
+
+        Transaction(TrajectoryStore& store)
+            : store_(&store)
+            , lock_(store.writer_mutex_)
+        {
+            std::shared_ptr<const Version> base = store.current_.load();
+            base_number_ = base->number;
+            size_ = base->size;
+            chunk_size_ = base->chunk_size;
+            chunk_shift_ = base->chunk_shift;
+            chunks_.assign(base->chunks.begin(), base->chunks.end());
+            writable_.assign(chunks_.size(), nullptr);
+        }
+
+        TrajectoryStore* store_;
+        std::unique_lock<std::mutex> lock_;
+        std::uint64_t base_number_ { 0 };
+        std::size_t size_ { 0 };
+        std::size_t chunk_size_ { 0 };
+        unsigned chunk_shift_ { 0 };
+        std::vector<std::shared_ptr<const Chunk>> chunks_;
+        std::vector<Chunk*> writable_; // 本事务中已复制（可写）的块，其余为 nullptr
+    };
+
+    /**
+     * @param poses 按时间戳排序的初始轨迹
+     * @param chunk_size 每块的位姿数，必须是 2 的幂
+     * @throw std::invalid_argument 如果 chunk_size 不是 2 的幂
+     */
+    explicit TrajectoryStore(const std::vector<TimedPose>& poses = {}, std::size_t chunk_size = kDefaultChunkSize)
+    {
+        if (!std::has_single_bit(chunk_size)) {
+            throw std::invalid_argument("Chunk size must be a power of two");
+        }
+        auto version = std::make_shared<Version>();
+        version->chunk_size = chunk_size;
+        version->chunk_shift = static_cast<unsigned>(std::countr_zero(chunk_size));
+        current_.store(std::move(version));
+        Transaction initial = begin();
+        for (const TimedPose& pose : poses) {
+            initial.append(pose);
+        }
+        initial.commit();
+    }
+
+    TrajectoryStore(const TrajectoryStore&) = delete;
+    TrajectoryStore& operator=(const TrajectoryStore&) = delete;
+
+    /**
+     * @brief 当前版本的快照（无锁，不等待写者）
+     */
+    Snapshot snapshot() const { return Snapshot(current_.load()); }
+
+    /**
+     * @brief 开始一个写事务，若已有事务在进行则等待它提交
+     */
+    Transaction begin() { return Transaction(*this); }
+
+private:
+    std::atomic<std::shared_ptr<const Version>> current_;
+    std::mutex writer_mutex_;
+};
+
+} // namespace robotics
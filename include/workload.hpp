@@ -0,0 +1,370 @@
+#pragma once
+/**
+ * @file workload.hpp
+ * @brief 确定性的合成工作负载生成器：6 自由度轨迹、类 LiDAR 点云与描述子集合。
+ *
+ * 所有生成器都只依赖一个 64 位种子。随机数使用自带的 splitmix64 与 Box-Muller，
+ * 不使用 std::*_distribution（其实现因标准库而异），因此同一种子在不同平台上
+ * 生成相同的数据（仅受 libm 中 sin/cos/log 的末位差异影响）。
+ *
+ * 线性方程组生成器依赖 Eigen，见 workload_systems.hpp。
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+#include "pose.hpp"
+
+namespace robotics::workload {
+
+/**
+ * @brief 可复现的伪随机数发生器 (splitmix64)
+ */
+class WorkloadRng {
+public:
+    explicit WorkloadRng(std::uint64_t seed)
+        : state_(seed)
+    {
+    }
+
+    // 下一个 64 位随机整数
+    std::uint64_t next()
+    {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1) 上的均匀分布
+    double uniform()
+    {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    // [lo, hi) 上的均匀分布
+    double uniform(double lo, double hi)
+    {
+        return lo + (hi - lo) * uniform();
+    }
+
+    // [0, n) 上的均匀整数
+    std::size_t index(std::size_t n)
+    {
+        return n == 0 ? 0 : static_cast<std::size_t>(next() % n);
+    }
+
+    // 标准正态分布 (Box-Muller)
+    double normal()
+    {
+        if (has_spare_) {
+            has_spare_ = false;
+            return spare_;
+        }
+        double u1 = uniform();
+        double u2 = uniform();
+        double radius = std::sqrt(-2.0 * std::log(1.0 - u1)); // 1 - u1 ∈ (0, 1]
+        double angle = 2.0 * std::numbers::pi * u2;
+        spare_ = radius * std::sin(angle);
+        has_spare_ = true;
+        return radius * std::cos(angle);
+    }
+
+    // 各分量独立的正态随机向量
+    Vector3 normalVector(double sigma)
+    {
+        double x = normal() * sigma;
+        double y = normal() * sigma;
+        double z = normal() * sigma;
+        return { x, y, z };
+    }
+
+private:
+    std::uint64_t state_;
+    double spare_ { 0.0 };
+    bool has_spare_ { false };
+};
+
+// --- 轨迹 ---
+
+/**
+ * @brief 轨迹生成的公共参数
+ */
+struct TrajectoryOptions {
+    std::size_t count { 1000 }; // 生成的位姿数
+    double rate_hz { 100.0 }; // 标称采样率
+    double start_time { 0.0 }; // 第一个位姿的时间戳
+    double timestamp_jitter { 0.0 }; // 时间戳抖动的标准差（秒），会被截断以保持单调
+    double gap_probability { 0.0 }; // 每个采样被丢弃（形成时间间隙）的概率
+    std::uint64_t seed { 42 };
+};
+
+/**
+ * @brief 抖动轨迹的额外参数（手持/振动平台）
+ */
+struct JerkyTrajectoryOptions : TrajectoryOptions {
+    double angular_rate_std { 1.5 }; // 角速度随机游走强度 (rad/s)
+    double acceleration_std { 3.0 }; // 线加速度噪声 (m/s^2)
+    double spike_probability { 0.01 }; // 每个采样出现冲击的概率
+    double spike_scale { 8.0 }; // 冲击相对于常规噪声的倍数
+};
+
+namespace detail {
+
+    /**
+     * @brief 生成单调递增的采样时间：标称网格 + 截断的抖动 + 随机间隙
+     */
+    inline std::vector<double> sampleTimes(const TrajectoryOptions& options, WorkloadRng& rng)
+    {
+        std::vector<double> times;
+        times.reserve(options.count);
+        double period = 1.0 / options.rate_hz;
+        double max_jitter = 0.45 * period; // 保证相邻采样不会交换顺序
+        for (std::size_t k = 0; times.size() < options.count; ++k) {
+            if (options.gap_probability > 0.0 && rng.uniform() < options.gap_probability) {
+                continue;
+            }
+            double jitter = 0.0;
+            if (options.timestamp_jitter > 0.0) {
+                jitter = std::clamp(rng.normal() * options.timestamp_jitter, -max_jitter, max_jitter);
+            }
+            times.push_back(options.start_time + static_cast<double>(k) * period + jitter);
+        }
+        return times;
+    }
+
+} // namespace detail
+
+/**
+ * @brief 平滑的 6 自由度轨迹（类车辆/无人机巡航）
+ *
+ * 位置为随机振幅、频率和相位的正弦叠加（Lissajous 曲线），航向沿速度方向，
+ * roll/pitch 为小幅低频摆动。各阶导数连续，适合插值与平滑类算法。
+ */
+inline std::vector<TimedPose> smoothTrajectory(const TrajectoryOptions& options)
+{
+    WorkloadRng rng(options.seed);
+    std::vector<double> times = detail::sampleTimes(options, rng);
+
+    double amplitude[3], omega[3], phase[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        amplitude[axis] = axis < 2 ? rng.uniform(20.0, 80.0) : rng.uniform(1.0, 5.0);
+        omega[axis] = 2.0 * std::numbers::pi * rng.uniform(0.005, 0.03);
+        phase[axis] = rng.uniform(0.0, 2.0 * std::numbers::pi);
+    }
+    double roll_amp = rng.uniform(0.02, 0.1), roll_omega = 2.0 * std::numbers::pi * rng.uniform(0.1, 0.3);
+    double pitch_amp = rng.uniform(0.02, 0.1), pitch_omega = 2.0 * std::numbers::pi * rng.uniform(0.1, 0.3);
+
+    std::vector<TimedPose> poses;
+    poses.reserve(times.size());
+    for (double time : times) {
+        double t = time - options.start_time;
+        Vector3 position {
+            amplitude[0] * std::sin(omega[0] * t + phase[0]),
+            amplitude[1] * std::sin(omega[1] * t + phase[1]),
+            amplitude[2] * std::sin(omega[2] * t + phase[2])
+        };
+        double vx = amplitude[0] * omega[0] * std::cos(omega[0] * t + phase[0]);
+        double vy = amplitude[1] * omega[1] * std::cos(omega[1] * t + phase[1]);
+        double yaw = std::atan2(vy, vx);
+        double roll = roll_amp * std::sin(roll_omega * t);
+        double pitch = pitch_amp * std::sin(pitch_omega * t);
+        poses.push_back({ time, { position, Quaternion::fromEuler(roll, pitch, yaw) } });
+    }
+    return poses;
+}
+
+/**
+ * @brief 抖动的 6 自由度轨迹（手持设备/崎岖路面）
+ *
+ * 角速度与线加速度均为带阻尼的随机游走，并以一定概率叠加冲击，
+ * 通过在流形上积分得到姿态，用于压测 SLERP 与插值的大角度分支。
+ */
+inline std::vector<TimedPose> jerkyTrajectory(const JerkyTrajectoryOptions& options)
+{
+    WorkloadRng rng(options.seed);
+    std::vector<double> times = detail::sampleTimes(options, rng);
+
+    std::vector<TimedPose> poses;
+    poses.reserve(times.size());
+    Vector3 position, velocity, angular_rate;
+    Quaternion orientation;
+    double previous_time = times.empty() ? 0.0 : times.front();
+    for (double time : times) {
+        double dt = time - previous_time;
+        previous_time = time;
+
+        double scale = rng.uniform() < options.spike_probability ? options.spike_scale : 1.0;
+        double sqrt_dt = std::sqrt(std::max(dt, 0.0));
+        angular_rate = angular_rate * 0.98 + rng.normalVector(options.angular_rate_std * scale * sqrt_dt);
+        Vector3 acceleration = velocity * -0.5 + rng.normalVector(options.acceleration_std * scale);
+
+        velocity = velocity + acceleration * dt;
+        position = position + velocity * dt;
+        orientation = orientation * Quaternion::fromRotationVector(angular_rate * dt);
+        orientation.normalize();
+        poses.push_back({ time, { position, orientation } });
+    }
+    return poses;
+}
+
+// --- 点云 ---
+
+/**
+ * @brief 类 LiDAR 扫描参数（默认与 64 线机械式雷达相当）
+ */
+struct LidarOptions {
+    int rings { 64 }; // 线数
+    int points_per_ring { 1024 }; // 每线水平方向采样数
+    double min_elevation_deg { -24.8 };
+    double max_elevation_deg { 2.0 };
+    double max_range { 120.0 }; // 最大量程 (m)
+    double sensor_height { 1.8 }; // 传感器离地高度 (m)
+    double range_noise { 0.02 }; // 测距噪声标准差 (m)
+    double dropout { 0.05 }; // 无回波概率
+    int obstacles { 60 }; // 场景中竖直柱状障碍物的数量
+    std::uint64_t seed { 42 };
+};
+
+/**
+ * @brief 生成一帧类 LiDAR 点云（传感器坐标系）
+ *
+ * 场景由地面、半径随方位起伏的环形墙面和随机分布的柱状障碍物组成，
+ * 每条射线取最近的交点并叠加测距噪声。点按"线 -> 方位角"的扫描顺序输出。
+ */
+inline std::vector<Vector3> lidarScan(const LidarOptions& options)
+{
+    WorkloadRng rng(options.seed);
+
+    struct Pillar {
+        double x, y, radius, height;
+    };
+    std::vector<Pillar> pillars;
+    pillars.reserve(options.obstacles);
+    for (int i = 0; i < options.obstacles; ++i) {
+        double r = rng.uniform(4.0, 60.0);
+        double az = rng.uniform(0.0, 2.0 * std::numbers::pi);
+        pillars.push_back({ r * std::cos(az), r * std::sin(az), rng.uniform(0.1, 1.5), rng.uniform(1.0, 10.0) });
+    }
+    double wall_radius = rng.uniform(50.0, 90.0);
+    double wall_ripple = rng.uniform(2.0, 10.0);
+
+    std::vector<Vector3> points;
+    points.reserve(static_cast<std::size_t>(options.rings) * options.points_per_ring);
+    const double deg = std::numbers::pi / 180.0;
+    for (int ring = 0; ring < options.rings; ++ring) {
+        double elevation = options.rings == 1
+            ? options.min_elevation_deg * deg
+            : (options.min_elevation_deg + (options.max_elevation_deg - options.min_elevation_deg) * ring / (options.rings - 1)) * deg;
+        double cos_el = std::cos(elevation), sin_el = std::sin(elevation);
+
+        for (int k = 0; k < options.points_per_ring; ++k) {
+            double azimuth = 2.0 * std::numbers::pi * k / options.points_per_ring;
+            Vector3 dir { cos_el * std::cos(azimuth), cos_el * std::sin(azimuth), sin_el };
+
+            double range = std::numeric_limits<double>::infinity();
+            if (dir.z < 0.0) {
+                range = options.sensor_height / -dir.z; // 地面 z = -h
+            }
+            // 环形墙面：水平距离为 R(azimuth)
+            double wall = (wall_radius + wall_ripple * std::sin(3.0 * azimuth)) / cos_el;
+            range = std::min(range, wall);
+            // 柱状障碍物：水平面内的射线-圆求交
+            for (const Pillar& p : pillars) {
+                double along = p.x * dir.x + p.y * dir.y; // 投影（未归一化的水平方向）
+                double horizontal_sq = cos_el * cos_el;
+                double tca = along / horizontal_sq;
+                if (tca <= 0.0) {
+                    continue;
+                }
+                double dx = p.x - dir.x * tca, dy = p.y - dir.y * tca;
+                double d2 = dx * dx + dy * dy;
+                if (d2 > p.radius * p.radius) {
+                    continue;
+                }
+                double t = tca - std::sqrt((p.radius * p.radius - d2) / horizontal_sq);
+                double z = dir.z * t;
+                if (t > 0.0 && t < range && z > -options.sensor_height && z < p.height - options.sensor_height) {
+                    range = t;
+                }
+            }
+
+            if (range > options.max_range || rng.uniform() < options.dropout) {
+                continue;
+            }
+            range += rng.normal() * options.range_noise;
+            points.push_back(dir * range);
+        }
+    }
+    return points;
+}
+
+// --- 描述子 ---
+
+/**
+ * @brief 行优先存储的描述子集合
+ */
+struct DescriptorSet {
+    std::size_t count { 0 };
+    std::size_t dim { 0 };
+    std::vector<double> data; // count * dim，行优先
+
+    const double* row(std::size_t i) const { return data.data() + i * dim; }
+
+    // 以 std::vector 形式取出一行，便于调用 a1 中的距离函数
+    std::vector<double> vectorAt(std::size_t i) const
+    {
+        return { row(i), row(i) + dim };
+    }
+};
+
+/**
+ * @brief 描述子生成参数（默认与 SIFT 的 128 维浮点描述子相当）
+ */
+struct DescriptorOptions {
+    std::size_t count { 10000 };
+    std::size_t dim { 128 };
+    std::size_t clusters { 64 }; // 聚类中心数（模拟视觉词汇）
+    double cluster_spread { 0.15 }; // 类内标准差（相对于单位尺度）
+    bool normalize { true }; // 是否做 L2 归一化
+    std::uint64_t seed { 42 };
+};
+
+/**
+ * @brief 生成带聚类结构的描述子集合
+ */
+inline DescriptorSet descriptorSet(const DescriptorOptions& options)
+{
+    WorkloadRng rng(options.seed);
+    std::vector<double> centers(options.clusters * options.dim);
+    for (double& c : centers) {
+        c = rng.uniform();
+    }
+
+    DescriptorSet set;
+    set.count = options.count;
+    set.dim = options.dim;
+    set.data.resize(options.count * options.dim);
+    for (std::size_t i = 0; i < options.count; ++i) {
+        const double* center = centers.data() + rng.index(options.clusters) * options.dim;
+        double* out = set.data.data() + i * options.dim;
+        double norm_sq = 0.0;
+        for (std::size_t d = 0; d < options.dim; ++d) {
+            out[d] = std::max(0.0, center[d] + rng.normal() * options.cluster_spread);
+            norm_sq += out[d] * out[d];
+        }
+        if (options.normalize && norm_sq > 0.0) {
+            double inv = 1.0 / std::sqrt(norm_sq);
+            for (std::size_t d = 0; d < options.dim; ++d) {
+                out[d] *= inv;
+            }
+        }
+    }
+    return set;
+}
+
+} // namespace robotics::workload
@@ -0,0 +1,288 @@
+#pragma once
+/**
+ * @file workload_systems.hpp
+ * @brief 确定性的线性方程组生成器：条件数可控的稠密 SPD / 一般方阵、类位姿图的稀疏 SPD 系统，
+ *        以及带真值的 SE(3) 位姿图。
+ *
+ * 与 workload.hpp 共用同一个可复现的随机数发生器；不使用 Eigen::Random（其底层为 std::rand）。
+ */
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <unordered_map>
+#include <vector>
+
+#include "lie.hpp"
+#include "pose_graph.hpp"
+#include "workload.hpp"
+
+namespace robotics::workload {
+
+/**
+ * @brief 稠密线性方程组 Ax = b 及其真解
+ */
+struct DenseLinearSystem {
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b;
+    Eigen::VectorXd x_true;
+};
+
+/**
+ * @brief 稀疏线性方程组 Ax = b 及其真解
+ */
+struct SparseLinearSystem {
+    Eigen::SparseMatrix<double> A;
+    Eigen::VectorXd b;
+    Eigen::VectorXd x_true;
+};
+
+namespace detail {
+
+    inline Eigen::MatrixXd gaussianMatrix(int rows, int cols, WorkloadRng& rng)
+    {
+        Eigen::MatrixXd m(rows, cols);
+        for (int j = 0; j < cols; ++j) {
+            for (int i = 0; i < rows; ++i) {
+                m(i, j) = rng.normal();
+            }
+        }
+        return m;
+    }
+
+    inline Eigen::VectorXd gaussianVector(int n, WorkloadRng& rng)
+    {
+        Eigen::VectorXd v(n);
+        for (int i = 0; i < n; ++i) {
+            v(i) = rng.normal();
+        }
+        return v;
+    }
+
+    // Haar 分布的随机正交矩阵：高斯矩阵 QR 分解后按 R 的对角符号修正
+    inline Eigen::MatrixXd randomOrthogonal(int n, WorkloadRng& rng)
+    {
+        Eigen::HouseholderQR<Eigen::MatrixXd> qr(gaussianMatrix(n, n, rng));
+        Eigen::MatrixXd q = qr.householderQ();
+        Eigen::MatrixXd r = qr.matrixQR().triangularView<Eigen::Upper>();
+        for (int i = 0; i < n; ++i) {
+            if (r(i, i) < 0.0) {
+                q.col(i) *= -1.0;
+            }
+        }
+        return q;
+    }
+
+    // 在 [1, condition] 上按对数均匀分布的 n 个谱值，从大到小排列
+    inline Eigen::VectorXd logSpacedSpectrum(int n, double condition)
+    {
+        Eigen::VectorXd s(n);
+        for (int i = 0; i < n; ++i) {
+            double frac = n > 1 ? static_cast<double>(i) / (n - 1) : 0.0;
+            s(i) = std::pow(condition, 1.0 - frac);
+        }
+        return s;
+    }
+
+} // namespace detail
+
+/**
+ * @brief 条件数可控的对称正定系统 A = Q diag(λ) Q^T
+ * @param n 维数
+ * @param condition 2-范数条件数 λmax/λmin（特征值在 [1, condition] 上对数均匀分布）
+ * @param seed 随机种子
+ */
+inline DenseLinearSystem spdSystem(int n, double condition = 1e3, std::uint64_t seed = 42)
+{
+    WorkloadRng rng(seed);
+    Eigen::MatrixXd q = detail::randomOrthogonal(n, rng);
+    Eigen::VectorXd lambda = detail::logSpacedSpectrum(n, condition);
+
+    DenseLinearSystem system;
+    system.A = q * lambda.asDiagonal() * q.transpose();
+    system.A = 0.5 * (system.A + system.A.transpose()); // 消除舍入造成的非对称
+    system.x_true = detail::gaussianVector(n, rng);
+    system.b = system.A * system.x_true;
+    return system;
+}
+
+/**
+ * @brief 病态的一般方阵系统 A = U diag(σ) V^T
+ * @param n 维数
+ * @param condition 2-范数条件数 σmax/σmin
+ * @param seed 随机种子
+ */
+inline DenseLinearSystem illConditionedSystem(int n, double condition = 1e10, std::uint64_t seed = 42)
+{
+    WorkloadRng rng(seed);
+    Eigen::MatrixXd u = detail::randomOrthogonal(n, rng);
+    Eigen::MatrixXd v = detail::randomOrthogonal(n, rng);
+    Eigen::VectorXd sigma = detail::logSpacedSpectrum(n, condition);
+
+    DenseLinearSystem system;
+    system.A = u * sigma.asDiagonal() * v.transpose();
+    system.x_true = detail::gaussianVector(n, rng);
+    system.b = system.A * system.x_true;
+    return system;
+}
+
+/**
+ * @brief 类位姿图结构的稀疏 SPD 系统
+ *
+ * 相当于一条里程计链（每个节点与后 band 个节点相连）加上若干随机回环边的加权图拉普拉斯矩阵，
+ * 再在对角线上加 diagonal_shift 使其严格正定（对应位姿图中固定规范自由度的先验）。
+ *
+ * @param n 未知数个数
+ * @param band 里程计链的带宽
+ * @param loop_closures 随机回环边的数量
+ * @param diagonal_shift 对角线正偏移
+ * @param seed 随机种子
+ */
+inline SparseLinearSystem sparseSpdSystem(int n, int band = 2, int loop_closures = 0,
+    double diagonal_shift = 1e-2, std::uint64_t seed = 42)
+{
+    WorkloadRng rng(seed);
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(static_cast<std::size_t>(n) * (2 * band + 1) + 4 * static_cast<std::size_t>(loop_closures));
+    Eigen::VectorXd diagonal = Eigen::VectorXd::Constant(n, diagonal_shift);
+
+    auto addEdge = [&](int i, int j, double weight) {
+        triplets.emplace_back(i, j, -weight);
+        triplets.emplace_back(j, i, -weight);
+        diagonal(i) += weight;
+        diagonal(j) += weight;
+    };
+    for (int i = 0; i < n; ++i) {
+        for (int k = 1; k <= band && i + k < n; ++k) {
+            addEdge(i, i + k, rng.uniform(0.5, 2.0) / k);
+        }
+    }
+    for (int e = 0; e < loop_closures && n > band + 1; ++e) {
+        int i = static_cast<int>(rng.index(n));
+        int j = static_cast<int>(rng.index(n));
+        if (std::abs(i - j) > band) {
+            addEdge(i, j, rng.uniform(0.1, 1.0));
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        triplets.emplace_back(i, i, diagonal(i));
+    }
+
+    SparseLinearSystem system;
+    system.A.resize(n, n);
+    system.A.setFromTriplets(triplets.begin(), triplets.end()); // 重复的回环边会被累加
+    system.A.makeCompressed();
+    system.x_true = detail::gaussianVector(n, rng);
+    system.b = system.A * system.x_true;
+    return system;
+}
+
+/**
+ * @brief 位姿图生成参数
+ */
+struct PoseGraphOptions {
+    std::size_t nodes { 10000 };
+    double cells_per_node { 1.0 }; // 活动区域的格子数与节点数之比，越小重访越频繁
+    double loop_probability { 0.3 }; // 回到访问过的格子时添加回环的概率
+    std::size_t min_loop_gap { 30 }; // 回环两端的最小节点间隔
+    double outlier_ratio { 0.0 }; // 错误关联的回环所占比例
+    double rotation_sigma { 0.002 }; // 观测噪声（rad）
+    double translation_sigma { 0.02 }; // 观测噪声（m）
+    std::uint64_t seed { 42 };
+};
+
+/**
+ * @brief 位姿图及其真值；图中的初值由里程计边逐个复合得到，节点 0 固定在真值上
+ */
+struct PoseGraphProblem {
+    std::vector<Pose> truth;
+    graph::PoseGraph graph;
+    std::size_t loop_closures { 0 };
+    std::size_t outliers { 0 };
+};
+
+/**
+ * @brief 曼哈顿网格上的轨迹（类似 M3500 数据集，带少量横滚/俯仰与高度起伏）
+ *
+ * 机器人每步前进一格，随机左转或右转，活动范围为 √(nodes · cells_per_node) 格见方，因此会反复经过同一格子；
+ * 经过时以 loop_probability 的概率与较早访问该格的某个节点形成回环。
+ * 错误回环连接一个随机的较早节点，但观测仍是真实回环的相对位姿（模拟错误的场景识别）。
+ */
+inline PoseGraphProblem poseGraphProblem(const PoseGraphOptions& options)
+{
+    WorkloadRng rng(options.seed);
+    PoseGraphProblem problem;
+    const std::size_t n = std::max<std::size_t>(options.nodes, 2);
+    const long side = std::max(8L, std::lround(std::sqrt(static_cast<double>(n) * options.cells_per_node)));
+
+    long x = side / 2, y = side / 2;
+    int heading = 0;
+    const int dx[4] = { 1, 0, -1, 0 };
+    const int dy[4] = { 0, 1, 0, -1 };
+    std::unordered_map<long, std::vector<std::size_t>> visits;
+    std::vector<std::pair<std::size_t, std::size_t>> loops; // (较早节点, 当前节点)
+    for (std::size_t k = 0; k < n; ++k) {
+        if (k > 0) {
+            double turn = rng.uniform();
+            heading = (heading + (turn < 0.15 ? 1 : turn < 0.3 ? 3 : 0)) % 4;
+            while (x + dx[heading] < 0 || x + dx[heading] >= side || y + dy[heading] < 0 || y + dy[heading] >= side) {
+                heading = (heading + 1) % 4;
+            }
+            x += dx[heading];
+            y += dy[heading];
+        }
+        double z = 0.5 * std::sin(0.013 * static_cast<double>(k));
+        Quaternion orientation = Quaternion::fromEuler(0.02 * rng.normal(), 0.02 * rng.normal(),
+            heading * std::numbers::pi / 2.0);
+        problem.truth.push_back({ Vector3 { static_cast<double>(x), static_cast<double>(y), z }, orientation });
+
+        std::vector<std::size_t>& cell = visits[x * side + y];
+        if (!cell.empty() && cell.front() + options.min_loop_gap <= k && rng.uniform() < options.loop_probability) {
+            std::size_t eligible = cell.size();
+            while (eligible > 0 && cell[eligible - 1] + options.min_loop_gap > k) {
+                --eligible;
+            }
+            loops.emplace_back(cell[rng.index(eligible)], k);
+        }
+        cell.push_back(k);
+    }
+
+    lie::Vector6d information_diagonal;
+    double wr = 1.0 / (options.rotation_sigma * options.rotation_sigma);
+    double wt = 1.0 / (options.translation_sigma * options.translation_sigma);
+    information_diagonal << wr, wr, wr, wt, wt, wt;
+    auto measure = [&](std::size_t from, std::size_t to) {
+        lie::Vector6d noise;
+        for (int i = 0; i < 6; ++i) {
+            noise(i) = rng.normal() * (i < 3 ? options.rotation_sigma : options.translation_sigma);
+        }
+        Pose z = problem.truth[from].inverse() * problem.truth[to] * lie::expSE3(noise);
+        z.orientation.normalize();
+        return z;
+    };
+
+    problem.graph.addNode(problem.truth[0], true);
+    for (std::size_t k = 1; k < n; ++k) {
+        Pose odometry = measure(k - 1, k);
+        Pose guess = problem.graph.poses()[k - 1] * odometry;
+        guess.orientation.normalize();
+        problem.graph.addNode(guess);
+        problem.graph.addEdge({ k - 1, k, odometry, information_diagonal.asDiagonal() });
+    }
+    for (auto [from, to] : loops) {
+        Pose z = measure(from, to);
+        if (rng.uniform() < options.outlier_ratio) {
+            std::size_t wrong = rng.index(to - options.min_loop_gap + 1);
+            if (wrong != from) {
+                from = wrong;
+                ++problem.outliers;
+            }
+        }
+        problem.graph.addEdge({ from, to, z, information_diagonal.asDiagonal() });
+        ++problem.loop_closures;
+    }
+    return problem;
+}
+
+} // namespace robotics::workload
@@ -2,9 +2,10 @@
  * @file main.cpp
  * @brief 演示 Eigen 库中不同线性方程组求解器的用法。
  *
- * 该文件包含两个示例：
+ * 该文件包含三个示例：
  * 1. 求解一个良态的对称正定方阵系统。
  * 2. 求解一个超定系统的最小二乘问题。
+ * 3. 用带状与三对角求解器求解只存储带内元素的系统。
  *
  * 使用了来自 mid-solvers.hpp/cpp 中定义的求解函数，并打印结果。
  */
@@ -44,6 +45,7 @@ int main()
     results1.push_back(solveWithJacobiSVD(A1, b1));
     results1.push_back(solveWithConjugateGradient(A1, b1)); // A1 是对称正定的，适用
     results1.push_back(solveWithBiCGSTAB(A1, b1));
+    results1.push_back(solveWithSparseLLT(A1.sparseView(), b1)); // 稀疏存储的同一个矩阵
     results1.push_back(solveWithManualJacobi(A1, b1));
 
     for (const auto& res : results1) {
@@ -102,5 +104,68 @@ int main()
         }
     }
 
+    // --- 示例 3: 带状系统 (只存储带内元素) ---
+    std::cout << "\n=== Example 3: Banded and Tridiagonal Systems ===" << std::endl;
+    const int n3 = 6;
+    BandedMatrix A3(n3, 1, 1); // 一维 Poisson 方程的 [-1, 2, -1] 矩阵，对称正定
+    Eigen::VectorXd b3 = Eigen::VectorXd::Ones(n3);
+    for (int i = 0; i < n3; ++i) {
+        A3(i, i) = 2.0;
+        if (i > 0) {
+            A3(i, i - 1) = -1.0;
+            A3(i - 1, i) = -1.0;
+        }
+    }
+    std::cout << "Matrix A3:\n"
+              << A3.toDense() << std::endl;
+
+    std::vector<SolveResult> results3;
+    results3.push_back(solveWithBandedLLT(A3, b3));
+    results3.push_back(solveWithBandedLU(A3, b3));
+    const Eigen::VectorXd off3 = Eigen::VectorXd::Constant(n3, -1.0), diag3 = Eigen::VectorXd::Constant(n3, 2.0);
+    results3.push_back(solveTridiagonal(off3, diag3, off3, b3));
+    results3.push_back(solveBanded(A3, b3)); // 不是严格对角占优，自动选择带状 LLT
+    results3.push_back(solveWithPartialPivLU(A3.toDense(), b3));
+
+    for (const auto& res : results3) {
+        std::cout << "\nMethod: " << res.method << std::endl;
+        if (res.success) {
+            std::cout << " Solution x: " << res.solution.transpose() << std::endl;
+            std::cout << " Residual Norm ||Ax-b||: " << res.error << std::endl;
+        } else {
+            std::cout << " Solver failed." << std::endl;
+        }
+    }
+
+    std::cout << "\n=== Example 4: Symmetric Indefinite (KKT) System ===" << std::endl;
+    // min ½ xᵀ H x - gᵀ x  s.t.  x₀ + x₁ + x₂ = 1；H 只是半正定，KKT 矩阵 [H cᵀ; c 0] 对称不定
+    Eigen::MatrixXd A4(4, 4);
+    A4 << 1.0, -1.0, 0.0, 1.0,
+        -1.0, 2.0, -1.0, 1.0,
+        0.0, -1.0, 1.0, 1.0,
+        1.0, 1.0, 1.0, 0.0;
+    Eigen::VectorXd b4(4);
+    b4 << 1.0, 0.0, -1.0, 1.0;
+    std::cout << "Matrix A4:\n"
+              << A4 << std::endl;
+
+    std::vector<SolveResult> results4;
+    Inertia inertia4;
+    results4.push_back(solveWithBunchKaufman(A4, b4, &inertia4));
+    results4.push_back(solveWithLDLT(A4, b4)); // 对角主元先消去 H 的部分，这里可行，但对不定矩阵没有稳定性保证
+    results4.push_back(solveWithPartialPivLU(A4, b4));
+
+    for (const auto& res : results4) {
+        std::cout << "\nMethod: " << res.method << std::endl;
+        if (res.success) {
+            std::cout << " Solution x: " << res.solution.transpose() << std::endl;
+            std::cout << " Residual Norm ||Ax-b||: " << res.error << std::endl;
+        } else {
+            std::cout << " Solver failed." << std::endl;
+        }
+    }
+    std::cout << "\nInertia of A4 (positive, negative, zero): " << inertia4.positive << ", " << inertia4.negative
+              << ", " << inertia4.zero << std::endl;
+
     return 0;
 }
\ No newline at end of file
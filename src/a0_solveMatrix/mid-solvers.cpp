@@ -4,8 +4,19 @@
 #include <Eigen/Cholesky> // 包含 Cholesky 分解
 #include <Eigen/QR>       // 包含 QR 分解
 #include <Eigen/SVD>      // 包含 SVD 分解
+#include <Eigen/OrderingMethods> // 包含 AMD 排序
+#include <Eigen/SparseLU>      // 包含稀疏 LU 分解
 #include <iostream> // 用于 std::cerr
 #include <cmath>    // 用于 std::abs
+#include <algorithm> // 用于 std::min / std::max
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <utility>   // 用于 std::swap
+#include <vector>
 
 // --- 直接法求解器实现 ---
 
@@ -105,6 +116,578 @@ SolveResult solveWithJacobiSVD(const Eigen::MatrixXd& A, const Eigen::VectorXd&
     return result;
 }
 
+// --- 多线程分块稠密分解实现 ---
+
+namespace {
+
+/**
+ * @brief 按列块组织的任务图：面板任务 panel(k) 与更新任务 update(j, k)（用面板 k 更新列块 j > k）
+ *
+ * panel(k) 依赖 update(k, k-1)；update(j, k) 依赖 panel(k) 与 update(j, k-1)。
+ * 就绪的任务放在一个队列里，面板与紧随其后的列块的更新放在队首（关键路径），其余更新放在队尾。
+ * 线程池的每个线程（含调用线程）各运行一个取任务的循环，直到所有任务完成或某个面板失败。
+ * @return bool 所有面板都成功时为 true
+ */
+bool runColumnTaskGraph(robotics::ThreadPool& pool, int blocks, const std::function<bool(int)>& panel,
+                        const std::function<void(int, int)>& update) {
+    if (blocks == 0) {
+        return true;
+    }
+    struct Task {
+        int block;
+        int panel; // block == panel 时是面板任务
+    };
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Task> ready { { 0, 0 } };
+    std::vector<int> applied(blocks, 0); // 已作用到第 j 个列块上的面板数
+    int panels_done = 0;
+    std::size_t remaining = static_cast<std::size_t>(blocks) * (blocks + 1) / 2;
+    bool failed = false;
+
+    auto enqueue = [&](Task task) {
+        if (task.block <= task.panel + 1) {
+            ready.push_front(task);
+        } else {
+            ready.push_back(task);
+        }
+    };
+    auto complete = [&](Task task) {
+        --remaining;
+        if (task.block == task.panel) {
+            panels_done = task.panel + 1;
+            for (int j = task.panel + 1; j < blocks; ++j) {
+                if (applied[j] == task.panel) {
+                    enqueue({ j, task.panel });
+                }
+            }
+        } else {
+            applied[task.block] = task.panel + 1;
+            if (task.block == task.panel + 1) {
+                enqueue({ task.block, task.block });
+            } else if (panels_done > task.panel + 1) {
+                enqueue({ task.block, task.panel + 1 });
+            }
+        }
+    };
+
+    pool.parallelFor(0, pool.size(), [&](std::size_t, std::size_t) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            changed.wait(lock, [&] { return failed || remaining == 0 || !ready.empty(); });
+            if (failed || remaining == 0) {
+                return;
+            }
+            Task task = ready.front();
+            ready.pop_front();
+            lock.unlock();
+            bool ok = true;
+            if (task.block == task.panel) {
+                ok = panel(task.panel);
+            } else {
+                update(task.block, task.panel);
+            }
+            lock.lock();
+            if (ok) {
+                complete(task);
+            } else {
+                failed = true;
+            }
+            changed.notify_all();
+        }
+    }, 1);
+    return !failed;
+}
+
+/**
+ * @brief 对 A(c:n, c:c+w) 做部分主元 LU（递归地把面板对半分，大部分计算是矩阵乘法）
+ *
+ * 行交换作用在整个面板 [panel_begin, panel_end) 的列上；pivots[i] 为第 i 行换到的行号。
+ * @return bool 遇到精确为零的主元时为 false
+ */
+bool factorLUPanel(Eigen::MatrixXd& A, int c, int w, int panel_begin, int panel_end, std::vector<int>& pivots) {
+    const int n = static_cast<int>(A.rows());
+    if (w <= 16) {
+        for (int j = c; j < c + w; ++j) {
+            Eigen::Index p = 0;
+            if (A.col(j).tail(n - j).cwiseAbs().maxCoeff(&p) == 0.0) {
+                return false;
+            }
+            pivots[j] = j + static_cast<int>(p);
+            if (pivots[j] != j) {
+                A.row(j).segment(panel_begin, panel_end - panel_begin)
+                    .swap(A.row(pivots[j]).segment(panel_begin, panel_end - panel_begin));
+            }
+            A.col(j).tail(n - j - 1) /= A(j, j);
+            const int right = c + w - j - 1;
+            if (right > 0) {
+                A.block(j + 1, j + 1, n - j - 1, right).noalias()
+                    -= A.col(j).tail(n - j - 1) * A.row(j).segment(j + 1, right);
+            }
+        }
+        return true;
+    }
+    const int w1 = w / 2, w2 = w - w1;
+    if (!factorLUPanel(A, c, w1, panel_begin, panel_end, pivots)) {
+        return false;
+    }
+    A.block(c, c, w1, w1).triangularView<Eigen::UnitLower>().solveInPlace(A.block(c, c + w1, w1, w2));
+    A.block(c + w1, c + w1, n - c - w1, w2).noalias()
+        -= A.block(c + w1, c, n - c - w1, w1) * A.block(c, c + w1, w1, w2);
+    return factorLUPanel(A, c + w1, w2, panel_begin, panel_end, pivots);
+}
+
+/** @brief 把第 [row_begin, row_end) 行的行交换依次作用在列 [col, col + width) 上 */
+void applyRowSwaps(Eigen::MatrixXd& A, const std::vector<int>& pivots, int row_begin, int row_end, int col,
+                   int width) {
+    for (int i = row_begin; i < row_end; ++i) {
+        if (pivots[i] != i) {
+            A.row(i).segment(col, width).swap(A.row(pivots[i]).segment(col, width));
+        }
+    }
+}
+
+/** @brief tile 为 0 时按矩阵规模与线程数选择列块宽度：每个线程至少约 4 个列块，宽度为 16 的倍数 */
+int tileWidth(int n, int tile, const robotics::ThreadPool& pool) {
+    if (tile > 0) {
+        return tile;
+    }
+    return std::clamp(n / (4 * static_cast<int>(pool.size())) / 16 * 16, 64, 192);
+}
+
+std::string tiledMethod(const char* name, int tile, const robotics::ThreadPool& pool) {
+    return std::string(name) + " (tile " + std::to_string(tile) + ", " + std::to_string(pool.size()) + " threads)";
+}
+
+} // namespace
+
+SolveResult solveWithPartialPivLU(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                                  int tile) {
+    SolveResult result;
+    tile = tileWidth(static_cast<int>(A.cols()), tile, pool);
+    result.method = tiledMethod("PartialPivLU", tile, pool);
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for LU.\n";
+        return result;
+    }
+    const int n = static_cast<int>(A.rows()), blocks = (n + tile - 1) / tile;
+    auto begin = [&](int k) { return k * tile; };
+    auto width = [&](int k) { return std::min(tile, n - k * tile); };
+    Eigen::MatrixXd LU = A;
+    std::vector<int> pivots(n);
+
+    bool ok = runColumnTaskGraph(pool, blocks,
+        [&](int k) { return factorLUPanel(LU, begin(k), width(k), begin(k), begin(k) + width(k), pivots); },
+        [&](int j, int k) {
+            const int c = begin(k), w = width(k), cj = begin(j), wj = width(j);
+            applyRowSwaps(LU, pivots, c, c + w, cj, wj);
+            LU.block(c, c, w, w).triangularView<Eigen::UnitLower>().solveInPlace(LU.block(c, cj, w, wj));
+            LU.block(c + w, cj, n - c - w, wj).noalias() -= LU.block(c + w, c, n - c - w, w) * LU.block(c, cj, w, wj);
+        });
+    if (!ok) {
+        std::cerr << "Error: Tiled LU found a zero pivot (matrix is singular).\n";
+        return result;
+    }
+    // 后面面板的行交换还没有作用到前面列块的 L 上；各列块互不相关，可以并行补上
+    pool.parallelFor(0, static_cast<std::size_t>(blocks), [&](std::size_t lo, std::size_t hi) {
+        for (int j = static_cast<int>(lo); j < static_cast<int>(hi); ++j) {
+            applyRowSwaps(LU, pivots, begin(j) + width(j), n, begin(j), width(j));
+        }
+    }, 1);
+
+    result.solution = b;
+    for (int i = 0; i < n; ++i) {
+        std::swap(result.solution(i), result.solution(pivots[i]));
+    }
+    LU.triangularView<Eigen::UnitLower>().solveInPlace(result.solution);
+    LU.triangularView<Eigen::Upper>().solveInPlace(result.solution);
+    if (!result.solution.allFinite()) {
+        std::cerr << "Error: LU solve resulted in non-finite values (matrix might be singular).\n";
+        return result;
+    }
+    result.error = (A * result.solution - b).norm();
+    result.success = true;
+    return result;
+}
+
+SolveResult solveWithLLT(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool, int tile) {
+    SolveResult result;
+    tile = tileWidth(static_cast<int>(A.cols()), tile, pool);
+    result.method = tiledMethod("Cholesky (LLT)", tile, pool);
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for Cholesky.\n";
+        return result;
+    }
+    if (!A.isApprox(A.transpose())) {
+        std::cerr << "Error: Matrix A is not symmetric, cannot use LLT.\n";
+        return result;
+    }
+    const int n = static_cast<int>(A.rows()), blocks = (n + tile - 1) / tile;
+    auto begin = [&](int k) { return k * tile; };
+    auto width = [&](int k) { return std::min(tile, n - k * tile); };
+    Eigen::MatrixXd L = A;
+
+    bool ok = runColumnTaskGraph(pool, blocks,
+        [&](int k) {
+            const int c = begin(k), w = width(k), below = n - c - w;
+            Eigen::Ref<Eigen::MatrixXd> diagonal = L.block(c, c, w, w);
+            Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>> llt(diagonal); // 原地分解对角块
+            if (llt.info() != Eigen::Success) {
+                return false;
+            }
+            if (below > 0) {
+                // L₂₁ = A₂₁ L₁₁⁻ᵀ
+                L.block(c, c, w, w).triangularView<Eigen::Lower>().transpose().solveInPlace<Eigen::OnTheRight>(
+                    L.block(c + w, c, below, w));
+            }
+            return true;
+        },
+        [&](int j, int k) {
+            const int c = begin(k), w = width(k), cj = begin(j), wj = width(j), below = n - cj - wj;
+            const auto lj = L.block(cj, c, wj, w);
+            L.block(cj, cj, wj, wj).triangularView<Eigen::Lower>() -= lj * lj.transpose();
+            if (below > 0) {
+                L.block(cj + wj, cj, below, wj).noalias() -= L.block(cj + wj, c, below, w) * lj.transpose();
+            }
+        });
+    if (!ok) {
+        std::cerr << "Error: LLT decomposition failed. Matrix might not be positive definite.\n";
+        return result;
+    }
+    result.solution = L.triangularView<Eigen::Lower>().solve(b);
+    L.triangularView<Eigen::Lower>().transpose().solveInPlace(result.solution);
+    result.error = (A * result.solution - b).norm();
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+SolveResult solveWithHouseholderQr(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                                   int tile) {
+    SolveResult result;
+    tile = tileWidth(static_cast<int>(A.cols()), tile, pool);
+    result.method = tiledMethod("Householder QR", tile, pool);
+    if (A.rows() != b.size() || A.rows() < A.cols()) {
+        std::cerr << "Error: Tiled QR needs rows(A) >= cols(A) and rows(A) == size(b).\n";
+        return result;
+    }
+    const int m = static_cast<int>(A.rows()), n = static_cast<int>(A.cols()), blocks = (n + tile - 1) / tile;
+    auto begin = [&](int k) { return k * tile; };
+    auto width = [&](int k) { return std::min(tile, n - k * tile); };
+    Eigen::MatrixXd QR = A;
+    std::vector<Eigen::VectorXd> coefficients(blocks);
+    auto reflectors = [&](int k) {
+        return Eigen::householderSequence(QR.block(begin(k), begin(k), m - begin(k), width(k)), coefficients[k]);
+    };
+
+    runColumnTaskGraph(pool, blocks,
+        [&](int k) {
+            Eigen::Ref<Eigen::MatrixXd> panel = QR.block(begin(k), begin(k), m - begin(k), width(k));
+            Eigen::HouseholderQR<Eigen::Ref<Eigen::MatrixXd>> qr(panel); // 原地分解，反射向量存在 R 的下方
+            coefficients[k] = qr.hCoeffs();
+            return true;
+        },
+        [&](int j, int k) {
+            QR.block(begin(k), begin(j), m - begin(k), width(j)).applyOnTheLeft(reflectors(k).adjoint());
+        });
+
+    const Eigen::VectorXd r = QR.diagonal().cwiseAbs();
+    if (n > 0 && !(r.minCoeff() > n * std::numeric_limits<double>::epsilon() * r.maxCoeff())) {
+        std::cerr << "Error: Tiled QR found a rank-deficient matrix, use column pivoting instead.\n";
+        return result;
+    }
+    Eigen::VectorXd y = b;
+    for (int k = 0; k < blocks; ++k) {
+        y.tail(m - begin(k)).applyOnTheLeft(reflectors(k).adjoint());
+    }
+    result.solution = QR.topLeftCorner(n, n).triangularView<Eigen::Upper>().solve(y.head(n));
+    result.error = (A * result.solution - b).norm(); // m > n 时是最小二乘解的残差范数
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+// --- 对称半正定与对称不定求解器实现 ---
+
+namespace {
+
+/** @brief 下三角元素绝对值的最大值；含非有限值时返回 NaN */
+double lowerMaxAbs(const Eigen::MatrixXd& A) {
+    double scale = 0.0;
+    for (Eigen::Index j = 0; j < A.cols(); ++j) {
+        const auto column = A.col(j).tail(A.rows() - j);
+        if (!column.allFinite()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        scale = std::max(scale, column.cwiseAbs().maxCoeff());
+    }
+    return scale;
+}
+
+/**
+ * @brief 检查 A 并初始化分解结果；返回零主元的阈值 √ε · max|A|，A 不合法时返回 NaN
+ */
+double beginSymmetricFactor(const Eigen::MatrixXd& A, SymmetricFactor& factor) {
+    if (A.rows() != A.cols()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const int n = static_cast<int>(A.rows());
+    factor.permutation.resize(n);
+    factor.block_sizes.assign(n, 1);
+    factor.inertia = Inertia();
+    for (int i = 0; i < n; ++i) {
+        factor.permutation[i] = i;
+    }
+    return std::sqrt(std::numeric_limits<double>::epsilon()) * lowerMaxAbs(A);
+}
+
+/** @brief 对称地交换第 p、q 行列（p < q），包括已经算出的 L 的行；只动下三角 */
+void symmetricInterchange(Eigen::MatrixXd& A, int p, int q, SymmetricFactor& factor) {
+    if (p == q) {
+        return;
+    }
+    const int n = static_cast<int>(A.rows());
+    A.row(p).head(p).swap(A.row(q).head(p));
+    A.col(p).tail(n - q - 1).swap(A.col(q).tail(n - q - 1));
+    for (int j = p + 1; j < q; ++j) {
+        std::swap(A(j, p), A(q, j));
+    }
+    std::swap(A(p, p), A(q, q));
+    std::swap(factor.permutation[p], factor.permutation[q]);
+}
+
+/** @brief 2x2 对称块 [a b; b c] 的特征值符号计入惯性 */
+void addBlockInertia(double a, double b, double c, Inertia& inertia) {
+    const double det = a * c - b * b;
+    if (det < 0.0) {
+        ++inertia.positive;
+        ++inertia.negative;
+    } else if (a + c > 0.0) {
+        inertia.positive += 2;
+    } else {
+        inertia.negative += 2;
+    }
+}
+
+SolveResult solveSymmetric(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia* inertia,
+                           bool (*factorize)(Eigen::MatrixXd&, SymmetricFactor&), const char* method) {
+    SolveResult result;
+    result.method = method;
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for " << method << ".\n";
+        return result;
+    }
+    Eigen::MatrixXd LD = A;
+    SymmetricFactor factor;
+    if (!factorize(LD, factor)) {
+        std::cerr << "Error: " << method << " decomposition failed (non-finite entries or indefinite matrix).\n";
+        return result;
+    }
+    result.solution = solveFactoredLDLT(LD, factor, b);
+    if (inertia != nullptr) {
+        *inertia = factor.inertia;
+    }
+    result.error = (A.selfadjointView<Eigen::Lower>() * result.solution - b).norm();
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+/**
+ * @brief 分块的 LDLT / Bunch–Kaufman 分解（与 LAPACK sytrf + lasyf 相同的组织方式）
+ *
+ * 每次处理 block 列的面板：面板内的列按需用 GEMV 补上面板内已消去的列带来的更新（只算主元选择要用到的列），
+ * L 的列存回 A，未除以主元的列存进工作矩阵 W；面板结束后一次性做 A₂₂ ← A₂₂ - L Wᵀ，只算下三角，是 BLAS-3 运算。
+ * 不分块时每消去一列都要读写整个剩余下三角，矩阵大于缓存后受内存带宽限制。
+ */
+bool factorSymmetricBlocked(Eigen::MatrixXd& A, SymmetricFactor& factor, bool bunch_kaufman) {
+    const double tolerance = beginSymmetricFactor(A, factor);
+    if (!std::isfinite(tolerance)) {
+        return false;
+    }
+    const int n = static_cast<int>(A.rows()), block = 64;
+    const double alpha = (1.0 + std::sqrt(17.0)) / 8.0;
+    Eigen::MatrixXd W(n, block + 1); // 2x2 主元可能让面板多出一列
+    Eigen::VectorXd diagonal = A.diagonal(); // LDLT：补上面板内更新后的对角元，用于选主元
+    Eigen::VectorXd column(n), other(n);
+
+    int k = 0;
+    while (k < n) {
+        const int start = k;
+        bool zero_tail = false;
+        // 第 j 列第 k 行以下的当前值（已做面板内的更新）；j 列在 k..j-1 行的元素存放在第 j 行
+        auto updated = [&](int j, Eigen::VectorXd& v) {
+            const int m = n - k, used = k - start;
+            v.resize(m);
+            v.head(j - k) = A.row(j).segment(k, j - k).transpose();
+            v.tail(n - j) = A.col(j).tail(n - j);
+            if (used > 0) {
+                v.noalias() -= A.block(k, start, m, used) * W.row(j).head(used).transpose();
+            }
+        };
+        auto interchange = [&](int p, int q) {
+            if (p != q) {
+                symmetricInterchange(A, p, q, factor);
+                W.row(p).head(k - start).swap(W.row(q).head(k - start));
+                std::swap(diagonal(p), diagonal(q));
+            }
+        };
+
+        while (k < n && k - start < block) {
+            const int m = n - k, used = k - start;
+            int step = 1;
+            if (!bunch_kaufman) {
+                Eigen::Index pivot = 0;
+                if (diagonal.tail(m).cwiseAbs().maxCoeff(&pivot) <= tolerance) {
+                    zero_tail = true;
+                    break;
+                }
+                interchange(k, k + static_cast<int>(pivot));
+                updated(k, column);
+            } else {
+                updated(k, column);
+                const double absakk = std::abs(column(0));
+                Eigen::Index imax = 0;
+                const double colmax = m > 1 ? column.tail(m - 1).cwiseAbs().maxCoeff(&imax) : 0.0;
+                const int r = k + 1 + static_cast<int>(imax);
+                if (std::max(absakk, colmax) <= tolerance) {
+                    // 整列可以忽略：零主元，L 与 W 的该列为零
+                    A.col(k).tail(m).setZero();
+                    W.col(used).segment(k, m).setZero();
+                    ++factor.inertia.zero;
+                    ++k;
+                    continue;
+                }
+                if (absakk < alpha * colmax) {
+                    // 第 r 列（除对角元外）的最大绝对值
+                    updated(r, other);
+                    const double diagonal_r = other(r - k);
+                    other(r - k) = 0.0;
+                    const double rowmax = other.cwiseAbs().maxCoeff();
+                    other(r - k) = diagonal_r;
+                    if (absakk * rowmax >= alpha * colmax * colmax) {
+                        // 仍用 1x1 主元 A(k, k)
+                    } else if (std::abs(diagonal_r) >= alpha * rowmax) {
+                        interchange(k, r); // 交换后的第 k 列就是原来的第 r 列，再交换第 k、r 行
+                        column.swap(other);
+                        std::swap(column(0), column(r - k));
+                    } else {
+                        interchange(k + 1, r); // 2x2 主元：第 k+1、r 行列交换
+                        std::swap(column(1), column(r - k));
+                        std::swap(other(1), other(r - k));
+                        step = 2;
+                    }
+                }
+            }
+
+            if (step == 1) {
+                const double d = column(0);
+                ++(d > 0.0 ? factor.inertia.positive : factor.inertia.negative);
+                W.col(used).segment(k, m) = column;
+                A.col(k).tail(m) = column;
+                A.col(k).tail(m - 1) /= d;
+                diagonal.tail(m - 1) -= A.col(k).tail(m - 1).cwiseProduct(W.col(used).tail(m - 1));
+            } else {
+                // other 是第 k+1 列从第 k 行开始的当前值；[l₁ l₂] = [a₁ a₂] D⁻¹
+                const double d11 = column(0), d21 = column(1), d22 = other(1);
+                const double det = d11 * d22 - d21 * d21;
+                addBlockInertia(d11, d21, d22, factor.inertia);
+                factor.block_sizes[k] = 2;
+                factor.block_sizes[k + 1] = 0;
+                W.col(used).segment(k, m) = column;
+                W.col(used + 1).segment(k, m) = other;
+                A(k, k) = d11;
+                A(k + 1, k) = d21;
+                A(k + 1, k + 1) = d22;
+                const int rest = m - 2;
+                A.col(k).tail(rest) = (d22 * column.tail(rest) - d21 * other.tail(rest)) / det;
+                A.col(k + 1).tail(rest) = (d11 * other.tail(rest) - d21 * column.tail(rest)) / det;
+            }
+            k += step;
+        }
+
+        // 面板结束：A₂₂ ← A₂₂ - L Wᵀ，只算下三角
+        const int m = n - k, used = k - start;
+        if (m > 0 && used > 0) {
+            A.bottomRightCorner(m, m).triangularView<Eigen::Lower>() -=
+                A.block(k, start, m, used) * W.block(k, 0, m, used).transpose();
+            diagonal.tail(m) = A.diagonal().tail(m);
+        }
+        if (zero_tail) {
+            // 剩余对角元都可以忽略：对半正定矩阵意味着剩余部分为零；否则是对角为零的不定矩阵，对角主元无法继续
+            if (lowerMaxAbs(A.bottomRightCorner(m, m)) > tolerance) {
+                return false;
+            }
+            A.bottomRightCorner(m, m).triangularView<Eigen::Lower>().setZero();
+            factor.inertia.zero += m;
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool factorLDLT(Eigen::MatrixXd& A, SymmetricFactor& factor) {
+    return factorSymmetricBlocked(A, factor, false);
+}
+
+bool factorBunchKaufman(Eigen::MatrixXd& A, SymmetricFactor& factor) {
+    return factorSymmetricBlocked(A, factor, true);
+}
+
+Eigen::VectorXd solveFactoredLDLT(const Eigen::MatrixXd& LD, const SymmetricFactor& factor, const Eigen::VectorXd& b) {
+    const int n = static_cast<int>(LD.rows());
+    Eigen::VectorXd y(n);
+    for (int i = 0; i < n; ++i) {
+        y(i) = b(factor.permutation[i]);
+    }
+    // L z = P b：2x2 块内 L 的次对角为零，跳过存放 D(k+1, k) 的位置
+    for (int k = 0; k < n; k += factor.block_sizes[k]) {
+        const int step = factor.block_sizes[k], rest = n - k - step;
+        for (int c = k; c < k + step; ++c) {
+            y.tail(rest) -= LD.col(c).tail(rest) * y(c);
+        }
+    }
+    // D w = z，零主元对应的分量取零
+    for (int k = 0; k < n; k += factor.block_sizes[k]) {
+        if (factor.block_sizes[k] == 1) {
+            y(k) = LD(k, k) != 0.0 ? y(k) / LD(k, k) : 0.0;
+        } else {
+            const double d11 = LD(k, k), d21 = LD(k + 1, k), d22 = LD(k + 1, k + 1);
+            const double det = d11 * d22 - d21 * d21, y1 = y(k), y2 = y(k + 1);
+            y(k) = (d22 * y1 - d21 * y2) / det;
+            y(k + 1) = (d11 * y2 - d21 * y1) / det;
+        }
+    }
+    // Lᵀ P x = w，从最后一块往前
+    for (int k = n - 1; k >= 0; --k) {
+        if (factor.block_sizes[k] == 0) {
+            continue; // 2x2 块的第二行在处理第一行时一起完成
+        }
+        const int step = factor.block_sizes[k], rest = n - k - step;
+        for (int c = k; c < k + step; ++c) {
+            y(c) -= LD.col(c).tail(rest).dot(y.tail(rest));
+        }
+    }
+    Eigen::VectorXd x(n);
+    for (int i = 0; i < n; ++i) {
+        x(factor.permutation[i]) = y(i);
+    }
+    return x;
+}
+
+/**
+ * @brief 使用 LDLT 分解求解 (适用于对称半正定/半负定矩阵，可以奇异)
+ */
+SolveResult solveWithLDLT(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia* inertia) {
+    return solveSymmetric(A, b, inertia, factorLDLT, "LDLT (diagonal pivoting)");
+}
+
+/**
+ * @brief 使用 Bunch–Kaufman 分解求解 (适用于对称不定矩阵，可以奇异)
+ */
+SolveResult solveWithBunchKaufman(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia* inertia) {
+    return solveSymmetric(A, b, inertia, factorBunchKaufman, "Bunch-Kaufman (LDLT)");
+}
+
 // --- 迭代法求解器实现 ---
 
 /**
@@ -222,4 +805,1424 @@ SolveResult solveWithManualJacobi(const Eigen::MatrixXd& A, const Eigen::VectorX
     result.error = (A * result.solution - b).norm();
     // success 保持 false
     return result;
-} 
\ No newline at end of file
+} 
+
+// --- 带停止条件与回调的迭代法实现 ---
+
+namespace {
+
+/**
+ * @brief 记录残差、检查停止条件并调用回调，CG 与 BiCGSTAB 共用
+ */
+class IterationMonitor {
+public:
+    IterationMonitor(const IterativeOptions& options, Eigen::Index n, IterationLog* log)
+        : options_(options),
+          max_iterations_(options.max_iterations > 0 ? options.max_iterations : 2 * static_cast<int>(n)),
+          log_(log), start_(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief 第 iteration 次迭代后（0 为迭代开始前）调用
+     * @return bool 应当停止时为 true，原因由 reason() 给出
+     */
+    bool stop(int iteration, double residual, const Eigen::VectorXd& x) {
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_;
+        if (log_ != nullptr) {
+            log_->residuals.push_back(residual);
+            log_->elapsed_ms.push_back(elapsed.count());
+        }
+        iterations_ = iteration;
+        residual_ = residual;
+        // 回调看到每一次迭代，包括收敛的那一次；收敛时忽略它的返回值
+        const bool observer_stop = iteration > 0 && options_.observer
+            && !options_.observer(IterationProgress{ iteration, residual, elapsed.count(), &x });
+        if (!std::isfinite(residual)) {
+            reason_ = StopReason::Breakdown;
+        } else if (residual < options_.tolerance) {
+            reason_ = StopReason::Converged;
+        } else if (observer_stop) {
+            reason_ = StopReason::Observer;
+        } else if (iteration >= max_iterations_) {
+            reason_ = StopReason::MaxIterations;
+        } else if (options_.time_budget_ms > 0.0 && elapsed.count() >= options_.time_budget_ms) {
+            reason_ = StopReason::TimeBudget;
+        } else if (stagnated(iteration, residual)) {
+            reason_ = StopReason::Stagnation;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 把最后的迭代值与结束原因写入 result 和 log
+     */
+    void finish(Eigen::VectorXd&& x, SolveResult& result) const {
+        result.solution = std::move(x);
+        result.iterations = iterations_;
+        result.error = residual_;
+        result.success = reason_ == StopReason::Converged;
+        if (log_ != nullptr) {
+            log_->reason = reason_;
+        }
+    }
+
+private:
+    bool stagnated(int iteration, double residual) {
+        if (iteration == 0 || residual < best_ * (1.0 - options_.stagnation_decrease)) {
+            best_ = std::min(best_, residual);
+            since_best_ = 0;
+            return false;
+        }
+        best_ = std::min(best_, residual);
+        return options_.stagnation_iterations > 0 && ++since_best_ >= options_.stagnation_iterations;
+    }
+
+    const IterativeOptions& options_;
+    int max_iterations_;
+    IterationLog* log_;
+    std::chrono::steady_clock::time_point start_;
+    int iterations_ = 0;
+    double residual_ = 0.0;
+    double best_ = std::numeric_limits<double>::infinity();
+    int since_best_ = 0;
+    StopReason reason_ = StopReason::MaxIterations;
+};
+
+/**
+ * @brief 对角预条件（与 Eigen::DiagonalPreconditioner 相同，零对角元取 1）
+ */
+Eigen::VectorXd inverseDiagonal(const Eigen::MatrixXd& A) {
+    return A.diagonal().unaryExpr([](double d) { return d != 0.0 ? 1.0 / d : 1.0; });
+}
+
+/**
+ * @brief 预条件共轭梯度，与 Eigen::internal::conjugate_gradient 的递推相同；x 为初值，返回时为最后的迭代值
+ */
+void conjugateGradient(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Eigen::VectorXd& x,
+                       IterationMonitor& monitor) {
+    const double rhs_norm2 = b.squaredNorm();
+    if (rhs_norm2 == 0.0) {
+        x.setZero();
+        monitor.stop(0, 0.0, x);
+        return;
+    }
+    // A 对称，与 Eigen（UpLo = Lower | Upper）一样乘 Aᵀ：按行访问的矩阵向量乘法，结果逐位相同
+    const auto At = A.transpose();
+    const Eigen::VectorXd inverse_diagonal = inverseDiagonal(A);
+    Eigen::VectorXd r = b - At * x;
+    if (monitor.stop(0, std::sqrt(r.squaredNorm() / rhs_norm2), x)) {
+        return;
+    }
+    Eigen::VectorXd p = inverse_diagonal.cwiseProduct(r), z, tmp;
+    double abs_new = r.dot(p);
+    for (int k = 1;; ++k) {
+        tmp.noalias() = At * p;
+        const double alpha = abs_new / p.dot(tmp);
+        x += alpha * p;
+        r -= alpha * tmp;
+        if (monitor.stop(k, std::sqrt(r.squaredNorm() / rhs_norm2), x)) {
+            return;
+        }
+        z = inverse_diagonal.cwiseProduct(r);
+        const double abs_old = abs_new;
+        abs_new = r.dot(z);
+        p = z + (abs_new / abs_old) * p;
+    }
+}
+
+/**
+ * @brief 预条件 BiCGSTAB，与 Eigen::internal::bicgstab 的递推相同（ρ 接近零时用当前解重新开始）
+ */
+void biconjugateGradientStabilized(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Eigen::VectorXd& x,
+                                   IterationMonitor& monitor) {
+    const double rhs_norm2 = b.squaredNorm();
+    if (rhs_norm2 == 0.0) {
+        x.setZero();
+        monitor.stop(0, 0.0, x);
+        return;
+    }
+    const Eigen::VectorXd inverse_diagonal = inverseDiagonal(A);
+    const double eps2 = Eigen::NumTraits<double>::epsilon() * Eigen::NumTraits<double>::epsilon();
+    Eigen::VectorXd r = b - A * x;
+    Eigen::VectorXd r0 = r;
+    double r0_norm2 = r0.squaredNorm();
+    if (monitor.stop(0, std::sqrt(r.squaredNorm() / rhs_norm2), x)) {
+        return;
+    }
+    const Eigen::Index n = b.size();
+    Eigen::VectorXd v = Eigen::VectorXd::Zero(n), p = Eigen::VectorXd::Zero(n), y, z, s, t;
+    double rho = 1.0, alpha = 1.0, w = 1.0;
+    for (int k = 1;; ++k) {
+        const double rho_old = rho;
+        rho = r0.dot(r);
+        if (std::abs(rho) < eps2 * r0_norm2) {
+            r = b - A * x;
+            r0 = r;
+            rho = r0_norm2 = r.squaredNorm();
+        }
+        const double beta = (rho / rho_old) * (alpha / w);
+        p = r + beta * (p - w * v);
+        y = inverse_diagonal.cwiseProduct(p);
+        v.noalias() = A * y;
+        alpha = rho / r0.dot(v);
+        s = r - alpha * v;
+        z = inverse_diagonal.cwiseProduct(s);
+        t.noalias() = A * z;
+        const double t_norm2 = t.squaredNorm();
+        w = t_norm2 > 0.0 ? t.dot(s) / t_norm2 : 0.0;
+        x += alpha * y + w * z;
+        r = s - w * t;
+        if (monitor.stop(k, std::sqrt(r.squaredNorm() / rhs_norm2), x)) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 带停止条件与回调的共轭梯度法
+ */
+SolveResult solveWithConjugateGradient(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                                       const IterativeOptions& options, IterationLog* log) {
+    SolveResult result;
+    result.method = "Conjugate Gradient (monitored)";
+    if (log != nullptr) {
+        *log = IterationLog();
+    }
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for CG.\n";
+        return result;
+    }
+    if (!A.isApprox(A.transpose())) {
+        std::cerr << "Error: Matrix A is not symmetric, cannot use Conjugate Gradient.\n";
+        return result;
+    }
+    IterationMonitor monitor(options, A.rows(), log);
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(A.rows());
+    conjugateGradient(A, b, x, monitor);
+    monitor.finish(std::move(x), result);
+    return result;
+}
+
+/**
+ * @brief 带停止条件与回调的 BiCGSTAB
+ */
+SolveResult solveWithBiCGSTAB(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const IterativeOptions& options,
+                              IterationLog* log) {
+    SolveResult result;
+    result.method = "BiCGSTAB (monitored)";
+    if (log != nullptr) {
+        *log = IterationLog();
+    }
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for BiCGSTAB.\n";
+        return result;
+    }
+    IterationMonitor monitor(options, A.rows(), log);
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(A.rows());
+    biconjugateGradientStabilized(A, b, x, monitor);
+    monitor.finish(std::move(x), result);
+    return result;
+}
+
+// --- 稀疏直接法实现 ---
+
+namespace {
+
+std::uint64_t mixHash(std::uint64_t hash, std::uint64_t value) {
+    // splitmix64 的末尾混合：相邻的下标也会得到差别很大的哈希
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief 未压缩（仍有插入空位）的矩阵先复制并压缩，之后的代码都按压缩格式访问
+ */
+const Eigen::SparseMatrix<double>& compressedView(const Eigen::SparseMatrix<double>& A,
+                                                  Eigen::SparseMatrix<double>& storage) {
+    if (A.isCompressed()) {
+        return A;
+    }
+    storage = A;
+    storage.makeCompressed();
+    return storage;
+}
+
+/**
+ * @brief 消去树上从 C 第 k 列（上三角）各元素出发、到 k 为止的路径，即 L 第 k 行的非零列
+ *
+ * 结果按拓扑序存放在 stack[top, n)；marks[i] == k 表示 i 已访问。返回 top。
+ */
+int eliminationReach(const SparseSymbolic& symbolic, int k, std::vector<int>& marks, std::vector<int>& stack) {
+    const int n = static_cast<int>(symbolic.parent.size());
+    int top = n;
+    marks[k] = k;
+    for (int p = symbolic.upper_pointers[k]; p < symbolic.upper_pointers[k + 1]; ++p) {
+        int i = symbolic.upper_rows[p];
+        int length = 0;
+        for (; marks[i] != k; i = symbolic.parent[i]) {
+            stack[length++] = i; // 先按路径顺序放在栈底，再整体搬到栈顶
+            marks[i] = k;
+        }
+        while (length > 0) {
+            stack[--top] = stack[--length];
+        }
+    }
+    return top;
+}
+
+/**
+ * @brief 分解运算量的估计 Σ c_j²，c_j 为 L 第 j 列的非零元个数
+ */
+double choleskyFlops(const SparseSymbolic& symbolic) {
+    double flops = 0.0;
+    for (std::size_t j = 0; j + 1 < symbolic.column_pointers.size(); ++j) {
+        const double count = symbolic.column_pointers[j + 1] - symbolic.column_pointers[j];
+        flops += count * count;
+    }
+    return flops;
+}
+
+/**
+ * @brief 第 j 列是否开始一个新的超节点：j - 1 的父节点不是 j，或去掉对角元后两列的非零元个数不同
+ */
+bool startsSupernode(const SparseSymbolic& symbolic, int j) {
+    const std::vector<int>& pointers = symbolic.column_pointers;
+    return j == 0 || symbolic.parent[j - 1] != j || pointers[j] - pointers[j - 1] != pointers[j + 1] - pointers[j] + 1;
+}
+
+// 平均每个超节点的运算量超过该值时，稠密内核的收益超过超节点装配的固定开销，solveSparse 改用超节点分解
+constexpr double kSupernodalFlopsPerSupernode = 1000.0;
+
+bool preferSupernodal(const SparseSymbolic& symbolic) {
+    int supernodes = 0;
+    for (std::size_t j = 0; j < symbolic.parent.size(); ++j) {
+        supernodes += startsSupernode(symbolic, static_cast<int>(j));
+    }
+    return choleskyFlops(symbolic) >= kSupernodalFlopsPerSupernode * supernodes;
+}
+
+} // namespace
+
+SparsityFingerprint sparsityFingerprint(const Eigen::SparseMatrix<double>& A) {
+    Eigen::SparseMatrix<double> storage;
+    const Eigen::SparseMatrix<double>& M = compressedView(A, storage);
+    SparsityFingerprint fingerprint;
+    fingerprint.rows = M.rows();
+    fingerprint.cols = M.cols();
+    fingerprint.nonzeros = M.nonZeros();
+    std::uint64_t hash = mixHash(static_cast<std::uint64_t>(M.rows()), static_cast<std::uint64_t>(M.cols()));
+    for (Eigen::Index j = 0; j <= M.cols(); ++j) {
+        hash = mixHash(hash, static_cast<std::uint64_t>(M.outerIndexPtr()[j]));
+    }
+    for (Eigen::Index p = 0; p < M.nonZeros(); ++p) {
+        hash = mixHash(hash, static_cast<std::uint64_t>(M.innerIndexPtr()[p]));
+    }
+    fingerprint.hash = hash;
+    return fingerprint;
+}
+
+bool analyzeSparseCholesky(const Eigen::SparseMatrix<double>& A, SparseSymbolic& symbolic) {
+    if (A.rows() != A.cols()) {
+        std::cerr << "Error: Matrix A must be square for sparse Cholesky analysis.\n";
+        return false;
+    }
+    Eigen::SparseMatrix<double> storage;
+    const Eigen::SparseMatrix<double>& M = compressedView(A, storage);
+    const int n = static_cast<int>(M.rows());
+    symbolic.fingerprint = sparsityFingerprint(M);
+
+    // 1. AMD 排序（按下三角对称化后的模式）
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> order; // order[新编号] = 旧编号
+    if (n > 0) {
+        Eigen::AMDOrdering<int>()(M.selfadjointView<Eigen::Lower>(), order);
+    }
+    symbolic.permutation.assign(order.indices().data(), order.indices().data() + n);
+    std::vector<int> rank(n);
+    for (int k = 0; k < n; ++k) {
+        rank[symbolic.permutation[k]] = k;
+    }
+
+    // 2. C = A(permutation, permutation) 的上三角模式与 A 的每个存储元素到它的映射
+    const int* outer = M.outerIndexPtr();
+    const int* inner = M.innerIndexPtr();
+    symbolic.upper_pointers.assign(n + 1, 0);
+    for (int j = 0; j < n; ++j) {
+        for (int p = outer[j]; p < outer[j + 1]; ++p) {
+            if (inner[p] >= j) {
+                ++symbolic.upper_pointers[std::max(rank[inner[p]], rank[j]) + 1];
+            }
+        }
+    }
+    for (int k = 0; k < n; ++k) {
+        symbolic.upper_pointers[k + 1] += symbolic.upper_pointers[k];
+    }
+    symbolic.upper_rows.resize(symbolic.upper_pointers[n]);
+    symbolic.scatter.assign(M.nonZeros(), -1);
+    std::vector<int> next(symbolic.upper_pointers.begin(), symbolic.upper_pointers.end() - 1);
+    for (int j = 0; j < n; ++j) {
+        for (int p = outer[j]; p < outer[j + 1]; ++p) {
+            if (inner[p] >= j) {
+                const int r = rank[inner[p]], c = rank[j];
+                const int position = next[std::max(r, c)]++;
+                symbolic.upper_rows[position] = std::min(r, c);
+                symbolic.scatter[p] = position;
+            }
+        }
+    }
+
+    // 3. 消去树（Liu 的算法，带路径压缩的祖先数组）
+    symbolic.parent.assign(n, -1);
+    std::vector<int> ancestor(n, -1);
+    for (int k = 0; k < n; ++k) {
+        for (int p = symbolic.upper_pointers[k]; p < symbolic.upper_pointers[k + 1]; ++p) {
+            for (int i = symbolic.upper_rows[p]; i != -1 && i < k;) {
+                const int up = ancestor[i];
+                ancestor[i] = k;
+                if (up == -1) {
+                    symbolic.parent[i] = k;
+                }
+                i = up;
+            }
+        }
+    }
+
+    // 4. L 的列计数：L 第 k 行的非零列就是消去树上的可达集合，总代价 O(nnz(L))
+    std::vector<int> counts(n, 1); // 对角元
+    std::vector<int> marks(n, -1), stack(n);
+    for (int k = 0; k < n; ++k) {
+        for (int top = eliminationReach(symbolic, k, marks, stack); top < n; ++top) {
+            ++counts[stack[top]];
+        }
+    }
+    symbolic.column_pointers.assign(n + 1, 0);
+    for (int j = 0; j < n; ++j) {
+        symbolic.column_pointers[j + 1] = symbolic.column_pointers[j] + counts[j];
+    }
+    return true;
+}
+
+bool analyzeSupernodal(const Eigen::SparseMatrix<double>& A, const SparseSymbolic& symbolic,
+                       SupernodalSymbolic& supernodal) {
+    const int n = static_cast<int>(symbolic.parent.size());
+    if (A.rows() != n || A.cols() != n) {
+        std::cerr << "Error: Matrix A does not match the symbolic analysis for supernodal Cholesky.\n";
+        return false;
+    }
+    Eigen::SparseMatrix<double> storage;
+    const Eigen::SparseMatrix<double>& M = compressedView(A, storage);
+
+    // 1. 超节点：j 是 j - 1 的父节点，且 L 的第 j - 1 列去掉对角元后与第 j 列的非零结构相同（个数相同即可判定）
+    supernodal.supernode_columns.assign(1, 0);
+    std::vector<int> supernode_of(n);
+    for (int j = 0; j < n; ++j) {
+        if (j > 0 && startsSupernode(symbolic, j)) {
+            supernodal.supernode_columns.push_back(j);
+        }
+        supernode_of[j] = static_cast<int>(supernodal.supernode_columns.size()) - 1;
+    }
+    if (n > 0) {
+        supernodal.supernode_columns.push_back(n);
+    }
+    const int supernodes = static_cast<int>(supernodal.supernode_columns.size()) - 1;
+    supernodal.supernode_parent.assign(supernodes, -1);
+    supernodal.flops = choleskyFlops(symbolic);
+    for (int s = 0; s < supernodes; ++s) {
+        const int last = supernodal.supernode_columns[s + 1] - 1;
+        if (symbolic.parent[last] != -1) {
+            supernodal.supernode_parent[s] = supernode_of[symbolic.parent[last]];
+        }
+    }
+
+    // 2. 排序后矩阵的下三角（按列），以及 A 的存储元素到它的映射
+    std::vector<int> rank(n);
+    for (int k = 0; k < n; ++k) {
+        rank[symbolic.permutation[k]] = k;
+    }
+    const int* outer = M.outerIndexPtr();
+    const int* inner = M.innerIndexPtr();
+    supernodal.lower_pointers.assign(n + 1, 0);
+    for (int j = 0; j < n; ++j) {
+        for (int p = outer[j]; p < outer[j + 1]; ++p) {
+            if (inner[p] >= j) {
+                ++supernodal.lower_pointers[std::min(rank[inner[p]], rank[j]) + 1];
+            }
+        }
+    }
+    for (int k = 0; k < n; ++k) {
+        supernodal.lower_pointers[k + 1] += supernodal.lower_pointers[k];
+    }
+    supernodal.lower_rows.resize(supernodal.lower_pointers[n]);
+    supernodal.lower_scatter.assign(M.nonZeros(), -1);
+    std::vector<int> next(supernodal.lower_pointers.begin(), supernodal.lower_pointers.end() - 1);
+    for (int j = 0; j < n; ++j) {
+        for (int p = outer[j]; p < outer[j + 1]; ++p) {
+            if (inner[p] >= j) {
+                const int r = rank[inner[p]], c = rank[j];
+                const int position = next[std::min(r, c)]++;
+                supernodal.lower_rows[position] = std::max(r, c);
+                supernodal.lower_scatter[p] = position;
+            }
+        }
+    }
+
+    // 3. 行结构：自己各列的下三角元素与子超节点行结构的并集（子超节点按编号在父节点之前）
+    std::vector<std::vector<int>> children(supernodes);
+    for (int s = 0; s < supernodes; ++s) {
+        if (supernodal.supernode_parent[s] != -1) {
+            children[supernodal.supernode_parent[s]].push_back(s);
+        }
+    }
+    supernodal.row_pointers.assign(1, 0);
+    supernodal.rows.clear();
+    supernodal.rows.reserve(symbolic.column_pointers[n]);
+    std::vector<int> marks(n, -1);
+    for (int s = 0; s < supernodes; ++s) {
+        const int first = supernodal.supernode_columns[s], end = supernodal.supernode_columns[s + 1];
+        const std::size_t begin = supernodal.rows.size();
+        auto add = [&](int row) {
+            if (row >= first && marks[row] != s) {
+                marks[row] = s;
+                supernodal.rows.push_back(row);
+            }
+        };
+        for (int j = first; j < end; ++j) {
+            add(j); // 对角元即使没有存储也属于 L
+            for (int p = supernodal.lower_pointers[j]; p < supernodal.lower_pointers[j + 1]; ++p) {
+                add(supernodal.lower_rows[p]);
+            }
+        }
+        for (int child : children[s]) {
+            for (int p = supernodal.row_pointers[child]; p < supernodal.row_pointers[child + 1]; ++p) {
+                add(supernodal.rows[p]);
+            }
+        }
+        std::sort(supernodal.rows.begin() + begin, supernodal.rows.end());
+        supernodal.row_pointers.push_back(static_cast<int>(supernodal.rows.size()));
+    }
+
+    // 4. 面板的存放位置与更新关系：d 的行结构落在 s 的列中时，d 需要更新 s
+    supernodal.value_pointers.assign(1, 0);
+    std::vector<int> targets;
+    std::vector<std::pair<int, int>> updates; // (s, d)
+    for (int d = 0; d < supernodes; ++d) {
+        const int width = supernodal.supernode_columns[d + 1] - supernodal.supernode_columns[d];
+        const int height = supernodal.row_pointers[d + 1] - supernodal.row_pointers[d];
+        supernodal.value_pointers.push_back(supernodal.value_pointers.back()
+                                            + static_cast<std::size_t>(width) * height);
+        int previous = -1;
+        for (int p = supernodal.row_pointers[d] + width; p < supernodal.row_pointers[d + 1]; ++p) {
+            const int target = supernode_of[supernodal.rows[p]];
+            if (target != previous) {
+                updates.emplace_back(target, d);
+                previous = target;
+            }
+        }
+    }
+    supernodal.update_pointers.assign(supernodes + 1, 0);
+    for (const auto& update : updates) {
+        ++supernodal.update_pointers[update.first + 1];
+    }
+    for (int s = 0; s < supernodes; ++s) {
+        supernodal.update_pointers[s + 1] += supernodal.update_pointers[s];
+    }
+    supernodal.update_sources.resize(updates.size());
+    std::vector<int> fill(supernodal.update_pointers.begin(), supernodal.update_pointers.end() - 1);
+    for (const auto& update : updates) {
+        supernodal.update_sources[fill[update.first]++] = update.second; // d 按升序遍历，列表也是升序
+    }
+    return true;
+}
+
+const SparseSymbolic* SparseAnalysisCache::analysis(const Eigen::SparseMatrix<double>& A) {
+    if (valid_ && sparsityFingerprint(A) == symbolic_.fingerprint) {
+        ++hits_;
+        return &symbolic_;
+    }
+    ++misses_;
+    supernodal_valid_ = false;
+    valid_ = analyzeSparseCholesky(A, symbolic_);
+    return valid_ ? &symbolic_ : nullptr;
+}
+
+const SupernodalSymbolic* SparseAnalysisCache::supernodalAnalysis(const Eigen::SparseMatrix<double>& A,
+                                                                   const SparseSymbolic** symbolic) {
+    if (analysis(A) == nullptr) {
+        return nullptr;
+    }
+    if (symbolic != nullptr) {
+        *symbolic = &symbolic_;
+    }
+    if (!supernodal_valid_) {
+        supernodal_valid_ = analyzeSupernodal(A, symbolic_, supernodal_);
+    }
+    return supernodal_valid_ ? &supernodal_ : nullptr;
+}
+
+void SparseAnalysisCache::clear() {
+    valid_ = false;
+    supernodal_valid_ = false;
+}
+
+namespace {
+
+/**
+ * @brief 有缓存时从缓存取符号分析，否则分析到 local 中；失败时为空
+ */
+const SparseSymbolic* lookupSymbolic(const Eigen::SparseMatrix<double>& M, SparseAnalysisCache* cache,
+                                     SparseSymbolic& local) {
+    if (cache != nullptr) {
+        return cache->analysis(M);
+    }
+    return analyzeSparseCholesky(M, local) ? &local : nullptr;
+}
+
+/**
+ * @brief 按符号分析做 up-looking 数值分解与回代，结果写入 result
+ * @return bool 分解失败（不正定）时为 false，不打印错误
+ */
+bool simplicialLLT(const Eigen::SparseMatrix<double>& M, const Eigen::VectorXd& b, const SparseSymbolic& symbolic,
+                   SolveResult& result) {
+    const int n = static_cast<int>(M.rows());
+
+    // 按缓存的映射把 A 的下三角搬到 C 的上三角，不需要重新排序
+    std::vector<double> upper_values(symbolic.upper_rows.size(), 0.0);
+    for (Eigen::Index p = 0; p < M.nonZeros(); ++p) {
+        if (symbolic.scatter[p] >= 0) {
+            upper_values[symbolic.scatter[p]] = M.valuePtr()[p];
+        }
+    }
+
+    // up-looking 数值分解：L 的第 k 行由 L(0:k, 0:k) y = C(0:k, k) 的稀疏三角求解得到
+    const int nonzeros = symbolic.column_pointers[n];
+    std::vector<int> rows(nonzeros);
+    std::vector<double> values(nonzeros);
+    std::vector<int> next(symbolic.column_pointers.begin(), symbolic.column_pointers.end() - 1);
+    std::vector<int> marks(n, -1), stack(n);
+    std::vector<double> x(n, 0.0);
+    for (int k = 0; k < n; ++k) {
+        const int top = eliminationReach(symbolic, k, marks, stack);
+        x[k] = 0.0;
+        for (int p = symbolic.upper_pointers[k]; p < symbolic.upper_pointers[k + 1]; ++p) {
+            x[symbolic.upper_rows[p]] = upper_values[p];
+        }
+        double d = x[k];
+        x[k] = 0.0;
+        for (int t = top; t < n; ++t) {
+            const int i = stack[t];
+            const double l = x[i] / values[symbolic.column_pointers[i]]; // L(k, i)
+            x[i] = 0.0;
+            for (int p = symbolic.column_pointers[i] + 1; p < next[i]; ++p) {
+                x[rows[p]] -= values[p] * l;
+            }
+            d -= l * l;
+            rows[next[i]] = k;
+            values[next[i]++] = l;
+        }
+        if (!(d > 0.0) || !std::isfinite(d)) {
+            return false;
+        }
+        rows[next[k]] = k;
+        values[next[k]++] = std::sqrt(d);
+    }
+
+    // 回代：L y = P b，Lᵀ z = y，x = Pᵀ z
+    Eigen::VectorXd y(n);
+    for (int k = 0; k < n; ++k) {
+        y(k) = b(symbolic.permutation[k]);
+    }
+    for (int j = 0; j < n; ++j) {
+        y(j) /= values[symbolic.column_pointers[j]];
+        for (int p = symbolic.column_pointers[j] + 1; p < symbolic.column_pointers[j + 1]; ++p) {
+            y(rows[p]) -= values[p] * y(j);
+        }
+    }
+    for (int j = n - 1; j >= 0; --j) {
+        for (int p = symbolic.column_pointers[j] + 1; p < symbolic.column_pointers[j + 1]; ++p) {
+            y(j) -= values[p] * y(rows[p]);
+        }
+        y(j) /= values[symbolic.column_pointers[j]];
+    }
+    result.solution.resize(n);
+    for (int k = 0; k < n; ++k) {
+        result.solution(symbolic.permutation[k]) = y(k);
+    }
+    result.error = (M.selfadjointView<Eigen::Lower>() * result.solution - b).norm();
+    result.success = result.solution.allFinite();
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 使用稀疏 Cholesky 分解求解 (适用于稀疏对称正定矩阵)
+ */
+SolveResult solveWithSparseLLT(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b,
+                               SparseAnalysisCache* cache) {
+    SolveResult result;
+    result.method = cache != nullptr ? "Sparse LLT (AMD, cached analysis)" : "Sparse LLT (AMD)";
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for sparse LLT.\n";
+        return result;
+    }
+    Eigen::SparseMatrix<double> storage;
+    const Eigen::SparseMatrix<double>& M = compressedView(A, storage);
+    SparseSymbolic local;
+    const SparseSymbolic* symbolic = lookupSymbolic(M, cache, local);
+    if (symbolic != nullptr && !simplicialLLT(M, b, *symbolic, result)) {
+        std::cerr << "Error: Sparse LLT found a non-positive pivot (matrix is not positive definite).\n";
+    }
+    return result;
+}
+
+namespace {
+
+/**
+ * @brief 在线程池上按树的依赖执行任务：parent[t] 为任务 t 的父任务（根为 -1），子任务都完成后父任务才就绪
+ *
+ * 就绪任务按后进先出执行（深度优先，刚完成的子任务的数据还在缓存中）。
+ * task(t, worker) 中的 worker 是执行它的循环的编号（0 到 pool.size() - 1），用于选择线程私有的工作区。
+ * @return bool 所有任务都成功时为 true；某个任务失败后不再开始新的任务
+ */
+bool runTreeTasks(robotics::ThreadPool& pool, const std::vector<int>& parent,
+                  const std::function<bool(int, int)>& task) {
+    const int tasks = static_cast<int>(parent.size());
+    std::vector<int> pending(tasks, 0);
+    for (int t = 0; t < tasks; ++t) {
+        if (parent[t] != -1) {
+            ++pending[parent[t]];
+        }
+    }
+    std::vector<int> ready;
+    for (int t = tasks - 1; t >= 0; --t) {
+        if (pending[t] == 0) {
+            ready.push_back(t);
+        }
+    }
+    std::mutex mutex;
+    std::condition_variable changed;
+    int remaining = tasks;
+    bool failed = false;
+
+    pool.parallelFor(0, pool.size(), [&](std::size_t worker, std::size_t) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            changed.wait(lock, [&] { return failed || remaining == 0 || !ready.empty(); });
+            if (failed || remaining == 0) {
+                return;
+            }
+            const int t = ready.back();
+            ready.pop_back();
+            lock.unlock();
+            const bool ok = task(t, static_cast<int>(worker));
+            lock.lock();
+            --remaining;
+            if (!ok) {
+                failed = true;
+            } else if (parent[t] != -1 && --pending[parent[t]] == 0) {
+                ready.push_back(parent[t]);
+            }
+            changed.notify_all();
+        }
+    }, 1);
+    return !failed;
+}
+
+/**
+ * @brief 左视超节点分解的工作区：全局行号到面板行号的映射与后代更新的稠密块，每个线程一份
+ */
+struct SupernodalWorkspace {
+    std::vector<int> relative;
+    Eigen::MatrixXd update;
+};
+
+/**
+ * @brief 分解超节点 s：装配 A 的元素，减去所有后代的更新，再做稠密 Cholesky 与三角求解
+ */
+bool factorSupernode(const SupernodalSymbolic& supernodal, const std::vector<double>& lower_values, int s,
+                     std::vector<double>& values, SupernodalWorkspace& workspace) {
+    const int first = supernodal.supernode_columns[s];
+    const int width = supernodal.supernode_columns[s + 1] - first;
+    const int* rows = supernodal.rows.data() + supernodal.row_pointers[s];
+    const int height = supernodal.row_pointers[s + 1] - supernodal.row_pointers[s];
+    Eigen::Map<Eigen::MatrixXd> panel(values.data() + supernodal.value_pointers[s], height, width);
+    panel.setZero();
+    for (int r = 0; r < height; ++r) {
+        workspace.relative[rows[r]] = r;
+    }
+    for (int j = first; j < first + width; ++j) {
+        for (int p = supernodal.lower_pointers[j]; p < supernodal.lower_pointers[j + 1]; ++p) {
+            panel(workspace.relative[supernodal.lower_rows[p]], j - first) = lower_values[p];
+        }
+    }
+
+    // 后代 d 的面板中落在 s 的列 [first, first + width) 的行为 [p1, p2)，它们及其下方的行都在 s 的行结构中
+    for (int u = supernodal.update_pointers[s]; u < supernodal.update_pointers[s + 1]; ++u) {
+        const int d = supernodal.update_sources[u];
+        const int d_width = supernodal.supernode_columns[d + 1] - supernodal.supernode_columns[d];
+        const int* d_rows = supernodal.rows.data() + supernodal.row_pointers[d];
+        const int d_height = supernodal.row_pointers[d + 1] - supernodal.row_pointers[d];
+        const int p1 = static_cast<int>(std::lower_bound(d_rows + d_width, d_rows + d_height, first) - d_rows);
+        const int p2 = static_cast<int>(std::lower_bound(d_rows + p1, d_rows + d_height, first + width) - d_rows);
+        Eigen::Map<const Eigen::MatrixXd> L(values.data() + supernodal.value_pointers[d], d_height, d_width);
+        workspace.update.resize(d_height - p1, p2 - p1);
+        workspace.update.noalias() = L.bottomRows(d_height - p1) * L.middleRows(p1, p2 - p1).transpose();
+        for (int c = 0; c < p2 - p1; ++c) {
+            const int column = d_rows[p1 + c] - first;
+            for (int r = c; r < d_height - p1; ++r) {
+                panel(workspace.relative[d_rows[p1 + r]], column) -= workspace.update(r, c);
+            }
+        }
+    }
+
+    Eigen::Ref<Eigen::MatrixXd> diagonal = panel.topRows(width);
+    Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>> llt(diagonal); // 原地分解，L 存在下三角
+    if (llt.info() != Eigen::Success || !diagonal.diagonal().allFinite()) {
+        return false;
+    }
+    diagonal.triangularView<Eigen::Lower>().transpose().solveInPlace<Eigen::OnTheRight>(
+        panel.bottomRows(height - width));
+    return true;
+}
+
+/**
+ * @brief 超节点数值分解与回代。运算量小的子树合并成一个任务，在线程池上按消去树调度
+ * @return bool 分解失败（不正定）时为 false，不打印错误
+ */
+bool supernodalLLT(const Eigen::SparseMatrix<double>& M, const Eigen::VectorXd& b, const SparseSymbolic& symbolic,
+                   const SupernodalSymbolic& supernodal, robotics::ThreadPool& pool, SolveResult& result) {
+    const int n = static_cast<int>(M.rows());
+    const int supernodes = static_cast<int>(supernodal.supernode_parent.size());
+    std::vector<double> lower_values(supernodal.lower_rows.size(), 0.0);
+    for (Eigen::Index p = 0; p < M.nonZeros(); ++p) {
+        if (supernodal.lower_scatter[p] >= 0) {
+            lower_values[supernodal.lower_scatter[p]] = M.valuePtr()[p];
+        }
+    }
+    std::vector<double> values(supernodal.value_pointers.back());
+    std::vector<SupernodalWorkspace> workspaces(pool.size());
+    for (SupernodalWorkspace& workspace : workspaces) {
+        workspace.relative.assign(n, 0);
+    }
+
+    bool ok = true;
+    if (pool.size() == 1) {
+        for (int s = 0; s < supernodes && ok; ++s) {
+            ok = factorSupernode(supernodal, lower_values, s, values, workspaces[0]);
+        }
+    } else {
+        // 子树运算量不超过 grain 的最高的超节点作为一个任务的根，整棵子树按编号顺序（子节点在前）串行分解
+        std::vector<double> subtree(supernodes, 0.0);
+        for (int s = 0; s < supernodes; ++s) {
+            for (int j = supernodal.supernode_columns[s]; j < supernodal.supernode_columns[s + 1]; ++j) {
+                const double count = symbolic.column_pointers[j + 1] - symbolic.column_pointers[j];
+                subtree[s] += count * count;
+            }
+            if (supernodal.supernode_parent[s] != -1) {
+                subtree[supernodal.supernode_parent[s]] += subtree[s];
+            }
+        }
+        const double grain = supernodal.flops / (16.0 * pool.size());
+        std::vector<int> task_of(supernodes), task_root, task_parent;
+        for (int s = supernodes - 1; s >= 0; --s) {
+            const int parent = supernodal.supernode_parent[s];
+            if (parent != -1 && subtree[parent] <= grain) {
+                task_of[s] = task_of[parent];
+            } else {
+                task_of[s] = static_cast<int>(task_root.size());
+                task_root.push_back(s);
+                task_parent.push_back(parent == -1 ? -1 : task_of[parent]);
+            }
+        }
+        std::vector<int> member_pointers(task_root.size() + 1, 0), members(supernodes);
+        for (int s = 0; s < supernodes; ++s) {
+            ++member_pointers[task_of[s] + 1];
+        }
+        for (std::size_t t = 0; t < task_root.size(); ++t) {
+            member_pointers[t + 1] += member_pointers[t];
+        }
+        std::vector<int> fill(member_pointers.begin(), member_pointers.end() - 1);
+        for (int s = 0; s < supernodes; ++s) {
+            members[fill[task_of[s]]++] = s;
+        }
+        ok = runTreeTasks(pool, task_parent, [&](int t, int worker) {
+            for (int m = member_pointers[t]; m < member_pointers[t + 1]; ++m) {
+                if (!factorSupernode(supernodal, lower_values, members[m], values, workspaces[worker])) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+    if (!ok) {
+        return false;
+    }
+
+    // 回代：L y = P b，Lᵀ z = y，x = Pᵀ z，每个超节点是一次稠密三角求解加一次矩阵向量乘
+    Eigen::VectorXd y(n), gathered;
+    for (int k = 0; k < n; ++k) {
+        y(k) = b(symbolic.permutation[k]);
+    }
+    auto panel_of = [&](int s) {
+        const int width = supernodal.supernode_columns[s + 1] - supernodal.supernode_columns[s];
+        const int height = supernodal.row_pointers[s + 1] - supernodal.row_pointers[s];
+        return Eigen::Map<const Eigen::MatrixXd>(values.data() + supernodal.value_pointers[s], height, width);
+    };
+    for (int s = 0; s < supernodes; ++s) {
+        const auto L = panel_of(s);
+        const int first = supernodal.supernode_columns[s], width = static_cast<int>(L.cols());
+        const int* rows = supernodal.rows.data() + supernodal.row_pointers[s];
+        L.topRows(width).triangularView<Eigen::Lower>().solveInPlace(y.segment(first, width));
+        gathered.noalias() = L.bottomRows(L.rows() - width) * y.segment(first, width);
+        for (int r = 0; r < gathered.size(); ++r) {
+            y(rows[width + r]) -= gathered(r);
+        }
+    }
+    for (int s = supernodes - 1; s >= 0; --s) {
+        const auto L = panel_of(s);
+        const int first = supernodal.supernode_columns[s], width = static_cast<int>(L.cols());
+        const int* rows = supernodal.rows.data() + supernodal.row_pointers[s];
+        gathered.resize(L.rows() - width);
+        for (int r = 0; r < gathered.size(); ++r) {
+            gathered(r) = y(rows[width + r]);
+        }
+        y.segment(first, width).noalias() -= L.bottomRows(L.rows() - width).transpose() * gathered;
+        L.topRows(width).triangularView<Eigen::Lower>().transpose().solveInPlace(y.segment(first, width));
+    }
+    result.solution.resize(n);
+    for (int k = 0; k < n; ++k) {
+        result.solution(symbolic.permutation[k]) = y(k);
+    }
+    result.error = (M.selfadjointView<Eigen::Lower>() * result.solution - b).norm();
+    result.success = result.solution.allFinite();
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 使用超节点稀疏 Cholesky 分解求解 (适用于填充较多的稀疏对称正定矩阵)
+ */
+SolveResult solveWithSupernodalLLT(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b,
+                                   robotics::ThreadPool& pool, SparseAnalysisCache* cache) {
+    SolveResult result;
+    result.method = "Supernodal LLT (AMD, " + std::to_string(pool.size()) + " threads)";
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for supernodal LLT.\n";
+        return result;
+    }
+    Eigen::SparseMatrix<double> storage;
+    const Eigen::SparseMatrix<double>& M = compressedView(A, storage);
+    if (cache != nullptr) {
+        const SparseSymbolic* symbolic = nullptr;
+        const SupernodalSymbolic* supernodal = cache->supernodalAnalysis(M, &symbolic);
+        if (supernodal != nullptr && !supernodalLLT(M, b, *symbolic, *supernodal, pool, result)) {
+            std::cerr << "Error: Supernodal LLT found a non-positive pivot (matrix is not positive definite).\n";
+        }
+        return result;
+    }
+    SparseSymbolic symbolic;
+    SupernodalSymbolic supernodal;
+    if (analyzeSparseCholesky(M, symbolic) && analyzeSupernodal(M, symbolic, supernodal)
+        && !supernodalLLT(M, b, symbolic, supernodal, pool, result)) {
+        std::cerr << "Error: Supernodal LLT found a non-positive pivot (matrix is not positive definite).\n";
+    }
+    return result;
+}
+
+/**
+ * @brief 稀疏求解器的自动选择
+ */
+SolveResult solveSparse(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                        SparseAnalysisCache* cache) {
+    SolveResult result;
+    result.method = "Sparse";
+    if (A.rows() != A.cols() || A.rows() != b.size()) {
+        std::cerr << "Error: Matrix A must be square and dimensions must match b for the sparse solver.\n";
+        return result;
+    }
+    Eigen::SparseMatrix<double> storage;
+    const Eigen::SparseMatrix<double>& M = compressedView(A, storage);
+
+    // 只存下三角时视为对称；存了严格上三角时要求与下三角对称（与 solveWithConjugateGradient 的近似检查相同）
+    const Eigen::SparseMatrix<double> strictly_upper = M.triangularView<Eigen::StrictlyUpper>();
+    const bool has_upper = strictly_upper.nonZeros() > 0;
+    const bool symmetric = !has_upper || M.isApprox(Eigen::SparseMatrix<double>(M.transpose()));
+    if (symmetric) {
+        const SparseSymbolic* symbolic = nullptr;
+        const SupernodalSymbolic* supernodal = nullptr;
+        SparseSymbolic local;
+        SupernodalSymbolic local_supernodal;
+        if (cache != nullptr) {
+            supernodal = cache->supernodalAnalysis(M, &symbolic);
+        } else if (analyzeSparseCholesky(M, local)) {
+            symbolic = &local;
+            if (preferSupernodal(local) && analyzeSupernodal(M, local, local_supernodal)) {
+                supernodal = &local_supernodal;
+            }
+        }
+        if (symbolic != nullptr) {
+            const bool large = supernodal != nullptr
+                && supernodal->flops >= kSupernodalFlopsPerSupernode * supernodal->supernode_parent.size();
+            const bool factored = large ? supernodalLLT(M, b, *symbolic, *supernodal, pool, result)
+                                        : simplicialLLT(M, b, *symbolic, result);
+            if (factored) {
+                result.method = large ? "Supernodal LLT (AMD, " + std::to_string(pool.size()) + " threads)"
+                                      : "Sparse LLT (AMD)";
+                return result;
+            }
+        }
+    }
+
+    // 不对称或不正定
+    result = SolveResult();
+    result.method = "Sparse LU (COLAMD)";
+    const Eigen::SparseMatrix<double> full =
+        has_upper ? M : Eigen::SparseMatrix<double>(M.selfadjointView<Eigen::Lower>());
+    Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> lu;
+    lu.compute(full);
+    if (lu.info() != Eigen::Success) {
+        std::cerr << "Error: Sparse LU decomposition failed (matrix may be singular).\n";
+        return result;
+    }
+    result.solution = lu.solve(b);
+    result.error = (full * result.solution - b).norm();
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+// --- 带状与三对角求解器实现 ---
+
+BandedMatrix::BandedMatrix(int n, int lower_bandwidth, int upper_bandwidth)
+    : size(n), lower(lower_bandwidth), upper(upper_bandwidth),
+      bands(Eigen::MatrixXd::Zero(lower_bandwidth + upper_bandwidth + 1, n)) {}
+
+BandedMatrix BandedMatrix::fromDense(const Eigen::MatrixXd& A, int lower_bandwidth, int upper_bandwidth) {
+    BandedMatrix result(static_cast<int>(A.cols()), lower_bandwidth, upper_bandwidth);
+    for (int j = 0; j < result.size; ++j) {
+        int first = std::max(0, j - upper_bandwidth), last = std::min(result.size - 1, j + lower_bandwidth);
+        for (int i = first; i <= last; ++i) {
+            result(i, j) = A(i, j);
+        }
+    }
+    return result;
+}
+
+double BandedMatrix::coeff(int i, int j) const {
+    return inBand(i, j) ? bands(upper + i - j, j) : 0.0;
+}
+
+Eigen::MatrixXd BandedMatrix::toDense() const {
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(size, size);
+    for (int j = 0; j < size; ++j) {
+        for (int i = std::max(0, j - upper); i <= std::min(size - 1, j + lower); ++i) {
+            A(i, j) = bands(upper + i - j, j);
+        }
+    }
+    return A;
+}
+
+Eigen::VectorXd BandedMatrix::multiply(const Eigen::VectorXd& x) const {
+    Eigen::VectorXd y = Eigen::VectorXd::Zero(size);
+    for (int j = 0; j < size; ++j) {
+        const double* column = bands.data() + static_cast<Eigen::Index>(j) * bands.rows();
+        for (int i = std::max(0, j - upper); i <= std::min(size - 1, j + lower); ++i) {
+            y(i) += column[upper + i - j] * x(j);
+        }
+    }
+    return y;
+}
+
+namespace {
+
+bool validBandedSystem(const BandedMatrix& A, const Eigen::VectorXd& b) {
+    return A.size == b.size() && A.lower >= 0 && A.upper >= 0 && A.bands.rows() == A.lower + A.upper + 1 &&
+           A.bands.cols() == A.size;
+}
+
+/**
+ * @brief 带状 Cholesky 分解与回代；不正定时返回 false
+ *
+ * L 的第 j 列存放在 (p+1) x n 矩阵的第 j 列：L(j+i, j) 位于第 i 行。消去第 j 列只更新其后 p 列中与之相交的部分。
+ */
+bool bandedLLT(const BandedMatrix& A, const Eigen::VectorXd& b, Eigen::VectorXd& x) {
+    const int n = A.size, p = A.lower;
+    Eigen::MatrixXd factor = A.bands.bottomRows(p + 1); // 下三角的带：A(j+i, j) 位于第 i 行
+    double* L = factor.data();
+    const Eigen::Index ld = p + 1;
+    for (int j = 0; j < n; ++j) {
+        double* column = L + j * ld;
+        if (!(column[0] > 0.0)) {
+            return false;
+        }
+        const double d = std::sqrt(column[0]);
+        column[0] = d;
+        const int m = std::min(p, n - 1 - j);
+        for (int i = 1; i <= m; ++i) {
+            column[i] /= d;
+        }
+        for (int k = 1; k <= m; ++k) {
+            double* target = L + (j + k) * ld; // 第 j+k 列，从对角元开始
+            const double ljk = column[k];
+            for (int i = k; i <= m; ++i) {
+                target[i - k] -= column[i] * ljk;
+            }
+        }
+    }
+
+    x = b;
+    for (int j = 0; j < n; ++j) {
+        const double* column = L + j * ld;
+        x(j) /= column[0];
+        const int m = std::min(p, n - 1 - j);
+        for (int i = 1; i <= m; ++i) {
+            x(j + i) -= column[i] * x(j);
+        }
+    }
+    for (int j = n - 1; j >= 0; --j) {
+        const double* column = L + j * ld;
+        const int m = std::min(p, n - 1 - j);
+        double s = x(j);
+        for (int i = 1; i <= m; ++i) {
+            s -= column[i] * x(j + i);
+        }
+        x(j) = s / column[0];
+    }
+    return true;
+}
+
+/**
+ * @brief 部分主元带状 LU 分解与回代；主元为零时返回 false
+ *
+ * 工作矩阵有 2 lower + upper + 1 行，A(i, j) 位于第 lower + upper + i - j 行，多出的 lower 行容纳行交换带来的填充。
+ */
+bool bandedLU(const BandedMatrix& A, const Eigen::VectorXd& b, Eigen::VectorXd& x) {
+    const int n = A.size, kl = A.lower, ku = kl + A.upper; // ku：分解后 U 的上带宽
+    Eigen::MatrixXd work = Eigen::MatrixXd::Zero(kl + ku + 1, n);
+    work.bottomRows(A.bands.rows()) = A.bands;
+    const Eigen::Index ld = work.rows();
+    double* W = work.data();
+    auto at = [&](int i, int j) -> double& { return W[j * ld + ku + i - j]; };
+    std::vector<int> pivots(n);
+
+    for (int j = 0; j < n; ++j) {
+        const int m = std::min(kl, n - 1 - j), last = std::min(n - 1, j + ku);
+        int pivot = j;
+        for (int i = 1; i <= m; ++i) {
+            if (std::abs(at(j + i, j)) > std::abs(at(pivot, j))) {
+                pivot = j + i;
+            }
+        }
+        pivots[j] = pivot;
+        if (!(std::abs(at(pivot, j)) > 0.0) || !std::isfinite(at(pivot, j))) {
+            return false;
+        }
+        if (pivot != j) {
+            for (int c = j; c <= last; ++c) {
+                std::swap(at(j, c), at(pivot, c));
+            }
+        }
+        const double inverse = 1.0 / at(j, j);
+        double* multipliers = &at(j + 1, j);
+        for (int i = 0; i < m; ++i) {
+            multipliers[i] *= inverse;
+        }
+        for (int c = j + 1; c <= last; ++c) {
+            const double a = at(j, c);
+            if (a != 0.0) {
+                double* target = &at(j + 1, c);
+                for (int i = 0; i < m; ++i) {
+                    target[i] -= multipliers[i] * a;
+                }
+            }
+        }
+    }
+
+    x = b;
+    for (int j = 0; j < n; ++j) {
+        std::swap(x(j), x(pivots[j]));
+        const int m = std::min(kl, n - 1 - j);
+        for (int i = 1; i <= m; ++i) {
+            x(j + i) -= at(j + i, j) * x(j);
+        }
+    }
+    for (int j = n - 1; j >= 0; --j) {
+        x(j) /= at(j, j);
+        for (int i = std::max(0, j - ku); i < j; ++i) {
+            x(i) -= at(i, j) * x(j);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 不选主元的三对角 LU 分解：记录主元的倒数与 upper(i) / 主元；主元为零时返回 false
+ */
+bool factorTridiagonal(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal, const Eigen::VectorXd& upper,
+                       Eigen::VectorXd& inverse_pivots, Eigen::VectorXd& scaled_upper) {
+    const Eigen::Index n = diagonal.size();
+    inverse_pivots.resize(n);
+    scaled_upper.resize(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        const double pivot = i == 0 ? diagonal(0) : diagonal(i) - lower(i) * scaled_upper(i - 1);
+        if (!(std::abs(pivot) > 0.0) || !std::isfinite(pivot)) {
+            return false;
+        }
+        inverse_pivots(i) = 1.0 / pivot;
+        scaled_upper(i) = i + 1 < n ? upper(i) * inverse_pivots(i) : 0.0;
+    }
+    return true;
+}
+
+/** @brief 用 factorTridiagonal 的结果原地求解，x 传入时为右端项 */
+void solveFactoredTridiagonal(const Eigen::VectorXd& lower, const Eigen::VectorXd& inverse_pivots,
+                              const Eigen::VectorXd& scaled_upper, Eigen::VectorXd& x) {
+    const Eigen::Index n = x.size();
+    x(0) *= inverse_pivots(0);
+    for (Eigen::Index i = 1; i < n; ++i) {
+        x(i) = (x(i) - lower(i) * x(i - 1)) * inverse_pivots(i);
+    }
+    for (Eigen::Index i = n - 2; i >= 0; --i) {
+        x(i) -= scaled_upper(i) * x(i + 1);
+    }
+}
+
+/** @brief 三对角（cyclic 时为循环三对角）方程组的残差范数 */
+double tridiagonalResidual(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal,
+                           const Eigen::VectorXd& upper, const Eigen::VectorXd& x, const Eigen::VectorXd& b,
+                           bool cyclic) {
+    const Eigen::Index n = x.size();
+    Eigen::VectorXd r = diagonal.cwiseProduct(x) - b;
+    if (n > 1) {
+        r.tail(n - 1) += lower.tail(n - 1).cwiseProduct(x.head(n - 1));
+        r.head(n - 1) += upper.head(n - 1).cwiseProduct(x.tail(n - 1));
+    }
+    if (cyclic) {
+        r(0) += lower(0) * x(n - 1);
+        r(n - 1) += upper(n - 1) * x(0);
+    }
+    return r.norm();
+}
+
+bool validTridiagonalSystem(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal,
+                            const Eigen::VectorXd& upper, const Eigen::VectorXd& b) {
+    const Eigen::Index n = diagonal.size();
+    return n > 0 && lower.size() == n && upper.size() == n && b.size() == n;
+}
+
+} // namespace
+
+/**
+ * @brief 使用带状 Cholesky 分解求解 (适用于带状对称正定矩阵)
+ */
+SolveResult solveWithBandedLLT(const BandedMatrix& A, const Eigen::VectorXd& b) {
+    SolveResult result;
+    result.method = "Banded Cholesky (LLT)";
+    if (!validBandedSystem(A, b) || A.lower != A.upper) {
+        std::cerr << "Error: Banded LLT needs a symmetric band (lower == upper) matching the size of b.\n";
+        return result;
+    }
+    if (!bandedLLT(A, b, result.solution)) {
+        std::cerr << "Error: Banded LLT decomposition failed. Matrix might not be positive definite.\n";
+        result.solution.resize(0);
+        return result;
+    }
+    result.error = (A.multiply(result.solution) - b).norm();
+    result.success = true;
+    return result;
+}
+
+/**
+ * @brief 使用部分主元的带状 LU 分解求解 (适用于一般带状方阵)
+ */
+SolveResult solveWithBandedLU(const BandedMatrix& A, const Eigen::VectorXd& b) {
+    SolveResult result;
+    result.method = "Banded PartialPivLU";
+    if (!validBandedSystem(A, b)) {
+        std::cerr << "Error: Banded matrix storage must be (lower + upper + 1) x n and match the size of b.\n";
+        return result;
+    }
+    if (!bandedLU(A, b, result.solution)) {
+        std::cerr << "Error: Banded LU found a zero pivot (matrix is singular).\n";
+        result.solution.resize(0);
+        return result;
+    }
+    result.error = (A.multiply(result.solution) - b).norm();
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+/**
+ * @brief Thomas 算法 (适用于对角占优或对称正定的三对角矩阵)
+ */
+SolveResult solveTridiagonal(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal,
+                             const Eigen::VectorXd& upper, const Eigen::VectorXd& b) {
+    SolveResult result;
+    result.method = "Thomas (tridiagonal)";
+    if (!validTridiagonalSystem(lower, diagonal, upper, b)) {
+        std::cerr << "Error: Tridiagonal diagonals and b must all have the same, nonzero length.\n";
+        return result;
+    }
+    Eigen::VectorXd inverse_pivots, scaled_upper;
+    if (!factorTridiagonal(lower, diagonal, upper, inverse_pivots, scaled_upper)) {
+        std::cerr << "Error: Thomas algorithm hit a zero pivot; use banded LU for this matrix.\n";
+        return result;
+    }
+    result.solution = b;
+    solveFactoredTridiagonal(lower, inverse_pivots, scaled_upper, result.solution);
+    result.error = tridiagonalResidual(lower, diagonal, upper, result.solution, b, false);
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+/**
+ * @brief 循环三对角方程组：Thomas 算法加 Sherman–Morrison 修正
+ */
+SolveResult solveCyclicTridiagonal(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal,
+                                   const Eigen::VectorXd& upper, const Eigen::VectorXd& b) {
+    SolveResult result;
+    result.method = "Cyclic tridiagonal (Sherman-Morrison)";
+    const Eigen::Index n = diagonal.size();
+    if (!validTridiagonalSystem(lower, diagonal, upper, b) || n < 3) {
+        std::cerr << "Error: Cyclic tridiagonal needs n >= 3 and diagonals matching the size of b.\n";
+        return result;
+    }
+    // A = T + u vᵀ，u = (γ, 0, …, 0, α)，v = (1, 0, …, 0, β / γ)；α = A(n-1, 0)，β = A(0, n-1)
+    const double alpha = upper(n - 1), beta = lower(0);
+    const double gamma = diagonal(0) != 0.0 ? -diagonal(0) : -1.0;
+    Eigen::VectorXd modified = diagonal;
+    modified(0) -= gamma;
+    modified(n - 1) -= alpha * beta / gamma;
+    Eigen::VectorXd inverse_pivots, scaled_upper;
+    if (!factorTridiagonal(lower, modified, upper, inverse_pivots, scaled_upper)) {
+        std::cerr << "Error: Cyclic tridiagonal hit a zero pivot.\n";
+        return result;
+    }
+    Eigen::VectorXd x = b, z = Eigen::VectorXd::Zero(n);
+    z(0) = gamma;
+    z(n - 1) = alpha;
+    solveFactoredTridiagonal(lower, inverse_pivots, scaled_upper, x);
+    solveFactoredTridiagonal(lower, inverse_pivots, scaled_upper, z);
+    const double denominator = 1.0 + z(0) + beta * z(n - 1) / gamma;
+    if (denominator == 0.0) {
+        std::cerr << "Error: Cyclic tridiagonal matrix is singular.\n";
+        return result;
+    }
+    x -= ((x(0) + beta * x(n - 1) / gamma) / denominator) * z;
+    result.solution = std::move(x);
+    result.error = tridiagonalResidual(lower, diagonal, upper, result.solution, b, true);
+    result.success = result.solution.allFinite();
+    return result;
+}
+
+/**
+ * @brief 批量 Thomas 算法：k 个独立的三对角方程组同时消元
+ */
+SolveResult solveTridiagonalBatch(const Eigen::MatrixXd& lower, const Eigen::MatrixXd& diagonal,
+                                  const Eigen::MatrixXd& upper, const Eigen::MatrixXd& b) {
+    SolveResult result;
+    result.method = "Batched Thomas (tridiagonal)";
+    const Eigen::Index k = diagonal.rows(), n = diagonal.cols();
+    if (n == 0 || lower.rows() != k || lower.cols() != n || upper.rows() != k || upper.cols() != n ||
+        b.rows() != k || b.cols() != n) {
+        std::cerr << "Error: Batched tridiagonal inputs must all be k x n with n > 0.\n";
+        return result;
+    }
+    // 每一列是 k 个方程组的同一行，按列做 Thomas 消元；零主元不单独检查，表现为解中的 Inf/NaN
+    Eigen::MatrixXd x = b, scaled_upper(k, n);
+    Eigen::ArrayXd inverse_pivots = diagonal.col(0).array().inverse();
+    x.col(0).array() *= inverse_pivots;
+    scaled_upper.col(0).array() = upper.col(0).array() * inverse_pivots;
+    for (Eigen::Index i = 1; i < n; ++i) {
+        inverse_pivots = (diagonal.col(i).array() - lower.col(i).array() * scaled_upper.col(i - 1).array()).inverse();
+        scaled_upper.col(i).array() = upper.col(i).array() * inverse_pivots;
+        x.col(i).array() = (x.col(i).array() - lower.col(i).array() * x.col(i - 1).array()) * inverse_pivots;
+    }
+    for (Eigen::Index i = n - 2; i >= 0; --i) {
+        x.col(i).array() -= scaled_upper.col(i).array() * x.col(i + 1).array();
+    }
+
+    Eigen::MatrixXd r = diagonal.cwiseProduct(x) - b;
+    if (n > 1) {
+        r.rightCols(n - 1) += lower.rightCols(n - 1).cwiseProduct(x.leftCols(n - 1));
+        r.leftCols(n - 1) += upper.leftCols(n - 1).cwiseProduct(x.rightCols(n - 1));
+    }
+    result.success = x.allFinite();
+    if (!result.success) {
+        std::cerr << "Error: Batched Thomas algorithm produced non-finite values (zero pivot).\n";
+    }
+    result.error = k > 0 ? r.rowwise().norm().maxCoeff() : 0.0;
+    result.solution = x.reshaped();
+    return result;
+}
+
+/**
+ * @brief 按带宽选择 Thomas、带状 LLT 或带状 LU
+ */
+SolveResult solveBanded(const BandedMatrix& A, const Eigen::VectorXd& b) {
+    if (!validBandedSystem(A, b) || A.size == 0) {
+        SolveResult result;
+        result.method = "Banded";
+        std::cerr << "Error: Banded matrix storage must be (lower + upper + 1) x n and match the size of b.\n";
+        return result;
+    }
+    const int n = A.size;
+    if (A.lower == 1 && A.upper == 1) {
+        // bands 的三行依次是上对角线（错开一位）、主对角线、下对角线（错开一位）
+        Eigen::VectorXd lower = Eigen::VectorXd::Zero(n), upper = Eigen::VectorXd::Zero(n);
+        const Eigen::VectorXd diagonal = A.bands.row(1).transpose();
+        lower.tail(n - 1) = A.bands.row(2).head(n - 1).transpose();
+        upper.head(n - 1) = A.bands.row(0).tail(n - 1).transpose();
+        if ((diagonal.cwiseAbs().array() > lower.cwiseAbs().array() + upper.cwiseAbs().array()).all()) {
+            return solveTridiagonal(lower, diagonal, upper, b);
+        }
+    }
+    if (A.lower == A.upper) {
+        bool symmetric = true;
+        for (int k = 1; k <= A.lower && symmetric && k < n; ++k) {
+            // 第 k 条下对角线 A(j+k, j) 与第 k 条上对角线 A(j, j+k)
+            symmetric = A.bands.row(A.upper + k).head(n - k).isApprox(A.bands.row(A.upper - k).tail(n - k));
+        }
+        if (symmetric) {
+            SolveResult result;
+            result.method = "Banded Cholesky (LLT)";
+            if (bandedLLT(A, b, result.solution)) {
+                result.error = (A.multiply(result.solution) - b).norm();
+                result.success = true;
+                return result;
+            }
+        }
+    }
+    return solveWithBandedLU(A, b);
+}
+
+/**
+ * @brief 稠密矩阵加带宽的入口
+ */
+SolveResult solveWithBandwidth(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, int lower_bandwidth,
+                               int upper_bandwidth) {
+    SolveResult result;
+    result.method = "Banded";
+    if (A.rows() != A.cols() || A.rows() != b.size() || lower_bandwidth < 0 || upper_bandwidth < 0) {
+        std::cerr << "Error: Matrix A must be square, match b, and have non-negative bandwidths.\n";
+        return result;
+    }
+    const int n = static_cast<int>(A.rows());
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            if (A(i, j) != 0.0 && (i - j > lower_bandwidth || j - i > upper_bandwidth)) {
+                std::cerr << "Error: Matrix A has nonzero entries outside the given bandwidth.\n";
+                return result;
+            }
+        }
+    }
+    return solveBanded(BandedMatrix::fromDense(A, std::min(lower_bandwidth, std::max(n - 1, 0)),
+                                               std::min(upper_bandwidth, std::max(n - 1, 0))),
+                       b);
+}
@@ -1,7 +1,13 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
+
+#include "parallel.hpp"
 
 /**
  * @brief 存储线性方程组求解结果的结构体
@@ -56,6 +62,116 @@ SolveResult solveWithColPivHouseholderQr(const Eigen::MatrixXd& A, const Eigen::
  */
 SolveResult solveWithJacobiSVD(const Eigen::MatrixXd& A, const Eigen::VectorXd& b);
 
+// 多线程分块稠密分解
+// 矩阵按 tile 列分成列块，分解是“面板分解”与“用面板更新后面的列块”两类任务组成的有向无环图，
+// 在调用者提供的线程池上执行（线程数由线程池决定，ThreadPool(1) 完全串行）。面板任务优先，
+// 下一块的面板只等它自己的列块更新完，不必等整个剩余矩阵，所以面板分解与其他列块的更新重叠。
+// 每个任务内部调用 Eigen 的单线程分块内核（项目不开启 OpenMP，Eigen 自身不会再开线程）。
+/**
+ * @brief 多线程分块部分主元 LU 分解求解 Ax = b
+ *
+ * 与 solveWithPartialPivLU 相同的部分主元策略（面板内递归分解），结果一致到舍入误差。
+ * @param pool 执行任务的线程池
+ * @param tile 列块的宽度，也是任务的粒度。任务图的可用并行度约为列块数的一半，
+ *             0 表示自动选择 n / (4 · 线程数)，限制在 64–192 之间
+ */
+SolveResult solveWithPartialPivLU(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                                  int tile = 0);
+
+/**
+ * @brief 多线程分块 Cholesky (LLT) 分解求解 Ax = b (要求 A 为对称正定矩阵，只读取下三角)
+ */
+SolveResult solveWithLLT(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                         int tile = 0);
+
+/**
+ * @brief 多线程分块 Householder QR（不选列主元）求解 Ax = b，A 为 m x n (m >= n) 的列满秩矩阵，m > n 时为最小二乘解
+ *
+ * 不选列主元才能按列块并行；R 的对角元相对最大值小于 n·ε 时认为秩亏，返回失败，
+ * 这时请用 solveWithColPivHouseholderQr。
+ */
+SolveResult solveWithHouseholderQr(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                                   int tile = 0);
+
+// 对称半正定与对称不定
+/**
+ * @brief 对称矩阵的惯性：正、负、零特征值的个数
+ *
+ * 由 L D Lᵀ 分解中 D 的符号得到。绝对值不超过 √ε · max|A| 的主元记为零（数值秩），
+ * 例如位姿图法方程中规范自由度对应的方向。
+ */
+struct Inertia {
+    int positive = 0;
+    int negative = 0;
+    int zero = 0;
+};
+
+/**
+ * @brief 对称 L D Lᵀ 分解 P A Pᵀ = L D Lᵀ 中除 L 与 D 之外的部分
+ *
+ * D 由 1x1 与 2x2（只有 Bunch–Kaufman 会产生）的对角块组成。分解后 L（单位对角不存）与 D 的下三角
+ * 原地存放在矩阵的下三角中；2x2 块的次对角元 D(k+1, k) 占据 L(k+1, k) 的位置（该位置的 L 为零）。
+ */
+struct SymmetricFactor {
+    /** @brief 分解的是 A(permutation, permutation)，即 (P A Pᵀ)(i, j) = A(permutation[i], permutation[j]) */
+    std::vector<int> permutation;
+    /** @brief block_sizes[k] 为从第 k 行开始的 D 块的大小（1 或 2），2x2 块的第二行为 0 */
+    std::vector<int> block_sizes;
+    /** @brief 由 D 得到的惯性（Sylvester 惯性定理） */
+    Inertia inertia;
+};
+
+/**
+ * @brief 原地 LDLT 分解，对角主元（每步选剩余对角元中绝对值最大的）
+ *
+ * 只读写 A 的下三角，与 factorBunchKaufman 一样分块。剩余对角元都不超过 √ε · max|A| 时停止，其余主元记为零，
+ * 所以对称半正定矩阵的零空间（位姿图法方程的规范自由度）不会因为舍入误差被当成很小的正主元。
+ * 只有对角主元，对一般的对称不定矩阵（如对角块为零的 KKT 系统）不稳定，这时请用 factorBunchKaufman。
+ * @param A 对称矩阵，只使用下三角；返回时存放 L 与 D
+ * @param factor 返回置换、块结构（全为 1）与惯性
+ * @return bool A 不是方阵、含非有限值，或剩余对角元可以忽略而剩余部分不可忽略（对角主元无法继续）时为 false
+ */
+bool factorLDLT(Eigen::MatrixXd& A, SymmetricFactor& factor);
+
+/**
+ * @brief 原地 Bunch–Kaufman 对称不定分解（与 LAPACK sytf2 相同的主元策略，α = (1 + √17) / 8）
+ *
+ * 只读写 A 的下三角，按 64 列的面板分块（同 LAPACK sytrf），剩余部分的更新是只算下三角的矩阵乘法，
+ * 工作矩阵只有 n x 65。主元选择保证 |L| 有界，对对称不定矩阵是稳定的。
+ * 主元所在的列整体不超过 √ε · max|A| 时记为零主元（D = 0，L 的该列为零）。
+ * @param A 对称矩阵，只使用下三角；返回时存放 L 与 D
+ * @param factor 返回置换、块结构与惯性
+ * @return bool A 不是方阵或含非有限值时为 false
+ */
+bool factorBunchKaufman(Eigen::MatrixXd& A, SymmetricFactor& factor);
+
+/**
+ * @brief 用 factorLDLT / factorBunchKaufman 的结果求解，零主元对应的分量取零
+ *
+ * A 奇异但 b 在值域内时（有规范自由度的法方程）得到一个满足方程的解，但不是最小范数解。
+ */
+Eigen::VectorXd solveFactoredLDLT(const Eigen::MatrixXd& LD, const SymmetricFactor& factor, const Eigen::VectorXd& b);
+
+/**
+ * @brief 使用对角主元的 LDLT 分解求解对称半正定（或半负定）方程组 Ax = b，A 可以奇异
+ * @param A 系数矩阵 (对称，只读取下三角)
+ * @param b 常数向量
+ * @param inertia 可为空；否则写入 A 的惯性
+ * @return SolveResult 包含求解结果的结构体
+ */
+SolveResult solveWithLDLT(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia* inertia = nullptr);
+
+/**
+ * @brief 使用 Bunch–Kaufman 分解求解对称不定方程组 Ax = b（KKT 系统、带约束的法方程），A 可以奇异
+ *
+ * 利用对称性，计算量约为 n³ / 3，是部分主元 LU 的一半。
+ * @param A 系数矩阵 (对称，只读取下三角)
+ * @param b 常数向量
+ * @param inertia 可为空；否则写入 A 的惯性
+ * @return SolveResult 包含求解结果的结构体
+ */
+SolveResult solveWithBunchKaufman(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia* inertia = nullptr);
+
 // 迭代法
 /**
  * @brief 使用共轭梯度法求解线性方程组 Ax = b (要求 A 为正定矩阵)
@@ -81,4 +197,333 @@ SolveResult solveWithBiCGSTAB(const Eigen::MatrixXd& A, const Eigen::VectorXd& b
  * @param tolerance 收敛容差
  * @return SolveResult 包含求解结果的结构体 (包含迭代次数和误差)
  */
-SolveResult solveWithManualJacobi(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, int max_iterations = 1000, double tolerance = 1e-6); 
\ No newline at end of file
+SolveResult solveWithManualJacobi(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, int max_iterations = 1000, double tolerance = 1e-6);
+
+// 迭代过程的监控与提前结束
+// 实时循环中，按时给出部分收敛的解比迟到的收敛解更有用。下面的重载自己实现 Eigen 的 CG / BiCGSTAB
+// （同样的递推与对角预条件），每次迭代后记录残差、检查停止条件并调用回调。
+/**
+ * @brief 迭代法结束的原因
+ */
+enum class StopReason {
+    Converged, // 相对残差 ‖b - Ax‖ / ‖b‖ 小于 tolerance
+    MaxIterations,
+    TimeBudget, // 用完了 time_budget_ms
+    Stagnation, // 连续 stagnation_iterations 次迭代，最小残差的下降都不到 stagnation_decrease
+    Observer, // 回调要求停止
+    Breakdown, // BiCGSTAB 的递推出现除以零或非有限值
+    InvalidInput, // 维数不匹配，或 CG 的矩阵不对称
+};
+
+/**
+ * @brief 每次迭代后传给回调的进度
+ */
+struct IterationProgress {
+    int iteration = 0; // 已完成的迭代次数
+    double residual = 0.0; // 递推得到的相对残差
+    double elapsed_ms = 0.0; // 从调用开始计时，含预条件的构造
+    const Eigen::VectorXd* solution = nullptr; // 当前的近似解，只在回调期间有效
+};
+
+/**
+ * @brief 迭代法的停止条件，默认值与 Eigen 的 CG / BiCGSTAB 相同
+ */
+struct IterativeOptions {
+    int max_iterations = 0; // 0 时为 2n
+    double tolerance = Eigen::NumTraits<double>::epsilon(); // 相对残差
+    double time_budget_ms = 0.0; // 0 表示不限时；每次迭代后检查，所以最多超出一次迭代的时间
+    int stagnation_iterations = 0; // 0 表示不检查停滞
+    double stagnation_decrease = 1e-2; // 最小残差下降到原来的 (1 - stagnation_decrease) 以下才算有进展
+    std::function<bool(const IterationProgress&)> observer; // 可为空；返回 false 时停止
+};
+
+/**
+ * @brief 迭代过程的记录
+ */
+struct IterationLog {
+    std::vector<double> residuals; // residuals[k] 为 k 次迭代后的相对残差，residuals[0] 为初始残差
+    std::vector<double> elapsed_ms; // 与 residuals 一一对应
+    StopReason reason = StopReason::InvalidInput;
+};
+
+/**
+ * @brief 带停止条件与回调的共轭梯度法 (要求 A 对称正定)，对角预条件
+ *
+ * 提前停止（超时、停滞、回调要求、达到最大迭代次数）时 success 为 false，但 solution 仍是最后一次迭代的近似解，
+ * error 是它的相对残差，调用者可以据此决定是否使用。
+ * @param options 停止条件与回调
+ * @param log 可为空；否则写入残差历史与结束原因
+ * @return SolveResult 包含求解结果的结构体 (包含迭代次数和相对残差)
+ */
+SolveResult solveWithConjugateGradient(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                                       const IterativeOptions& options, IterationLog* log = nullptr);
+
+/**
+ * @brief 带停止条件与回调的 BiCGSTAB，对角预条件
+ *
+ * 残差不单调下降，停滞检查比较的是到目前为止的最小残差。其余约定与带停止条件的 solveWithConjugateGradient 相同。
+ */
+SolveResult solveWithBiCGSTAB(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, const IterativeOptions& options,
+                              IterationLog* log = nullptr);
+
+// 稀疏直接法
+// 位姿图、BA 的法方程在迭代之间只有数值变化，稀疏模式不变。稀疏 Cholesky 的符号分析（填充较少的排序、
+// 消去树、L 的列结构）只依赖模式，用模式的指纹判断是否可以复用，模式不变时每次求解只做数值分解与回代。
+/**
+ * @brief 稀疏矩阵非零模式的指纹：维数、非零元个数与行列下标的 64 位哈希
+ *
+ * 只取决于模式，与数值无关（数值为零但被存储的元素也算在模式内）。
+ * 两个不同模式哈希相同的概率约为 2⁻⁶⁴，视为不会发生。
+ */
+struct SparsityFingerprint {
+    Eigen::Index rows = 0;
+    Eigen::Index cols = 0;
+    Eigen::Index nonzeros = 0;
+    std::uint64_t hash = 0;
+
+    bool operator==(const SparsityFingerprint&) const = default;
+};
+
+/**
+ * @brief 计算 A 的模式指纹，代价 O(n + nnz)，远小于排序
+ */
+SparsityFingerprint sparsityFingerprint(const Eigen::SparseMatrix<double>& A);
+
+/**
+ * @brief 稀疏 Cholesky 的符号分析结果，只依赖 A 下三角的模式
+ *
+ * 分解的是按 AMD 排序后的矩阵 C = A(permutation, permutation)，L 按列压缩存储。
+ */
+struct SparseSymbolic {
+    /** @brief 分析时 A 的模式指纹 */
+    SparsityFingerprint fingerprint;
+    /** @brief 填充较少的排序：permutation[k] 为 C 的第 k 行（列）对应的 A 的行（列） */
+    std::vector<int> permutation;
+    /** @brief C 的上三角按列压缩的模式（第 k 列就是 C 下三角的第 k 行），数值分解按列读取 */
+    std::vector<int> upper_pointers;
+    std::vector<int> upper_rows;
+    /** @brief A 的第 p 个存储元素在 C 上三角中的位置；不在下三角的元素为 -1 */
+    std::vector<int> scatter;
+    /** @brief C 的消去树：parent[j] 为 j 的父节点，根为 -1 */
+    std::vector<int> parent;
+    /** @brief L 的列指针，第 j 列（含对角元）占 [column_pointers[j], column_pointers[j + 1])，nnz(L) 为最后一个元素 */
+    std::vector<int> column_pointers;
+};
+
+/**
+ * @brief 稀疏 Cholesky 的符号分析：AMD 排序、消去树与 L 的列计数
+ *
+ * 只读取 A 的下三角。A 不是方阵时返回 false。
+ */
+bool analyzeSparseCholesky(const Eigen::SparseMatrix<double>& A, SparseSymbolic& symbolic);
+
+/**
+ * @brief 超节点（supernodal）稀疏 Cholesky 的符号分析：在 SparseSymbolic 的基础上把 L 的列分组
+ *
+ * 消去树上前后相连、去掉对角元后非零结构相同的连续列组成一个超节点，L 在超节点内是一个稠密的
+ * (行数 x 宽度) 面板，数值分解用稠密的矩阵乘法、Cholesky 与三角求解完成。
+ */
+struct SupernodalSymbolic {
+    /** @brief 超节点 s 包含 L 的第 [supernode_columns[s], supernode_columns[s + 1]) 列 */
+    std::vector<int> supernode_columns;
+    /** @brief 超节点的消去树：supernode_parent[s] 为 s 最后一列的父节点所在的超节点，根为 -1 */
+    std::vector<int> supernode_parent;
+    /** @brief 超节点 s 的行结构 rows[row_pointers[s], row_pointers[s + 1])，升序，开头是它自己的列 */
+    std::vector<int> row_pointers;
+    std::vector<int> rows;
+    /** @brief 超节点 s 的面板（列优先）在数值数组中的起点，最后一个元素为数值数组的长度 */
+    std::vector<std::size_t> value_pointers;
+    /** @brief 更新超节点 s 的后代超节点 update_sources[update_pointers[s], update_pointers[s + 1])，升序 */
+    std::vector<int> update_pointers;
+    std::vector<int> update_sources;
+    /** @brief 排序后矩阵下三角的列结构，以及 A 的第 p 个存储元素在其中的位置（不在下三角的为 -1） */
+    std::vector<int> lower_pointers;
+    std::vector<int> lower_rows;
+    std::vector<int> lower_scatter;
+    /** @brief 分解运算量的估计 Σ c_j²（c_j 为 L 第 j 列的非零元个数），用于选择求解器与划分任务 */
+    double flops = 0.0;
+};
+
+/**
+ * @brief 由 analyzeSparseCholesky 的结果划分超节点，计算各超节点的行结构与更新关系
+ *
+ * 代价与 L 的非零元个数成正比。A 必须与 symbolic 分析时的模式相同。
+ */
+bool analyzeSupernodal(const Eigen::SparseMatrix<double>& A, const SparseSymbolic& symbolic,
+                       SupernodalSymbolic& supernodal);
+
+/**
+ * @brief 按模式指纹缓存一个符号分析结果
+ *
+ * 每次求解先算 A 的指纹（O(nnz)），与缓存的相同就直接复用，不同才重新分析并替换缓存。
+ * 对象不是线程安全的；每个求解循环（或线程）持有自己的缓存。
+ */
+class SparseAnalysisCache {
+public:
+    /**
+     * @brief 返回与 A 模式一致的符号分析，必要时重新分析
+     * @return const SparseSymbolic* A 不是方阵时为空
+     */
+    const SparseSymbolic* analysis(const Eigen::SparseMatrix<double>& A);
+
+    /**
+     * @brief 与 analysis 相同（只计一次命中或未命中），另外返回超节点划分；同一个模式只划分一次
+     * @param symbolic 可为空；否则写入对应的 analysis 结果
+     * @return const SupernodalSymbolic* A 不是方阵时为空
+     */
+    const SupernodalSymbolic* supernodalAnalysis(const Eigen::SparseMatrix<double>& A,
+                                                 const SparseSymbolic** symbolic = nullptr);
+
+    /** @brief 丢弃缓存的分析，下一次求解重新分析 */
+    void clear();
+
+    int hits() const { return hits_; }
+    int misses() const { return misses_; }
+
+private:
+    SparseSymbolic symbolic_;
+    SupernodalSymbolic supernodal_;
+    bool valid_ = false;
+    bool supernodal_valid_ = false;
+    int hits_ = 0;
+    int misses_ = 0;
+};
+
+/**
+ * @brief 使用稀疏 Cholesky (LLT) 分解求解 Ax = b (要求 A 为对称正定矩阵，只读取下三角)
+ *
+ * 按 AMD 排序后做 up-looking 数值分解（L 的第 k 行由消去树上的路径得到）。
+ * @param A 稀疏系数矩阵 (必须是对称正定矩阵)
+ * @param b 常数向量
+ * @param cache 可为空，此时每次都重新做符号分析；否则模式与上一次相同时复用缓存的分析
+ * @return SolveResult 包含求解结果的结构体
+ */
+SolveResult solveWithSparseLLT(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b,
+                               SparseAnalysisCache* cache = nullptr);
+
+/**
+ * @brief 使用超节点稀疏 Cholesky 分解求解 Ax = b (要求 A 为对称正定矩阵，只读取下三角)
+ *
+ * 左视（left-looking）分解：每个超节点先收集后代超节点的更新（稠密矩阵乘法），再对自己的面板做稠密 Cholesky
+ * 与三角求解。超节点只依赖它在消去树上的后代，所以不相交的子树可以同时分解：
+ * 运算量小的子树整体作为一个任务，其余超节点各是一个任务，子节点都完成后父节点才就绪，在调用者的线程池上执行。
+ * 填充较多（L 中有较大的稠密块）时比 solveWithSparseLLT 快；填充很少时超节点很窄，不如 solveWithSparseLLT。
+ * @param pool 执行任务的线程池，ThreadPool(1) 时按列顺序串行分解
+ * @param cache 可为空；否则模式与上一次相同时复用缓存的分析与超节点划分
+ */
+SolveResult solveWithSupernodalLLT(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b,
+                                   robotics::ThreadPool& pool, SparseAnalysisCache* cache = nullptr);
+
+/**
+ * @brief 按对称性与分解运算量自动选择稀疏求解器
+ *
+ * 只存储了下三角，或严格上三角与下三角对称时视为对称，先做符号分析：平均每个超节点的运算量较大（L 中有较宽的稠密块）时
+ * 用 solveWithSupernodalLLT，否则用 solveWithSparseLLT。分解失败（不正定）或矩阵不对称时用 Eigen::SparseLU（COLAMD 排序）。
+ * SolveResult::method 记录实际使用的方法。cache 不为空时两种分解共用缓存的分析，每次求解只计一次命中或未命中。
+ */
+SolveResult solveSparse(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b, robotics::ThreadPool& pool,
+                        SparseAnalysisCache* cache = nullptr);
+
+// 带状与三对角
+/**
+ * @brief 带状矩阵的紧凑存储：下带宽 lower、上带宽 upper，只存带内的 (lower + upper + 1) x n 个元素
+ *
+ * 按列存放，A(i, j) 位于 bands(upper + i - j, j)，与 LAPACK 的带状格式相同。
+ * 每一列在带内的元素是连续的，带状分解与回代都按列访问。n 很大（如 10⁶）时无法构造稠密矩阵，只能用这种格式。
+ */
+struct BandedMatrix {
+    /** @brief 矩阵阶数 n */
+    int size = 0;
+    /** @brief 下带宽：i - j > lower 的元素为零 */
+    int lower = 0;
+    /** @brief 上带宽：j - i > upper 的元素为零 */
+    int upper = 0;
+    /** @brief (lower + upper + 1) x n 的带内元素 */
+    Eigen::MatrixXd bands;
+
+    BandedMatrix() = default;
+    BandedMatrix(int n, int lower_bandwidth, int upper_bandwidth);
+
+    /** @brief 从稠密矩阵中取出带内元素；带外的元素被忽略 */
+    static BandedMatrix fromDense(const Eigen::MatrixXd& A, int lower_bandwidth, int upper_bandwidth);
+
+    /** @brief 带内元素的引用，调用者保证 (i, j) 在带内 */
+    double& operator()(int i, int j) { return bands(upper + i - j, j); }
+    /** @brief 任意位置的元素，带外为 0 */
+    double coeff(int i, int j) const;
+    bool inBand(int i, int j) const { return i - j <= lower && j - i <= upper; }
+
+    Eigen::MatrixXd toDense() const;
+    /** @brief 矩阵与向量的乘积，O(n (lower + upper)) */
+    Eigen::VectorXd multiply(const Eigen::VectorXd& x) const;
+};
+
+/**
+ * @brief 使用带状 Cholesky 分解求解 Ax = b（要求 A 对称正定，lower == upper）
+ *
+ * 只读取下三角的带，分解不产生带外的填充，代价 O(n p²)，p 为带宽。
+ * @param A 带状系数矩阵 (必须是对称正定矩阵)
+ * @param b 常数向量
+ * @return SolveResult 包含求解结果的结构体
+ */
+SolveResult solveWithBandedLLT(const BandedMatrix& A, const Eigen::VectorXd& b);
+
+/**
+ * @brief 使用部分主元的带状 LU 分解求解 Ax = b（与 LAPACK gbsv 相同）
+ *
+ * 行交换使 U 的上带宽增加到 lower + upper，代价 O(n lower (lower + upper))。
+ * @param A 带状系数矩阵
+ * @param b 常数向量
+ * @return SolveResult 包含求解结果的结构体
+ */
+SolveResult solveWithBandedLU(const BandedMatrix& A, const Eigen::VectorXd& b);
+
+/**
+ * @brief 使用 Thomas 算法求解三对角方程组，O(n)
+ *
+ * 第 i 行为 lower(i) x(i-1) + diagonal(i) x(i) + upper(i) x(i+1) = b(i)，lower(0) 与 upper(n-1) 不使用。
+ * 不选主元，对角占优或对称正定的矩阵上是稳定的；其他矩阵请用 solveWithBandedLU。
+ * @param lower 下对角线（长度 n）
+ * @param diagonal 主对角线（长度 n）
+ * @param upper 上对角线（长度 n）
+ * @param b 常数向量
+ * @return SolveResult 包含求解结果的结构体
+ */
+SolveResult solveTridiagonal(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal,
+                             const Eigen::VectorXd& upper, const Eigen::VectorXd& b);
+
+/**
+ * @brief 求解循环三对角方程组（周期样条、闭合轨迹），O(n)
+ *
+ * 与 solveTridiagonal 的区别是 lower(0) 为 A(0, n-1)、upper(n-1) 为 A(n-1, 0)。
+ * 用 Sherman–Morrison 公式把角上的两个元素化为秩一修正，只做一次三对角分解、两次回代。要求 n >= 3。
+ */
+SolveResult solveCyclicTridiagonal(const Eigen::VectorXd& lower, const Eigen::VectorXd& diagonal,
+                                   const Eigen::VectorXd& upper, const Eigen::VectorXd& b);
+
+/**
+ * @brief 一次求解 k 个互相独立、阶数都为 n 的三对角方程组
+ *
+ * 四个参数都是 k x n 的矩阵，第 s 行是第 s 个方程组（含义同 solveTridiagonal）。
+ * 列优先存储下同一行号的 k 个元素是连续的，Thomas 算法的每一步同时处理 k 个方程组，内层循环可以向量化。
+ * @return SolveResult solution 按列优先存放 k x n 的解（第 s 个方程组的解是 reshaped(k, n) 的第 s 行），
+ *         error 为各方程组残差范数的最大值
+ */
+SolveResult solveTridiagonalBatch(const Eigen::MatrixXd& lower, const Eigen::MatrixXd& diagonal,
+                                  const Eigen::MatrixXd& upper, const Eigen::MatrixXd& b);
+
+/**
+ * @brief 按带宽自动选择带状求解器
+ *
+ * 三对角且严格对角占优时用 Thomas 算法；对称（lower == upper 且带内元素对称）时先试带状 LLT，
+ * 分解失败（不正定）再退回带状 LU；其他情况用带状 LU。SolveResult::method 记录实际使用的方法。
+ */
+SolveResult solveBanded(const BandedMatrix& A, const Eigen::VectorXd& b);
+
+/**
+ * @brief 已知稠密矩阵 A 的带宽时的入口：取出带内元素后调用 solveBanded
+ *
+ * 带外存在非零元素时失败。
+ */
+SolveResult solveWithBandwidth(const Eigen::MatrixXd& A, const Eigen::VectorXd& b, int lower_bandwidth,
+                               int upper_bandwidth);
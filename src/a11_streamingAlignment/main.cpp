@@ -0,0 +1,214 @@
+/**
+ * @file main.cpp
+ * @brief 流式 Umeyama / Horn 对齐：现场生成上亿对对应点，不保存数据，只累加互协方差。
+ *
+ * 依次演示：
+ *   1. 流式并行累加 N 对点（默认 1 亿），恢复已知的相似变换；
+ *   2. 结果与线程数无关（逐位相同）；
+ *   3. 远离原点的坐标下，中心化累加与原始和 Σ t sᵀ - n t̄ s̄ᵀ 的精度对比；
+ *   4. SVD 解与 Horn 四元数解一致；
+ *   5. 逐点 add 与批量 add 的吞吐量。
+ *
+ * 运行方式：./a11_streamingAlignment-main [--count N] [--threads N]
+ */
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include "alignment.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/**
+ * @brief 确定性地生成第 [lo, hi) 对对应点：source 在以 origin 为中心的立方体内，target = truth(source) + 噪声
+ *
+ * 随机数种子只取决于 lo，所以同一块无论由哪个线程生成都相同。
+ */
+void generatePairs(std::size_t lo, std::size_t hi, const Similarity& truth, const Vector3& origin, double noise,
+    Vector3* source, Vector3* target)
+{
+    workload::WorkloadRng rng(0x5eed0000 + lo);
+    for (std::size_t i = 0; i < hi - lo; ++i) {
+        source[i] = origin + Vector3 { rng.uniform(-100.0, 100.0), rng.uniform(-100.0, 100.0), rng.uniform(-5.0, 5.0) };
+        Vector3 jitter { rng.uniform(-noise, noise), rng.uniform(-noise, noise), rng.uniform(-noise, noise) };
+        target[i] = truth.apply(source[i]) + jitter;
+    }
+}
+
+AlignmentAccumulator streamPairs(ThreadPool& pool, std::size_t n, const Similarity& truth, const Vector3& origin,
+    double noise)
+{
+    return accumulateAlignment(pool, n, [&](std::size_t lo, std::size_t hi, AlignmentAccumulator& accumulator) {
+        constexpr std::size_t kBuffer = 4096;
+        std::vector<Vector3> source(kBuffer), target(kBuffer);
+        for (std::size_t first = lo; first < hi; first += kBuffer) {
+            std::size_t last = std::min(hi, first + kBuffer);
+            generatePairs(first, last, truth, origin, noise, source.data(), target.data());
+            accumulator.add(source.data(), target.data(), last - first);
+        }
+    });
+}
+
+double rotationErrorDeg(const Quaternion& a, const Quaternion& b)
+{
+    return (a.conjugate() * b).angle() * 180.0 / std::numbers::pi;
+}
+
+/**
+ * @brief 打印解的误差；平移误差取数据中心 center 处的映射误差，
+ *        否则远离原点时微小的旋转误差会被力臂放大成很大的 t 误差
+ */
+void printSolution(const std::string& name, const Similarity& estimate, const Similarity& truth,
+    const AlignmentAccumulator& accumulator, const Vector3& center = {})
+{
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::scientific << std::setprecision(2)
+              << std::setw(12) << rotationErrorDeg(estimate.transform.orientation, truth.transform.orientation)
+              << std::setw(12) << (estimate.apply(center) - truth.apply(center)).norm() << std::setw(12)
+              << std::fabs(estimate.scale - truth.scale) << std::setw(12) << accumulator.rmsResidual(estimate)
+              << std::defaultfloat << std::endl;
+}
+
+void printHeader()
+{
+    std::cout << "  " << std::left << std::setw(24) << "" << std::right << std::setw(12) << "rot (deg)"
+              << std::setw(12) << "trans (m)" << std::setw(12) << "scale" << std::setw(12) << "rms resid" << std::endl;
+}
+
+/**
+ * @brief 朴素做法：累加原始和，最后用 Σ t sᵀ - n t̄ s̄ᵀ 得到互协方差
+ */
+Similarity naiveRawSums(const std::vector<Vector3>& source, const std::vector<Vector3>& target)
+{
+    Eigen::Vector3d sum_source = Eigen::Vector3d::Zero(), sum_target = Eigen::Vector3d::Zero();
+    Eigen::Matrix3d sum_cross = Eigen::Matrix3d::Zero();
+    double sum_source_sq = 0.0;
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        Eigen::Vector3d s(source[i].x, source[i].y, source[i].z), t(target[i].x, target[i].y, target[i].z);
+        sum_source += s;
+        sum_target += t;
+        sum_cross += t * s.transpose();
+        sum_source_sq += s.squaredNorm();
+    }
+    double n = static_cast<double>(source.size());
+    Eigen::Vector3d ms = sum_source / n, mt = sum_target / n;
+    Eigen::Matrix3d cross = sum_cross - n * mt * ms.transpose();
+    double source_ss = sum_source_sq - n * ms.squaredNorm();
+
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd(cross, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::Vector3d signs(1.0, 1.0, 1.0);
+    if (svd.matrixU().determinant() * svd.matrixV().determinant() < 0.0) {
+        signs(2) = -1.0;
+    }
+    Eigen::Matrix3d rotation = svd.matrixU() * signs.asDiagonal() * svd.matrixV().transpose();
+    double scale = rotation.cwiseProduct(cross).sum() / source_ss;
+    Eigen::Vector3d translation = mt - scale * rotation * ms;
+    Eigen::Quaterniond q(rotation);
+    Similarity result;
+    result.transform = { Vector3 { translation.x(), translation.y(), translation.z() },
+        Quaternion { q.w(), q.x(), q.y(), q.z() } };
+    result.scale = scale;
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t count = 100'000'000;
+    unsigned threads = hardwareThreads();
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--count") {
+            count = std::stoull(argv[i + 1]);
+        } else if (arg == "--threads") {
+            threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        }
+    }
+    ThreadPool pool(threads);
+
+    Similarity truth;
+    truth.transform = { Vector3 { 512.0, -230.0, 31.5 }, Quaternion::fromEuler(0.3, -0.2, 1.1) };
+    truth.scale = 1.7;
+    const double noise = 0.05; // 每个坐标 ±5 cm 均匀噪声
+
+    // --- 1. 流式累加 ---
+    AlignmentAccumulator streamed;
+    double ms = timeMs([&] { streamed = streamPairs(pool, count, truth, Vector3 {}, noise); });
+    std::cout << "Streamed " << count << " correspondences in " << std::fixed << std::setprecision(0) << ms
+              << " ms (" << std::setprecision(1) << count / ms / 1e3 << " M pairs/s, " << threads << " threads)"
+              << std::endl;
+    std::cout << "  accumulator: " << sizeof(AlignmentAccumulator) << " bytes; storing the pairs would take "
+              << std::setprecision(2) << 2.0 * sizeof(Vector3) * count / 1e9 << " GB" << std::endl;
+    std::cout << "  expected rms residual: " << std::setprecision(4) << noise << " m (uniform noise)\n";
+    printHeader();
+    printSolution("Sim(3) via SVD", streamed.solve(true), truth, streamed);
+
+    // --- 2. 与线程数无关 ---
+    const std::size_t subset = std::min<std::size_t>(count, 2'000'000);
+    ThreadPool serial(1);
+    Similarity one = streamPairs(serial, subset, truth, Vector3 {}, noise).solve(true);
+    Similarity many = streamPairs(pool, subset, truth, Vector3 {}, noise).solve(true);
+    bool identical = one.scale == many.scale && one.transform.position.x == many.transform.position.x
+        && one.transform.position.y == many.transform.position.y
+        && one.transform.position.z == many.transform.position.z
+        && one.transform.orientation.w == many.transform.orientation.w
+        && one.transform.orientation.x == many.transform.orientation.x
+        && one.transform.orientation.y == many.transform.orientation.y
+        && one.transform.orientation.z == many.transform.orientation.z;
+    std::cout << "\n1 thread vs " << threads << " threads on " << subset << " pairs: "
+              << (identical ? "bitwise identical" : "DIFFERENT") << std::endl;
+
+    // --- 3. 远离原点的坐标 ---
+    std::vector<Vector3> source(subset), target(subset);
+    Vector3 utm { 4.5e6, 5.3e6, 120.0 };
+    pool.parallelFor(0, subset, [&](std::size_t lo, std::size_t hi) {
+        generatePairs(lo, hi, truth, utm, noise, source.data() + lo, target.data() + lo);
+    }, 65536);
+    std::cout << "\nSource centred at (4.5e6, 5.3e6) m, " << subset << " pairs:" << std::endl;
+    printHeader();
+    AlignmentAccumulator far = accumulateAlignment(source.data(), target.data(), subset, pool);
+    printSolution("centred (this lib)", far.solve(true), truth, far, utm);
+    printSolution("raw sums", naiveRawSums(source, target), truth, far, utm);
+
+    // --- 4. SVD 与 Horn ---
+    std::cout << "\nClosed-form solvers on the streamed accumulator:" << std::endl;
+    printHeader();
+    printSolution("Umeyama SVD, Sim(3)", streamed.solve(true), truth, streamed);
+    printSolution("Horn quaternion, Sim(3)", streamed.solveHorn(true), truth, streamed);
+    Similarity rigid_truth = truth;
+    rigid_truth.scale = 1.0;
+    printSolution("Umeyama SVD, SE(3)", streamed.solve(false), rigid_truth, streamed);
+
+    // --- 5. 逐点与批量 ---
+    AlignmentAccumulator per_point, batched;
+    double per_point_ms = timeMs([&] {
+        for (std::size_t i = 0; i < subset; ++i) {
+            per_point.add(source[i], target[i]);
+        }
+    });
+    double batched_ms = timeMs([&] { batched.add(source.data(), target.data(), subset); });
+    std::cout << "\nSerial accumulation of " << subset << " stored pairs: add(pair) " << std::fixed
+              << std::setprecision(1)
+              << per_point_ms << " ms, add(block) " << batched_ms << " ms (" << std::setprecision(2)
+              << per_point_ms / batched_ms << "x); rotation difference " << std::scientific << std::setprecision(1)
+              << rotationErrorDeg(per_point.solve(true).transform.orientation,
+                     batched.solve(true).transform.orientation)
+              << " deg" << std::endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file main.cpp
+ * @brief 带协方差的位姿插值演示：10 Hz 关键帧（每个带 6x6 协方差）插值到 200 Hz 传感器时间戳。
+ *
+ * 1. 在转角最大的关键帧区间和一个约 115° 的构造区间上用蒙特卡洛检验一阶传播的协方差，
+ *    并与直接线性混合两端协方差的做法对比；
+ * 2. 批量插值的吞吐量（两种模型，串行与线程池）；
+ * 3. float 压缩存储的内存与精度。
+ *
+ * 运行方式：./a13_poseCovariance-main [--threads N]
+ */
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include "lie.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "pose_covariance.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/**
+ * @brief 随机的对称正定协方差：姿态标准差 1–10 mrad，位置 5–50 cm，带随机相关
+ */
+Matrix6d randomCovariance(workload::WorkloadRng& rng)
+{
+    Matrix6d m;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            m(i, j) = rng.normal();
+        }
+    }
+    Matrix6d correlation = m * m.transpose() / 6.0 + 0.2 * Matrix6d::Identity();
+    lie::Vector6d sigma;
+    for (int i = 0; i < 6; ++i) {
+        sigma(i) = i < 3 ? rng.uniform(1e-3, 1e-2) : rng.uniform(0.05, 0.5);
+        sigma(i) /= std::sqrt(correlation(i, i));
+    }
+    return sigma.asDiagonal() * correlation * sigma.asDiagonal();
+}
+
+/**
+ * @brief 右扰动 δ = [Log(R̄ᵀR); R̄ᵀ(p - p̄)]，一阶下与 logSE3(T̄⁻¹T) 相同
+ */
+lie::Vector6d rightPerturbation(const Pose& mean, const Pose& sample, CovarianceModel model)
+{
+    if (model == CovarianceModel::SE3) {
+        return lie::logSE3(mean.inverse() * sample);
+    }
+    lie::Vector6d delta;
+    delta << lie::toEigen(lie::log(mean.orientation.conjugate() * sample.orientation)),
+        lie::toEigen(mean.orientation.conjugate().rotate(sample.position - mean.position));
+    return delta;
+}
+
+Pose perturb(const Pose& pose, const Eigen::LLT<Matrix6d>& llt, workload::WorkloadRng& rng)
+{
+    lie::Vector6d z;
+    for (int i = 0; i < 6; ++i) {
+        z(i) = rng.normal();
+    }
+    return pose * lie::expSE3(llt.matrixL() * z);
+}
+
+const char* modelName(CovarianceModel model)
+{
+    return model == CovarianceModel::SE3 ? "SE3" : "Decoupled";
+}
+
+/**
+ * @brief 对两端位姿按各自协方差采样、插值，比较样本协方差与一阶传播结果
+ */
+void monteCarloCheck(const PoseWithCovariance& start, const PoseWithCovariance& end, double t)
+{
+    const int runs = 20000;
+    Eigen::LLT<Matrix6d> start_llt(start.covariance), end_llt(end.covariance);
+    double angle = (start.pose.orientation.conjugate() * end.pose.orientation).angle();
+    std::cout << " rotation " << std::fixed << std::setprecision(1) << angle * 180.0 / std::numbers::pi
+              << " deg, t = " << t << ", " << runs << " runs; std [rot mrad | pos cm]:" << std::endl;
+    for (CovarianceModel model : { CovarianceModel::Decoupled, CovarianceModel::SE3 }) {
+        PoseWithCovariance predicted = interpolatePoseWithCovariance(start, end, t, model);
+        Matrix6d empirical = Matrix6d::Zero();
+        workload::WorkloadRng rng(5);
+        double mc_ms = timeMs([&] {
+            for (int run = 0; run < runs; ++run) {
+                PoseWithCovariance a { perturb(start.pose, start_llt, rng), start.covariance };
+                PoseWithCovariance b { perturb(end.pose, end_llt, rng), end.covariance };
+                Pose sample = interpolatePoseWithCovariance(a, b, t, model).pose;
+                lie::Vector6d delta = rightPerturbation(predicted.pose, sample, model);
+                empirical += delta * delta.transpose();
+            }
+        });
+        empirical /= runs;
+        double propagate_us = 1e3 * timeMs([&] {
+            for (int i = 0; i < 1000; ++i) {
+                predicted = interpolatePoseWithCovariance(start, end, t, model);
+            }
+        }) / 1000.0;
+        // 常见的简化做法：直接线性混合两端协方差
+        Matrix6d blended = (1.0 - t) * start.covariance + t * end.covariance;
+
+        lie::Vector6d scale;
+        scale << 1e3, 1e3, 1e3, 1e2, 1e2, 1e2;
+        auto print_row = [&](const std::string& name, const Matrix6d& covariance) {
+            lie::Vector6d sigma = covariance.diagonal().cwiseSqrt().cwiseProduct(scale);
+            std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2);
+            for (int i = 0; i < 6; ++i) {
+                std::cout << std::setw(7) << sigma(i) << (i == 2 ? "  |" : "");
+            }
+            std::cout << "   rel err " << std::setprecision(3) << (covariance - empirical).norm() / empirical.norm()
+                      << std::endl;
+        };
+        std::cout << " " << modelName(model) << ":" << std::endl;
+        print_row("Monte Carlo", empirical);
+        print_row("propagated", predicted.covariance);
+        print_row("linear blend of ends", blended);
+        std::cout << "  cost per query: " << std::setprecision(2) << propagate_us << " us propagated, " << mc_ms
+                  << " ms Monte Carlo" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned threads = hardwareThreads();
+    if (argc == 3 && std::string(argv[1]) == "--threads") {
+        threads = static_cast<unsigned>(std::stoul(argv[2]));
+    }
+    ThreadPool pool(threads);
+
+    workload::TrajectoryOptions options;
+    options.rate_hz = 10.0;
+    options.count = 6001;
+    std::vector<TimedPose> keyframes = workload::smoothTrajectory(options);
+
+    workload::WorkloadRng rng(11);
+    std::vector<TimedPoseWithCovariance<double>> keyframes_double;
+    std::vector<TimedPoseWithCovariance<float>> keyframes_float;
+    for (const TimedPose& keyframe : keyframes) {
+        Matrix6d covariance = randomCovariance(rng);
+        keyframes_double.push_back({ keyframe.time_stamp, keyframe.pose, PackedCovariance<double>::pack(covariance) });
+        keyframes_float.push_back({ keyframe.time_stamp, keyframe.pose, PackedCovariance<float>::pack(covariance) });
+    }
+
+    const double sensor_hz = 200.0;
+    std::vector<double> times;
+    for (double t = keyframes.front().time_stamp; t <= keyframes.back().time_stamp; t += 1.0 / sensor_hz) {
+        times.push_back(t);
+    }
+    std::cout << keyframes.size() << " keyframes @ " << options.rate_hz << " Hz, " << times.size()
+              << " sensor timestamps @ " << sensor_hz << " Hz" << std::endl;
+
+    // --- 1. 蒙特卡洛检验 ---
+    std::size_t segment = 0;
+    double largest_angle = 0.0;
+    for (std::size_t i = 0; i + 1 < keyframes.size(); ++i) {
+        double angle = (keyframes[i].pose.orientation.conjugate() * keyframes[i + 1].pose.orientation).angle();
+        if (angle > largest_angle) {
+            largest_angle = angle;
+            segment = i;
+        }
+    }
+    PoseWithCovariance start { keyframes[segment].pose, keyframes_double[segment].covariance.unpack() };
+    PoseWithCovariance end { keyframes[segment + 1].pose, keyframes_double[segment + 1].covariance.unpack() };
+    std::cout << "\nLargest-rotation keyframe segment (" << segment << "):";
+    monteCarloCheck(start, end, 0.4);
+
+    // 人为构造的大转角区间（约 115°、5 m），雅可比的作用在这里才明显
+    PoseWithCovariance far { start.pose * Pose { Vector3 { 3.0, 4.0, 0.5 }, lie::exp(Vector3 { 0.3, -0.5, 1.9 }) },
+        end.covariance };
+    std::cout << "\nSynthetic segment:";
+    monteCarloCheck(start, far, 0.4);
+
+    // --- 2. 批量吞吐量 ---
+    std::cout << "\nBatch interpolation of " << times.size() << " timestamps:" << std::endl;
+    std::vector<TimedPoseWithCovariance<double>> out(times.size());
+    ThreadPool serial(1);
+    for (CovarianceModel model : { CovarianceModel::Decoupled, CovarianceModel::SE3 }) {
+        double serial_ms = timeMs([&] {
+            interpolateTimedPosesWithCovariance(keyframes_double, times.data(), times.size(), out.data(), serial,
+                model);
+        });
+        double parallel_ms = timeMs([&] {
+            interpolateTimedPosesWithCovariance(keyframes_double, times.data(), times.size(), out.data(), pool, model);
+        });
+        std::cout << "  " << std::left << std::setw(10) << modelName(model) << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(8) << serial_ms << " ms (1 thread)"
+                  << std::setw(8) << parallel_ms << " ms (" << threads << (threads == 1 ? " thread)" : " threads)")
+                  << std::setprecision(1) << std::setw(7) << times.size() / parallel_ms / 1e3 << " M queries/s"
+                  << std::endl;
+    }
+    std::vector<TimedPose> means = interpolateTimedPoses(keyframes, times);
+    bool identical = true;
+    interpolateTimedPosesWithCovariance(keyframes_double, times.data(), times.size(), out.data(), pool);
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        const Pose& a = means[i].pose;
+        const Pose& b = out[i].pose;
+        identical = identical && a.position.x == b.position.x && a.position.y == b.position.y
+            && a.position.z == b.position.z && a.orientation.w == b.orientation.w && a.orientation.x == b.orientation.x
+            && a.orientation.y == b.orientation.y && a.orientation.z == b.orientation.z;
+    }
+    std::cout << "  Decoupled means identical to interpolateTimedPoses: " << (identical ? "yes" : "NO") << std::endl;
+
+    // --- 3. float 存储 ---
+    std::vector<TimedPoseWithCovariance<float>> out_float(times.size());
+    interpolateTimedPosesWithCovariance(keyframes_float, times.data(), times.size(), out_float.data(), pool);
+    double worst = 0.0;
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        lie::Vector6d reference = out[i].covariance.unpack().diagonal().cwiseSqrt();
+        lie::Vector6d approx = out_float[i].covariance.unpack().diagonal().cwiseSqrt();
+        worst = std::max(worst, (approx - reference).cwiseQuotient(reference).cwiseAbs().maxCoeff());
+    }
+    std::cout << "\nCovariance storage per pose: " << sizeof(Matrix6d) << " B dense double, "
+              << sizeof(PackedCovariance<double>) << " B packed double, " << sizeof(PackedCovariance<float>)
+              << " B packed float" << std::endl;
+    std::cout << "  float keyframes + float output: worst relative std error " << std::scientific
+              << std::setprecision(2) << worst << " over " << times.size() << " queries" << std::endl;
+    return 0;
+}
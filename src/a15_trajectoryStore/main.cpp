@@ -0,0 +1,256 @@
+/**
+ * @file main.cpp
+ * @brief 版本化轨迹存储演示：回环修正期间读者持续插值，对比“锁 + 整体复制”与写时复制的分块快照。
+ *
+ * 写者每隔一段时间修正轨迹最后 5% 的位姿并追加新位姿；读者不停地取一批时间戳做插值。
+ * 基线按原来的做法在独占锁内复制整个 vector、修改后替换，读者持共享锁读取。
+ *
+ * 运行方式：./a15_trajectoryStore-main [--threads N]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "interpolation.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "trajectory_store.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+constexpr std::size_t kQueriesPerBatch = 256;
+constexpr int kCorrections = 20;
+constexpr double kCorrectedFraction = 0.05;
+constexpr std::size_t kAppendedPerCorrection = 2000;
+
+/**
+ * @brief 原来的做法：读者持共享锁，写者在独占锁内复制整条轨迹、修改、替换
+ */
+struct LockedTrajectory {
+    mutable std::shared_mutex mutex;
+    std::vector<TimedPose> poses;
+};
+
+/**
+ * @brief 一次回环修正：把 [first, size) 的位姿左乘一个小的刚体变换
+ */
+Pose correctionFor(int round)
+{
+    return { Vector3 { 0.01 * round, -0.005 * round, 0.002 }, Quaternion::fromEuler(0.0, 0.0, 1e-4 * round) };
+}
+
+struct RunResult {
+    std::vector<double> writer_ms;
+    std::vector<double> reader_latency_us;
+    std::size_t batches { 0 };
+    double seconds { 0.0 };
+    std::vector<TimedPose> final_poses;
+};
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::size_t k = static_cast<std::size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+    return values[k];
+}
+
+/**
+ * @brief 读者线程不停地插值，写者（调用线程）做 kCorrections 次修正
+ * @param read(times, out) 读取一批
+ * @param write(round) 做一次修正
+ */
+template <typename Read, typename Write>
+RunResult runWorkload(unsigned readers, double start_time, double end_time, Read&& read, Write&& write)
+{
+    RunResult result;
+    std::atomic<bool> stop { false };
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::vector<double>> latencies(readers);
+    std::vector<std::thread> threads;
+    for (unsigned r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            workload::WorkloadRng rng(100 + r);
+            std::vector<double> times(kQueriesPerBatch);
+            std::vector<TimedPose> out(kQueriesPerBatch);
+            while (!stop.load(std::memory_order_relaxed)) {
+                double begin = rng.uniform(start_time, end_time - 1.0);
+                for (std::size_t k = 0; k < kQueriesPerBatch; ++k) {
+                    times[k] = begin + static_cast<double>(k) / kQueriesPerBatch;
+                }
+                latencies[r].push_back(1e3 * timeMs([&] { read(times, out); }));
+            }
+        });
+    }
+    for (int round = 1; round <= kCorrections; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        result.writer_ms.push_back(timeMs([&] { write(round); }));
+    }
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (auto& l : latencies) {
+        result.batches += l.size();
+        result.reader_latency_us.insert(result.reader_latency_us.end(), l.begin(), l.end());
+    }
+    return result;
+}
+
+void printResult(const std::string& name, const RunResult& result)
+{
+    double writer_mean = 0.0;
+    for (double ms : result.writer_ms) {
+        writer_mean += ms / static_cast<double>(result.writer_ms.size());
+    }
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << writer_mean << std::setw(10) << *std::max_element(result.writer_ms.begin(),
+                                                                     result.writer_ms.end())
+              << std::setprecision(0) << std::setw(10) << static_cast<double>(result.batches) / result.seconds
+              << std::setprecision(1) << std::setw(10)
+              << percentile(result.reader_latency_us, 0.5) << std::setw(10)
+              << percentile(result.reader_latency_us, 0.99) << std::setw(11)
+              << *std::max_element(result.reader_latency_us.begin(), result.reader_latency_us.end()) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned threads = hardwareThreads();
+    if (argc == 3 && std::string(argv[1]) == "--threads") {
+        threads = static_cast<unsigned>(std::stoul(argv[2]));
+    }
+    const unsigned readers = std::max(2u, threads);
+
+    workload::TrajectoryOptions options;
+    options.rate_hz = 200.0;
+    options.count = 2000000;
+    std::vector<TimedPose> initial = workload::smoothTrajectory(options);
+    const std::size_t total = initial.size() + kCorrections * kAppendedPerCorrection;
+    std::vector<TimedPose> future = workload::smoothTrajectory([&] {
+        workload::TrajectoryOptions more = options;
+        more.count = total;
+        return more;
+    }());
+    const double start_time = initial.front().time_stamp;
+    const double end_time = initial.back().time_stamp;
+    std::cout << initial.size() << " poses (" << initial.size() * sizeof(TimedPose) / (1 << 20) << " MiB), "
+              << readers << " reader threads, " << kCorrections << " corrections of the last "
+              << kCorrectedFraction * 100.0 << "% + " << kAppendedPerCorrection << " appended poses each" << std::endl;
+
+    // 修正作用在 [当前大小 × (1 - fraction), 当前大小) 上，然后追加新位姿
+    auto corrected_range = [](std::size_t size) {
+        return static_cast<std::size_t>(static_cast<double>(size) * (1.0 - kCorrectedFraction));
+    };
+
+    LockedTrajectory locked;
+    locked.poses = initial;
+    std::size_t appended_locked = initial.size();
+    RunResult baseline = runWorkload(readers, start_time, end_time,
+        [&](const std::vector<double>& times, std::vector<TimedPose>& out) {
+            std::shared_lock lock(locked.mutex);
+            interpolateTimedPoses(locked.poses, times.data(), times.size(), out.data());
+        },
+        [&](int round) {
+            std::unique_lock lock(locked.mutex);
+            std::vector<TimedPose> copy = locked.poses;
+            Pose correction = correctionFor(round);
+            for (std::size_t i = corrected_range(copy.size()); i < copy.size(); ++i) {
+                copy[i].pose = correction * copy[i].pose;
+            }
+            for (std::size_t k = 0; k < kAppendedPerCorrection; ++k) {
+                copy.push_back(future[appended_locked++]);
+            }
+            locked.poses.swap(copy);
+        });
+    baseline.final_poses = locked.poses;
+
+    TrajectoryStore store(initial);
+    std::size_t appended_store = initial.size();
+    std::size_t shared_chunks = 0, total_chunks = 0;
+    RunResult versioned = runWorkload(readers, start_time, end_time,
+        [&](const std::vector<double>& times, std::vector<TimedPose>& out) {
+            store.snapshot().interpolate(times.data(), times.size(), out.data());
+        },
+        [&](int round) {
+            TrajectoryStore::Snapshot before = store.snapshot();
+            TrajectoryStore::Transaction transaction = store.begin();
+            Pose correction = correctionFor(round);
+            std::size_t first = corrected_range(transaction.size());
+            std::size_t chunk_size = transaction.chunkSize();
+            for (std::size_t c = first / chunk_size; c < transaction.chunkCount(); ++c) {
+                std::span<TimedPose> chunk = transaction.writableChunk(c);
+                for (std::size_t i = std::max(first, c * chunk_size) - c * chunk_size; i < chunk.size(); ++i) {
+                    chunk[i].pose = correction * chunk[i].pose;
+                }
+            }
+            for (std::size_t k = 0; k < kAppendedPerCorrection; ++k) {
+                transaction.append(future[appended_store++]);
+            }
+            transaction.commit();
+            TrajectoryStore::Snapshot after = store.snapshot();
+            for (std::size_t c = 0; c < before.chunkCount(); ++c) {
+                shared_chunks += after.sharesChunk(before, c) ? 1 : 0;
+            }
+            total_chunks += before.chunkCount();
+        });
+    versioned.final_poses = store.snapshot().toVector();
+
+    std::cout << "\n  " << std::left << std::setw(20) << "" << std::right << std::setw(20) << "writer ms (mean/max)"
+              << std::setw(10) << "batch/s" << std::setw(31) << "reader batch us (p50/p99/max)" << std::endl;
+    printResult("lock + full copy", baseline);
+    printResult("COW chunk snapshots", versioned);
+    std::cout << "\n  chunks shared with the previous version: " << shared_chunks << " / " << total_chunks << " ("
+              << std::setprecision(1) << 100.0 * static_cast<double>(shared_chunks) / static_cast<double>(total_chunks)
+              << "%), " << (total_chunks - shared_chunks) * TrajectoryStore::kDefaultChunkSize * sizeof(TimedPose)
+            / kCorrections / (1 << 20)
+              << " MiB copied per correction vs " << baseline.final_poses.size() * sizeof(TimedPose) / (1 << 20)
+              << " MiB" << std::endl;
+
+    bool identical = baseline.final_poses.size() == versioned.final_poses.size();
+    for (std::size_t i = 0; identical && i < baseline.final_poses.size(); ++i) {
+        const Pose& a = baseline.final_poses[i].pose;
+        const Pose& b = versioned.final_poses[i].pose;
+        identical = a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z
+            && a.orientation.w == b.orientation.w && a.orientation.z == b.orientation.z;
+    }
+    std::cout << "  final trajectories identical: " << (identical ? "yes" : "NO") << std::endl;
+
+    // 快照隔离：修正之前取得的快照在修正之后保持不变
+    TrajectoryStore::Snapshot pinned = store.snapshot();
+    TimedPose before = pinned.interpolate(end_time - 0.5);
+    {
+        TrajectoryStore::Transaction transaction = store.begin();
+        for (std::size_t i = corrected_range(transaction.size()); i < transaction.size(); ++i) {
+            transaction.at(i).pose = correctionFor(100) * transaction[i].pose;
+        }
+        transaction.commit();
+    }
+    TimedPose still = pinned.interpolate(end_time - 0.5);
+    TimedPose now = store.snapshot().interpolate(end_time - 0.5);
+    std::cout << "  pinned snapshot v" << pinned.version() << " unchanged after v" << store.snapshot().version()
+              << " was published: " << (still.pose.position.x == before.pose.position.x ? "yes" : "NO")
+              << " (new version moved the pose by " << std::setprecision(3)
+              << (now.pose.position - still.pose.position).norm() << " m)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file main.cpp
+ * @brief 回环修正的批量传播：把关键帧之间插值的 SE(3) 修正写回 1000 万个稠密位姿。
+ *
+ * 1. 逐个位姿调用 interpolateTimedPose 求修正再左乘（原来的写法）；
+ * 2. CorrectionSchedule + correct_poses 内核的每个实现（串行），以及线程池并行；
+ * 3. a3 使用的 std::list / std::map 容器；
+ * 4. TrajectoryStore 写事务：只复制回环之后的块。
+ *
+ * 运行方式：./a16_correctionPropagation-main [--threads N] [--poses N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "correction.hpp"
+#include "interpolation.hpp"
+#include "kernels.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "trajectory_store.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/**
+ * @brief 相对参考结果的最大位置误差（m）与姿态误差（四元数之差的范数，q 与 -q 视为相同）
+ */
+std::pair<double, double> maxError(const std::vector<TimedPose>& poses, const std::vector<TimedPose>& reference)
+{
+    double position = 0.0, orientation = 0.0;
+    for (std::size_t i = 0; i < poses.size(); ++i) {
+        const Quaternion& a = poses[i].pose.orientation;
+        const Quaternion& b = reference[i].pose.orientation;
+        double same = std::sqrt((a.w - b.w) * (a.w - b.w) + (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)
+            + (a.z - b.z) * (a.z - b.z));
+        double flipped = std::sqrt((a.w + b.w) * (a.w + b.w) + (a.x + b.x) * (a.x + b.x) + (a.y + b.y) * (a.y + b.y)
+            + (a.z + b.z) * (a.z + b.z));
+        position = std::max(position, (poses[i].pose.position - reference[i].pose.position).norm());
+        orientation = std::max(orientation, std::min(same, flipped));
+    }
+    return { position, orientation };
+}
+
+void printRow(const std::string& name, std::size_t count, double ms, double baseline_ms,
+    std::pair<double, double> error)
+{
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << ms << std::setprecision(2) << std::setw(10) << 1e6 * ms / static_cast<double>(count)
+              << std::setprecision(1) << std::setw(9) << baseline_ms / ms << "x" << std::scientific
+              << std::setprecision(1) << std::setw(11) << error.first << std::setw(11) << error.second
+              << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned threads = hardwareThreads();
+    std::size_t count = 10000000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--threads") {
+            threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        } else if (flag == "--poses") {
+            count = std::stoul(argv[i + 1]);
+        }
+    }
+    ThreadPool pool(threads);
+
+    // 1000 Hz 的稠密轨迹，每秒一个关键帧；回环修正在前 20% 为单位变换，之后随时间累积漂移
+    workload::TrajectoryOptions options;
+    options.count = count;
+    options.rate_hz = 1000.0;
+    const std::vector<TimedPose> dense = workload::smoothTrajectory(options);
+    std::vector<TimedPose> keyframes;
+    std::vector<Pose> optimized;
+    workload::WorkloadRng rng(7);
+    Vector3 drift_position, drift_rotation;
+    for (std::size_t i = 0; i < dense.size(); i += 1000) {
+        keyframes.push_back(dense[i]);
+        if (i > dense.size() / 5) {
+            drift_position = drift_position + rng.normalVector(0.01);
+            drift_rotation = drift_rotation + rng.normalVector(2e-4);
+        }
+        optimized.push_back(Pose { drift_position, Quaternion::fromRotationVector(drift_rotation) } * dense[i].pose);
+    }
+    const std::vector<TimedPose> corrections = keyframeCorrections(keyframes, optimized);
+    std::cout << dense.size() << " dense poses (" << dense.size() * sizeof(TimedPose) / (1 << 20) << " MiB), "
+              << corrections.size() << " keyframe corrections, " << threads << (threads == 1 ? " thread" : " threads")
+              << std::endl;
+
+    std::cout << "\n  " << std::left << std::setw(34) << "" << std::right << std::setw(10) << "ms" << std::setw(10)
+              << "ns/pose" << std::setw(10) << "speedup" << std::setw(11) << "pos err" << std::setw(11) << "rot err"
+              << std::endl;
+
+    // --- 1. 逐个位姿插值修正 ---
+    std::vector<TimedPose> reference = dense;
+    double baseline_ms = timeMs([&] {
+        double first = corrections.front().time_stamp, last = corrections.back().time_stamp;
+        for (TimedPose& p : reference) {
+            Pose c = interpolateTimedPose(corrections, std::clamp(p.time_stamp, first, last)).pose;
+            p.pose = c * p.pose;
+        }
+    });
+    printRow("per-pose interpolateTimedPose", dense.size(), baseline_ms, baseline_ms, { 0.0, 0.0 });
+
+    // --- 2. 按区间批量调用内核 ---
+    std::vector<TimedPose> poses;
+    CorrectionSchedule schedule(corrections);
+    for (const auto& variant : kernels::correct_poses_kernel.supportedVariants()) {
+        poses = dense;
+        double ms = timeMs([&] { schedule.apply(poses.data(), poses.size(), variant.function); });
+        bool selected = variant.isa == kernels::correct_poses_kernel.selectedIsa();
+        printRow(std::string("schedule, ") + isaName(variant.isa) + (selected ? " (selected)" : ""), dense.size(),
+            ms, baseline_ms, maxError(poses, reference));
+    }
+    poses = dense;
+    double parallel_ms = timeMs([&] { propagateCorrections(poses, corrections, pool); });
+    printRow("propagateCorrections (pool)", dense.size(), parallel_ms, baseline_ms, maxError(poses, reference));
+
+    // --- 3. a3 的其他容器（取最后 1/10，前 20% 的修正是单位变换会被跳过） ---
+    std::size_t subset = dense.size() / 10;
+    auto tail = static_cast<std::ptrdiff_t>(dense.size() - subset);
+    std::vector<TimedPose> subset_reference(reference.begin() + tail, reference.end());
+    std::list<TimedPose> as_list(dense.begin() + tail, dense.end());
+    double list_ms = timeMs([&] { propagateCorrections(as_list, corrections); });
+    printRow("std::list", subset, list_ms, baseline_ms * 0.1,
+        maxError(std::vector<TimedPose>(as_list.begin(), as_list.end()), subset_reference));
+    std::map<double, TimedPose> as_map;
+    for (auto it = dense.begin() + tail; it != dense.end(); ++it) {
+        as_map.emplace(it->time_stamp, *it);
+    }
+    double map_ms = timeMs([&] { propagateCorrections(as_map, corrections); });
+    std::vector<TimedPose> from_map;
+    for (const auto& [time, pose] : as_map) {
+        from_map.push_back(pose);
+    }
+    printRow("std::map", subset, map_ms, baseline_ms * 0.1, maxError(from_map, subset_reference));
+    std::cout << "  (list/map use the last " << subset << " poses; speedup is against 1/10 of the baseline)"
+              << std::endl;
+
+    // --- 4. 版本化轨迹存储 ---
+    TrajectoryStore store(dense);
+    TrajectoryStore::Snapshot before = store.snapshot();
+    std::size_t rewritten = 0;
+    double store_ms = timeMs([&] {
+        TrajectoryStore::Transaction transaction = store.begin();
+        rewritten = propagateCorrections(transaction, corrections, pool);
+        transaction.commit();
+    });
+    printRow("TrajectoryStore transaction", dense.size(), store_ms, baseline_ms,
+        maxError(store.snapshot().toVector(), reference));
+    std::size_t shared = 0;
+    for (std::size_t c = 0; c < before.chunkCount(); ++c) {
+        shared += store.snapshot().sharesChunk(before, c) ? 1 : 0;
+    }
+    std::cout << "  store: " << rewritten << " of " << before.chunkCount() << " chunks rewritten, " << shared
+              << " still shared with v" << before.version() << std::endl;
+    return 0;
+}
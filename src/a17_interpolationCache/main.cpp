@@ -0,0 +1,214 @@
+/**
+ * @file main.cpp
+ * @brief 插值结果缓存演示：多个传感器管线在几乎相同的时刻查询位姿，写者同时修正并追加轨迹。
+ *
+ * 每一帧（30 Hz）有 6 个传感器各自请求一次位姿，时间戳相差不到量化步长的一半，分给若干消费者线程。
+ * 1. 每次查询直接在当前快照上插值；
+ * 2. 经 CachedTrajectory：同一帧的后续请求命中缓存，写者提交时失效被修改的时间范围。
+ *
+ * 运行方式：./a17_interpolationCache-main [--threads N]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "interpolation_cache.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "trajectory_store.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+constexpr std::size_t kSensors = 6;
+constexpr double kFrameRate = 30.0;
+constexpr double kCorrectedFraction = 0.02;
+constexpr std::size_t kAppendedPerCorrection = 200;
+constexpr std::size_t kFramesPerBlock = 64; // 传感器数据实时到达：消费者之间最多相差一块
+
+struct RunResult {
+    double ms { 0.0 };
+    std::size_t queries { 0 };
+    std::size_t hits { 0 };
+    int commits { 0 };
+};
+
+/**
+ * @brief 消费者线程处理全部帧（线程 r 负责传感器 r, r + readers, ...），写者（调用线程）每 20 ms 提交一次修正
+ *
+ * 帧按块推进：所有消费者处理完第 b 块之后才开始第 b + 1 块，模拟数据按时间到达，而不是某个线程独自跑完全部帧。
+ * @param query(time, hit) 一次位姿查询
+ * @param write(round) 一次修正 + 追加
+ */
+template <typename Query, typename Write>
+RunResult runWorkload(unsigned readers, const std::vector<std::vector<double>>& sensor_times, Query&& query,
+    Write&& write)
+{
+    RunResult result;
+    std::atomic<unsigned> running { readers };
+    std::atomic<std::size_t> finished_blocks { 0 }; // 所有线程累计完成的块数
+    std::vector<std::size_t> queries(readers, 0), hits(readers, 0);
+    std::vector<std::thread> threads;
+    result.ms = timeMs([&] {
+        for (unsigned r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                std::size_t frames = sensor_times.front().size();
+                for (std::size_t b = 0; b * kFramesPerBlock < frames; ++b) {
+                    while (finished_blocks.load(std::memory_order_acquire) < b * readers) {
+                        std::this_thread::yield();
+                    }
+                    for (std::size_t f = b * kFramesPerBlock; f < std::min(frames, (b + 1) * kFramesPerBlock); ++f) {
+                        for (std::size_t s = r; s < kSensors; s += readers) {
+                            bool hit = false;
+                            query(sensor_times[s][f], hit);
+                            ++queries[r];
+                            hits[r] += hit ? 1 : 0;
+                        }
+                    }
+                    finished_blocks.fetch_add(1, std::memory_order_release);
+                }
+                running.fetch_sub(1);
+            });
+        }
+        while (running.load() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            write(++result.commits);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    for (unsigned r = 0; r < readers; ++r) {
+        result.queries += queries[r];
+        result.hits += hits[r];
+    }
+    return result;
+}
+
+void printResult(const std::string& name, const RunResult& result, double baseline_ms)
+{
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.ms << std::setw(10) << 1e6 * result.ms / static_cast<double>(result.queries)
+              << std::setw(9) << baseline_ms / result.ms << "x" << std::setw(9)
+              << 100.0 * static_cast<double>(result.hits) / static_cast<double>(result.queries) << "%"
+              << std::setw(9) << result.commits << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned threads = hardwareThreads();
+    if (argc == 3 && std::string(argv[1]) == "--threads") {
+        threads = static_cast<unsigned>(std::stoul(argv[2]));
+    }
+    const unsigned readers = std::clamp(threads, 2u, static_cast<unsigned>(kSensors));
+
+    workload::TrajectoryOptions options;
+    options.rate_hz = 200.0;
+    options.count = 1000000;
+    const std::vector<TimedPose> initial = workload::smoothTrajectory(options);
+    std::vector<TimedPose> future = workload::smoothTrajectory([&] {
+        workload::TrajectoryOptions more = options;
+        more.count = options.count * 3 / 2;
+        return more;
+    }());
+
+    InterpolationCacheOptions cache_options;
+    workload::WorkloadRng rng(11);
+    std::vector<std::vector<double>> sensor_times(kSensors);
+    double span = initial.back().time_stamp - initial.front().time_stamp;
+    for (double t = initial.front().time_stamp + 1.0; t < initial.front().time_stamp + span - 1.0;
+         t += 1.0 / kFrameRate) {
+        for (auto& times : sensor_times) {
+            times.push_back(t + rng.uniform(-0.1, 0.1) * cache_options.resolution);
+        }
+    }
+    std::cout << initial.size() << " poses, " << sensor_times.front().size() << " frames x " << kSensors
+              << " sensors, " << readers << " consumer threads, resolution " << cache_options.resolution * 1e6
+              << " us, " << InterpolationCache(cache_options).capacity() << " slots" << std::endl;
+
+    auto corrected_range = [](std::size_t size) {
+        return static_cast<std::size_t>(static_cast<double>(size) * (1.0 - kCorrectedFraction));
+    };
+    auto correct = [&](TrajectoryStore::Transaction& transaction, int round, std::size_t& appended) {
+        Pose correction { Vector3 { 0.001 * round, 0.0, 0.0 }, Quaternion::fromEuler(0.0, 0.0, 1e-5 * round) };
+        for (std::size_t i = corrected_range(transaction.size()); i < transaction.size(); ++i) {
+            transaction.at(i).pose = correction * transaction[i].pose;
+        }
+        for (std::size_t k = 0; k < kAppendedPerCorrection && appended < future.size(); ++k) {
+            transaction.append(future[appended++]);
+        }
+    };
+
+    std::cout << "\n  " << std::left << std::setw(24) << "" << std::right << std::setw(10) << "ms" << std::setw(10)
+              << "ns/query" << std::setw(10) << "speedup" << std::setw(10) << "hit rate" << std::setw(9) << "commits"
+              << std::endl;
+
+    TrajectoryStore direct_store(initial);
+    std::size_t direct_appended = initial.size();
+    RunResult direct = runWorkload(readers, sensor_times,
+        [&](double time, bool& hit) {
+            hit = false;
+            return direct_store.snapshot().interpolate(time);
+        },
+        [&](int round) {
+            TrajectoryStore::Transaction transaction = direct_store.begin();
+            correct(transaction, round, direct_appended);
+            transaction.commit();
+        });
+    printResult("snapshot().interpolate", direct, direct.ms);
+
+    TrajectoryStore cached_store(initial);
+    CachedTrajectory cached(cached_store, cache_options);
+    std::size_t cached_appended = initial.size();
+    RunResult with_cache = runWorkload(readers, sensor_times,
+        [&](double time, bool& hit) { return cached.interpolate(time, &hit); },
+        [&](int round) {
+            TrajectoryStore::Transaction transaction = cached_store.begin();
+            correct(transaction, round, cached_appended);
+            cached.commit(transaction);
+        });
+    printResult("CachedTrajectory", with_cache, direct.ms);
+
+    // 缓存的结果与在最新快照上、量化时间处重新插值逐位相同（被修正过的尾部也一样）；
+    // 与未量化时间上的位姿相差不超过速度 × resolution / 2
+    TrajectoryStore::Snapshot snapshot = cached_store.snapshot();
+    std::size_t checked = 0, mismatches = 0;
+    double quantization_error = 0.0;
+    for (std::size_t f = 0; f < sensor_times.front().size(); ++f) {
+        for (const auto& times : sensor_times) {
+            double time = times[f];
+            bool hit = false;
+            TimedPose result = cached.interpolate(time, &hit);
+            TimedPose fresh = snapshot.interpolate(result.time_stamp);
+            const Pose& a = result.pose;
+            const Pose& b = fresh.pose;
+            bool same = a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z
+                && a.orientation.w == b.orientation.w && a.orientation.x == b.orientation.x
+                && a.orientation.y == b.orientation.y && a.orientation.z == b.orientation.z;
+            checked += hit ? 1 : 0;
+            mismatches += same ? 0 : 1;
+            quantization_error = std::max(quantization_error,
+                (result.pose.position - snapshot.interpolate(time).pose.position).norm());
+        }
+    }
+    std::cout << "\n  after " << with_cache.commits << " commits: " << checked
+              << " cached results re-checked against the latest snapshot, " << mismatches << " mismatches"
+              << "\n  largest distance to the pose at the unquantized time: " << std::scientific
+              << std::setprecision(1) << quantization_error << " m" << std::endl;
+    return 0;
+}
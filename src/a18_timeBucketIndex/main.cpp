@@ -0,0 +1,155 @@
+/**
+ * @file main.cpp
+ * @brief 均匀时间分桶索引与二分查找、std::map 的对比：随机顺序的时间查找和插值，以及逐个追加时的增量建索引。
+ *
+ * 三条 1000 Hz 的轨迹：时间戳有抖动；再加 20% 的丢帧；以及桶宽取错（标称周期的 1/10，触发自动加宽）。
+ *
+ * 运行方式：./a18_timeBucketIndex-main [--poses N] [--queries N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "interpolation.hpp"
+#include "pose.hpp"
+#include "time_bucket_index.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void printRow(const std::string& name, double ms, std::size_t count, double baseline_ms, std::size_t mismatches)
+{
+    std::cout << "    " << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << ms << std::setw(10) << 1e6 * ms / static_cast<double>(count) << std::setw(9)
+              << baseline_ms / ms << "x" << std::setw(12) << mismatches << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t count = 4000000, query_count = 1000000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--poses") {
+            count = std::stoul(argv[i + 1]);
+        } else if (flag == "--queries") {
+            query_count = std::stoul(argv[i + 1]);
+        }
+    }
+
+    struct Case {
+        std::string name;
+        double jitter;
+        double gaps;
+        double period_scale; // 桶宽相对估计周期的倍数
+    };
+    const Case cases[] = {
+        { "jittered 1 kHz", 0.2, 0.0, 1.0 },
+        { "jittered, 20% dropped", 0.2, 0.2, 1.0 },
+        { "period guessed 10x too small", 0.2, 0.2, 0.1 },
+    };
+
+    std::cout << count << " poses per trajectory, " << query_count << " random-order queries" << std::endl;
+    std::cout << "\n    " << std::left << std::setw(30) << "" << std::right << std::setw(10) << "ms" << std::setw(10)
+              << "ns/query" << std::setw(10) << "speedup" << std::setw(12) << "mismatches" << std::endl;
+    for (const Case& c : cases) {
+        workload::TrajectoryOptions options;
+        options.count = count;
+        options.rate_hz = 1000.0;
+        options.timestamp_jitter = c.jitter / options.rate_hz;
+        options.gap_probability = c.gaps;
+        const std::vector<TimedPose> poses = workload::smoothTrajectory(options);
+
+        // 逐个追加并增量索引，与一次性建立的结果相同
+        std::vector<TimedPose> growing;
+        growing.reserve(poses.size());
+        TimeBucketIndex index(TimeBucketIndex::estimatePeriod(poses) * c.period_scale);
+        double build_ms = timeMs([&] {
+            for (const TimedPose& pose : poses) {
+                growing.push_back(pose);
+                index.extend(growing);
+            }
+        });
+        std::cout << "\n  " << c.name << ": " << poses.size() << " poses, period " << index.period() * 1e3 << " ms, "
+                  << index.bucketCount() << " buckets, incremental build " << std::fixed << std::setprecision(1)
+                  << 1e6 * build_ms / static_cast<double>(poses.size()) << " ns/append" << std::defaultfloat
+                  << std::endl;
+
+        workload::WorkloadRng rng(3);
+        std::vector<double> times(query_count);
+        for (double& t : times) {
+            t = rng.uniform(poses.front().time_stamp, poses.back().time_stamp);
+        }
+        std::vector<std::size_t> expected(times.size()), actual(times.size());
+        auto mismatches = [&] {
+            std::size_t n = 0;
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                n += expected[k] == actual[k] ? 0 : 1;
+            }
+            return n;
+        };
+
+        double binary_ms = timeMs([&] {
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                expected[k] = findSegmentIndex(poses, times[k]);
+            }
+        });
+        printRow("findSegmentIndex (binary)", binary_ms, times.size(), binary_ms, 0);
+
+        std::map<double, std::size_t> tree;
+        for (std::size_t i = 0; i < poses.size(); ++i) {
+            tree.emplace_hint(tree.end(), poses[i].time_stamp, i);
+        }
+        double tree_ms = timeMs([&] {
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                actual[k] = std::prev(tree.upper_bound(times[k]))->second;
+            }
+        });
+        printRow("std::map::upper_bound", tree_ms, times.size(), binary_ms, mismatches());
+        tree.clear();
+
+        double bucket_ms = timeMs([&] {
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                actual[k] = index.findSegmentIndex(poses, times[k]);
+            }
+        });
+        printRow("TimeBucketIndex", bucket_ms, times.size(), binary_ms, mismatches());
+
+        std::vector<TimedPose> out_binary(times.size()), out_bucket(times.size());
+        double interpolate_ms = timeMs([&] {
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                out_binary[k] = interpolateTimedPose(poses, times[k]);
+            }
+        });
+        printRow("interpolateTimedPose", interpolate_ms, times.size(), interpolate_ms, 0);
+        double indexed_ms = timeMs([&] {
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                out_bucket[k] = interpolateTimedPose(poses, index, times[k]);
+            }
+        });
+        std::size_t differ = 0;
+        for (std::size_t k = 0; k < times.size(); ++k) {
+            const Pose& a = out_binary[k].pose;
+            const Pose& b = out_bucket[k].pose;
+            differ += a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z
+                    && a.orientation.w == b.orientation.w && a.orientation.x == b.orientation.x
+                    && a.orientation.y == b.orientation.y && a.orientation.z == b.orientation.z
+                ? 0
+                : 1;
+        }
+        printRow("  ... with TimeBucketIndex", indexed_ms, times.size(), interpolate_ms, differ);
+    }
+    return 0;
+}
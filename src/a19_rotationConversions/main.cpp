@@ -0,0 +1,140 @@
+/**
+ * @file main.cpp
+ * @brief 旋转表示的批量转换：逐个位姿调用 pose.hpp（AoS）与 rotation_kernels.hpp 的 SoA 内核各实现的对比。
+ *
+ * 六种转换：四元数 ↔ 旋转矩阵、四元数 ↔ 旋转向量、四元数 ↔ ZYX 欧拉角。输入是随机的单位四元数，
+ * 以及由它们转换得到的矩阵、旋转向量和欧拉角。误差一列是与逐个位姿转换结果的最大分量差。
+ *
+ * 运行方式：./a19_rotationConversions-main [--count N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "pose.hpp"
+#include "rotation_kernels.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+double maxDifference(const Quaternion& a, const Quaternion& b)
+{
+    return std::max({ std::fabs(a.w - b.w), std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) });
+}
+
+double maxDifference(const Vector3& a, const Vector3& b)
+{
+    return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) });
+}
+
+double maxDifference(const RotationMatrix& a, const RotationMatrix& b)
+{
+    double result = 0.0;
+    for (int k = 0; k < 9; ++k) {
+        result = std::max(result, std::fabs(a.m[k] - b.m[k]));
+    }
+    return result;
+}
+
+void printRow(const std::string& conversion, const std::string& variant, double ms, std::size_t count,
+    double baseline_ms, double max_error, bool selected)
+{
+    std::cout << "  " << std::left << std::setw(22) << conversion << std::setw(16) << variant << std::right
+              << std::fixed << std::setprecision(1) << std::setw(9) << ms << std::setprecision(2) << std::setw(10)
+              << 1e6 * ms / static_cast<double>(count) << std::setw(9) << baseline_ms / ms << "x" << std::scientific
+              << std::setprecision(1) << std::setw(11) << max_error << std::defaultfloat
+              << (selected ? "  <- selected" : "") << std::endl;
+}
+
+/**
+ * @brief 一种转换：先逐个元素调用 convert（AoS）作为基线，再依次运行内核在当前 CPU 上可用的每个实现
+ */
+template <typename Out, typename OutSoA, typename In, typename InSoA, typename Convert>
+void benchmark(const std::string& name, const std::vector<In>& input, const InSoA& soa_input, Convert convert,
+    const DispatchedKernel<kernels::RotationConversion>& kernel)
+{
+    std::vector<Out> expected(input.size());
+    double baseline_ms = bestOfMs([&] {
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            expected[i] = convert(input[i]);
+        }
+    });
+    printRow(name, "per pose (AoS)", baseline_ms, input.size(), baseline_ms, 0.0, false);
+
+    OutSoA output;
+    output.resize(input.size());
+    for (const auto& variant : kernel.supportedVariants()) {
+        double ms = bestOfMs([&] { variant.function(soa_input.data().data(), output.data().data(), input.size()); });
+        double max_error = 0.0;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            max_error = std::max(max_error, maxDifference(expected[i], output[i]));
+        }
+        printRow("", std::string("kernel ") + isaName(variant.isa), ms, input.size(), baseline_ms, max_error,
+            variant.isa == kernel.selectedIsa());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t count = 1000000;
+    if (argc == 3 && std::string(argv[1]) == "--count") {
+        count = std::stoul(argv[2]);
+    }
+
+    workload::WorkloadRng rng(19);
+    std::vector<Quaternion> rotations(count);
+    std::vector<RotationMatrix> matrices(count);
+    std::vector<Vector3> rotation_vectors(count), euler(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Quaternion q { rng.normal(), rng.normal(), rng.normal(), rng.normal() };
+        q.normalize();
+        rotations[i] = q;
+        matrices[i] = RotationMatrix(q);
+        rotation_vectors[i] = q.toRotationVector();
+        euler[i] = q.toEuler();
+    }
+    const QuaternionSoA soa_rotations(rotations);
+    const Vector3SoA soa_rotation_vectors(rotation_vectors), soa_euler(euler);
+    RotationMatrixSoA soa_matrices;
+    soa_matrices.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        soa_matrices.set(i, matrices[i]);
+    }
+
+    std::cout << count << " random rotations\n\n  " << std::left << std::setw(22) << "Conversion" << std::setw(16)
+              << "Variant" << std::right << std::setw(9) << "ms" << std::setw(10) << "ns/elem" << std::setw(10)
+              << "Speedup" << std::setw(11) << "Max diff" << std::endl;
+
+    benchmark<RotationMatrix, RotationMatrixSoA>("quaternion -> matrix", rotations, soa_rotations,
+        [](const Quaternion& q) { return RotationMatrix(q); }, kernels::quaternion_to_matrix_kernel);
+    benchmark<Quaternion, QuaternionSoA>("matrix -> quaternion", matrices, soa_matrices,
+        [](const RotationMatrix& r) { return r.toQuaternion(); }, kernels::matrix_to_quaternion_kernel);
+    benchmark<Quaternion, QuaternionSoA>("rotation vector -> q", rotation_vectors, soa_rotation_vectors,
+        [](const Vector3& v) { return Quaternion::fromRotationVector(v); },
+        kernels::rotation_vector_to_quaternion_kernel);
+    benchmark<Vector3, Vector3SoA>("q -> rotation vector", rotations, soa_rotations,
+        [](const Quaternion& q) { return q.toRotationVector(); }, kernels::quaternion_to_rotation_vector_kernel);
+    benchmark<Quaternion, QuaternionSoA>("euler -> quaternion", euler, soa_euler,
+        [](const Vector3& e) { return Quaternion::fromEuler(e.x, e.y, e.z); }, kernels::euler_to_quaternion_kernel);
+    benchmark<Vector3, Vector3SoA>("quaternion -> euler", rotations, soa_rotations,
+        [](const Quaternion& q) { return q.toEuler(); }, kernels::quaternion_to_euler_kernel);
+    return 0;
+}
@@ -55,6 +55,7 @@ double distance_modern(const std::vector<double>& p1, const std::vector<double>&
     return std::sqrt(sum_of_squares);
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 /**
  * @brief 主函数，演示 distance_modern 函数的用法。
  * @return int 程序退出代码 (0 表示成功)。
@@ -82,3 +83,4 @@ int main()
     }
     return 0;
 }
+#endif // PRESLAM_NO_MAIN
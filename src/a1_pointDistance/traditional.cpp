@@ -30,6 +30,7 @@ double distance_traditional(const std::vector<double>& p1, const std::vector<dou
     return std::sqrt(sum_sq_diff);
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 /**
  * @brief 主函数，演示 distance_traditional 函数的用法。
  * @return int 程序退出代码 (0 表示成功)。
@@ -55,3 +56,4 @@ int main()
     }
     return 0;
 }
+#endif // PRESLAM_NO_MAIN
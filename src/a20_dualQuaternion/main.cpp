@@ -0,0 +1,254 @@
+/**
+ * @file main.cpp
+ * @brief 对偶四元数插值：interpolatePose（平移线性 + SLERP）、DLB、ScLERP 的单次开销与偏差，以及 LiDAR 去畸变的吞吐。
+ *
+ * 偏差都以 ScLERP（沿螺旋运动匀速前进）为参考。去畸变用 200 Hz 的轨迹和 10 Hz 的机械式雷达：
+ * 点按方位角先后到达，同一个 5 ms 区间内的点一起交给 kernels::deskewPoints。
+ *
+ * 运行方式：./a20_dualQuaternion-main [--points N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "dual_quaternion.hpp"
+#include "interpolation.hpp"
+#include "pose.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// 两个姿态之间的夹角 (rad)，由 a⁻¹ b 的虚部求 atan2，小角度时不损失精度
+double angleBetween(const Quaternion& a, const Quaternion& b)
+{
+    Quaternion d = a.conjugate() * b;
+    return 2.0 * std::atan2(std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z), std::fabs(d.w));
+}
+
+/**
+ * @brief 绕随机轴转 angle、平移 distance（方向随机，一般不沿转轴）的一段运动
+ */
+std::pair<Pose, Pose> makeSegment(workload::WorkloadRng& rng, double angle, double distance)
+{
+    Quaternion start { rng.normal(), rng.normal(), rng.normal(), rng.normal() };
+    start.normalize();
+    Vector3 axis = rng.normalVector(1.0);
+    Vector3 direction = rng.normalVector(1.0);
+    Pose motion { direction * (distance / direction.norm()), Quaternion::fromRotationVector(axis * (angle / axis.norm())) };
+    Pose first { rng.normalVector(10.0), start };
+    return { first, first * motion };
+}
+
+struct Deviation {
+    double position { 0.0 };
+    double rotation { 0.0 };
+};
+
+void accumulate(Deviation& deviation, const Pose& pose, const Pose& reference)
+{
+    deviation.position = std::max(deviation.position, (pose.position - reference.position).norm());
+    deviation.rotation = std::max(deviation.rotation, angleBetween(pose.orientation, reference.orientation));
+}
+
+void perCall(const std::string& name, const Pose& first, const Pose& second)
+{
+    const std::size_t calls = 2000000;
+    workload::WorkloadRng rng(7);
+    std::vector<double> factors(calls);
+    for (double& t : factors) {
+        t = rng.uniform();
+    }
+    const DualQuaternion a = DualQuaternion::fromPose(first), b = DualQuaternion::fromPose(second);
+
+    std::vector<Pose> reference(calls), result(calls);
+    double sclerp_ms = bestOfMs([&] {
+        for (std::size_t k = 0; k < calls; ++k) {
+            reference[k] = sclerp(a, b, factors[k]).toPose();
+        }
+    });
+    std::string label = name;
+    auto row = [&](const std::string& method, double ms) {
+        Deviation deviation;
+        for (std::size_t k = 0; k < calls; ++k) {
+            accumulate(deviation, result[k], reference[k]);
+        }
+        std::cout << "  " << std::left << std::setw(20) << label << std::setw(18) << method << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(9) << 1e6 * ms / static_cast<double>(calls) << std::scientific
+                  << std::setprecision(1) << std::setw(12) << deviation.position << std::setw(12) << deviation.rotation
+                  << std::defaultfloat << std::endl;
+        label.clear();
+    };
+    double interpolate_ms = bestOfMs([&] {
+        for (std::size_t k = 0; k < calls; ++k) {
+            result[k] = interpolatePose(first, second, factors[k]);
+        }
+    });
+    row("interpolatePose", interpolate_ms);
+    double dlb_ms = bestOfMs([&] {
+        for (std::size_t k = 0; k < calls; ++k) {
+            result[k] = dlb(a, b, factors[k]).toPose();
+        }
+    });
+    row("dlb", dlb_ms);
+    result = reference;
+    row("sclerp", sclerp_ms);
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t point_count = 4000000;
+    if (argc == 3 && std::string(argv[1]) == "--points") {
+        point_count = std::stoul(argv[2]);
+    }
+
+    // 1. 单次插值的开销，以及与 ScLERP 的最大偏差（位置 m、姿态 rad）
+    workload::WorkloadRng rng(20);
+    std::cout << "Per call (2M random factors)\n\n  " << std::left << std::setw(20) << "Segment" << std::setw(18)
+              << "Method" << std::right << std::setw(9) << "ns/call" << std::setw(12) << "max dpos" << std::setw(12)
+              << "max drot" << std::endl;
+    auto [small_a, small_b] = makeSegment(rng, 0.02, 0.1);
+    perCall("5 ms (0.02 rad)", small_a, small_b);
+    auto [large_a, large_b] = makeSegment(rng, 1.0, 2.0);
+    perCall("large (1 rad)", large_a, large_b);
+
+    // 2. 偏差随区间内转角的变化：平移 1 m，t 取 [0, 1] 上 101 个点
+    std::cout << "\nDeviation from ScLERP, 1 m translation\n\n  " << std::setw(10) << "angle" << std::setw(18)
+              << "interpolatePose" << std::setw(12) << "dlb" << std::setw(12) << "dlb drot" << std::endl;
+    for (double angle : { 0.001, 0.01, 0.05, 0.2, 1.0, 2.0 }) {
+        Deviation linear, blended;
+        for (int trial = 0; trial < 100; ++trial) {
+            auto [first, second] = makeSegment(rng, angle, 1.0);
+            const DualQuaternion a = DualQuaternion::fromPose(first), b = DualQuaternion::fromPose(second);
+            for (int k = 0; k <= 100; ++k) {
+                double t = 0.01 * k;
+                Pose reference = sclerp(a, b, t).toPose();
+                accumulate(linear, interpolatePose(first, second, t), reference);
+                accumulate(blended, dlb(a, b, t).toPose(), reference);
+            }
+        }
+        std::cout << "  " << std::setw(10) << angle << std::scientific << std::setprecision(1) << std::setw(18)
+                  << linear.position << std::setw(12) << blended.position << std::setw(12) << blended.rotation
+                  << std::defaultfloat << std::endl;
+    }
+
+    // 3. 去畸变：点按方位角排序，时间 = 帧起始 + 方位角占比 × 100 ms
+    std::vector<Vector3> scan = workload::lidarScan({});
+    std::vector<double> phase(scan.size());
+    std::vector<std::size_t> order(scan.size());
+    for (std::size_t i = 0; i < scan.size(); ++i) {
+        order[i] = i;
+        phase[i] = (std::atan2(scan[i].y, scan[i].x) + std::numbers::pi) / (2.0 * std::numbers::pi);
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) { return phase[i] < phase[j]; });
+
+    const double sweep_period = 0.1;
+    std::size_t sweeps = (point_count + scan.size() - 1) / scan.size();
+    workload::TrajectoryOptions options;
+    options.rate_hz = 200.0;
+    options.count = static_cast<std::size_t>(static_cast<double>(sweeps) * sweep_period * options.rate_hz) + 2;
+    const std::vector<TimedPose> poses = workload::smoothTrajectory(options);
+
+    std::vector<Vector3> points;
+    std::vector<double> times;
+    points.reserve(sweeps * scan.size());
+    times.reserve(sweeps * scan.size());
+    for (std::size_t s = 0; s < sweeps; ++s) {
+        double start = poses.front().time_stamp + sweep_period * static_cast<double>(s);
+        for (std::size_t i : order) {
+            points.push_back(scan[i]);
+            times.push_back(start + sweep_period * phase[i]);
+        }
+    }
+
+    // 按位姿区间分组（各方法共用，不计时）
+    struct Group {
+        std::size_t segment, begin, end;
+    };
+    std::vector<Group> groups;
+    std::vector<double> factors(points.size());
+    for (std::size_t i = 0; i < points.size();) {
+        std::size_t segment = std::min(findSegmentIndex(poses, times[i]), poses.size() - 2);
+        double t0 = poses[segment].time_stamp, t1 = poses[segment + 1].time_stamp;
+        std::size_t j = i;
+        for (; j < points.size() && times[j] <= t1; ++j) {
+            factors[j] = (times[j] - t0) / (t1 - t0);
+        }
+        groups.push_back({ segment, i, j });
+        i = j;
+    }
+    std::vector<DualQuaternion> dual_poses(poses.size());
+    for (std::size_t k = 0; k < poses.size(); ++k) {
+        dual_poses[k] = DualQuaternion::fromPose(poses[k].pose);
+    }
+
+    std::vector<Vector3> reference(points.size()), out(points.size());
+    for (const Group& g : groups) {
+        for (std::size_t i = g.begin; i < g.end; ++i) {
+            reference[i] = sclerp(dual_poses[g.segment], dual_poses[g.segment + 1], factors[i]).transformPoint(points[i]);
+        }
+    }
+    auto row = [&](const std::string& name, double ms, double baseline_ms, bool selected) {
+        double deviation = 0.0;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            deviation = std::max(deviation, (out[i] - reference[i]).norm());
+        }
+        std::cout << "  " << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << ms << std::setprecision(2) << std::setw(10)
+                  << 1e6 * ms / static_cast<double>(points.size()) << std::setw(9) << baseline_ms / ms << "x"
+                  << std::scientific << std::setprecision(1) << std::setw(11) << deviation << std::defaultfloat
+                  << (selected ? "  <- selected" : "") << std::endl;
+    };
+
+    std::cout << "\nDeskew: " << points.size() << " points, " << sweeps << " sweeps of " << scan.size() << ", "
+              << groups.size() << " pose segments of " << 1e3 / options.rate_hz << " ms\n\n  " << std::left
+              << std::setw(32) << "Method" << std::right << std::setw(9) << "ms" << std::setw(10) << "ns/point"
+              << std::setw(10) << "Speedup" << std::setw(11) << "Max dev" << std::endl;
+    double baseline_ms = bestOfMs([&] {
+        for (const Group& g : groups) {
+            const Pose& first = poses[g.segment].pose;
+            const Pose& second = poses[g.segment + 1].pose;
+            for (std::size_t i = g.begin; i < g.end; ++i) {
+                out[i] = interpolatePose(first, second, factors[i]).transform(points[i]);
+            }
+        }
+    });
+    row("interpolatePose + transform", baseline_ms, baseline_ms, false);
+    double sclerp_ms = bestOfMs([&] {
+        for (const Group& g : groups) {
+            for (std::size_t i = g.begin; i < g.end; ++i) {
+                out[i] = sclerp(dual_poses[g.segment], dual_poses[g.segment + 1], factors[i]).transformPoint(points[i]);
+            }
+        }
+    });
+    row("sclerp + transformPoint", sclerp_ms, baseline_ms, false);
+    for (const auto& variant : kernels::deskew_points_kernel.supportedVariants()) {
+        double ms = bestOfMs([&] {
+            for (const Group& g : groups) {
+                variant.function(dual_poses[g.segment], dual_poses[g.segment + 1], factors.data() + g.begin,
+                    points.data() + g.begin, out.data() + g.begin, g.end - g.begin);
+            }
+        });
+        row(std::string("deskewPoints ") + isaName(variant.isa), ms, baseline_ms,
+            variant.isa == kernels::deskew_points_kernel.selectedIsa());
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file main.cpp
+ * @brief 四元数的批量归一化与一阶重新归一化：逐个 Quaternion::normalize 与 normalize_quaternions /
+ *        renormalize_quaternions 各实现的对比，以及长串复合、反复修正时姿态偏离单位球的程度。
+ *
+ * 运行方式：./a21_quaternionNormalization-main [--count N]（批量部分的数组长度）
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "interpolation.hpp"
+#include "kernels.hpp"
+#include "pose.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+double unitError(const Quaternion& q)
+{
+    return std::fabs(std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z) - 1.0);
+}
+
+double maxUnitError(const std::vector<Quaternion>& quaternions)
+{
+    double result = 0.0;
+    for (const Quaternion& q : quaternions) {
+        result = std::max(result, unitError(q));
+    }
+    return result;
+}
+
+void printRow(const std::string& name, double ms, std::size_t count, double baseline_ms, double error, bool selected)
+{
+    std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << 1e3 * ms << std::setw(10) << 1e6 * ms / static_cast<double>(count) << std::setw(9)
+              << baseline_ms / ms << "x" << std::scientific << std::setprecision(1) << std::setw(12) << error
+              << std::defaultfloat << (selected ? "  <- selected" : "") << std::endl;
+}
+
+/**
+ * @brief 先对 input 的副本运行一次 f（用于测误差），再连续运行 passes 次计时。归一化是幂等的，重复运行的开销不变
+ */
+template <typename F>
+double timeOn(const std::vector<Quaternion>& input, std::vector<Quaternion>& work, std::size_t passes, F&& f)
+{
+    work = input;
+    f();
+    return bestOfMs([&] {
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            f();
+        }
+    }) / static_cast<double>(passes);
+}
+
+void benchmark(const std::string& title, const std::vector<Quaternion>& input, std::size_t passes,
+    void (Quaternion::*member)(), const DispatchedKernel<void(Quaternion*, std::size_t)>& kernel)
+{
+    std::cout << "\n" << title << "\n\n  " << std::left << std::setw(36) << "Method" << std::right << std::setw(9)
+              << "us" << std::setw(10) << "ns/quat" << std::setw(10) << "Speedup" << std::setw(12) << "max ||q|-1|"
+              << std::endl;
+    std::vector<Quaternion> work;
+    double baseline_ms = timeOn(input, work, passes, [&] {
+        for (Quaternion& q : work) {
+            (q.*member)();
+        }
+    });
+    printRow("per quaternion (member function)", baseline_ms, input.size(), baseline_ms, maxUnitError(work), false);
+    for (const auto& variant : kernel.supportedVariants()) {
+        double ms = timeOn(input, work, passes, [&] { variant.function(work.data(), work.size()); });
+        printRow(kernel.name() + " " + isaName(variant.isa), ms, input.size(), baseline_ms, maxUnitError(work),
+            variant.isa == kernel.selectedIsa());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // 默认 1024 个四元数（32 KB）留在 L1 里反复处理；数组很大时各实现都受内存带宽限制
+    std::size_t count = 1024;
+    if (argc == 3 && std::string(argv[1]) == "--count") {
+        count = std::stoul(argv[2]);
+    }
+    const std::size_t passes = std::max<std::size_t>(1, 64000000 / count);
+
+    // 1. 批量归一化：任意模长（0.1 到 10）；一阶重新归一化：模长偏离 1 不超过 1e-6
+    workload::WorkloadRng rng(21);
+    std::vector<Quaternion> arbitrary(count), near_unit(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Quaternion q { rng.normal(), rng.normal(), rng.normal(), rng.normal() };
+        q.normalize();
+        arbitrary[i] = q * std::pow(10.0, rng.uniform(-1.0, 1.0));
+        near_unit[i] = q * (1.0 + rng.uniform(-1e-6, 1e-6));
+    }
+    std::cout << count << " quaternions, " << passes << " passes" << std::endl;
+    benchmark("normalize, |q| in [0.1, 10]", arbitrary, passes, &Quaternion::normalize,
+        kernels::normalize_quaternions_kernel);
+    benchmark("renormalize, ||q| - 1| <= 1e-6", near_unit, passes, &Quaternion::renormalize,
+        kernels::renormalize_quaternions_kernel);
+
+    // 2. 长串复合 q ← q · dq：每步的舍入误差累积成模长的随机游走
+    const std::size_t steps = 10000000;
+    std::vector<Quaternion> increments(1024);
+    for (Quaternion& dq : increments) {
+        dq = Quaternion::fromRotationVector(rng.normalVector(0.01));
+    }
+    std::cout << "\nComposition chain of " << steps << " small rotations\n\n  " << std::left << std::setw(36)
+              << "Policy" << std::right << std::setw(10) << "ns/step" << std::setw(14) << "final ||q|-1|" << std::endl;
+    auto chain = [&](const std::string& name, std::size_t every, void (Quaternion::*fix)()) {
+        Quaternion q;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < steps; ++k) {
+            q = q * increments[k & 1023];
+            if (fix != nullptr && (k + 1) % every == 0) {
+                (q.*fix)();
+            }
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << 1e6 * elapsed.count() / static_cast<double>(steps) << std::scientific
+                  << std::setprecision(1) << std::setw(14) << unitError(q) << std::defaultfloat << std::endl;
+    };
+    chain("none", 1, nullptr);
+    chain("normalize every step", 1, &Quaternion::normalize);
+    chain("renormalize every step", 1, &Quaternion::renormalize);
+    chain("renormalize every 1000 steps", 1000, &Quaternion::renormalize);
+
+    // 3. 反复修正同一段轨迹（多次回环）：correct_poses 在复合后做一阶重新归一化
+    workload::TrajectoryOptions options;
+    options.count = 10000;
+    std::vector<TimedPose> corrected = workload::smoothTrajectory(options), composed = corrected;
+    const double start_time = corrected.front().time_stamp, end_time = corrected.back().time_stamp;
+    const std::size_t rounds = 2000;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        Pose start { rng.normalVector(0.01), Quaternion::fromRotationVector(rng.normalVector(0.001)) };
+        Pose end { rng.normalVector(0.01), Quaternion::fromRotationVector(rng.normalVector(0.001)) };
+        kernels::CorrectionSegment segment = kernels::makeCorrectionSegment(start_time, start, end_time, end);
+        kernels::correctPoses(segment, corrected.data(), corrected.size());
+        for (TimedPose& p : composed) {
+            double s = (p.time_stamp - start_time) / (end_time - start_time);
+            p.pose = interpolatePose(start, end, s) * p.pose;
+        }
+    }
+    double corrected_error = 0.0, composed_error = 0.0;
+    for (std::size_t i = 0; i < corrected.size(); ++i) {
+        corrected_error = std::max(corrected_error, unitError(corrected[i].pose.orientation));
+        composed_error = std::max(composed_error, unitError(composed[i].pose.orientation));
+    }
+    std::cout << "\n" << rounds << " corrections of a " << corrected.size() << "-pose trajectory, max ||q|-1|:\n  "
+              << std::left << std::setw(36) << "composition only" << std::scientific << std::setprecision(1)
+              << composed_error << "\n  " << std::setw(36) << "correctPoses (renormalized)" << corrected_error
+              << std::defaultfloat << std::endl;
+    return 0;
+}
@@ -0,0 +1,455 @@
+/**
+ * @file main.cpp
+ * @brief 定长 EKF（ekf.hpp）与按 a0 求解器层写的动态矩阵实现的对比，以及 1 kHz 的误差状态 INS：
+ *        IMU 预测、100 Hz 轮速计速度与 10 Hz GNSS 位置更新，滤波循环内不允许堆分配。
+ *
+ * 真值轨迹取自 workload::smoothTrajectory，IMU 测量由真值差分得到（与 a12 相同），再加上常值零偏和白噪声。
+ * 误差状态顺序为 [δθ, δv, δp, δbg, δba]，姿态误差是右扰动 R = R̄ Exp(δθ)（与 lie.hpp 一致）。
+ *
+ * 运行方式：./a22_extendedKalmanFilter-main [--seconds S]
+ */
+#define PRESLAM_ALLOC_TRACKING
+#include "alloc_tracker.hpp"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "ekf.hpp"
+#include "imu_preintegration.hpp"
+#include "lie.hpp"
+#include "pose.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+constexpr int kStateSize = 15;
+using Filter = ekf::ErrorStateFilter<kStateSize>;
+using State = Filter::State;
+using Covariance = Filter::Covariance;
+using Jacobian3 = Eigen::Matrix<double, 3, kStateSize>;
+
+const Vector3 kGravity { 0.0, 0.0, -9.81 };
+
+template <typename F>
+double nsPerCall(std::size_t calls, F&& f)
+{
+    double best = 1e300;
+    for (int r = 0; r < 3; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < calls; ++k) {
+            f();
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / static_cast<double>(calls));
+    }
+    return best;
+}
+
+/**
+ * @brief 随机的对称正定协方差，特征值在 [1e-4, 1] 之间
+ */
+Covariance randomCovariance(workload::WorkloadRng& rng)
+{
+    Covariance a;
+    for (int i = 0; i < kStateSize * kStateSize; ++i) {
+        a.data()[i] = rng.normal();
+    }
+    Eigen::HouseholderQR<Covariance> qr(a);
+    Covariance q = qr.householderQ();
+    State eigenvalues;
+    for (int i = 0; i < kStateSize; ++i) {
+        eigenvalues(i) = std::pow(10.0, rng.uniform(-4.0, 0.0));
+    }
+    return q * eigenvalues.asDiagonal() * q.transpose();
+}
+
+double minEigenvalue(const Eigen::MatrixXd& p)
+{
+    return Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd>(0.5 * (p + p.transpose())).eigenvalues().minCoeff();
+}
+
+template <typename T>
+using MatrixX = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+/**
+ * @brief 显式算出增益（乘以 1 + gain_error 模拟增益的误差）后更新协方差：P - K H P 或 Joseph 形式的完整乘积
+ */
+template <typename T>
+MatrixX<T> updateCovariance(const MatrixX<T>& p, const MatrixX<T>& h, const MatrixX<T>& r, bool joseph,
+    double gain_error)
+{
+    MatrixX<T> hp = h * p;
+    MatrixX<T> gain = Eigen::LLT<MatrixX<T>>(hp * h.transpose() + r).solve(hp).transpose() * T(1.0 + gain_error);
+    if (!joseph) {
+        return p - gain * hp;
+    }
+    MatrixX<T> a = MatrixX<T>::Identity(p.rows(), p.cols()) - gain * h;
+    return a * p * a.transpose() + gain * r * gain.transpose();
+}
+
+/**
+ * @brief 按 a0 求解器层的写法：MatrixXd，Kᵀ = S⁻¹ H P 逐列调用 solveWithLLT，Joseph 形式做完整的矩阵乘法
+ */
+void updateWithSolverLayer(Eigen::MatrixXd& p, Eigen::VectorXd& dx, const Eigen::VectorXd& residual,
+    const Eigen::MatrixXd& h, const Eigen::MatrixXd& r)
+{
+    Eigen::MatrixXd hp = h * p;
+    Eigen::MatrixXd s = hp * h.transpose() + r;
+    Eigen::MatrixXd gain_t(h.rows(), p.cols());
+    for (Eigen::Index j = 0; j < p.cols(); ++j) {
+        gain_t.col(j) = solveWithLLT(s, hp.col(j)).solution;
+    }
+    dx += gain_t.transpose() * (residual - h * dx);
+    Eigen::MatrixXd a = Eigen::MatrixXd::Identity(p.rows(), p.cols()) - gain_t.transpose() * h;
+    p = a * p * a.transpose() + gain_t.transpose() * r * gain_t;
+}
+
+/**
+ * @brief 同样的公式，但分解对象直接用 Eigen::LLT<MatrixXd>
+ */
+void updateDynamic(Eigen::MatrixXd& p, Eigen::VectorXd& dx, const Eigen::VectorXd& residual, const Eigen::MatrixXd& h,
+    const Eigen::MatrixXd& r)
+{
+    Eigen::MatrixXd hp = h * p;
+    Eigen::LLT<Eigen::MatrixXd> llt(hp * h.transpose() + r);
+    Eigen::MatrixXd gain_t = llt.solve(hp);
+    dx += gain_t.transpose() * (residual - h * dx);
+    Eigen::MatrixXd a = Eigen::MatrixXd::Identity(p.rows(), p.cols()) - gain_t.transpose() * h;
+    p = a * p * a.transpose() + gain_t.transpose() * r * gain_t;
+}
+
+/**
+ * @brief 1 kHz 的真值与 IMU 测量（与 a12 的构造方式相同）
+ */
+struct Dataset {
+    std::vector<double> times;
+    std::vector<imu::NavState> truth;
+    std::vector<imu::ImuSample> samples;
+};
+
+Dataset makeDataset(double duration, double rate_hz, const imu::ImuBias& bias, const imu::ImuNoise& noise)
+{
+    workload::TrajectoryOptions options;
+    options.rate_hz = rate_hz;
+    options.count = static_cast<std::size_t>(duration * rate_hz) + 1;
+    options.seed = 22;
+    std::vector<TimedPose> poses = workload::smoothTrajectory(options);
+
+    Dataset data;
+    const std::size_t n = poses.size();
+    const double dt = 1.0 / rate_hz;
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t prev = k == 0 ? 0 : k - 1;
+        std::size_t next = k + 1 == n ? k : k + 1;
+        Vector3 velocity = (poses[next].pose.position - poses[prev].pose.position)
+            * (1.0 / (poses[next].time_stamp - poses[prev].time_stamp));
+        data.times.push_back(poses[k].time_stamp);
+        data.truth.push_back({ poses[k].pose, velocity });
+    }
+    workload::WorkloadRng rng(23);
+    for (std::size_t k = 0; k + 1 < n; ++k) {
+        const Quaternion& q = data.truth[k].pose.orientation;
+        Vector3 omega = lie::log(q.conjugate() * data.truth[k + 1].pose.orientation) * (1.0 / dt);
+        Vector3 acceleration = (data.truth[k + 1].velocity - data.truth[k].velocity) * (1.0 / dt);
+        Vector3 specific_force = q.conjugate().rotate(acceleration - kGravity);
+        data.samples.push_back({ data.times[k],
+            omega + bias.gyro + rng.normalVector(noise.gyro_noise_density / std::sqrt(dt)),
+            specific_force + bias.accel + rng.normalVector(noise.accel_noise_density / std::sqrt(dt)) });
+    }
+    return data;
+}
+
+/**
+ * @brief 名义状态：位姿、速度与零偏
+ */
+struct NominalState {
+    imu::NavState nav;
+    imu::ImuBias bias;
+};
+
+void inject(NominalState& x, const State& dx)
+{
+    x.nav.pose.orientation = x.nav.pose.orientation * lie::exp(lie::fromEigen(dx.segment<3>(0)));
+    x.nav.pose.orientation.normalize();
+    x.nav.velocity = x.nav.velocity + lie::fromEigen(dx.segment<3>(3));
+    x.nav.pose.position = x.nav.pose.position + lie::fromEigen(dx.segment<3>(6));
+    x.bias.gyro = x.bias.gyro + lie::fromEigen(dx.segment<3>(9));
+    x.bias.accel = x.bias.accel + lie::fromEigen(dx.segment<3>(12));
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 120.0;
+    if (argc == 3 && std::string(argv[1]) == "--seconds") {
+        seconds = std::stod(argv[2]);
+    }
+
+    // --- 1. 单次更新与预测的代价：N = 15，M = 3 ---
+    workload::WorkloadRng rng(22);
+    const Covariance p0 = randomCovariance(rng);
+    Jacobian3 h = Jacobian3::Zero();
+    h.block<3, 3>(0, 6).setIdentity(); // GNSS 位置
+    h.block<3, 3>(0, 0) = 0.3 * Eigen::Matrix3d::Random(); // 杆臂带来的姿态项
+    const Eigen::Matrix3d r = 0.09 * Eigen::Matrix3d::Identity();
+    const Eigen::Vector3d residual(0.2, -0.1, 0.3);
+    Covariance f = Covariance::Identity() + 1e-3 * Covariance::Random();
+    const Covariance q = 1e-6 * Covariance::Identity();
+
+    const Eigen::MatrixXd p_dyn = p0, h_dyn = h, r_dyn = r, f_dyn = f, q_dyn = q;
+    const Eigen::VectorXd residual_dyn = residual;
+    Eigen::MatrixXd p_work;
+    Eigen::VectorXd dx_work;
+    Filter filter(p0);
+    State correction;
+
+    std::cout << "Single update, N = " << kStateSize << ", M = 3\n\n  " << std::left << std::setw(40) << "Method"
+              << std::right << std::setw(10) << "ns/call" << std::setw(12) << "max |dP|" << std::endl;
+    auto row = [](const std::string& name, double ns, double diff) {
+        std::cout << "  " << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << ns << std::scientific << std::setprecision(1) << std::setw(12) << diff
+                  << std::defaultfloat << std::endl;
+    };
+    const std::size_t calls = 200000;
+    double solver_ns = nsPerCall(calls / 10, [&] {
+        p_work = p_dyn;
+        dx_work = Eigen::VectorXd::Zero(kStateSize);
+        updateWithSolverLayer(p_work, dx_work, residual_dyn, h_dyn, r_dyn);
+    });
+    Eigen::MatrixXd reference = p_work;
+    double dynamic_ns = nsPerCall(calls, [&] {
+        p_work = p_dyn;
+        dx_work = Eigen::VectorXd::Zero(kStateSize);
+        updateDynamic(p_work, dx_work, residual_dyn, h_dyn, r_dyn);
+    });
+    double dynamic_diff = (p_work - reference).cwiseAbs().maxCoeff();
+    double fixed_ns = nsPerCall(calls, [&] {
+        filter = Filter(p0);
+        correction.setZero();
+        filter.update<3>(residual, h, r, correction);
+    });
+    row("MatrixXd + solveWithLLT (a0), Joseph", solver_ns, 0.0);
+    row("MatrixXd + Eigen::LLT, Joseph", dynamic_ns, dynamic_diff);
+    row("ekf::ErrorStateFilter<15>", fixed_ns, (Eigen::MatrixXd(filter.covariance()) - reference).cwiseAbs().maxCoeff());
+
+    std::cout << "\nPredict P <- F P F^T + Q\n\n";
+    double predict_dyn_ns = nsPerCall(calls, [&] { p_work = f_dyn * p_dyn * f_dyn.transpose() + q_dyn; });
+    reference = p_work;
+    Covariance full;
+    double predict_full_ns = nsPerCall(calls, [&] { full.noalias() = f * p0 * f.transpose() + q; });
+    double predict_fixed_ns = nsPerCall(calls, [&] {
+        filter = Filter(p0);
+        filter.predict(f, q);
+    });
+    row("MatrixXd, full product", predict_dyn_ns, 0.0);
+    row("Matrix<15, 15>, full product", predict_full_ns, (Eigen::MatrixXd(full) - reference).cwiseAbs().maxCoeff());
+    row("ekf::ErrorStateFilter<15>::predict", predict_fixed_ns,
+        (Eigen::MatrixXd(filter.covariance()) - reference).cwiseAbs().maxCoeff());
+
+    // --- 2. 一批互不相关的测量：堆成一个 3k 维测量 vs 依次更新 ---
+    const std::size_t batch = 20;
+    std::vector<ekf::Measurement<3, kStateSize>> measurements(batch);
+    for (auto& m : measurements) {
+        for (int i = 0; i < 3 * kStateSize; ++i) {
+            m.jacobian.data()[i] = rng.normal();
+        }
+        m.residual = Eigen::Vector3d(rng.normal(), rng.normal(), rng.normal());
+        m.noise = Eigen::Matrix3d::Identity() * std::pow(10.0, rng.uniform(-2.0, 0.0));
+    }
+    Eigen::MatrixXd h_stack = Eigen::MatrixXd::Zero(3 * batch, kStateSize);
+    Eigen::MatrixXd r_stack = Eigen::MatrixXd::Zero(3 * batch, 3 * batch);
+    Eigen::VectorXd residual_stack(3 * batch);
+    for (std::size_t k = 0; k < batch; ++k) {
+        h_stack.middleRows(3 * k, 3) = measurements[k].jacobian;
+        r_stack.block(3 * k, 3 * k, 3, 3) = measurements[k].noise;
+        residual_stack.segment(3 * k, 3) = measurements[k].residual;
+    }
+    std::cout << "\nBatch of " << batch << " independent 3-D measurements\n\n";
+    double stacked_ns = nsPerCall(calls / 100, [&] {
+        p_work = p_dyn;
+        dx_work = Eigen::VectorXd::Zero(kStateSize);
+        updateDynamic(p_work, dx_work, residual_stack, h_stack, r_stack);
+    });
+    reference = p_work;
+    Eigen::VectorXd reference_dx = dx_work;
+    double sequential_ns = nsPerCall(calls / 100, [&] {
+        filter = Filter(p0);
+        correction.setZero();
+        filter.update<3>(measurements.data(), batch, correction);
+    });
+    row("stacked, MatrixXd + Eigen::LLT (60x60)", stacked_ns, 0.0);
+    row("sequential, ErrorStateFilter<15>", sequential_ns,
+        (Eigen::MatrixXd(filter.covariance()) - reference).cwiseAbs().maxCoeff());
+    std::cout << "  max |d(dx)| between the two: " << std::scientific << std::setprecision(1)
+              << (Eigen::VectorXd(correction) - reference_dx).cwiseAbs().maxCoeff() << std::defaultfloat << std::endl;
+
+    // --- 3. 协方差更新的形式：以 long double 的 Joseph 形式为参考，增益可带相对误差 ---
+    std::cout << "\nCovariance update forms, 30 updates with a predict every 5, prior variance 1e-2 to 1e4\n\n  "
+              << std::left << std::setw(10) << "R" << std::setw(12) << "gain error" << std::setw(28) << "Form"
+              << std::right << std::setw(12) << "rel error" << std::setw(14) << "min eig/max" << std::setw(13)
+              << "max |P-P^T|" << std::endl;
+    for (double scale : { 1e-4, 1e-8 }) {
+        for (double gain_error : { 0.0, 1e-3 }) {
+            workload::WorkloadRng sequence(2024);
+            Covariance prior = randomCovariance(sequence);
+            for (int i = 0; i < kStateSize; ++i) {
+                prior.row(i) *= std::pow(10.0, 0.4 * i - 2.0);
+                prior.col(i) *= std::pow(10.0, 0.4 * i - 2.0); // 方差从 1e-2 到 1e4
+            }
+            Eigen::MatrixXd simple = prior, joseph = prior;
+            MatrixX<long double> exact = prior.cast<long double>();
+            Filter filter(prior);
+            const Eigen::MatrixXd noise = scale * Eigen::MatrixXd::Identity(3, 3);
+            for (int k = 0; k < 30; ++k) {
+                Jacobian3 hk;
+                for (int i = 0; i < 3 * kStateSize; ++i) {
+                    hk.data()[i] = sequence.normal();
+                }
+                const Eigen::MatrixXd hd = hk;
+                simple = updateCovariance<double>(simple, hd, noise, false, gain_error);
+                joseph = updateCovariance<double>(joseph, hd, noise, true, gain_error);
+                exact = updateCovariance<long double>(exact, hd.cast<long double>(), noise.cast<long double>(), true, 0.0);
+                State unused = State::Zero();
+                filter.update<3>(Eigen::Vector3d::Zero(), hk, noise, unused);
+                if (k % 5 == 4) {
+                    Covariance fk = Covariance::Identity();
+                    for (int i = 0; i < kStateSize * kStateSize; ++i) {
+                        fk.data()[i] += 0.01 * sequence.normal();
+                    }
+                    const Covariance qk = 1e-3 * scale * Covariance::Identity();
+                    simple = fk * simple * fk.transpose() + qk;
+                    joseph = fk * joseph * fk.transpose() + qk;
+                    exact = fk.cast<long double>() * exact * fk.cast<long double>().transpose() + qk.cast<long double>();
+                    filter.predict(fk, qk);
+                }
+            }
+            auto print = [&](const std::string& form, const Eigen::MatrixXd& p) {
+                std::ostringstream setting;
+                setting << scale;
+                long double error = (p.cast<long double>() - exact).cwiseAbs().maxCoeff() / exact.cwiseAbs().maxCoeff();
+                std::cout << "  " << std::left << std::setw(10) << setting.str() << std::setw(12)
+                          << (gain_error == 0.0 ? "0" : "1e-3") << std::setw(28) << form << std::right
+                          << std::scientific << std::setprecision(1) << std::setw(12) << static_cast<double>(error)
+                          << std::setw(14) << minEigenvalue(p) / p.cwiseAbs().maxCoeff() << std::setw(13)
+                          << (p - p.transpose()).cwiseAbs().maxCoeff() << std::defaultfloat << std::endl;
+            };
+            print("P - K H P", simple);
+            print("Joseph, full products", joseph);
+            if (gain_error == 0.0) {
+                print("Joseph, lower (ekf.hpp)", filter.covariance());
+            }
+        }
+    }
+
+    // --- 4. 1 kHz 误差状态 INS：轮速计 100 Hz，GNSS 10 Hz ---
+    const double rate_hz = 1000.0, dt = 1.0 / rate_hz;
+    const imu::ImuBias true_bias { Vector3 { 0.004, -0.003, 0.005 }, Vector3 { 0.08, -0.05, 0.12 } };
+    const imu::ImuNoise noise;
+    const Dataset data = makeDataset(seconds, rate_hz, true_bias, noise);
+    const double gnss_sigma = 0.3, odometry_sigma = 0.05;
+    std::vector<Eigen::Vector3d> gnss(data.samples.size()), odometry(data.samples.size());
+    for (std::size_t k = 0; k < data.samples.size(); ++k) {
+        const imu::NavState& truth = data.truth[k + 1];
+        gnss[k] = lie::toEigen(truth.pose.position + rng.normalVector(gnss_sigma));
+        odometry[k] = lie::toEigen(truth.pose.orientation.conjugate().rotate(truth.velocity)
+            + rng.normalVector(odometry_sigma));
+    }
+
+    NominalState x { data.truth.front(), {} };
+    State initial_sigma;
+    initial_sigma << Eigen::Vector3d::Constant(0.01), Eigen::Vector3d::Constant(0.1), Eigen::Vector3d::Constant(0.1),
+        Eigen::Vector3d::Constant(0.01), Eigen::Vector3d::Constant(0.2);
+    Filter ins(initial_sigma.cwiseAbs2().asDiagonal().toDenseMatrix());
+    Covariance process = Covariance::Zero();
+    process.diagonal() << Eigen::Vector3d::Constant(std::pow(noise.gyro_noise_density, 2) * dt),
+        Eigen::Vector3d::Constant(std::pow(noise.accel_noise_density, 2) * dt), Eigen::Vector3d::Zero(),
+        Eigen::Vector3d::Constant(1e-10 * dt), Eigen::Vector3d::Constant(1e-8 * dt);
+    const Eigen::Matrix3d gnss_noise = gnss_sigma * gnss_sigma * Eigen::Matrix3d::Identity();
+    const Eigen::Matrix3d odometry_noise = odometry_sigma * odometry_sigma * Eigen::Matrix3d::Identity();
+    const double gate = 16.27; // χ²(3) 的 99.9% 分位数
+
+    Covariance transition = Covariance::Identity();
+    Jacobian3 gnss_jacobian = Jacobian3::Zero();
+    gnss_jacobian.block<3, 3>(0, 6).setIdentity();
+    Jacobian3 odometry_jacobian = Jacobian3::Zero();
+    double position_error2 = 0.0, gnss_nis = 0.0, odometry_nis = 0.0;
+    std::size_t gnss_updates = 0, odometry_updates = 0, rejected = 0;
+    double predict_ns = 0.0, update_ns = 0.0;
+    std::size_t violations = 0;
+    {
+        AllocScope loop("a22 ESKF loop", AllocPolicy::Forbid);
+        for (std::size_t k = 0; k < data.samples.size(); ++k) {
+            auto start = std::chrono::steady_clock::now();
+            const imu::ImuSample& sample = data.samples[k];
+            const Eigen::Vector3d omega = lie::toEigen(sample.gyro - x.bias.gyro);
+            const Eigen::Vector3d force = lie::toEigen(sample.accel - x.bias.accel);
+            const Eigen::Matrix3d rotation = lie::rotationMatrix(x.nav.pose.orientation);
+            const Quaternion step = lie::exp(lie::fromEigen(omega * dt));
+
+            // 名义状态（与 a12 的积分相同）与误差状态的转移矩阵
+            transition.block<3, 3>(0, 0) = lie::rotationMatrix(step).transpose();
+            transition.block<3, 3>(0, 9) = -lie::rightJacobian(lie::fromEigen(omega * dt)) * dt;
+            transition.block<3, 3>(3, 0) = -rotation * lie::skew(force) * dt;
+            transition.block<3, 3>(3, 12) = -rotation * dt;
+            transition.block<3, 3>(6, 3) = Eigen::Matrix3d::Identity() * dt;
+            const Vector3 acceleration = lie::fromEigen(rotation * force) + kGravity;
+            x.nav.pose.position = x.nav.pose.position + x.nav.velocity * dt + acceleration * (0.5 * dt * dt);
+            x.nav.velocity = x.nav.velocity + acceleration * dt;
+            x.nav.pose.orientation = x.nav.pose.orientation * step;
+            ins.predict(transition, process);
+            auto predicted = std::chrono::steady_clock::now();
+
+            State dx = State::Zero();
+            if ((k + 1) % 10 == 0) {
+                const Eigen::Matrix3d rotation_t = lie::rotationMatrix(x.nav.pose.orientation).transpose();
+                const Eigen::Vector3d body_velocity = rotation_t * lie::toEigen(x.nav.velocity);
+                odometry_jacobian.block<3, 3>(0, 0) = lie::skew(body_velocity);
+                odometry_jacobian.block<3, 3>(0, 3) = rotation_t;
+                ekf::UpdateResult result = ins.update<3>(odometry[k] - body_velocity, odometry_jacobian,
+                    odometry_noise, dx, gate);
+                odometry_nis += result.accepted ? result.nis : 0.0;
+                odometry_updates += result.accepted ? 1 : 0;
+                rejected += result.accepted ? 0 : 1;
+            }
+            if ((k + 1) % 100 == 0) {
+                ekf::UpdateResult result = ins.update<3>(gnss[k] - lie::toEigen(x.nav.pose.position), gnss_jacobian,
+                    gnss_noise, dx, gate);
+                gnss_nis += result.accepted ? result.nis : 0.0;
+                gnss_updates += result.accepted ? 1 : 0;
+                rejected += result.accepted ? 0 : 1;
+            }
+            inject(x, dx);
+            auto updated = std::chrono::steady_clock::now();
+            predict_ns += std::chrono::duration<double, std::nano>(predicted - start).count();
+            update_ns += std::chrono::duration<double, std::nano>(updated - predicted).count();
+            double position_error = (x.nav.pose.position - data.truth[k + 1].pose.position).norm();
+            position_error2 += position_error * position_error;
+        }
+        violations = loop.violations();
+    }
+    const double steps = static_cast<double>(data.samples.size());
+    std::cout << "\nError-state INS, " << std::setprecision(6) << seconds << " s: IMU @ 1 kHz, odometry @ 100 Hz, GNSS @ 10 Hz\n\n"
+              << std::fixed << std::setprecision(2) << "  predict (nominal + covariance)   " << std::setw(8)
+              << 1e-3 * predict_ns / steps << " us/step\n"
+              << "  updates + injection              " << std::setw(8) << 1e-3 * update_ns / steps
+              << " us/step (averaged over all steps)\n"
+              << "  heap allocations in the loop     " << std::setw(8) << violations << "\n"
+              << "  position RMSE                    " << std::setw(8) << std::sqrt(position_error2 / steps)
+              << " m (GNSS sigma " << gnss_sigma << " m)\n"
+              << "  mean NIS (expected 3)            " << std::setw(8) << odometry_nis / odometry_updates
+              << " odometry, " << gnss_nis / gnss_updates << " GNSS, " << rejected << " rejected\n"
+              << "  gyro bias error                  " << std::scientific << std::setprecision(1) << std::setw(8)
+              << (x.bias.gyro - true_bias.gyro).norm() << " rad/s\n"
+              << "  accel bias error                 " << std::setw(8) << (x.bias.accel - true_bias.accel).norm()
+              << " m/s^2" << std::defaultfloat << std::endl;
+    return violations == 0 ? 0 : 1;
+}
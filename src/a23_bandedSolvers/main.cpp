@@ -0,0 +1,192 @@
+/**
+ * @file main.cpp
+ * @brief 带状与三对角求解器（a0 mid-solvers）：与稠密分解的规模对比，百万级样本的轨迹平滑与样条拟合，
+ *        以及批量 Thomas 算法。
+ *
+ * 轨迹平滑使用 Whittaker 平滑器 (I + λ DᵀD) x = y，D 为二阶差分，系数矩阵是带宽 2 的对称正定矩阵；
+ * 三次样条的二阶导数满足 [1, 4, 1] 的三对角方程组，闭合轨迹上是循环三对角。
+ *
+ * 运行方式：./a23_bandedSolvers-main [--count N]（平滑与样条的样本数，默认 10⁶）
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief Whittaker 平滑器的系数矩阵 I + λ DᵀD，D 为 (n-2) x n 的二阶差分
+ */
+BandedMatrix whittakerMatrix(int n, double lambda)
+{
+    BandedMatrix A(n, 2, 2);
+    for (int i = 0; i < n; ++i) {
+        A(i, i) = 1.0;
+    }
+    const double d[3] = { 1.0, -2.0, 1.0 };
+    for (int r = 0; r + 2 < n; ++r) {
+        for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 3; ++b) {
+                A(r + a, r + b) += lambda * d[a] * d[b];
+            }
+        }
+    }
+    return A;
+}
+
+void printRow(const std::string& name, double ms, std::size_t unknowns, const SolveResult& result)
+{
+    std::cout << "  " << std::left << std::setw(38) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(11) << ms << std::setw(13) << 1e6 * ms / static_cast<double>(unknowns)
+              << std::scientific << std::setprecision(1) << std::setw(12) << result.error << std::defaultfloat
+              << (result.success ? "" : "  (failed)") << std::endl;
+}
+
+void printHeader(const std::string& title)
+{
+    std::cout << "\n" << title << "\n\n  " << std::left << std::setw(38) << "Method" << std::right << std::setw(11)
+              << "ms" << std::setw(13) << "ns/unknown" << std::setw(12) << "|Ax - b|" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    int count = 1000000;
+    if (argc == 3 && std::string(argv[1]) == "--count") {
+        count = std::stoi(argv[2]);
+    }
+    workload::WorkloadRng rng(23);
+    auto random_vector = [&](int n) {
+        Eigen::VectorXd v(n);
+        for (int i = 0; i < n; ++i) {
+            v(i) = rng.normal();
+        }
+        return v;
+    };
+
+    // 1. 同一个带宽 2 的对称正定矩阵：稠密 LLT 是 O(n³)，带状 LLT 是 O(n)
+    std::cout << "Whittaker smoother matrix (bandwidth 2), dense vs banded" << std::endl;
+    std::cout << "\n  " << std::setw(8) << "n" << std::setw(14) << "dense LLT ms" << std::setw(15)
+              << "banded LLT ms" << std::setw(10) << "speedup" << std::setw(12) << "max |dx|" << std::endl;
+    for (int n : { 250, 500, 1000, 2000 }) {
+        BandedMatrix banded = whittakerMatrix(n, 100.0);
+        Eigen::MatrixXd dense = banded.toDense();
+        Eigen::VectorXd b = random_vector(n);
+        SolveResult dense_result, banded_result;
+        double dense_ms = bestOfMs([&] { dense_result = solveWithLLT(dense, b); }, 1);
+        double banded_ms = bestOfMs([&] { banded_result = solveWithBandedLLT(banded, b); });
+        std::cout << "  " << std::setw(8) << n << std::fixed << std::setprecision(3) << std::setw(14) << dense_ms
+                  << std::setw(15) << banded_ms << std::setprecision(0) << std::setw(9) << dense_ms / banded_ms
+                  << "x" << std::scientific << std::setprecision(1) << std::setw(12)
+                  << (dense_result.solution - banded_result.solution).cwiseAbs().maxCoeff() << std::defaultfloat
+                  << std::endl;
+    }
+
+    // 2. 百万级轨迹平滑：位置加 5 cm 白噪声，三个坐标轴分别求解同一个带状系统
+    workload::TrajectoryOptions options;
+    options.count = static_cast<std::size_t>(count);
+    const std::vector<TimedPose> truth = workload::smoothTrajectory(options);
+    const BandedMatrix smoother = whittakerMatrix(count, 1e4);
+    Eigen::MatrixXd clean(count, 3), noisy(count, 3), smoothed(count, 3);
+    for (int i = 0; i < count; ++i) {
+        const Vector3& p = truth[static_cast<std::size_t>(i)].pose.position;
+        clean.row(i) << p.x, p.y, p.z;
+        noisy.row(i) = clean.row(i) + 0.05 * Eigen::RowVector3d(rng.normal(), rng.normal(), rng.normal());
+    }
+    printHeader("Trajectory smoothing, " + std::to_string(count) + " poses x 3 axes, lambda = 1e4");
+    for (const auto& [name, solver] : {
+             std::pair<std::string, SolveResult (*)(const BandedMatrix&, const Eigen::VectorXd&)> {
+                 "solveWithBandedLLT", solveWithBandedLLT },
+             { "solveWithBandedLU", solveWithBandedLU },
+             { "solveBanded (selects banded LLT)", solveBanded },
+         }) {
+        SolveResult worst;
+        double ms = bestOfMs([&] {
+            for (int axis = 0; axis < 3; ++axis) {
+                SolveResult result = solver(smoother, noisy.col(axis));
+                smoothed.col(axis) = result.solution;
+                if (axis == 0 || result.error > worst.error) {
+                    worst = result;
+                }
+            }
+        });
+        printRow(name, ms, 3 * static_cast<std::size_t>(count), worst);
+    }
+    auto rmse = [&](const Eigen::MatrixXd& estimate) {
+        return std::sqrt((estimate - clean).rowwise().squaredNorm().mean());
+    };
+    std::cout << "  position RMSE: " << std::fixed << std::setprecision(4) << rmse(noisy) << " m noisy, "
+              << rmse(smoothed) << " m smoothed" << std::defaultfloat << std::endl;
+
+    // 3. 三次样条的二阶导数：自然边界为 [1, 4, 1] 三对角，闭合轨迹为循环三对角
+    const int interior = count - 2;
+    const Eigen::VectorXd ones = Eigen::VectorXd::Ones(interior), fours = Eigen::VectorXd::Constant(interior, 4.0);
+    Eigen::VectorXd rhs(interior);
+    for (int i = 0; i < interior; ++i) {
+        rhs(i) = 6.0 * (noisy(i, 0) - 2.0 * noisy(i + 1, 0) + noisy(i + 2, 0));
+    }
+    BandedMatrix spline(interior, 1, 1);
+    spline.bands.row(0).setOnes();
+    spline.bands.row(1).setConstant(4.0);
+    spline.bands.row(2).setOnes();
+    printHeader("Natural cubic spline through " + std::to_string(count) + " samples ([1, 4, 1] tridiagonal)");
+    SolveResult result;
+    double ms = bestOfMs([&] { result = solveTridiagonal(ones, fours, ones, rhs); });
+    printRow("solveTridiagonal (Thomas)", ms, interior, result);
+    ms = bestOfMs([&] { result = solveBanded(spline, rhs); });
+    printRow("solveBanded (selects Thomas)", ms, interior, result);
+    ms = bestOfMs([&] { result = solveWithBandedLLT(spline, rhs); });
+    printRow("solveWithBandedLLT", ms, interior, result);
+    ms = bestOfMs([&] { result = solveWithBandedLU(spline, rhs); });
+    printRow("solveWithBandedLU", ms, interior, result);
+    ms = bestOfMs([&] { result = solveCyclicTridiagonal(ones, fours, ones, rhs); });
+    printRow("solveCyclicTridiagonal (closed loop)", ms, interior, result);
+
+    // 4. 大量互相独立的小方程组（例如按窗口分段的样条）：逐个求解与批量求解
+    const int systems = 16384, size = 64;
+    Eigen::MatrixXd lower(systems, size), diagonal(systems, size), upper(systems, size), b(systems, size);
+    for (int s = 0; s < systems; ++s) {
+        for (int i = 0; i < size; ++i) {
+            lower(s, i) = rng.normal();
+            upper(s, i) = rng.normal();
+            diagonal(s, i) = std::fabs(lower(s, i)) + std::fabs(upper(s, i)) + rng.uniform(0.5, 2.0);
+            b(s, i) = rng.normal();
+        }
+    }
+    printHeader(std::to_string(systems) + " independent tridiagonal systems of size " + std::to_string(size));
+    SolveResult worst;
+    ms = bestOfMs([&] {
+        for (int s = 0; s < systems; ++s) {
+            SolveResult single = solveTridiagonal(lower.row(s).transpose(), diagonal.row(s).transpose(),
+                upper.row(s).transpose(), b.row(s).transpose());
+            if (s == 0 || single.error > worst.error) {
+                worst = single;
+            }
+        }
+    });
+    printRow("solveTridiagonal, one by one", ms, static_cast<std::size_t>(systems) * size, worst);
+    ms = bestOfMs([&] { result = solveTridiagonalBatch(lower, diagonal, upper, b); });
+    printRow("solveTridiagonalBatch", ms, static_cast<std::size_t>(systems) * size, result);
+    return 0;
+}
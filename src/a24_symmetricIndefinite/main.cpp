@@ -0,0 +1,190 @@
+/**
+ * @file main.cpp
+ * @brief 对称半正定与对称不定方程组（a0 mid-solvers 的 solveWithLDLT / solveWithBunchKaufman）：
+ *        与部分主元 LU、列主元 QR、LLT、Eigen::LDLT 在三类位姿图问题上的耗时、残差与惯性对比。
+ *
+ * 三类问题都来自只含平移的位姿图（环形轨迹加随机回环）的法方程 H = Jᵀ J：
+ * 固定第一个节点时 H 对称正定；不固定时 H 只是半正定，有 3 维规范自由度（整体平移）；
+ * 改用“质心为零”的约束消去规范自由度时，得到对称不定的 KKT 系统 [H Cᵀ; C 0]。
+ *
+ * 运行方式：./a24_symmetricIndefinite-main [--nodes N]（位姿图节点数，默认 400，未知量为 3N）
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "workload.hpp"
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief 只含平移的位姿图的法方程 Jᵀ J：相邻节点与随机回环各是一条边，每条边贡献 [I -I; -I I]
+ */
+Eigen::MatrixXd translationGraph(int nodes, int loop_closures, robotics::workload::WorkloadRng& rng)
+{
+    Eigen::MatrixXd H = Eigen::MatrixXd::Zero(3 * nodes, 3 * nodes);
+    auto add_edge = [&](int i, int j, double weight) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const int a = 3 * i + axis, b = 3 * j + axis;
+            H(a, a) += weight;
+            H(b, b) += weight;
+            H(a, b) -= weight;
+            H(b, a) -= weight;
+        }
+    };
+    for (int i = 0; i + 1 < nodes; ++i) {
+        add_edge(i, i + 1, rng.uniform(0.5, 2.0));
+    }
+    for (int k = 0; k < loop_closures; ++k) {
+        const int i = static_cast<int>(rng.uniform(0.0, nodes - 1.0));
+        const int j = static_cast<int>(rng.uniform(0.0, nodes - 1.0));
+        if (i != j) {
+            add_edge(i, j, rng.uniform(0.1, 1.0));
+        }
+    }
+    return H;
+}
+
+struct Method {
+    std::string name;
+    SolveResult (*solve)(const Eigen::MatrixXd&, const Eigen::VectorXd&, Inertia*);
+};
+
+void runProblem(const std::string& title, const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+    const std::vector<Method>& methods)
+{
+    std::cout << "\n" << title << " (n = " << A.rows() << ")\n\n  " << std::left << std::setw(30) << "Method"
+              << std::right << std::setw(10) << "ms" << std::setw(12) << "|Ax - b|" << std::setw(10) << "|x|"
+              << std::setw(18) << "inertia (+,-,0)" << std::endl;
+    for (const Method& method : methods) {
+        SolveResult result;
+        Inertia inertia { -1, -1, -1 };
+        double ms = bestOfMs([&] { result = method.solve(A, b, &inertia); });
+        std::cout << "  " << std::left << std::setw(30) << method.name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(10) << ms;
+        if (result.success) {
+            std::cout << std::scientific << std::setprecision(1) << std::setw(12) << result.error << std::setw(10)
+                      << result.solution.norm();
+        } else {
+            std::cout << std::setw(22) << "failed";
+        }
+        std::cout << std::defaultfloat;
+        if (inertia.positive >= 0) {
+            std::string counts = std::to_string(inertia.positive) + ", " + std::to_string(inertia.negative) + ", "
+                + std::to_string(inertia.zero);
+            std::cout << std::setw(18) << counts;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int nodes = 400;
+    if (argc == 3 && std::string(argv[1]) == "--nodes") {
+        nodes = std::stoi(argv[2]);
+    }
+    robotics::workload::WorkloadRng rng(24);
+    const Eigen::MatrixXd laplacian = translationGraph(nodes, nodes / 4, rng);
+    const int n = static_cast<int>(laplacian.rows());
+    auto random_vector = [&](int size) {
+        Eigen::VectorXd v(size);
+        for (int i = 0; i < size; ++i) {
+            v(i) = rng.normal();
+        }
+        return v;
+    };
+
+    // 所有求解器统一成带惯性输出的签名；没有惯性的求解器不写 inertia
+    const std::vector<Method> methods = {
+        { "solveWithPartialPivLU", [](const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia*) {
+             return solveWithPartialPivLU(A, b);
+         } },
+        { "solveWithColPivHouseholderQr", [](const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia*) {
+             return solveWithColPivHouseholderQr(A, b);
+         } },
+        { "solveWithLLT", [](const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia*) {
+             return solveWithLLT(A, b);
+         } },
+        { "Eigen::LDLT", [](const Eigen::MatrixXd& A, const Eigen::VectorXd& b, Inertia*) {
+             SolveResult result;
+             result.method = "Eigen::LDLT";
+             Eigen::LDLT<Eigen::MatrixXd> ldlt(A);
+             result.solution = ldlt.solve(b);
+             result.error = (A * result.solution - b).norm();
+             result.success = ldlt.info() == Eigen::Success && result.solution.allFinite();
+             return result;
+         } },
+        { "solveWithLDLT", solveWithLDLT },
+        { "solveWithBunchKaufman", solveWithBunchKaufman },
+    };
+
+    // 1. 固定第一个节点（加一个强先验）：对称正定
+    Eigen::MatrixXd anchored = laplacian;
+    anchored.topLeftCorner(3, 3) += 1e4 * Eigen::Matrix3d::Identity();
+    runProblem("Anchored translation graph, symmetric positive definite", anchored, random_vector(n), methods);
+
+    // 2. 不固定：半正定，零空间是整体平移；右端项取 H x，保证在值域内
+    const Eigen::VectorXd in_range = laplacian * random_vector(n);
+    runProblem("Free translation graph, semidefinite with 3 gauge directions", laplacian, in_range, methods);
+
+    // 3. 质心约束 Σ xᵢ / N = 0：KKT 矩阵 [H Cᵀ; C 0]，惯性应为 (n, 3, 0)
+    Eigen::MatrixXd kkt = Eigen::MatrixXd::Zero(n + 3, n + 3);
+    kkt.topLeftCorner(n, n) = laplacian;
+    for (int i = 0; i < nodes; ++i) {
+        kkt.block(n, 3 * i, 3, 3) = Eigen::Matrix3d::Identity() / nodes;
+        kkt.block(3 * i, n, 3, 3) = Eigen::Matrix3d::Identity() / nodes;
+    }
+    Eigen::VectorXd kkt_rhs = Eigen::VectorXd::Zero(n + 3);
+    kkt_rhs.head(n) = in_range;
+    runProblem("Gauge fixed by a centroid constraint, KKT (indefinite)", kkt, kkt_rhs, methods);
+
+    // 4. 分解耗时随规模的变化：对称分解只需要 LU 一半的计算量
+    std::cout << "\nFactorization of the KKT matrix, ms\n\n  " << std::setw(8) << "n" << std::setw(10) << "LU"
+              << std::setw(10) << "LLT*" << std::setw(14) << "Eigen::LDLT" << std::setw(16) << "Bunch-Kaufman"
+              << std::endl;
+    for (int size : { 100, 200, 400, 800 }) {
+        const Eigen::MatrixXd graph = translationGraph(size, size / 4, rng);
+        const int m = static_cast<int>(graph.rows());
+        Eigen::MatrixXd K = Eigen::MatrixXd::Zero(m + 3, m + 3);
+        K.topLeftCorner(m, m) = graph;
+        for (int i = 0; i < size; ++i) {
+            K.block(m, 3 * i, 3, 3) = Eigen::Matrix3d::Identity() / size;
+            K.block(3 * i, m, 3, 3) = Eigen::Matrix3d::Identity() / size;
+        }
+        // LLT 不能分解不定矩阵，只作为对称分解的速度参照：K 加上足够大的对角项后对角占优、正定
+        const double shift = 1.0 + 2.0 * graph.diagonal().maxCoeff();
+        const Eigen::MatrixXd spd = K + shift * Eigen::MatrixXd::Identity(m + 3, m + 3);
+        Eigen::MatrixXd LD;
+        SymmetricFactor factor;
+        double lu_ms = bestOfMs([&] { Eigen::PartialPivLU<Eigen::MatrixXd> lu(K); });
+        double llt_ms = bestOfMs([&] { Eigen::LLT<Eigen::MatrixXd> llt(spd); });
+        double ldlt_ms = bestOfMs([&] { Eigen::LDLT<Eigen::MatrixXd> ldlt(K); });
+        double bk_ms = bestOfMs([&] {
+            LD = K;
+            factorBunchKaufman(LD, factor);
+        });
+        std::cout << "  " << std::setw(8) << m + 3 << std::fixed << std::setprecision(2) << std::setw(10) << lu_ms
+                  << std::setw(10) << llt_ms << std::setw(14) << ldlt_ms << std::setw(16) << bk_ms
+                  << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
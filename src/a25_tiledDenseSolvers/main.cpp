@@ -0,0 +1,151 @@
+/**
+ * @file main.cpp
+ * @brief 多线程分块稠密分解（a0 mid-solvers 中以 ThreadPool 为参数的 LU / LLT / QR）：与 Eigen 单线程分解的对比、
+ *        列块宽度的影响、任务图的可用并行度与线程数扩展。
+ *
+ * 可用并行度按浮点运算量计算：总运算量除以关键路径（panel(k) → update(k+1, k) → panel(k+1) → ...）的运算量，
+ * 是任意多线程时加速比的上限，与运行机器的核数无关。
+ *
+ * 运行方式：./a25_tiledDenseSolvers-main [--size N]（扩展性测试的矩阵规模，默认 2000）
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "parallel.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief 列块 LU 任务图的总运算量与关键路径运算量
+ */
+std::pair<double, double> luTaskFlops(int n, int tile)
+{
+    const int blocks = (n + tile - 1) / tile;
+    auto width = [&](int k) { return static_cast<double>(std::min(tile, n - k * tile)); };
+    auto panel = [&](int k) {
+        const double rows = n - k * tile, w = width(k);
+        return rows * w * w - w * w * w / 3.0;
+    };
+    auto update = [&](int j, int k) {
+        const double rows = n - k * tile, w = width(k), wj = width(j);
+        return w * w * wj + 2.0 * (rows - w) * w * wj;
+    };
+    double total = 0.0, critical = 0.0;
+    for (int k = 0; k < blocks; ++k) {
+        total += panel(k);
+        critical += panel(k);
+        for (int j = k + 1; j < blocks; ++j) {
+            total += update(j, k);
+        }
+        if (k + 1 < blocks) {
+            critical += update(k + 1, k);
+        }
+    }
+    return { total, critical };
+}
+
+int main(int argc, char** argv)
+{
+    int size = 2000;
+    if (argc == 3 && std::string(argv[1]) == "--size") {
+        size = std::stoi(argv[2]);
+    }
+    workload::WorkloadRng rng(25);
+    auto random_matrix = [&](int rows, int cols) {
+        return Eigen::MatrixXd(Eigen::MatrixXd::NullaryExpr(rows, cols, [&](Eigen::Index, Eigen::Index) {
+            return rng.normal();
+        }));
+    };
+    auto relative = [](const Eigen::VectorXd& x, const Eigen::VectorXd& reference) {
+        return (x - reference).norm() / reference.norm();
+    };
+    std::cout << "hardwareThreads() = " << hardwareThreads() << std::endl;
+
+    // 1. 单线程时分块实现与 Eigen 的分解相比没有额外开销
+    ThreadPool serial(1);
+    std::cout << "\nOne thread, automatic tile: Eigen vs tiled task graph\n\n  " << std::setw(6) << "n" << std::left
+              << "  " << std::setw(16) << "Factorization" << std::right << std::setw(11) << "Eigen ms" << std::setw(11)
+              << "tiled ms" << std::setw(9) << "GFLOP/s" << std::setw(12) << "rel. diff" << std::endl;
+    for (int n : { 1000, 2000, 3000 }) {
+        const Eigen::MatrixXd A = random_matrix(n, n);
+        const Eigen::MatrixXd spd = A * A.transpose() + n * Eigen::MatrixXd::Identity(n, n);
+        const Eigen::VectorXd b = random_matrix(n, 1);
+        const double cube = static_cast<double>(n) * n * n;
+        auto row = [&](const std::string& name, double flops, auto&& eigen, auto&& tiled) {
+            SolveResult reference, result;
+            const int repeats = n <= 1000 ? 3 : 1;
+            double eigen_ms = bestOfMs([&] { reference = eigen(); }, repeats);
+            double tiled_ms = bestOfMs([&] { result = tiled(); }, repeats);
+            std::cout << "  " << std::setw(6) << n << "  " << std::left << std::setw(16) << name << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(11) << eigen_ms << std::setw(11) << tiled_ms
+                      << std::setw(9) << flops / tiled_ms * 1e-6 << std::scientific << std::setprecision(1)
+                      << std::setw(12) << relative(result.solution, reference.solution) << std::defaultfloat
+                      << (result.success ? "" : "  (failed)") << std::endl;
+        };
+        row("LU", 2.0 * cube / 3.0, [&] { return solveWithPartialPivLU(A, b); },
+            [&] { return solveWithPartialPivLU(A, b, serial); });
+        row("LLT", cube / 3.0, [&] { return solveWithLLT(spd, b); }, [&] { return solveWithLLT(spd, b, serial); });
+        row("Householder QR", 4.0 * cube / 3.0,
+            [&] {
+                SolveResult result;
+                result.solution = Eigen::HouseholderQR<Eigen::MatrixXd>(A).solve(b);
+                return result;
+            },
+            [&] { return solveWithHouseholderQr(A, b, serial); });
+    }
+
+    // 2. 列块宽度：越窄并行度越高，但每个任务的矩阵乘法越小、效率越低
+    const Eigen::MatrixXd A = random_matrix(size, size);
+    const Eigen::MatrixXd spd = A * A.transpose() + size * Eigen::MatrixXd::Identity(size, size);
+    const Eigen::VectorXd b = random_matrix(size, 1);
+    std::cout << "\nLU, n = " << size << ", one thread: tile width vs available parallelism\n\n  " << std::setw(6)
+              << "tile" << std::setw(8) << "tasks" << std::setw(11) << "ms" << std::setw(9) << "GFLOP/s"
+              << std::setw(14) << "parallelism" << std::endl;
+    for (int tile : { 64, 128, 192, 256, 384 }) {
+        const int blocks = (size + tile - 1) / tile;
+        const auto [total, critical] = luTaskFlops(size, tile);
+        SolveResult result;
+        double ms = bestOfMs([&] { result = solveWithPartialPivLU(A, b, serial, tile); }, 1);
+        std::cout << "  " << std::setw(6) << tile << std::setw(8) << blocks * (blocks + 1) / 2 << std::fixed
+                  << std::setprecision(1) << std::setw(11) << ms << std::setw(9) << total / ms * 1e-6
+                  << std::setw(13) << total / critical << "x" << std::defaultfloat << std::endl;
+    }
+
+    // 3. 线程数：每次调用使用调用者提供的线程池，互不影响
+    std::cout << "\nn = " << size << ", automatic tile, threads per call\n\n  " << std::setw(8) << "threads"
+              << std::setw(11) << "LU ms" << std::setw(11) << "LLT ms" << std::setw(11) << "QR ms" << "  LU method"
+              << std::endl;
+    for (unsigned threads : { 1u, 2u, 4u }) {
+        ThreadPool pool(threads);
+        SolveResult lu;
+        double lu_ms = bestOfMs([&] { lu = solveWithPartialPivLU(A, b, pool); }, 1);
+        double llt_ms = bestOfMs([&] { solveWithLLT(spd, b, pool); }, 1);
+        double qr_ms = bestOfMs([&] { solveWithHouseholderQr(A, b, pool); }, 1);
+        std::cout << "  " << std::setw(8) << threads << std::fixed << std::setprecision(1) << std::setw(11) << lu_ms
+                  << std::setw(11) << llt_ms << std::setw(11) << qr_ms << std::defaultfloat << "  " << lu.method
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file main.cpp
+ * @brief 稀疏 Cholesky 的符号分析缓存（a0 mid-solvers 的 solveWithSparseLLT + SparseAnalysisCache）：
+ *        符号分析在一次求解中所占的比例、模式指纹的代价，以及模式不变的多次求解中缓存带来的收益。
+ *
+ * 两类问题都是类位姿图的 SPD 矩阵：workload_systems 的标量图拉普拉斯（里程计链加回环），
+ * 以及把它的每个元素换成 6x6 块（与 SE(3) 位姿图法方程的块结构相同）。
+ * 参照为 Eigen::SimplicialLLT（同样是 AMD 排序）：每次 compute，与 analyzePattern 一次后只 factorize。
+ *
+ * 运行方式：./a26_sparseAnalysisCache-main [--nodes N]（标量问题的未知量个数，默认 40000）
+ */
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "workload.hpp"
+#include "workload_systems.hpp"
+
+using namespace robotics;
+
+using SparseMatrix = Eigen::SparseMatrix<double>;
+using EigenLLT = Eigen::SimplicialLLT<SparseMatrix, Eigen::Lower, Eigen::AMDOrdering<int>>;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief 把标量矩阵的每个元素 s 换成 s · B（B 为 6x6 SPD），两个 SPD 矩阵的 Kronecker 积仍是 SPD
+ */
+SparseMatrix blockExpand(const SparseMatrix& S, workload::WorkloadRng& rng)
+{
+    Eigen::Matrix<double, 6, 6> G;
+    for (int i = 0; i < 36; ++i) {
+        G(i) = rng.normal();
+    }
+    const Eigen::Matrix<double, 6, 6> B = G * G.transpose() + 6.0 * Eigen::Matrix<double, 6, 6>::Identity();
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(static_cast<std::size_t>(S.nonZeros()) * 36);
+    for (int j = 0; j < S.outerSize(); ++j) {
+        for (SparseMatrix::InnerIterator it(S, j); it; ++it) {
+            for (int c = 0; c < 6; ++c) {
+                for (int r = 0; r < 6; ++r) {
+                    triplets.emplace_back(6 * it.row() + r, 6 * j + c, it.value() * B(r, c));
+                }
+            }
+        }
+    }
+    SparseMatrix A(6 * S.rows(), 6 * S.cols());
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+/**
+ * @brief 模式不变、数值变化的下一次迭代：A ← D A D（D 为正对角矩阵），仍然对称正定
+ */
+void rescale(SparseMatrix& A, workload::WorkloadRng& rng)
+{
+    Eigen::VectorXd d(A.rows());
+    for (Eigen::Index i = 0; i < d.size(); ++i) {
+        d(i) = rng.uniform(0.8, 1.25);
+    }
+    for (int j = 0; j < A.outerSize(); ++j) {
+        for (SparseMatrix::InnerIterator it(A, j); it; ++it) {
+            it.valueRef() *= d(it.row()) * d(j);
+        }
+    }
+}
+
+void profile(const std::string& title, const SparseMatrix& full, const Eigen::VectorXd& b)
+{
+    const SparseMatrix A = full.triangularView<Eigen::Lower>(); // 求解器都只读下三角
+    SparseSymbolic symbolic;
+    SparseAnalysisCache cache;
+    SolveResult uncached, cached, eigen;
+    EigenLLT factored;
+    factored.analyzePattern(A);
+
+    const double fingerprint_ms = bestOfMs([&] { sparsityFingerprint(A); });
+    const double analyze_ms = bestOfMs([&] { analyzeSparseCholesky(A, symbolic); });
+    const double uncached_ms = bestOfMs([&] { uncached = solveWithSparseLLT(A, b); });
+    solveWithSparseLLT(A, b, &cache); // 第一次求解填充缓存
+    const double cached_ms = bestOfMs([&] { cached = solveWithSparseLLT(A, b, &cache); });
+    const double eigen_compute_ms = bestOfMs([&] {
+        EigenLLT llt(A);
+        eigen.solution = llt.solve(b);
+    });
+    const double eigen_factorize_ms = bestOfMs([&] {
+        factored.factorize(A);
+        factored.solve(b);
+    });
+
+    std::cout << "\n" << title << ": n = " << A.rows() << ", nnz(lower A) = " << A.nonZeros()
+              << ", nnz(L) = " << symbolic.column_pointers.back() << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  fingerprint                          " << std::setw(9) << fingerprint_ms << " ms\n";
+    std::cout << "  symbolic analysis (AMD, etree, L)    " << std::setw(9) << analyze_ms << " ms\n";
+    std::cout << "  solveWithSparseLLT, no cache         " << std::setw(9) << uncached_ms << " ms\n";
+    std::cout << "  solveWithSparseLLT, cache hit        " << std::setw(9) << cached_ms << " ms  (saves "
+              << std::setprecision(0) << 100.0 * (1.0 - cached_ms / uncached_ms) << "%)\n"
+              << std::setprecision(2);
+    std::cout << "  Eigen::SimplicialLLT, compute        " << std::setw(9) << eigen_compute_ms << " ms\n";
+    std::cout << "  Eigen::SimplicialLLT, factorize only " << std::setw(9) << eigen_factorize_ms << " ms\n";
+    std::cout << std::scientific << std::setprecision(1) << "  |x_cached - x_eigen| / |x_eigen|     "
+              << (cached.solution - eigen.solution).norm() / eigen.solution.norm() << ", cache hits "
+              << cache.hits() << ", misses " << cache.misses() << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    int nodes = 40000;
+    if (argc == 3 && std::string(argv[1]) == "--nodes") {
+        nodes = std::stoi(argv[2]);
+    }
+    workload::WorkloadRng rng(26);
+
+    // 1. 一次求解中各部分的耗时。回环较少时填充很少，数值分解便宜，符号分析占了大部分时间
+    const workload::SparseLinearSystem scalar = workload::sparseSpdSystem(nodes, 3, nodes / 400, 1e-2, 26);
+    profile("Scalar pose-graph Laplacian", scalar.A, scalar.b);
+    const workload::SparseLinearSystem graph = workload::sparseSpdSystem(nodes / 8, 2, nodes / 1600, 1e-2, 27);
+    const SparseMatrix blocks = blockExpand(graph.A, rng);
+    Eigen::VectorXd block_rhs(blocks.rows());
+    for (Eigen::Index i = 0; i < block_rhs.size(); ++i) {
+        block_rhs(i) = rng.normal();
+    }
+    profile("6x6-block pose graph", blocks, block_rhs);
+
+    // 2. 随机回环越多，L 的填充越多，数值分解的代价增长得比符号分析快
+    std::cout << "\nScalar graph, n = " << nodes << ": share of the symbolic analysis vs loop closures\n\n  "
+              << std::setw(8) << "loops" << std::setw(11) << "nnz(L)" << std::setw(13) << "analysis ms"
+              << std::setw(12) << "numeric ms" << std::setw(8) << "share" << std::endl;
+    for (int loops : { 0, nodes / 1000, nodes / 400, nodes / 100, nodes / 20 }) {
+        const workload::SparseLinearSystem system = workload::sparseSpdSystem(nodes, 3, loops, 1e-2, 26);
+        const SparseMatrix lower = system.A.triangularView<Eigen::Lower>();
+        SparseSymbolic symbolic;
+        SparseAnalysisCache cache;
+        solveWithSparseLLT(lower, system.b, &cache);
+        const double analyze_ms = bestOfMs([&] { analyzeSparseCholesky(lower, symbolic); }, 1);
+        const double numeric_ms = bestOfMs([&] { solveWithSparseLLT(lower, system.b, &cache); }, 1);
+        std::cout << "  " << std::setw(8) << loops << std::setw(11) << symbolic.column_pointers.back() << std::fixed
+                  << std::setprecision(2) << std::setw(13) << analyze_ms << std::setw(12) << numeric_ms
+                  << std::setprecision(0) << std::setw(7) << 100.0 * analyze_ms / (analyze_ms + numeric_ms) << "%"
+                  << std::defaultfloat << std::endl;
+    }
+
+    // 3. 求解循环：每次迭代数值变化，每 10 次迭代加一条回环（模式改变）
+    const int iterations = 40;
+    SparseMatrix A = blocks.triangularView<Eigen::Lower>();
+    SparseAnalysisCache cache;
+    double cached_ms = 0.0, uncached_ms = 0.0, eigen_ms = 0.0, max_difference = 0.0;
+    for (int it = 0; it < iterations; ++it) {
+        if (it > 0 && it % 10 == 0) {
+            const int i = static_cast<int>(rng.index(static_cast<std::size_t>(graph.A.rows())));
+            const int j = static_cast<int>(rng.index(static_cast<std::size_t>(graph.A.rows())));
+            for (int k = 0; k < 6; ++k) {
+                A.coeffRef(6 * std::max(i, j) + k, 6 * std::min(i, j) + k) -= 0.1; // 对角块保持占优
+                A.coeffRef(6 * i + k, 6 * i + k) += 0.1;
+                A.coeffRef(6 * j + k, 6 * j + k) += 0.1;
+            }
+            A.makeCompressed();
+        }
+        rescale(A, rng);
+        SolveResult with_cache, without_cache;
+        cached_ms += bestOfMs([&] { with_cache = solveWithSparseLLT(A, block_rhs, &cache); }, 1);
+        uncached_ms += bestOfMs([&] { without_cache = solveWithSparseLLT(A, block_rhs); }, 1);
+        eigen_ms += bestOfMs([&] { EigenLLT llt(A); }, 1);
+        max_difference = std::max(max_difference,
+            (with_cache.solution - without_cache.solution).norm() / without_cache.solution.norm());
+    }
+    std::cout << "\nSolve loop, " << iterations << " iterations on the 6x6-block graph, a loop closure every 10\n\n"
+              << std::fixed << std::setprecision(1) << "  solveWithSparseLLT, no cache      " << std::setw(9)
+              << uncached_ms << " ms\n"
+              << "  solveWithSparseLLT, with cache    " << std::setw(9) << cached_ms << " ms  (" << cache.hits()
+              << " hits, " << cache.misses() << " misses)\n"
+              << "  Eigen::SimplicialLLT, compute     " << std::setw(9) << eigen_ms << " ms (analysis + factorization)\n"
+              << std::scientific << std::setprecision(1) << "  max relative difference, cached vs uncached "
+              << max_difference << std::defaultfloat << std::endl;
+    return 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file main.cpp
+ * @brief 超节点稀疏 Cholesky（a0 mid-solvers 的 solveWithSupernodalLLT / solveSparse）：
+ *        填充从少到多时与逐列（simplicial）分解的对比、超节点的宽度、消去树提供的并行度，以及每次调用的线程数。
+ *
+ * 问题与 a26 相同：workload_systems 的标量位姿图拉普拉斯，以及把每个元素换成 6x6 块的图，回环个数从少到多。
+ * 参照为 a26 的 solveWithSparseLLT（up-looking）与 Eigen::SimplicialLLT（同样是 AMD 排序）。
+ *
+ * 运行方式：./a27_supernodalCholesky-main [--nodes N]（标量问题的未知量个数，默认 40000）
+ */
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "parallel.hpp"
+#include "workload.hpp"
+#include "workload_systems.hpp"
+
+using namespace robotics;
+
+using SparseMatrix = Eigen::SparseMatrix<double>;
+using EigenLLT = Eigen::SimplicialLLT<SparseMatrix, Eigen::Lower, Eigen::AMDOrdering<int>>;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief 把标量矩阵的每个元素 s 换成 s · B（B 为 6x6 SPD），两个 SPD 矩阵的 Kronecker 积仍是 SPD
+ */
+SparseMatrix blockExpand(const SparseMatrix& S, workload::WorkloadRng& rng)
+{
+    Eigen::Matrix<double, 6, 6> G;
+    for (int i = 0; i < 36; ++i) {
+        G(i) = rng.normal();
+    }
+    const Eigen::Matrix<double, 6, 6> B = G * G.transpose() + 6.0 * Eigen::Matrix<double, 6, 6>::Identity();
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(static_cast<std::size_t>(S.nonZeros()) * 36);
+    for (int j = 0; j < S.outerSize(); ++j) {
+        for (SparseMatrix::InnerIterator it(S, j); it; ++it) {
+            for (int c = 0; c < 6; ++c) {
+                for (int r = 0; r < 6; ++r) {
+                    triplets.emplace_back(6 * it.row() + r, 6 * j + c, it.value() * B(r, c));
+                }
+            }
+        }
+    }
+    SparseMatrix A(6 * S.rows(), 6 * S.cols());
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+/**
+ * @brief 可用并行度：总运算量除以超节点消去树上最重的一条根到叶路径的运算量
+ */
+double availableParallelism(const SupernodalSymbolic& supernodal)
+{
+    const int supernodes = static_cast<int>(supernodal.supernode_parent.size());
+    std::vector<double> path(supernodes, 0.0);
+    double total = 0.0, critical = 0.0;
+    for (int s = 0; s < supernodes; ++s) { // 子节点的编号比父节点小，按编号顺序时子节点已经算完
+        const int width = supernodal.supernode_columns[s + 1] - supernodal.supernode_columns[s];
+        const int height = supernodal.row_pointers[s + 1] - supernodal.row_pointers[s];
+        double own = 0.0;
+        for (int c = 0; c < width; ++c) {
+            own += static_cast<double>(height - c) * (height - c);
+        }
+        total += own;
+        path[s] += own;
+        critical = std::max(critical, path[s]);
+        if (supernodal.supernode_parent[s] != -1) {
+            path[supernodal.supernode_parent[s]] = std::max(path[supernodal.supernode_parent[s]], path[s]);
+        }
+    }
+    return critical > 0.0 ? total / critical : 1.0;
+}
+
+struct Problem {
+    std::string name;
+    SparseMatrix A; // 只有下三角
+    Eigen::VectorXd b;
+};
+
+void compare(const std::vector<Problem>& problems)
+{
+    std::cout << "\nOne thread: simplicial vs supernodal (analysis cached, numeric factorization + solve)\n\n  "
+              << std::left << std::setw(20) << "problem" << std::right << std::setw(10) << "nnz(L)" << std::setw(9)
+              << "flops" << std::setw(7) << "width" << std::setw(11) << "simpl. ms" << std::setw(10) << "super ms"
+              << std::setw(10) << "Eigen ms" << std::setw(10) << "rel.diff" << "  solveSparse" << std::endl;
+    ThreadPool serial(1);
+    for (const Problem& problem : problems) {
+        SparseSymbolic symbolic;
+        SupernodalSymbolic supernodal;
+        analyzeSparseCholesky(problem.A, symbolic);
+        analyzeSupernodal(problem.A, symbolic, supernodal);
+        SparseAnalysisCache cache;
+        SolveResult simplicial, super, dispatched;
+        solveWithSupernodalLLT(problem.A, problem.b, serial, &cache); // 填充缓存：两种分解都复用同一个分析
+        const double simplicial_ms = bestOfMs([&] { simplicial = solveWithSparseLLT(problem.A, problem.b, &cache); });
+        const double super_ms = bestOfMs([&] { super = solveWithSupernodalLLT(problem.A, problem.b, serial, &cache); });
+        EigenLLT factored;
+        factored.analyzePattern(problem.A);
+        const double eigen_ms = bestOfMs([&] {
+            factored.factorize(problem.A);
+            factored.solve(problem.b);
+        });
+        dispatched = solveSparse(problem.A, problem.b, serial);
+        const double width = static_cast<double>(problem.A.rows()) / supernodal.supernode_parent.size();
+        std::cout << "  " << std::left << std::setw(20) << problem.name << std::right << std::setw(10)
+                  << symbolic.column_pointers.back() << std::scientific << std::setprecision(1) << std::setw(9)
+                  << supernodal.flops << std::fixed << std::setprecision(2) << std::setw(7) << width
+                  << std::setprecision(1) << std::setw(11) << simplicial_ms << std::setw(10) << super_ms
+                  << std::setw(10) << eigen_ms << std::scientific << std::setprecision(1) << std::setw(10)
+                  << (super.solution - simplicial.solution).norm() / simplicial.solution.norm() << "  "
+                  << dispatched.method << std::defaultfloat << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int nodes = 40000;
+    if (argc == 3 && std::string(argv[1]) == "--nodes") {
+        nodes = std::stoi(argv[2]);
+    }
+    workload::WorkloadRng rng(27);
+    std::cout << "hardwareThreads() = " << hardwareThreads() << std::endl;
+
+    // 1. 回环越多，填充越多，超节点越宽，稠密内核的收益越大
+    std::vector<Problem> problems;
+    for (int loops : { nodes / 400, nodes / 40, nodes / 20 }) {
+        const workload::SparseLinearSystem system = workload::sparseSpdSystem(nodes, 3, loops, 1e-2, 26);
+        problems.push_back({ "scalar, " + std::to_string(loops) + " loops",
+            SparseMatrix(system.A.triangularView<Eigen::Lower>()), system.b });
+    }
+    for (int loops : { nodes / 3200, nodes / 800, nodes / 200 }) {
+        const workload::SparseLinearSystem graph = workload::sparseSpdSystem(nodes / 8, 2, loops, 1e-2, 27);
+        const SparseMatrix blocks = blockExpand(graph.A, rng);
+        Eigen::VectorXd b(blocks.rows());
+        for (Eigen::Index i = 0; i < b.size(); ++i) {
+            b(i) = rng.normal();
+        }
+        problems.push_back({ "6x6, " + std::to_string(loops) + " loops",
+            SparseMatrix(blocks.triangularView<Eigen::Lower>()), b });
+    }
+    compare(problems);
+
+    // 2. 线程数由每次调用的线程池决定；消去树上不相交的子树同时分解
+    std::cout << "\nSupernodal LLT, threads per call (available parallelism = total / critical-path flops)\n\n  "
+              << std::left << std::setw(20) << "problem" << std::right << std::setw(13) << "parallelism"
+              << std::setw(10) << "1 thr ms" << std::setw(10) << "2 thr ms" << std::setw(10) << "4 thr ms"
+              << std::endl;
+    for (const Problem& problem : problems) {
+        SparseAnalysisCache cache;
+        ThreadPool serial(1);
+        const SupernodalSymbolic* supernodal = cache.supernodalAnalysis(problem.A);
+        std::cout << "  " << std::left << std::setw(20) << problem.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << availableParallelism(*supernodal) << "x";
+        for (unsigned threads : { 1u, 2u, 4u }) {
+            ThreadPool pool(threads);
+            std::cout << std::setw(10)
+                      << bestOfMs([&] { solveWithSupernodalLLT(problem.A, problem.b, pool, &cache); });
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
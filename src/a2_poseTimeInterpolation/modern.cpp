@@ -186,6 +186,7 @@ TimedPose interpolateTimedPoseModern(const std::vector<TimedPose>& poses, double
     return {target_time, interp_pose};
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 int main() {
     // 创建一个位姿序列，使用初始化列表
     std::vector<TimedPose> poses = {
@@ -237,4 +238,5 @@ int main() {
     }
 
     return 0;
-} 
\ No newline at end of file
+} 
+#endif // PRESLAM_NO_MAIN
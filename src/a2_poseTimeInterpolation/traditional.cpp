@@ -129,6 +129,7 @@ TimedPose interpolateTimedPose(const std::vector<TimedPose>& poses, double targe
     return { target_time, interp_pose };
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 int main()
 {
     // 创建一个位姿序列
@@ -200,3 +201,4 @@ int main()
 
     return 0;
 }
+#endif // PRESLAM_NO_MAIN
@@ -275,6 +275,7 @@ bool isOriginalTimestamp(const Container& poses, double time) {
 }
 
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 int main() {
     // 创建位姿数据 (用于所有容器)
     std::vector<TimedPose> pose_data = {
@@ -334,3 +335,4 @@ int main() {
 
     return 0;
 }
+#endif // PRESLAM_NO_MAIN
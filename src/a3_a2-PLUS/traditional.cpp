@@ -190,6 +190,7 @@ void printInterpolatedPose(const TimedPose& interp_pose, double time, bool is_in
     std::cout << "----------------------------------------" << std::endl;
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 int main()
 {
     // 创建位姿数据 (用于所有容器)
@@ -268,3 +269,4 @@ int main()
 
     return 0;
 }
+#endif // PRESLAM_NO_MAIN
@@ -128,6 +128,7 @@ void parallel_for_each_async(Iterator begin, Iterator end, Function func)
     }
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 /**
  * @brief 主函数，演示并行for_each函数的不同实现
  */
@@ -179,4 +180,5 @@ int main()
     std::cout << "两种方法的结果" << (results_match ? "一致" : "不一致") << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
+#endif // PRESLAM_NO_MAIN
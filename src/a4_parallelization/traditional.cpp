@@ -69,6 +69,7 @@ void parallel_for_each(Iterator begin, Iterator end, Function func)
     }
 }
 
+#ifndef PRESLAM_NO_MAIN // 被差分测试等其他程序包含时不编译 main
 /**
  * @brief 主函数，演示parallel_for_each的用法
  */
@@ -96,4 +97,5 @@ int main()
     }
 
     return 0;
-}
\ No newline at end of file
+}
+#endif // PRESLAM_NO_MAIN
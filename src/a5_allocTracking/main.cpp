@@ -0,0 +1,200 @@
+/**
+ * @file main.cpp
+ * @brief 统计各实验热点路径上的堆分配次数、字节数与峰值。
+ *
+ * 运行方式：
+ *   ./a5_allocTracking-main            打印各作用域的分配报告
+ *   ./a5_allocTracking-main --strict   严格模式：声明为零分配的作用域一旦分配即 abort
+ *                                      （也可以设置环境变量 PRESLAM_ALLOC_STRICT=1）
+ * 若任一零分配作用域发生违规，程序以非零退出码结束。
+ */
+#define PRESLAM_ALLOC_TRACKING
+#include "alloc_tracker.hpp"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+#include "ekf.hpp"
+#include "pose.hpp"
+
+using namespace robotics;
+
+/**
+ * @brief 传统实现的欧氏距离 (与 a1 相同)
+ */
+double distance_traditional(const std::vector<double>& p1, const std::vector<double>& p2)
+{
+    double sum_sq_diff = 0.0;
+    for (size_t i = 0; i < p1.size(); ++i) {
+        double diff = p1[i] - p2[i];
+        sum_sq_diff += diff * diff;
+    }
+    return std::sqrt(sum_sq_diff);
+}
+
+/**
+ * @brief 现代实现的欧氏距离 (与 a1 相同，含临时 vector)
+ */
+double distance_modern(const std::vector<double>& p1, const std::vector<double>& p2)
+{
+    std::vector<double> diff_sq;
+    diff_sq.reserve(p1.size());
+    std::transform(p1.begin(), p1.end(), p2.begin(), std::back_inserter(diff_sq),
+        [](double val1, double val2) {
+            double diff = val1 - val2;
+            return diff * diff;
+        });
+    return std::sqrt(std::accumulate(diff_sq.begin(), diff_sq.end(), 0.0));
+}
+
+/**
+ * @brief 生成一个对称正定矩阵 A = M^T M + n I
+ */
+Eigen::MatrixXd makeSpdMatrix(int n)
+{
+    Eigen::MatrixXd m = Eigen::MatrixXd::Random(n, n);
+    return m.transpose() * m + n * Eigen::MatrixXd::Identity(n, n);
+}
+
+int main(int argc, char** argv)
+{
+    bool strict = argc > 1 && std::string(argv[1]) == "--strict";
+    if (strict) {
+        AllocTracker::setStrict(true);
+    }
+
+    // --- a0: 求解器。SolveResult 自身包含 std::string 和 VectorXd ---
+    const int n = 64;
+    Eigen::MatrixXd A = makeSpdMatrix(n);
+    Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+    double checksum = 0.0;
+    for (int rep = 0; rep < 10; ++rep) {
+        {
+            PRESLAM_ALLOC_SCOPE("a0 solveWithPartialPivLU");
+            checksum += solveWithPartialPivLU(A, b).error;
+        }
+        {
+            PRESLAM_ALLOC_SCOPE("a0 solveWithLLT");
+            checksum += solveWithLLT(A, b).error;
+        }
+        {
+            PRESLAM_ALLOC_SCOPE("a0 solveWithConjugateGradient");
+            checksum += solveWithConjugateGradient(A, b).error;
+        }
+        {
+            PRESLAM_ALLOC_SCOPE("a0 SolveResult construct");
+            SolveResult result;
+            result.method = "Column Pivoting Householder QR"; // 超过 SSO 长度
+            checksum += result.error;
+        }
+    }
+    {
+        // 预先分配好分解对象后，重复求解不应再分配
+        Eigen::LLT<Eigen::MatrixXd> llt(A);
+        Eigen::VectorXd x(n);
+        PRESLAM_NO_ALLOC_SCOPE("a0 LLT solveInPlace (preallocated)");
+        for (int rep = 0; rep < 10; ++rep) {
+            x = b;
+            llt.solveInPlace(x);
+            checksum += x(0);
+        }
+    }
+
+    // --- a1: 点距离 ---
+    std::vector<double> p1(128), p2(128);
+    std::iota(p1.begin(), p1.end(), 0.0);
+    std::iota(p2.begin(), p2.end(), 1.0);
+    {
+        PRESLAM_NO_ALLOC_SCOPE("a1 distance_traditional");
+        for (int rep = 0; rep < 1000; ++rep) {
+            checksum += distance_traditional(p1, p2);
+        }
+    }
+    {
+        PRESLAM_ALLOC_SCOPE("a1 distance_modern");
+        for (int rep = 0; rep < 1000; ++rep) {
+            checksum += distance_modern(p1, p2);
+        }
+    }
+
+    // --- a3: 不同容器构建 ---
+    const int pose_count = 1000;
+    {
+        PRESLAM_ALLOC_SCOPE("a3 std::vector<TimedPose> (reserve)");
+        std::vector<TimedPose> poses;
+        poses.reserve(pose_count);
+        for (int i = 0; i < pose_count; ++i) {
+            poses.push_back({ double(i), Pose {} });
+        }
+        checksum += poses.back().time_stamp;
+    }
+    {
+        PRESLAM_ALLOC_SCOPE("a3 std::list<TimedPose>");
+        std::list<TimedPose> poses;
+        for (int i = 0; i < pose_count; ++i) {
+            poses.push_back({ double(i), Pose {} });
+        }
+        checksum += poses.back().time_stamp;
+    }
+    {
+        PRESLAM_ALLOC_SCOPE("a3 std::map<double, TimedPose>");
+        std::map<double, TimedPose> poses;
+        for (int i = 0; i < pose_count; ++i) {
+            poses[double(i)] = { double(i), Pose {} };
+        }
+        checksum += poses.rbegin()->first;
+    }
+
+    // --- a22: 定长 EKF 的预测与更新，1 kHz 的热路径 ---
+    {
+        using Filter = ekf::ErrorStateFilter<15>;
+        Filter filter;
+        Filter::Covariance transition = Filter::Covariance::Identity();
+        transition.block<3, 3>(6, 3).diagonal().setConstant(1e-3);
+        const Filter::Covariance process = 1e-6 * Filter::Covariance::Identity();
+        Eigen::Matrix<double, 3, 15> jacobian = Eigen::Matrix<double, 3, 15>::Zero();
+        jacobian.block<3, 3>(0, 6).setIdentity();
+        const Eigen::Matrix3d noise = 0.09 * Eigen::Matrix3d::Identity();
+        std::vector<ekf::Measurement<3, 15>> batch(8, { Eigen::Vector3d(0.1, -0.2, 0.3), jacobian, noise });
+        PRESLAM_NO_ALLOC_SCOPE("a22 EKF predict + update (N = 15)");
+        for (int rep = 0; rep < 1000; ++rep) {
+            Filter::State correction = Filter::State::Zero();
+            filter.predict(transition, process);
+            filter.update<3>(Eigen::Vector3d(0.1, -0.2, 0.3), jacobian, noise, correction);
+            filter.update<3>(batch.data(), batch.size(), correction);
+            checksum += correction(6);
+        }
+    }
+
+    // 非严格模式下演示违规检测：distance_modern 的临时 vector 会被记录下来
+    std::size_t expected_violations = 0;
+    if (!strict) {
+        AllocScope probe("a1 distance_modern (declared alloc-free)", AllocPolicy::Forbid);
+        checksum += distance_modern(p1, p2);
+        expected_violations = probe.violations();
+    }
+
+    std::cout << "=== Allocation report ===" << std::endl;
+    AllocTracker::report(std::cout);
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+    std::size_t unexpected = AllocTracker::totalViolations() - expected_violations;
+    if (expected_violations > 0) {
+        std::cout << "Detected " << expected_violations
+                  << " allocation(s) in distance_modern declared allocation-free (expected demo)." << std::endl;
+    }
+    if (unexpected > 0) {
+        std::cerr << "Error: " << unexpected << " allocation(s) inside allocation-free scopes." << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file main.cpp
+ * @brief 演示确定性合成工作负载生成器：生产规模的轨迹、点云、描述子与线性方程组。
+ *
+ * 每类数据打印规模、简单统计和内容指纹；同一种子生成两次并比较指纹以验证可复现性。
+ */
+#include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "pose.hpp"
+#include "workload.hpp"
+#include "workload_systems.hpp"
+
+using namespace robotics;
+using namespace robotics::workload;
+
+/**
+ * @brief FNV-1a 64 位哈希，用作数据内容指纹
+ */
+std::uint64_t fingerprint(const void* data, std::size_t bytes, std::uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < bytes; ++i) {
+        hash = (hash ^ p[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+std::uint64_t fingerprint(const std::vector<T>& values)
+{
+    return fingerprint(values.data(), values.size() * sizeof(T));
+}
+
+std::uint64_t fingerprint(const Eigen::MatrixXd& m)
+{
+    return fingerprint(m.data(), static_cast<std::size_t>(m.size()) * sizeof(double));
+}
+
+/**
+ * @brief 计时执行 f 并返回毫秒数
+ */
+template <typename F>
+double timeMs(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void printRow(const std::string& name, const std::string& size, double ms, std::uint64_t fp, bool reproducible)
+{
+    std::cout << std::left << std::setw(30) << name << std::setw(26) << size << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1) << ms << " ms  "
+              << std::hex << std::setw(16) << std::setfill('0') << fp << std::dec << std::setfill(' ')
+              << (reproducible ? "  reproducible" : "  MISMATCH") << std::endl;
+}
+
+int main()
+{
+    bool all_reproducible = true;
+    std::cout << std::left << std::setw(30) << "Workload" << std::setw(26) << "Size" << std::right
+              << std::setw(13) << "Time" << "  Fingerprint" << std::endl;
+
+    // --- 轨迹 ---
+    TrajectoryOptions smooth_options;
+    smooth_options.count = 200000;
+    smooth_options.rate_hz = 200.0;
+    smooth_options.timestamp_jitter = 2e-4;
+    std::vector<TimedPose> smooth;
+    double ms = timeMs([&] { smooth = smoothTrajectory(smooth_options); });
+    bool same = fingerprint(smooth) == fingerprint(smoothTrajectory(smooth_options));
+    all_reproducible &= same;
+    printRow("smooth trajectory @200Hz", std::to_string(smooth.size()) + " poses", ms, fingerprint(smooth), same);
+
+    JerkyTrajectoryOptions jerky_options;
+    jerky_options.count = 1000000;
+    jerky_options.rate_hz = 1000.0;
+    jerky_options.timestamp_jitter = 5e-5;
+    jerky_options.gap_probability = 0.001;
+    std::vector<TimedPose> jerky;
+    ms = timeMs([&] { jerky = jerkyTrajectory(jerky_options); });
+    same = fingerprint(jerky) == fingerprint(jerkyTrajectory(jerky_options));
+    all_reproducible &= same;
+    printRow("jerky trajectory @1kHz", std::to_string(jerky.size()) + " poses", ms, fingerprint(jerky), same);
+
+    // --- 点云 ---
+    LidarOptions lidar_options;
+    std::vector<Vector3> cloud;
+    ms = timeMs([&] { cloud = lidarScan(lidar_options); });
+    same = fingerprint(cloud) == fingerprint(lidarScan(lidar_options));
+    all_reproducible &= same;
+    printRow("LiDAR scan 64x1024", std::to_string(cloud.size()) + " points", ms, fingerprint(cloud), same);
+
+    // --- 描述子 ---
+    DescriptorOptions descriptor_options;
+    DescriptorSet descriptors;
+    ms = timeMs([&] { descriptors = descriptorSet(descriptor_options); });
+    same = fingerprint(descriptors.data) == fingerprint(descriptorSet(descriptor_options).data);
+    all_reproducible &= same;
+    printRow("descriptors (clustered)", std::to_string(descriptors.count) + " x " + std::to_string(descriptors.dim),
+        ms, fingerprint(descriptors.data), same);
+
+    // --- 线性方程组 ---
+    DenseLinearSystem spd;
+    ms = timeMs([&] { spd = spdSystem(500, 1e6, 7); });
+    same = fingerprint(spd.A) == fingerprint(spdSystem(500, 1e6, 7).A);
+    all_reproducible &= same;
+    printRow("SPD system (cond 1e6)", "500 x 500", ms, fingerprint(spd.A), same);
+
+    DenseLinearSystem ill;
+    ms = timeMs([&] { ill = illConditionedSystem(200, 1e10, 7); });
+    same = fingerprint(ill.A) == fingerprint(illConditionedSystem(200, 1e10, 7).A);
+    all_reproducible &= same;
+    printRow("ill-conditioned (cond 1e10)", "200 x 200", ms, fingerprint(ill.A), same);
+
+    SparseLinearSystem sparse;
+    ms = timeMs([&] { sparse = sparseSpdSystem(100000, 3, 2000, 1e-2, 7); });
+    same = fingerprint(sparse.A.valuePtr(), sparse.A.nonZeros() * sizeof(double))
+        == [] {
+               SparseLinearSystem again = sparseSpdSystem(100000, 3, 2000, 1e-2, 7);
+               return fingerprint(again.A.valuePtr(), again.A.nonZeros() * sizeof(double));
+           }();
+    all_reproducible &= same;
+    printRow("sparse SPD (pose-graph like)", "100000, nnz " + std::to_string(sparse.A.nonZeros()), ms,
+        fingerprint(sparse.A.valuePtr(), sparse.A.nonZeros() * sizeof(double)), same);
+
+    // --- 数据特征检查 ---
+    std::cout << "\n=== Sanity checks ===" << std::endl;
+    double duration = jerky.back().time_stamp - jerky.front().time_stamp;
+    std::cout << "Jerky trajectory duration: " << duration << " s ("
+              << jerky.size() / duration << " Hz effective)" << std::endl;
+
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd_spd(spd.A);
+    std::cout << "SPD condition number: " << std::scientific
+              << svd_spd.singularValues()(0) / svd_spd.singularValues().tail(1)(0) << std::endl;
+    Eigen::VectorXd x_spd = spd.A.llt().solve(spd.b);
+    std::cout << "SPD LLT relative error: " << (x_spd - spd.x_true).norm() / spd.x_true.norm() << std::endl;
+
+    Eigen::VectorXd x_ill = ill.A.partialPivLu().solve(ill.b);
+    std::cout << "Ill-conditioned LU relative error: " << (x_ill - ill.x_true).norm() / ill.x_true.norm() << std::endl;
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(sparse.A);
+    Eigen::VectorXd x_sparse = ldlt.solve(sparse.b);
+    std::cout << "Sparse LDLT relative error: " << (x_sparse - sparse.x_true).norm() / sparse.x_true.norm()
+              << std::defaultfloat << std::endl;
+
+    if (!all_reproducible) {
+        std::cerr << "Error: generator output is not reproducible." << std::endl;
+        return 1;
+    }
+    return 0;
+}
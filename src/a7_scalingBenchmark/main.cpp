@@ -0,0 +1,329 @@
+/**
+ * @file main.cpp
+ * @brief 强扩展与弱扩展基准：在 1..N 个线程上运行项目中的并行路径，输出可跨机器比较的表格。
+ *
+ * 运行方式：
+ *   ./a7_scalingBenchmark-main [--max-threads N] [--quick] [--csv]
+ *
+ * 每个内核在每个线程数下取 3 次运行中的最短时间，并计算：
+ *   - 加速比 T1 / Tp 与效率（强扩展 T1/(p*Tp)，弱扩展 T1/Tp）
+ *   - 实际内存带宽，与同一线程数下 STREAM triad 的带宽比较
+ * 效率低于 80% 时给出瓶颈判断：带宽达到 triad 的 60% 以上视为内存带宽受限，
+ * 否则视为同步/调度开销受限（线程数超过硬件线程数时标记为超额订阅）。
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "interpolation.hpp"
+#include "parallel.hpp"
+#include "pose.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+using Vector6d = Eigen::Matrix<double, 6, 1>;
+
+/**
+ * @brief 一次测量的结果
+ */
+struct Measurement {
+    std::string kernel;
+    std::string mode; // "strong" 或 "weak"
+    unsigned threads { 1 };
+    std::size_t size { 0 };
+    double ms { 0.0 };
+    double bytes { 0.0 }; // 估计的内存流量
+    double speedup { 1.0 };
+    double efficiency { 1.0 };
+    double stream_gbs { 0.0 };
+    std::string verdict;
+};
+
+/**
+ * @brief 一个可扩展的基准内核
+ *
+ * setup(size) 准备数据，run(pool, threads) 执行一次，bytes_per_item 用于估计内存流量。
+ */
+struct Kernel {
+    std::string name;
+    std::size_t strong_size;
+    std::size_t weak_size_per_thread;
+    double bytes_per_item;
+    std::function<void(std::size_t)> setup;
+    std::function<void(ThreadPool&, unsigned)> run;
+};
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 3)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * @brief STREAM triad a = b + s * c，返回 GB/s
+ */
+double streamTriadGBs(ThreadPool& pool, std::size_t n)
+{
+    std::vector<double> a(n, 0.0), b(n, 1.0), c(n, 2.0);
+    double ms = bestOfMs([&] {
+        pool.parallelFor(0, n, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                a[i] = b[i] + 3.0 * c[i];
+            }
+        });
+    });
+    return 3.0 * sizeof(double) * n / (ms * 1e6);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned max_threads = hardwareThreads();
+    bool quick = false;
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max-threads" && i + 1 < argc) {
+            max_threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--quick") {
+            quick = true;
+        } else if (arg == "--csv") {
+            csv = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--max-threads N] [--quick] [--csv]" << std::endl;
+            return 1;
+        }
+    }
+    std::size_t scale = quick ? 16 : 1;
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned p = 1; p < max_threads; p *= 2) {
+        thread_counts.push_back(p);
+    }
+    thread_counts.push_back(max_threads);
+
+    // --- 共享数据 ---
+    std::vector<double> values;
+    std::vector<TimedPose> trajectory;
+    std::vector<double> query_times;
+    std::vector<TimedPose> interpolated;
+    std::vector<Matrix6d> systems;
+    std::vector<Vector6d> rhs, solutions;
+    workload::DescriptorSet database, queries;
+    std::vector<double> distances;
+
+    std::vector<Kernel> kernels;
+
+    auto setup_values = [&](std::size_t n) { values.assign(n, 1.0); };
+    auto light_op = [](double& x) { x = x * 1.0000001 + 0.5; };
+
+    kernels.push_back({ "for_each thread (light)", (1u << 23) / scale, (1u << 21) / scale, 16.0, setup_values,
+        [&](ThreadPool&, unsigned p) { parallel_for_each(values.begin(), values.end(), light_op, p); } });
+    kernels.push_back({ "for_each async (light)", (1u << 23) / scale, (1u << 21) / scale, 16.0, setup_values,
+        [&](ThreadPool&, unsigned p) { parallel_for_each_async(values.begin(), values.end(), light_op, p); } });
+    kernels.push_back({ "for_each pool (light)", (1u << 23) / scale, (1u << 21) / scale, 16.0, setup_values,
+        [&](ThreadPool& pool, unsigned) {
+            pool.parallelFor(0, values.size(), [&](std::size_t lo, std::size_t hi) {
+                for (std::size_t i = lo; i < hi; ++i) {
+                    light_op(values[i]);
+                }
+            });
+        } });
+    kernels.push_back({ "for_each pool (compute)", (1u << 20) / scale, (1u << 18) / scale, 16.0, setup_values,
+        [&](ThreadPool& pool, unsigned) {
+            pool.parallelFor(0, values.size(), [&](std::size_t lo, std::size_t hi) {
+                for (std::size_t i = lo; i < hi; ++i) {
+                    double x = values[i];
+                    for (int k = 0; k < 32; ++k) {
+                        x = std::sin(x) + 1.0;
+                    }
+                    values[i] = x;
+                }
+            });
+        } });
+
+    kernels.push_back({ "batched interpolation", (1u << 22) / scale, (1u << 20) / scale, 136.0,
+        [&](std::size_t n) {
+            workload::TrajectoryOptions options;
+            options.count = std::max<std::size_t>(n / 4, 2);
+            options.rate_hz = 200.0;
+            trajectory = workload::smoothTrajectory(options);
+            double t0 = trajectory.front().time_stamp, t1 = trajectory.back().time_stamp;
+            query_times.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                query_times[i] = t0 + (t1 - t0) * static_cast<double>(i) / static_cast<double>(n);
+            }
+            interpolated.resize(n);
+        },
+        [&](ThreadPool& pool, unsigned) {
+            interpolateTimedPoses(trajectory, query_times.data(), query_times.size(), interpolated.data(), pool);
+        } });
+
+    kernels.push_back({ "batched 6x6 LLT solves", (1u << 18) / scale, (1u << 16) / scale, 6 * 6 * 8 + 2 * 6 * 8,
+        [&](std::size_t n) {
+            workload::WorkloadRng rng(7);
+            systems.resize(n);
+            rhs.resize(n);
+            solutions.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                Matrix6d m;
+                for (int k = 0; k < 36; ++k) {
+                    m.data()[k] = rng.normal();
+                }
+                systems[i] = m.transpose() * m + 6.0 * Matrix6d::Identity();
+                for (int k = 0; k < 6; ++k) {
+                    rhs[i](k) = rng.normal();
+                }
+            }
+        },
+        [&](ThreadPool& pool, unsigned) {
+            pool.parallelFor(0, systems.size(), [&](std::size_t lo, std::size_t hi) {
+                for (std::size_t i = lo; i < hi; ++i) {
+                    solutions[i] = systems[i].llt().solve(rhs[i]);
+                }
+            });
+        } });
+
+    const std::size_t database_size = 2048 / (quick ? 4 : 1);
+    kernels.push_back({ "distance matrix (128-d)", 2048 / scale * 4, 256 / scale * 4, 0.0,
+        [&](std::size_t n) {
+            workload::DescriptorOptions options;
+            options.count = database_size;
+            database = workload::descriptorSet(options);
+            options.count = n;
+            options.seed = 43;
+            queries = workload::descriptorSet(options);
+            distances.resize(n * database_size);
+        },
+        [&](ThreadPool& pool, unsigned) {
+            const std::size_t dim = database.dim;
+            pool.parallelFor(0, queries.count, [&](std::size_t lo, std::size_t hi) {
+                for (std::size_t q = lo; q < hi; ++q) {
+                    const double* a = queries.row(q);
+                    for (std::size_t j = 0; j < database.count; ++j) {
+                        const double* b = database.row(j);
+                        double sum = 0.0;
+                        for (std::size_t d = 0; d < dim; ++d) {
+                            double diff = a[d] - b[d];
+                            sum += diff * diff;
+                        }
+                        distances[q * database.count + j] = std::sqrt(sum);
+                    }
+                }
+            });
+        } });
+
+    // --- 测量 ---
+    std::map<unsigned, double> stream;
+    std::vector<Measurement> results;
+    unsigned hardware = hardwareThreads();
+
+    for (unsigned p : thread_counts) {
+        ThreadPool pool(p);
+        stream[p] = streamTriadGBs(pool, (1u << 23) / scale);
+    }
+
+    for (const std::string mode : { "strong", "weak" }) {
+        for (Kernel& kernel : kernels) {
+            double baseline_ms = 0.0;
+            for (unsigned p : thread_counts) {
+                std::size_t size = mode == "strong" ? kernel.strong_size : kernel.weak_size_per_thread * p;
+                kernel.setup(size);
+                ThreadPool pool(p);
+                kernel.run(pool, p); // 预热（页面分配、线程启动）
+
+                Measurement m;
+                m.kernel = kernel.name;
+                m.mode = mode;
+                m.threads = p;
+                m.size = size;
+                m.ms = bestOfMs([&] { kernel.run(pool, p); });
+                m.bytes = kernel.bytes_per_item * static_cast<double>(size);
+                m.stream_gbs = stream[p];
+                if (p == thread_counts.front()) {
+                    baseline_ms = m.ms;
+                }
+                double ratio = baseline_ms / m.ms;
+                m.speedup = mode == "strong" ? ratio : ratio * p;
+                m.efficiency = mode == "strong" ? ratio / p : ratio;
+
+                double gbs = m.bytes / (m.ms * 1e6);
+                if (p == 1) {
+                    m.verdict = "baseline";
+                } else if (m.efficiency >= 0.8) {
+                    m.verdict = "scales";
+                } else if (p > hardware) {
+                    m.verdict = "oversubscribed";
+                } else if (m.bytes > 0.0 && gbs >= 0.6 * m.stream_gbs) {
+                    m.verdict = "memory-bandwidth bound";
+                } else {
+                    m.verdict = "sync/overhead bound";
+                }
+                results.push_back(m);
+            }
+        }
+    }
+
+    // --- 输出 ---
+    if (csv) {
+        std::cout << "kernel,mode,threads,size,ms,speedup,efficiency,gbs,stream_gbs,verdict" << std::endl;
+        for (const Measurement& m : results) {
+            std::cout << m.kernel << ',' << m.mode << ',' << m.threads << ',' << m.size << ',' << m.ms << ','
+                      << m.speedup << ',' << m.efficiency << ',' << m.bytes / (m.ms * 1e6) << ',' << m.stream_gbs
+                      << ',' << m.verdict << std::endl;
+        }
+        return 0;
+    }
+
+    std::cout << "Hardware threads: " << hardware << ", tested up to " << max_threads << std::endl;
+    std::cout << "STREAM triad (GB/s):";
+    for (unsigned p : thread_counts) {
+        std::cout << "  " << p << "T=" << std::fixed << std::setprecision(1) << stream[p];
+    }
+    std::cout << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(26) << "Kernel" << std::setw(8) << "Mode" << std::right << std::setw(8)
+              << "Threads" << std::setw(10) << "Size" << std::setw(11) << "Time(ms)" << std::setw(9) << "Speedup"
+              << std::setw(7) << "Eff." << std::setw(9) << "GB/s" << "  Verdict" << std::endl;
+    std::cout << std::string(100, '-') << std::endl;
+    for (const Measurement& m : results) {
+        std::cout << std::left << std::setw(26) << m.kernel << std::setw(8) << m.mode << std::right << std::setw(8)
+                  << m.threads << std::setw(10) << m.size << std::setw(11) << std::setprecision(2) << m.ms
+                  << std::setw(9) << m.speedup << std::setw(6) << std::setprecision(0) << m.efficiency * 100 << "%"
+                  << std::setw(9) << std::setprecision(1) << m.bytes / (m.ms * 1e6) << "  " << m.verdict << std::endl;
+    }
+
+    // 每个内核第一次效率跌破 80% 的线程数
+    std::cout << std::endl
+              << "Scaling breakdown (first thread count below 80% efficiency):" << std::endl;
+    for (const std::string mode : { "strong", "weak" }) {
+        for (const Kernel& kernel : kernels) {
+            auto it = std::find_if(results.begin(), results.end(), [&](const Measurement& m) {
+                return m.kernel == kernel.name && m.mode == mode && m.efficiency < 0.8;
+            });
+            std::cout << "  " << std::left << std::setw(26) << kernel.name << std::setw(8) << mode;
+            if (it == results.end()) {
+                std::cout << "scales to " << max_threads << " threads" << std::endl;
+            } else {
+                std::cout << "breaks at " << it->threads << " threads (" << it->verdict << ")" << std::endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,4032 @@
+/**
+ * @file main.cpp
+ * @brief 随机差分测试：在生成的输入上比较各实验的 traditional / modern 实现以及库中的优化版本。
+ *
+ * 运行方式：
+ *   ./a8_differentialTesting-main [--iterations N] [--max-size N] [--seed S] [--only NAME] [--self-test]
+ *
+ * 实验文件以 PRESLAM_NO_MAIN 包含进各自的命名空间，因此比较的是原始代码本身而不是副本。
+ * 任一性质失败时打印收缩后的最小反例并以非零退出码结束。
+ * --self-test 额外运行一个注入了错误的实现，确认框架能发现并收缩它。
+ */
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "pose.hpp"
+
+// 实验文件自身的 #include 已在上面展开过，这里只会引入它们的函数定义
+#define PRESLAM_NO_MAIN
+namespace a1t {
+#include "../a1_pointDistance/traditional.cpp"
+}
+namespace a1m {
+#include "../a1_pointDistance/modern.cpp"
+}
+namespace a2t {
+#include "../a2_poseTimeInterpolation/traditional.cpp"
+}
+namespace a2m {
+#include "../a2_poseTimeInterpolation/modern.cpp"
+}
+namespace a3t {
+#include "../a3_a2-PLUS/traditional.cpp"
+}
+namespace a3m {
+#include "../a3_a2-PLUS/modern.cpp"
+}
+namespace a4t {
+#include "../a4_parallelization/traditional.cpp"
+}
+namespace a4m {
+#include "../a4_parallelization/modern.cpp"
+}
+
+#include "../a0_solveMatrix/mid-solvers.cpp"
+#include "../a0_solveMatrix/mid-solvers.hpp"
+
+// 库头文件放在实验文件之后：robotics::interpolatePose 与 a2 的同名函数签名相同，
+// 先声明会让 a2 中的非限定调用经 ADL 产生二义性
+#include "alignment.hpp"
+#include "correction.hpp"
+#include "dual_quaternion.hpp"
+#include "ekf.hpp"
+#include "imu_preintegration.hpp"
+#include "interpolation.hpp"
+#include "interpolation_cache.hpp"
+#include "kernels.hpp"
+#include "mid-differential.hpp"
+#include "parallel.hpp"
+#include "pose_covariance.hpp"
+#include "pose_graph.hpp"
+#include "rotation_kernels.hpp"
+#include "time_bucket_index.hpp"
+#include "trajectory_store.hpp"
+#include "workload.hpp"
+
+using namespace differential;
+using robotics::Pose;
+using robotics::Quaternion;
+using robotics::TimedPose;
+using robotics::Vector3;
+
+namespace {
+
+Quaternion randomQuaternion(WorkloadRng& rng)
+{
+    Quaternion q { rng.normal(), rng.normal(), rng.normal(), rng.normal() };
+    q.normalize();
+    return q;
+}
+
+std::string formatVector(const std::vector<double>& v)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "{ ";
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        out << (i ? ", " : "") << v[i];
+    }
+    out << " }";
+    return out.str();
+}
+
+// ---------------------------------------------------------------------------
+// a1：欧氏距离
+// ---------------------------------------------------------------------------
+
+struct DistanceInput {
+    std::vector<double> p1;
+    std::vector<double> p2;
+};
+
+DistanceInput generateDistance(WorkloadRng& rng, int size)
+{
+    DistanceInput input;
+    std::size_t dim = rng.index(static_cast<std::size_t>(size) + 1);
+    double scale = std::pow(10.0, rng.uniform(-3.0, 3.0));
+    if (rng.uniform() < 0.02) {
+        scale = 1e160; // 平方和溢出为 inf，两种实现应当一致
+    }
+    for (std::size_t i = 0; i < dim; ++i) {
+        input.p1.push_back(scale * rng.normal());
+        input.p2.push_back(scale * rng.normal());
+    }
+    if (rng.uniform() < 0.05) {
+        input.p2.push_back(rng.normal()); // 维数不一致：两种实现都应抛出 invalid_argument
+    }
+    return input;
+}
+
+std::vector<DistanceInput> shrinkDistance(const DistanceInput& input)
+{
+    std::vector<DistanceInput> candidates;
+    for (std::size_t i = 0; i < std::max(input.p1.size(), input.p2.size()); ++i) {
+        DistanceInput smaller = input;
+        if (i < smaller.p1.size()) {
+            smaller.p1.erase(smaller.p1.begin() + i);
+        }
+        if (i < smaller.p2.size()) {
+            smaller.p2.erase(smaller.p2.begin() + i);
+        }
+        candidates.push_back(std::move(smaller));
+    }
+    for (std::size_t i = 0; i < input.p1.size(); ++i) {
+        for (double replacement : { 0.0, std::round(input.p1[i]) }) {
+            if (input.p1[i] != replacement) {
+                DistanceInput simpler = input;
+                simpler.p1[i] = replacement;
+                candidates.push_back(std::move(simpler));
+            }
+        }
+    }
+    for (std::size_t i = 0; i < input.p2.size(); ++i) {
+        for (double replacement : { 0.0, std::round(input.p2[i]) }) {
+            if (input.p2[i] != replacement) {
+                DistanceInput simpler = input;
+                simpler.p2[i] = replacement;
+                candidates.push_back(std::move(simpler));
+            }
+        }
+    }
+    return candidates;
+}
+
+std::string describeDistance(const DistanceInput& input)
+{
+    return "    p1 = " + formatVector(input.p1) + "\n    p2 = " + formatVector(input.p2);
+}
+
+using DistanceFunction = std::function<double(const std::vector<double>&, const std::vector<double>&)>;
+
+/**
+ * @brief 以 a1 traditional 为参考比较一组距离实现
+ */
+std::string checkDistances(const DistanceInput& input,
+    const std::vector<std::pair<std::string, DistanceFunction>>& impls)
+{
+    auto reference = capture([&] { return a1t::distance_traditional(input.p1, input.p2); });
+    auto compare = [](double a, double b) {
+        std::ostringstream out;
+        out.precision(17);
+        if (!close(a, b, 1e-12)) {
+            out << a << " vs " << b;
+        }
+        return out.str();
+    };
+    for (const auto& [name, impl] : impls) {
+        auto outcome = capture([&] { return impl(input.p1, input.p2); });
+        std::string diff = compareOutcome("a1 traditional", reference, name, outcome, compare);
+        if (!diff.empty()) {
+            return diff;
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief a1 的两个实现，以及 distance 内核在当前 CPU 上可运行的每个实现
+ */
+std::vector<std::pair<std::string, DistanceFunction>> distanceImplementations()
+{
+    std::vector<std::pair<std::string, DistanceFunction>> impls = {
+        { "a1 modern", a1m::distance_modern },
+        { "kernels::euclideanDistance",
+            [](const auto& p1, const auto& p2) { return robotics::kernels::euclideanDistance(p1, p2); } },
+    };
+    for (const auto& variant : robotics::kernels::distance_kernel.supportedVariants()) {
+        impls.emplace_back(std::string("distance kernel ") + robotics::isaName(variant.isa),
+            [function = variant.function](const std::vector<double>& p1, const std::vector<double>& p2) {
+                if (p1.size() != p2.size()) {
+                    throw std::invalid_argument("Points must have the same dimension.");
+                }
+                return function(p1.data(), p2.data(), p1.size());
+            });
+    }
+    return impls;
+}
+
+// ---------------------------------------------------------------------------
+// 点变换内核
+// ---------------------------------------------------------------------------
+
+struct TransformInput {
+    Pose pose;
+    std::vector<Vector3> points;
+};
+
+TransformInput generateTransform(WorkloadRng& rng, int size)
+{
+    TransformInput input;
+    input.pose.position = rng.normalVector(100.0);
+    input.pose.orientation = randomQuaternion(rng);
+    double scale = std::pow(10.0, rng.uniform(-2.0, 3.0));
+    input.points.resize(rng.index(static_cast<std::size_t>(size) * 4 + 1));
+    for (Vector3& p : input.points) {
+        p = rng.normalVector(scale);
+    }
+    return input;
+}
+
+std::vector<TransformInput> shrinkTransform(const TransformInput& input)
+{
+    std::vector<TransformInput> candidates;
+    for (std::size_t i = 0; i < input.points.size(); ++i) {
+        TransformInput smaller = input;
+        smaller.points.erase(smaller.points.begin() + i);
+        candidates.push_back(std::move(smaller));
+    }
+    TransformInput no_translation = input;
+    no_translation.pose.position = Vector3 {};
+    candidates.push_back(std::move(no_translation));
+    if (input.pose.orientation.w != 1.0) {
+        TransformInput no_rotation = input;
+        no_rotation.pose.orientation = Quaternion {};
+        candidates.push_back(std::move(no_rotation));
+    }
+    return candidates;
+}
+
+std::string describeTransform(const TransformInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    pose = " << formatPose(input.pose) << "\n    points = {";
+    for (const Vector3& p : input.points) {
+        out << " { " << p.x << ", " << p.y << ", " << p.z << " }";
+    }
+    out << " }";
+    return out.str();
+}
+
+std::string checkTransform(const TransformInput& input)
+{
+    std::vector<Vector3> expected;
+    for (const Vector3& p : input.points) {
+        expected.push_back(input.pose.orientation.rotate(p) + input.pose.position);
+    }
+    for (const auto& variant : robotics::kernels::transform_points_kernel.supportedVariants()) {
+        std::vector<Vector3> out(input.points.size());
+        variant.function(input.pose, input.points.data(), out.data(), out.size());
+        std::vector<Vector3> in_place = input.points; // 就地变换必须得到同样的结果
+        variant.function(input.pose, in_place.data(), in_place.data(), in_place.size());
+        for (std::size_t k = 0; k < out.size(); ++k) {
+            double tol = 1e-12 * std::max(1.0, expected[k].norm());
+            if (!((out[k] - expected[k]).norm() <= tol) || !((in_place[k] - out[k]).norm() == 0.0)) {
+                std::ostringstream out_message;
+                out_message.precision(17);
+                out_message << "Quaternion::rotate vs transform_points " << robotics::isaName(variant.isa)
+                            << " at point " << k << ": [" << expected[k].x << ", " << expected[k].y << ", "
+                            << expected[k].z << "] vs [" << out[k].x << ", " << out[k].y << ", " << out[k].z
+                            << "] (in place [" << in_place[k].x << ", " << in_place[k].y << ", " << in_place[k].z
+                            << "])";
+                return out_message.str();
+            }
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a2/a3：两个位姿之间的插值
+// ---------------------------------------------------------------------------
+
+struct PosePairInput {
+    Pose a;
+    Pose b;
+    double t { 0.0 };
+};
+
+PosePairInput generatePosePair(WorkloadRng& rng, int size)
+{
+    PosePairInput input;
+    double extent = static_cast<double>(size);
+    input.a.position = rng.normalVector(extent);
+    input.b.position = rng.normalVector(extent);
+    input.a.orientation = randomQuaternion(rng);
+    switch (rng.index(4)) {
+    case 0:
+        input.b.orientation = randomQuaternion(rng);
+        break;
+    case 1: // 夹角很小：走归一化线性插值分支
+        input.b.orientation = input.a.orientation * Quaternion::fromRotationVector(rng.normalVector(1e-3));
+        input.b.orientation.normalize();
+        break;
+    case 2: { // 接近对径：检验最短路径处理
+        Quaternion q = input.a.orientation * Quaternion::fromRotationVector(rng.normalVector(0.3));
+        input.b.orientation = { -q.w, -q.x, -q.y, -q.z };
+        input.b.orientation.normalize();
+        break;
+    }
+    default:
+        input.b.orientation = input.a.orientation;
+        break;
+    }
+    double pick = rng.uniform();
+    input.t = pick < 0.1 ? 0.0 : pick < 0.2 ? 1.0 : rng.uniform(-0.25, 1.25); // 含截断区间之外的值
+    return input;
+}
+
+std::vector<PosePairInput> shrinkPosePair(const PosePairInput& input)
+{
+    std::vector<PosePairInput> candidates;
+    for (double t : { 0.0, 0.5, 1.0, std::round(input.t * 8.0) / 8.0 }) {
+        if (t != input.t) {
+            PosePairInput simpler = input;
+            simpler.t = t;
+            candidates.push_back(simpler);
+        }
+    }
+    PosePairInput zero_positions = input;
+    zero_positions.a.position = zero_positions.b.position = Vector3 {};
+    candidates.push_back(zero_positions);
+    PosePairInput identity_start = input;
+    identity_start.a.orientation = Quaternion {};
+    candidates.push_back(identity_start);
+    PosePairInput same_orientation = input;
+    same_orientation.b.orientation = same_orientation.a.orientation;
+    candidates.push_back(same_orientation);
+    return candidates;
+}
+
+std::string describePosePair(const PosePairInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    pose1 = " << formatPose(input.a) << "\n    pose2 = " << formatPose(input.b) << "\n    t = " << input.t;
+    return out.str();
+}
+
+std::string checkPosePair(const PosePairInput& input)
+{
+    using PoseFunction = Pose (*)(const Pose&, const Pose&, double);
+    const std::vector<std::pair<std::string, PoseFunction>> impls = {
+        { "a2 modern", a2m::interpolatePoseModern },
+        { "a3 traditional", a3t::interpolatePose },
+        { "a3 modern", a3m::interpolatePoseModern },
+        { "robotics::interpolatePose", robotics::interpolatePose },
+    };
+    Pose reference = a2t::interpolatePose(input.a, input.b, input.t);
+    for (const auto& [name, impl] : impls) {
+        std::string diff = comparePose(reference, impl(input.a, input.b, input.t), 1e-12);
+        if (!diff.empty()) {
+            return "a2 traditional vs " + name + ": " + diff;
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a2/a3：按时间插值（不同容器、单次与批量）
+// ---------------------------------------------------------------------------
+
+struct TimedInput {
+    std::vector<TimedPose> poses;
+    std::vector<double> queries;
+};
+
+TimedInput generateTimed(WorkloadRng& rng, int size)
+{
+    TimedInput input;
+    if (rng.uniform() >= 0.03) { // 偶尔生成空序列
+        robotics::workload::JerkyTrajectoryOptions options;
+        options.count = 1 + rng.index(static_cast<std::size_t>(size));
+        options.rate_hz = rng.uniform(10.0, 1000.0);
+        options.start_time = rng.uniform(-100.0, 1e6);
+        options.timestamp_jitter = rng.uniform() < 0.5 ? 0.0 : 0.2 / options.rate_hz;
+        options.gap_probability = rng.uniform() < 0.5 ? 0.0 : 0.2;
+        options.seed = rng.next();
+        input.poses = rng.uniform() < 0.5 ? robotics::workload::smoothTrajectory(options)
+                                          : robotics::workload::jerkyTrajectory(options);
+    }
+    std::size_t query_count = 1 + rng.index(static_cast<std::size_t>(size));
+    double t0 = input.poses.empty() ? 0.0 : input.poses.front().time_stamp;
+    double t1 = input.poses.empty() ? 1.0 : input.poses.back().time_stamp;
+    for (std::size_t k = 0; k < query_count; ++k) {
+        double pick = rng.uniform();
+        if (pick < 0.2 && !input.poses.empty()) {
+            input.queries.push_back(input.poses[rng.index(input.poses.size())].time_stamp); // 恰好是原始时间戳
+        } else if (pick < 0.25) {
+            input.queries.push_back(rng.uniform() < 0.5 ? t0 : t1);
+        } else if (pick < 0.3) {
+            input.queries.push_back(rng.uniform() < 0.5 ? std::nextafter(t0, -1e300) : std::nextafter(t1, 1e300));
+        } else {
+            input.queries.push_back(rng.uniform(t0, t1));
+        }
+    }
+    return input;
+}
+
+std::vector<TimedInput> shrinkTimed(const TimedInput& input)
+{
+    std::vector<TimedInput> candidates;
+    if (input.queries.size() > 1) {
+        for (std::size_t k = 0; k < input.queries.size(); ++k) {
+            TimedInput smaller = input;
+            smaller.queries = { input.queries[k] };
+            candidates.push_back(std::move(smaller));
+        }
+    }
+    for (std::size_t i = 0; i < input.poses.size(); ++i) {
+        TimedInput smaller = input;
+        smaller.poses.erase(smaller.poses.begin() + i);
+        candidates.push_back(std::move(smaller));
+    }
+    for (std::size_t i = 0; i < input.poses.size(); ++i) {
+        if (input.poses[i].pose.orientation.w != 1.0) {
+            TimedInput simpler = input;
+            simpler.poses[i].pose.orientation = Quaternion {};
+            candidates.push_back(std::move(simpler));
+        }
+    }
+    return candidates;
+}
+
+std::string describeTimed(const TimedInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    poses = {\n";
+    for (const TimedPose& p : input.poses) {
+        out << "        { " << p.time_stamp << ", " << formatPose(p.pose) << " },\n";
+    }
+    out << "    };\n    queries = " << formatVector(input.queries);
+    return out.str();
+}
+
+std::string compareTimedPose(const TimedPose& a, const TimedPose& b)
+{
+    if (a.time_stamp != b.time_stamp) {
+        std::ostringstream out;
+        out.precision(17);
+        out << "time_stamp " << a.time_stamp << " vs " << b.time_stamp;
+        return out.str();
+    }
+    return comparePose(a.pose, b.pose, 1e-12);
+}
+
+std::string checkTimed(const TimedInput& input)
+{
+    std::list<TimedPose> as_list(input.poses.begin(), input.poses.end());
+    std::map<double, TimedPose> as_map;
+    for (const TimedPose& p : input.poses) {
+        as_map.emplace(p.time_stamp, p);
+    }
+
+    using Query = std::function<TimedPose(double)>;
+    const std::vector<std::pair<std::string, Query>> impls = {
+        { "a2 modern", [&](double t) { return a2m::interpolateTimedPoseModern(input.poses, t); } },
+        { "a3 traditional<vector>", [&](double t) { return a3t::interpolateTimedPose(input.poses, t); } },
+        { "a3 traditional<list>", [&](double t) { return a3t::interpolateTimedPose(as_list, t); } },
+        { "a3 traditional<map>", [&](double t) { return a3t::interpolateTimedPose(as_map, t); } },
+        { "a3 modern<vector>", [&](double t) { return a3m::interpolateTimedPoseModern(input.poses, t); } },
+        { "a3 modern<list>", [&](double t) { return a3m::interpolateTimedPoseModern(as_list, t); } },
+        { "a3 modern<map>", [&](double t) { return a3m::interpolateTimedPoseModern(as_map, t); } },
+        { "robotics::interpolateTimedPose", [&](double t) { return robotics::interpolateTimedPose(input.poses, t); } },
+    };
+
+    std::vector<Outcome<TimedPose>> reference;
+    for (double t : input.queries) {
+        reference.push_back(capture([&] { return a2t::interpolateTimedPose(input.poses, t); }));
+        for (const auto& [name, impl] : impls) {
+            std::string diff = compareOutcome("a2 traditional", reference.back(), name,
+                capture([&] { return impl(t); }), compareTimedPose);
+            if (!diff.empty()) {
+                return diff;
+            }
+        }
+    }
+
+    // 批量接口：任一查询越界时整批抛出，否则逐个与参考一致
+    auto first_error = std::find_if(reference.begin(), reference.end(), [](const auto& o) { return !o.value; });
+    std::vector<double> sorted = input.queries;
+    std::sort(sorted.begin(), sorted.end());
+    robotics::ThreadPool pool(3);
+    const std::vector<std::pair<std::string, std::function<std::vector<TimedPose>()>>> batches = {
+        { "batched", [&] { return robotics::interpolateTimedPoses(input.poses, input.queries); } },
+        { "batched (sorted)", [&] { return robotics::interpolateTimedPoses(input.poses, sorted); } },
+        { "batched (pool)", [&] {
+             std::vector<TimedPose> out(input.queries.size());
+             robotics::interpolateTimedPoses(input.poses, input.queries.data(), input.queries.size(), out.data(), pool);
+             return out;
+         } },
+    };
+    for (const auto& [name, batch] : batches) {
+        auto outcome = capture(batch);
+        if (first_error != reference.end()) {
+            if (outcome.value || outcome.error != first_error->error) {
+                return name + " should throw " + first_error->error;
+            }
+            continue;
+        }
+        if (!outcome.value) {
+            return name + " threw " + outcome.error;
+        }
+        const std::vector<double>& times = name == "batched (sorted)" ? sorted : input.queries;
+        for (std::size_t k = 0; k < times.size(); ++k) {
+            TimedPose expected = a2t::interpolateTimedPose(input.poses, times[k]);
+            std::string diff = compareTimedPose(expected, (*outcome.value)[k]);
+            if (!diff.empty()) {
+                return "a2 traditional vs " + name + " at query " + std::to_string(k) + ": " + diff;
+            }
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a4：并行 for_each
+// ---------------------------------------------------------------------------
+
+struct ForEachInput {
+    std::vector<std::uint64_t> values;
+    unsigned threads { 1 };
+};
+
+ForEachInput generateForEach(WorkloadRng& rng, int size)
+{
+    ForEachInput input;
+    input.values.resize(rng.index(static_cast<std::size_t>(size) * 64 + 1));
+    for (std::uint64_t& v : input.values) {
+        v = rng.next();
+    }
+    input.threads = 1 + static_cast<unsigned>(rng.index(8));
+    return input;
+}
+
+std::vector<ForEachInput> shrinkForEach(const ForEachInput& input)
+{
+    std::vector<ForEachInput> candidates;
+    if (!input.values.empty()) {
+        ForEachInput half = input;
+        half.values.resize(input.values.size() / 2);
+        candidates.push_back(std::move(half));
+        ForEachInput shorter = input;
+        shorter.values.pop_back();
+        candidates.push_back(std::move(shorter));
+    }
+    for (unsigned threads : { 1u, 2u }) {
+        if (threads < input.threads) {
+            ForEachInput fewer = input;
+            fewer.threads = threads;
+            candidates.push_back(std::move(fewer));
+        }
+    }
+    return candidates;
+}
+
+std::string describeForEach(const ForEachInput& input)
+{
+    return "    " + std::to_string(input.values.size()) + " elements, " + std::to_string(input.threads) + " threads";
+}
+
+std::string checkForEach(const ForEachInput& input)
+{
+    auto op = [](std::uint64_t& x) { x = x * 6364136223846793005ULL + 1442695040888963407ULL; };
+    std::vector<std::uint64_t> expected = input.values;
+    std::for_each(expected.begin(), expected.end(), op);
+
+    using Variant = std::function<void(std::vector<std::uint64_t>&)>;
+    const std::vector<std::pair<std::string, Variant>> impls = {
+        { "a4 traditional", [&](auto& v) { a4t::parallel_for_each(v.begin(), v.end(), op); } },
+        { "a4 modern pool", [&](auto& v) { a4m::parallel_for_each_pool(v.begin(), v.end(), op); } },
+        { "a4 modern async", [&](auto& v) { a4m::parallel_for_each_async(v.begin(), v.end(), op); } },
+        { "robotics::parallel_for_each",
+            [&](auto& v) { robotics::parallel_for_each(v.begin(), v.end(), op, input.threads); } },
+        { "robotics::parallel_for_each_async",
+            [&](auto& v) { robotics::parallel_for_each_async(v.begin(), v.end(), op, input.threads); } },
+        { "ThreadPool::parallelFor", [&](auto& v) {
+             robotics::ThreadPool pool(input.threads);
+             pool.parallelFor(0, v.size(), [&](std::size_t lo, std::size_t hi) {
+                 for (std::size_t i = lo; i < hi; ++i) {
+                     op(v[i]);
+                 }
+             });
+         } },
+    };
+    for (const auto& [name, impl] : impls) {
+        std::vector<std::uint64_t> actual = input.values;
+        impl(actual);
+        auto mismatch = std::mismatch(expected.begin(), expected.end(), actual.begin());
+        if (mismatch.first != expected.end()) {
+            return "std::for_each vs " + name + ": first difference at index "
+                + std::to_string(std::distance(expected.begin(), mismatch.first));
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a0：稠密 SPD 方程组的各求解器
+// ---------------------------------------------------------------------------
+
+struct SolverInput {
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b;
+};
+
+SolverInput generateSolver(WorkloadRng& rng, int size)
+{
+    int n = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(std::min(size, 40))));
+    SolverInput input;
+    input.A = Eigen::MatrixXd::Zero(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            input.A(i, j) = input.A(j, i) = 0.5 * rng.normal();
+        }
+    }
+    // 严格对角占优的对称矩阵：SPD，且手写 Jacobi 迭代保证收敛
+    for (int i = 0; i < n; ++i) {
+        input.A(i, i) = input.A.row(i).cwiseAbs().sum() + rng.uniform(0.5, 2.0);
+    }
+    input.b.resize(n);
+    for (int i = 0; i < n; ++i) {
+        input.b(i) = rng.normal();
+    }
+    return input;
+}
+
+std::vector<SolverInput> shrinkSolver(const SolverInput& input)
+{
+    std::vector<SolverInput> candidates;
+    Eigen::Index n = input.A.rows();
+    if (n > 1) {
+        // 去掉一行一列仍然对角占优
+        candidates.push_back({ input.A.topLeftCorner(n - 1, n - 1), input.b.head(n - 1) });
+    }
+    for (Eigen::Index i = 0; i < n; ++i) {
+        for (Eigen::Index j = i + 1; j < n; ++j) {
+            if (input.A(i, j) != 0.0) {
+                SolverInput simpler = input;
+                simpler.A(i, j) = simpler.A(j, i) = 0.0;
+                candidates.push_back(std::move(simpler));
+            }
+        }
+    }
+    return candidates;
+}
+
+std::string describeSolver(const SolverInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    A =\n"
+        << input.A << "\n    b = " << input.b.transpose();
+    return out.str();
+}
+
+std::string checkSolver(const SolverInput& input)
+{
+    SolveResult reference = solveWithPartialPivLU(input.A, input.b);
+    if (!reference.success) {
+        return "reference LU failed";
+    }
+    struct Candidate {
+        SolveResult result;
+        double tolerance;
+    };
+    // 直接法在条件数很小的系统上应一致到舍入误差；迭代法受各自的收敛阈值限制
+    const std::vector<Candidate> candidates = {
+        { solveWithLLT(input.A, input.b), 1e-10 },
+        { solveWithColPivHouseholderQr(input.A, input.b), 1e-10 },
+        { solveWithJacobiSVD(input.A, input.b), 1e-10 },
+        { solveWithConjugateGradient(input.A, input.b), 1e-6 },
+        { solveWithBiCGSTAB(input.A, input.b), 1e-6 },
+        { solveWithManualJacobi(input.A, input.b, 10000, 1e-12), 1e-6 },
+    };
+    double scale = std::max(1.0, reference.solution.norm());
+    for (const Candidate& candidate : candidates) {
+        if (!candidate.result.success) {
+            return candidate.result.method + " reported failure";
+        }
+        double diff = (candidate.result.solution - reference.solution).norm() / scale;
+        if (!(diff <= candidate.tolerance)) {
+            std::ostringstream out;
+            out << reference.method << " vs " << candidate.result.method << ": relative difference " << diff;
+            return out.str();
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a0 带状与三对角求解器：与稠密 LU / LLT 比较
+// ---------------------------------------------------------------------------
+
+struct BandedInput {
+    Eigen::MatrixXd general; // 带宽 (lower, upper) 的一般矩阵，不对角占优时需要选主元
+    int lower = 0;
+    int upper = 0;
+    bool dominant = false; // general 严格对角占优时直接比较解，否则只比较后向误差
+    Eigen::MatrixXd symmetric; // 带宽 lower 的对称正定矩阵
+    Eigen::MatrixXd tridiagonal; // 3 x n：下对角线、主对角线、上对角线，对角占优；角上元素用于循环三对角
+    Eigen::MatrixXd batch_lower, batch_diagonal, batch_upper, batch_b; // k x n，对角占优
+    Eigen::VectorXd b;
+};
+
+BandedInput generateBanded(WorkloadRng& rng, int size)
+{
+    BandedInput input;
+    const int n = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(std::min(size, 60))));
+    input.lower = static_cast<int>(rng.index(static_cast<std::size_t>(std::min(5, n))));
+    input.upper = static_cast<int>(rng.index(static_cast<std::size_t>(std::min(5, n))));
+    input.dominant = rng.uniform() < 0.5;
+    input.general = Eigen::MatrixXd::Zero(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = std::max(0, i - input.lower); j <= std::min(n - 1, i + input.upper); ++j) {
+            input.general(i, j) = rng.normal();
+        }
+        double sign = rng.uniform() < 0.5 ? -1.0 : 1.0;
+        if (input.dominant) {
+            input.general(i, i) = sign * (input.general.row(i).cwiseAbs().sum() + rng.uniform(0.5, 2.0));
+        } else if (rng.uniform() < 0.2) {
+            input.general(i, i) *= 1e-10; // 不选主元时会放大舍入误差
+        }
+    }
+    Eigen::MatrixXd factor = Eigen::MatrixXd::Zero(n, n);
+    for (int j = 0; j < n; ++j) {
+        for (int i = j; i <= std::min(n - 1, j + input.lower); ++i) {
+            factor(i, j) = rng.normal();
+        }
+    }
+    input.symmetric = factor * factor.transpose() + Eigen::MatrixXd::Identity(n, n);
+
+    auto dominant_tridiagonal = [&](double& lower, double& diagonal, double& upper) {
+        lower = rng.normal();
+        upper = rng.normal();
+        diagonal = (rng.uniform() < 0.5 ? -1.0 : 1.0) * (std::fabs(lower) + std::fabs(upper) + rng.uniform(0.5, 2.0));
+    };
+    input.tridiagonal.resize(3, n);
+    for (int i = 0; i < n; ++i) {
+        dominant_tridiagonal(input.tridiagonal(0, i), input.tridiagonal(1, i), input.tridiagonal(2, i));
+    }
+    const int k = 1 + static_cast<int>(rng.index(5));
+    input.batch_lower.resize(k, n);
+    input.batch_diagonal.resize(k, n);
+    input.batch_upper.resize(k, n);
+    input.batch_b.resize(k, n);
+    for (int s = 0; s < k; ++s) {
+        for (int i = 0; i < n; ++i) {
+            dominant_tridiagonal(input.batch_lower(s, i), input.batch_diagonal(s, i), input.batch_upper(s, i));
+            input.batch_b(s, i) = rng.normal();
+        }
+    }
+    input.b.resize(n);
+    for (int i = 0; i < n; ++i) {
+        input.b(i) = rng.normal();
+    }
+    return input;
+}
+
+std::vector<BandedInput> shrinkBanded(const BandedInput& input)
+{
+    std::vector<BandedInput> candidates;
+    const Eigen::Index n = input.b.size();
+    if (n > 1) {
+        // 去掉最后一行一列仍是同样带宽、同样性质的矩阵
+        BandedInput smaller = input;
+        smaller.general = input.general.topLeftCorner(n - 1, n - 1);
+        smaller.symmetric = input.symmetric.topLeftCorner(n - 1, n - 1);
+        smaller.tridiagonal = input.tridiagonal.leftCols(n - 1);
+        smaller.batch_lower = input.batch_lower.leftCols(n - 1);
+        smaller.batch_diagonal = input.batch_diagonal.leftCols(n - 1);
+        smaller.batch_upper = input.batch_upper.leftCols(n - 1);
+        smaller.batch_b = input.batch_b.leftCols(n - 1);
+        smaller.b = input.b.head(n - 1);
+        smaller.lower = std::min<int>(smaller.lower, static_cast<int>(n) - 2);
+        smaller.upper = std::min<int>(smaller.upper, static_cast<int>(n) - 2);
+        candidates.push_back(std::move(smaller));
+    }
+    if (input.batch_b.rows() > 1) {
+        BandedInput fewer = input;
+        fewer.batch_lower = input.batch_lower.topRows(1);
+        fewer.batch_diagonal = input.batch_diagonal.topRows(1);
+        fewer.batch_upper = input.batch_upper.topRows(1);
+        fewer.batch_b = input.batch_b.topRows(1);
+        candidates.push_back(std::move(fewer));
+    }
+    return candidates;
+}
+
+std::string describeBanded(const BandedInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    lower = " << input.lower << ", upper = " << input.upper << ", dominant = " << input.dominant
+        << "\n    general =\n"
+        << input.general << "\n    symmetric =\n"
+        << input.symmetric << "\n    tridiagonal (lower, diagonal, upper) =\n"
+        << input.tridiagonal << "\n    batch diagonal =\n"
+        << input.batch_diagonal << "\n    b = " << input.b.transpose();
+    return out.str();
+}
+
+std::string checkBanded(const BandedInput& input)
+{
+    const Eigen::Index n = input.b.size();
+    std::ostringstream out;
+    out.precision(17);
+    auto relative = [](const Eigen::VectorXd& x, const Eigen::VectorXd& reference) {
+        return (x - reference).norm() / std::max(1.0, reference.norm());
+    };
+    auto backward_error = [](const Eigen::MatrixXd& A, const SolveResult& result, const Eigen::VectorXd& b) {
+        return (A * result.solution - b).norm() / (A.norm() * result.solution.norm() + b.norm());
+    };
+
+    // 1. 一般带状矩阵：带状 LU 与按带宽自动选择的入口
+    // 数值上奇异的矩阵（对角元很小的三角带状矩阵）上两种 LU 的舍入路径不同，可能一个遇到零主元一个没有，这时跳过
+    if (Eigen::PartialPivLU<Eigen::MatrixXd>(input.general).rcond() > 1e-12) {
+        SolveResult dense = solveWithPartialPivLU(input.general, input.b);
+        const SolveResult results[] = {
+            solveWithBandedLU(BandedMatrix::fromDense(input.general, input.lower, input.upper), input.b),
+            solveWithBandwidth(input.general, input.b, input.lower, input.upper),
+        };
+        for (const SolveResult& result : results) {
+            if (!result.success) {
+                return result.method + " reported failure on a well-conditioned matrix";
+            }
+            double diff = input.dominant ? relative(result.solution, dense.solution)
+                                         : backward_error(input.general, result, input.b);
+            if (!(diff <= 1e-10)) {
+                out << result.method << ": " << (input.dominant ? "relative difference " : "backward error ")
+                    << diff;
+                return out.str();
+            }
+        }
+    }
+
+    // 2. 对称正定：带状 LLT；取负后不正定，自动选择应退回带状 LU
+    SolveResult llt = solveWithLLT(input.symmetric, input.b);
+    const SolveResult spd[] = {
+        solveWithBandedLLT(BandedMatrix::fromDense(input.symmetric, input.lower, input.lower), input.b),
+        solveWithBandwidth(input.symmetric, input.b, input.lower, input.lower),
+    };
+    for (const SolveResult& result : spd) {
+        if (!result.success || !(relative(result.solution, llt.solution) <= 1e-10)) {
+            out << result.method << " on SPD: success " << result.success << ", relative difference "
+                << (result.success ? relative(result.solution, llt.solution) : 0.0);
+            return out.str();
+        }
+    }
+    if (input.lower != 1 && spd[1].method != "Banded Cholesky (LLT)") {
+        return "solveWithBandwidth chose " + spd[1].method + " for an SPD banded matrix";
+    }
+    SolveResult negated = solveWithBandwidth(-input.symmetric, input.b, input.lower, input.lower);
+    if (!negated.success || !(relative(negated.solution, -llt.solution) <= 1e-10)
+        || negated.method == "Banded Cholesky (LLT)") {
+        out << "negative definite: " << negated.method << ", success " << negated.success;
+        return out.str();
+    }
+
+    // 3. 三对角与循环三对角
+    const Eigen::VectorXd lower = input.tridiagonal.row(0).transpose(), diagonal = input.tridiagonal.row(1).transpose(),
+                          upper = input.tridiagonal.row(2).transpose();
+    Eigen::MatrixXd T = Eigen::MatrixXd::Zero(n, n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        T(i, i) = diagonal(i);
+        if (i > 0) {
+            T(i, i - 1) = lower(i);
+        }
+        if (i + 1 < n) {
+            T(i, i + 1) = upper(i);
+        }
+    }
+    SolveResult thomas = solveTridiagonal(lower, diagonal, upper, input.b);
+    SolveResult reference = solveWithPartialPivLU(T, input.b);
+    if (!thomas.success || !(relative(thomas.solution, reference.solution) <= 1e-12)) {
+        return "Thomas vs dense LU: relative difference " + std::to_string(relative(thomas.solution, reference.solution));
+    }
+    if (n >= 3) {
+        T(0, n - 1) = lower(0);
+        T(n - 1, 0) = upper(n - 1);
+        SolveResult cyclic = solveCyclicTridiagonal(lower, diagonal, upper, input.b);
+        reference = solveWithPartialPivLU(T, input.b);
+        if (!cyclic.success || !(relative(cyclic.solution, reference.solution) <= 1e-12)) {
+            out << "cyclic tridiagonal vs dense LU: success " << cyclic.success << ", relative difference "
+                << relative(cyclic.solution, reference.solution);
+            return out.str();
+        }
+    }
+
+    // 4. 批量 Thomas 与逐个求解一致
+    SolveResult batch
+        = solveTridiagonalBatch(input.batch_lower, input.batch_diagonal, input.batch_upper, input.batch_b);
+    const Eigen::Index k = input.batch_b.rows();
+    if (!batch.success || batch.solution.size() != k * n) {
+        return "batched Thomas reported failure";
+    }
+    const auto solutions = batch.solution.reshaped(k, n);
+    for (Eigen::Index s = 0; s < k; ++s) {
+        SolveResult single = solveTridiagonal(input.batch_lower.row(s).transpose(),
+            input.batch_diagonal.row(s).transpose(), input.batch_upper.row(s).transpose(),
+            input.batch_b.row(s).transpose());
+        double diff = relative(solutions.row(s).transpose(), single.solution);
+        if (!(diff <= 1e-14)) {
+            out << "batched vs single Thomas, system " << s << ": relative difference " << diff;
+            return out.str();
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a0 多线程分块稠密分解：与 Eigen 的单线程分解比较
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief 作用域内丢弃 std::cerr 的输出：a0 的求解器在预期的失败（奇异、不正定）上也会打印错误信息
+ */
+class ScopedSilentStderr {
+public:
+    ScopedSilentStderr()
+        : saved_(std::cerr.rdbuf(nullptr))
+    {
+    }
+    ~ScopedSilentStderr()
+    {
+        std::cerr.rdbuf(saved_);
+        std::cerr.clear();
+    }
+    ScopedSilentStderr(const ScopedSilentStderr&) = delete;
+    ScopedSilentStderr& operator=(const ScopedSilentStderr&) = delete;
+
+private:
+    std::streambuf* saved_;
+};
+
+struct TiledInput {
+    Eigen::MatrixXd general; // 可能含零列（奇异）
+    Eigen::MatrixXd spd; // 可能减去一个大的对角元（不正定）
+    Eigen::MatrixXd tall; // m >= n，可能含零列（秩亏）
+    Eigen::VectorXd b;
+    Eigen::VectorXd b_tall;
+    int tile = 1; // 很窄的列块：小矩阵上也有很多任务
+    unsigned threads = 1;
+};
+
+TiledInput generateTiled(WorkloadRng& rng, int size)
+{
+    TiledInput input;
+    const int n = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(std::min(2 * size, 100))));
+    const int m = n + static_cast<int>(rng.index(static_cast<std::size_t>(n) + 1));
+    auto random_matrix = [&](int rows, int cols) {
+        return Eigen::MatrixXd(Eigen::MatrixXd::NullaryExpr(rows, cols, [&](Eigen::Index, Eigen::Index) {
+            return rng.normal();
+        }));
+    };
+    input.general = random_matrix(n, n);
+    input.tall = random_matrix(m, n);
+    const Eigen::MatrixXd factor = random_matrix(n, n);
+    input.spd = factor * factor.transpose() + n * Eigen::MatrixXd::Identity(n, n);
+    const int column = static_cast<int>(rng.index(static_cast<std::size_t>(n)));
+    if (rng.uniform() < 0.1) {
+        input.general.col(column).setZero();
+    }
+    if (rng.uniform() < 0.1) {
+        input.tall.col(column).setZero();
+    }
+    if (rng.uniform() < 0.1) {
+        input.spd(column, column) -= 10.0 * input.spd.diagonal().maxCoeff();
+    }
+    input.b = random_matrix(n, 1);
+    input.b_tall = random_matrix(m, 1);
+    input.tile = 1 + static_cast<int>(rng.index(24));
+    input.threads = 1 + static_cast<unsigned>(rng.index(4));
+    return input;
+}
+
+std::vector<TiledInput> shrinkTiled(const TiledInput& input)
+{
+    std::vector<TiledInput> candidates;
+    const Eigen::Index n = input.b.size();
+    if (n > 1) {
+        TiledInput smaller = input;
+        smaller.general = input.general.topLeftCorner(n - 1, n - 1);
+        smaller.spd = input.spd.topLeftCorner(n - 1, n - 1);
+        smaller.tall = input.tall.leftCols(n - 1);
+        smaller.b = input.b.head(n - 1);
+        candidates.push_back(std::move(smaller));
+    }
+    if (input.threads > 1) {
+        TiledInput serial = input;
+        serial.threads = 1;
+        candidates.push_back(std::move(serial));
+    }
+    return candidates;
+}
+
+std::string describeTiled(const TiledInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    n = " << input.b.size() << ", m = " << input.b_tall.size() << ", tile = " << input.tile
+        << ", threads = " << input.threads << "\n    general =\n"
+        << input.general << "\n    spd =\n"
+        << input.spd << "\n    tall =\n"
+        << input.tall << "\n    b = " << input.b.transpose();
+    return out.str();
+}
+
+std::string checkTiled(const TiledInput& input)
+{
+    robotics::ThreadPool pool(input.threads);
+    ScopedSilentStderr silent;
+    std::ostringstream out;
+    out.precision(17);
+    auto relative = [](const Eigen::VectorXd& x, const Eigen::VectorXd& reference) {
+        return (x - reference).norm() / std::max(1.0, reference.norm());
+    };
+    auto backward_error = [](const Eigen::MatrixXd& A, const SolveResult& result, const Eigen::VectorXd& b) {
+        return (A * result.solution - b).norm() / (A.norm() * result.solution.norm() + b.norm());
+    };
+
+    // 1. LU：含零列时必须报告失败；否则后向误差与单线程 LU 相当，条件数不大时解一致
+    const bool singular = input.general.colwise().norm().minCoeff() == 0.0;
+    SolveResult lu = solveWithPartialPivLU(input.general, input.b, pool, input.tile);
+    if (lu.success == singular) {
+        out << "tiled LU: success " << lu.success << " on a " << (singular ? "singular" : "nonsingular") << " matrix";
+        return out.str();
+    }
+    if (!singular) {
+        const Eigen::PartialPivLU<Eigen::MatrixXd> reference(input.general);
+        const double diff = relative(lu.solution, reference.solve(input.b));
+        if (!(backward_error(input.general, lu, input.b) <= 1e-13) || (reference.rcond() > 1e-6 && !(diff <= 1e-9))) {
+            out << "tiled LU: backward error " << backward_error(input.general, lu, input.b)
+                << ", relative difference to Eigen " << diff;
+            return out.str();
+        }
+    }
+
+    // 2. LLT：不正定时必须报告失败
+    const bool definite = Eigen::LLT<Eigen::MatrixXd>(input.spd).info() == Eigen::Success;
+    SolveResult llt = solveWithLLT(input.spd, input.b, pool, input.tile);
+    if (llt.success != definite) {
+        out << "tiled LLT: success " << llt.success << ", Eigen::LLT success " << definite;
+        return out.str();
+    }
+    if (definite) {
+        const double diff = relative(llt.solution, Eigen::LLT<Eigen::MatrixXd>(input.spd).solve(input.b));
+        if (!(diff <= 1e-12)) {
+            out << "tiled LLT: relative difference to Eigen " << diff;
+            return out.str();
+        }
+    }
+
+    // 3. QR 最小二乘：秩亏（含零列）时必须报告失败；否则与列主元 QR 的最小二乘解一致
+    const bool deficient = input.tall.colwise().norm().minCoeff() == 0.0;
+    SolveResult qr = solveWithHouseholderQr(input.tall, input.b_tall, pool, input.tile);
+    if (qr.success == deficient) {
+        out << "tiled QR: success " << qr.success << " on a " << (deficient ? "rank-deficient" : "full-rank")
+            << " matrix";
+        return out.str();
+    }
+    if (!deficient) {
+        const Eigen::ColPivHouseholderQR<Eigen::MatrixXd> reference(input.tall);
+        const Eigen::VectorXd x = reference.solve(input.b_tall);
+        const double diff = relative(qr.solution, x);
+        const double condition = std::abs(reference.matrixR()(0, 0))
+            / std::abs(reference.matrixR()(input.tall.cols() - 1, input.tall.cols() - 1));
+        if (condition < 1e6 && !(diff <= 1e-8)) {
+            out << "tiled QR: relative difference to column-pivoting QR " << diff << " (condition ~" << condition
+                << ")";
+            return out.str();
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a0 对称半正定 / 对称不定求解器：重构 L D Lᵀ、惯性与稠密 LU 比较
+// ---------------------------------------------------------------------------
+
+struct SymmetricInput {
+    Eigen::MatrixXd A; // 由谱或 KKT 结构构造，惯性已知
+    Inertia inertia;
+    std::string kind;
+    Eigen::VectorXd x; // b = A x 总在值域内
+};
+
+SymmetricInput generateSymmetric(WorkloadRng& rng, int size)
+{
+    SymmetricInput input;
+    // 分解按 64 列分块，规模要超过一个面板才能覆盖面板之间的更新
+    const int n = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(std::min(3 * size, 160))));
+    auto orthogonal = [&](int m) {
+        Eigen::HouseholderQR<Eigen::MatrixXd> qr(
+            Eigen::MatrixXd::NullaryExpr(m, m, [&](Eigen::Index, Eigen::Index) { return rng.normal(); }));
+        return Eigen::MatrixXd(qr.householderQ());
+    };
+    auto magnitude = [&] { return std::pow(10.0, rng.uniform(-1.0, 1.0)); };
+    const double kind = rng.uniform();
+    if (kind < 0.5 || n < 2) {
+        // Q Λ Qᵀ：Λ 含正、负与精确为零的特征值；三成是半正定（位姿图法方程的规范自由度）
+        input.kind = "spectral";
+        const bool semidefinite = rng.uniform() < 0.3;
+        Eigen::VectorXd eigenvalues(n);
+        for (int i = 0; i < n; ++i) {
+            const double u = rng.uniform();
+            eigenvalues(i) = u < 0.2 ? 0.0 : (semidefinite || u < 0.6 ? magnitude() : -magnitude());
+            ++(eigenvalues(i) > 0.0 ? input.inertia.positive
+                                    : (eigenvalues(i) < 0.0 ? input.inertia.negative : input.inertia.zero));
+        }
+        const Eigen::MatrixXd q = orthogonal(n);
+        input.A = q * eigenvalues.asDiagonal() * q.transpose();
+    } else if (kind < 0.8) {
+        // KKT [H Cᵀ; C 0]：H 正定，C 行满秩，惯性为 (h, c, 0)
+        input.kind = "kkt";
+        const int c = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(n / 2)));
+        const int h = n - c;
+        Eigen::VectorXd eigenvalues(h), singular(c);
+        for (int i = 0; i < h; ++i) {
+            eigenvalues(i) = magnitude();
+        }
+        for (int i = 0; i < c; ++i) {
+            singular(i) = rng.uniform(0.5, 2.0);
+        }
+        const Eigen::MatrixXd q = orthogonal(h);
+        input.A = Eigen::MatrixXd::Zero(n, n);
+        input.A.topLeftCorner(h, h) = q * eigenvalues.asDiagonal() * q.transpose();
+        input.A.bottomLeftCorner(c, h) = singular.asDiagonal() * orthogonal(h).topRows(c);
+        input.A.topRightCorner(h, c) = input.A.bottomLeftCorner(c, h).transpose();
+        input.inertia = { h, c, 0 };
+    } else {
+        // [0 B; Bᵀ 0]：对角全为零，只有 2x2 主元可用，惯性为 (k, k, 0)
+        input.kind = "zero diagonal";
+        const int k = std::max(1, n / 2);
+        Eigen::VectorXd singular(k);
+        for (int i = 0; i < k; ++i) {
+            singular(i) = magnitude();
+        }
+        input.A = Eigen::MatrixXd::Zero(2 * k, 2 * k);
+        input.A.topRightCorner(k, k) = orthogonal(k) * singular.asDiagonal() * orthogonal(k).transpose();
+        input.A.bottomLeftCorner(k, k) = input.A.topRightCorner(k, k).transpose();
+        input.inertia = { k, k, 0 };
+    }
+    input.A = 0.5 * (input.A + input.A.transpose()).eval();
+    input.x.resize(input.A.rows());
+    for (Eigen::Index i = 0; i < input.x.size(); ++i) {
+        input.x(i) = rng.normal();
+    }
+    return input;
+}
+
+std::vector<SymmetricInput> shrinkSymmetric(const SymmetricInput& input)
+{
+    // 惯性由构造得到，删去行列会改变它；只尝试更简单的 x
+    std::vector<SymmetricInput> candidates;
+    if (!input.x.isOnes()) {
+        SymmetricInput ones = input;
+        ones.x.setOnes();
+        candidates.push_back(std::move(ones));
+    }
+    return candidates;
+}
+
+std::string describeSymmetric(const SymmetricInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    " << input.kind << ", n = " << input.A.rows() << ", inertia (" << input.inertia.positive << ", "
+        << input.inertia.negative << ", " << input.inertia.zero << ")\n    A =\n"
+        << input.A << "\n    x = " << input.x.transpose();
+    return out.str();
+}
+
+/**
+ * @brief 检查一个 L D Lᵀ 分解：块结构、置换、重构误差、|L| 的界（对角主元分解半正定矩阵时为 1）与惯性
+ */
+std::string checkSymmetricFactor(const SymmetricInput& input, const Eigen::MatrixXd& LD, const SymmetricFactor& factor,
+    double l_bound)
+{
+    const int n = static_cast<int>(input.A.rows());
+    std::ostringstream out;
+    out.precision(17);
+    std::vector<int> sorted = factor.permutation;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < n; ++i) {
+        if (sorted[static_cast<std::size_t>(i)] != i) {
+            return "permutation is not a permutation of 0..n-1";
+        }
+    }
+    Eigen::MatrixXd L = Eigen::MatrixXd::Identity(n, n), D = Eigen::MatrixXd::Zero(n, n);
+    for (int k = 0; k < n;) {
+        const int block = factor.block_sizes[static_cast<std::size_t>(k)];
+        if (block != 1 && !(block == 2 && k + 1 < n && factor.block_sizes[static_cast<std::size_t>(k + 1)] == 0)) {
+            out << "invalid block size " << block << " at row " << k;
+            return out.str();
+        }
+        D.block(k, k, block, block) = LD.block(k, k, block, block).selfadjointView<Eigen::Lower>();
+        L.block(k + block, k, n - k - block, block) = LD.block(k + block, k, n - k - block, block);
+        k += block;
+    }
+    Eigen::MatrixXd permuted(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            permuted(i, j) = input.A(factor.permutation[static_cast<std::size_t>(i)],
+                factor.permutation[static_cast<std::size_t>(j)]);
+        }
+    }
+    const double scale = input.A.cwiseAbs().maxCoeff();
+    const double reconstruction = (L * D * L.transpose() - permuted).cwiseAbs().maxCoeff() / std::max(scale, 1e-300);
+    // 奇异时按数值秩丢掉了不超过 √ε · max|A| 的列
+    const double tolerance = input.inertia.zero > 0 ? std::sqrt(std::numeric_limits<double>::epsilon()) : 1e-12 * n;
+    if (!(reconstruction <= tolerance)) {
+        out << "max |P A P^T - L D L^T| / max |A| = " << reconstruction;
+        return out.str();
+    }
+    const double l_max = L.cwiseAbs().maxCoeff();
+    if (!(l_max <= l_bound)) {
+        out << "max |L| = " << l_max << " exceeds the pivoting bound " << l_bound;
+        return out.str();
+    }
+    const Inertia& got = factor.inertia;
+    if (got.positive != input.inertia.positive || got.negative != input.inertia.negative
+        || got.zero != input.inertia.zero) {
+        out << "inertia (" << got.positive << ", " << got.negative << ", " << got.zero << ")";
+        return out.str();
+    }
+    return {};
+}
+
+std::string checkSymmetric(const SymmetricInput& input)
+{
+    const Eigen::MatrixXd& A = input.A;
+    const Eigen::VectorXd b = A * input.x;
+    ScopedSilentStderr silent;
+    std::ostringstream out;
+    out.precision(17);
+    auto backward_error = [&](const SolveResult& result) {
+        const double residual = (A * result.solution - b).norm();
+        const double scale = A.norm() * result.solution.norm() + b.norm();
+        return scale > 0.0 ? residual / scale : residual; // A = 0 时解为零
+    };
+
+    // 1. Bunch–Kaufman 对所有输入都应成功。它限制的是元素增长而不是 |L|（只有 rook 主元才能界定 |L|）
+    Eigen::MatrixXd LD = A;
+    SymmetricFactor factor;
+    if (!factorBunchKaufman(LD, factor)) {
+        return "factorBunchKaufman reported failure";
+    }
+    std::string error = checkSymmetricFactor(input, LD, factor, std::numeric_limits<double>::infinity());
+    if (!error.empty()) {
+        return "Bunch-Kaufman: " + error;
+    }
+    Inertia inertia;
+    SolveResult bunch_kaufman = solveWithBunchKaufman(A, b, &inertia);
+    if (!bunch_kaufman.success || !(backward_error(bunch_kaufman) <= 1e-13)) {
+        out << "solveWithBunchKaufman: success " << bunch_kaufman.success << ", backward error "
+            << backward_error(bunch_kaufman);
+        return out.str();
+    }
+    if (inertia.positive != factor.inertia.positive || inertia.negative != factor.inertia.negative
+        || inertia.zero != factor.inertia.zero) {
+        return "solveWithBunchKaufman returned a different inertia than factorBunchKaufman";
+    }
+
+    // 2. 对角主元 LDLT：对角全为零时必须失败；半正定（|l| ≤ 1）与 KKT（消去 H 后 Schur 补负定）必须成功。
+    //    一般的对称不定矩阵上对角主元没有稳定性保证，不检查
+    LD = A;
+    const bool ldlt_ok = factorLDLT(LD, factor);
+    if (input.kind == "zero diagonal") {
+        if (ldlt_ok) {
+            return "factorLDLT succeeded on a matrix with an all-zero diagonal";
+        }
+    } else if (input.kind == "kkt" || input.inertia.negative == 0) {
+        if (!ldlt_ok) {
+            return "factorLDLT reported failure on a " + input.kind + " matrix";
+        }
+        const double l_bound = input.inertia.negative == 0 ? 1.0 + 1e-12 : std::numeric_limits<double>::infinity();
+        error = checkSymmetricFactor(input, LD, factor, l_bound);
+        if (!error.empty()) {
+            return "LDLT: " + error;
+        }
+        SolveResult ldlt = solveWithLDLT(A, b);
+        if (!ldlt.success || !(backward_error(ldlt) <= 1e-13)) {
+            out << "solveWithLDLT: success " << ldlt.success << ", backward error " << backward_error(ldlt);
+            return out.str();
+        }
+    }
+
+    // 3. 非奇异时与稠密 LU 的解一致
+    if (input.inertia.zero == 0) {
+        SolveResult lu = solveWithPartialPivLU(A, b);
+        const double diff = (bunch_kaufman.solution - lu.solution).norm() / std::max(1.0, lu.solution.norm());
+        if (!(diff <= 1e-9)) {
+            out << "Bunch-Kaufman vs dense LU: relative difference " << diff;
+            return out.str();
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a0 稀疏 Cholesky 与符号分析缓存：与稠密 LLT 比较，模式不变时复用、改变时重新分析
+// ---------------------------------------------------------------------------
+
+struct SparseInput {
+    Eigen::SparseMatrix<double> A; // 只有下三角；可能减去一个大的对角元（不正定）
+    std::vector<double> scales; // 第二次求解 D A D 的对角元，模式不变
+    int extra_row = 0; // 第三次求解在 (extra_row, extra_col) 加一个元素，模式可能改变
+    int extra_col = 0;
+    Eigen::VectorXd b;
+};
+
+/**
+ * @brief 随机图的加权拉普拉斯加对角偏移（SPD），只保留下三角
+ */
+SparseInput generateSparse(WorkloadRng& rng, int size)
+{
+    SparseInput input;
+    const int n = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(std::min(2 * size, 80))));
+    const double density = rng.uniform(0.0, 4.0) / n; // 平均每个节点的边数在 0–4 之间
+    Eigen::MatrixXd dense = Eigen::MatrixXd::Zero(n, n);
+    for (int j = 0; j < n; ++j) {
+        for (int i = j + 1; i < n; ++i) {
+            if (rng.uniform() < density) {
+                const double weight = rng.uniform(0.1, 2.0);
+                dense(i, j) -= weight;
+                dense(i, i) += weight;
+                dense(j, j) += weight;
+            }
+        }
+        dense(j, j) += rng.uniform(0.01, 1.0);
+    }
+    if (rng.uniform() < 0.1) {
+        const int k = static_cast<int>(rng.index(static_cast<std::size_t>(n)));
+        dense(k, k) -= 10.0 * dense.diagonal().maxCoeff();
+    }
+    input.A = dense.sparseView();
+    input.A.makeCompressed();
+    for (int i = 0; i < n; ++i) {
+        input.scales.push_back(rng.uniform(0.5, 2.0));
+    }
+    input.extra_row = static_cast<int>(rng.index(static_cast<std::size_t>(n)));
+    input.extra_col = static_cast<int>(rng.index(static_cast<std::size_t>(input.extra_row) + 1));
+    input.b = Eigen::VectorXd::NullaryExpr(n, [&](Eigen::Index) { return rng.normal(); });
+    return input;
+}
+
+std::vector<SparseInput> shrinkSparse(const SparseInput& input)
+{
+    std::vector<SparseInput> candidates;
+    const int n = static_cast<int>(input.b.size());
+    if (n > 1) {
+        SparseInput smaller = input;
+        smaller.A = input.A.topLeftCorner(n - 1, n - 1);
+        smaller.A.makeCompressed();
+        smaller.scales.pop_back();
+        smaller.extra_row = std::min(input.extra_row, n - 2);
+        smaller.extra_col = std::min(input.extra_col, smaller.extra_row);
+        smaller.b = input.b.head(n - 1);
+        candidates.push_back(std::move(smaller));
+    }
+    return candidates;
+}
+
+std::string describeSparse(const SparseInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    n = " << input.b.size() << ", extra entry (" << input.extra_row << ", " << input.extra_col
+        << ")\n    A (lower) =\n"
+        << Eigen::MatrixXd(input.A) << "\n    b = " << input.b.transpose();
+    return out.str();
+}
+
+std::string checkSparse(const SparseInput& input)
+{
+    ScopedSilentStderr silent;
+    std::ostringstream out;
+    out.precision(17);
+    const int n = static_cast<int>(input.b.size());
+    using SparseMatrix = Eigen::SparseMatrix<double>;
+
+    // 三次求解的矩阵：A，数值不同、模式相同的 D A D，多一个元素的 A'
+    SparseMatrix scaled = input.A;
+    for (int j = 0; j < n; ++j) {
+        for (SparseMatrix::InnerIterator it(scaled, j); it; ++it) {
+            it.valueRef() *= input.scales[it.row()] * input.scales[j];
+        }
+    }
+    SparseMatrix extended = input.A;
+    const bool pattern_changes = extended.coeff(input.extra_row, input.extra_col) == 0.0;
+    extended.coeffRef(input.extra_row, input.extra_col) += input.extra_row == input.extra_col ? 1.0 : -0.5;
+    extended.coeffRef(input.extra_row, input.extra_row) += 0.5; // 加上一条边的拉普拉斯，正定性不变
+    extended.coeffRef(input.extra_col, input.extra_col) += 0.5;
+    SparseMatrix uncompressed = extended; // 插入后仍是未压缩格式
+    extended.makeCompressed();
+
+    // 1. 指纹只取决于模式，与数值和存储是否压缩无关
+    const SparsityFingerprint fingerprint = sparsityFingerprint(input.A);
+    if (!(sparsityFingerprint(scaled) == fingerprint)) {
+        return "fingerprint changed when only the values changed";
+    }
+    if (!(sparsityFingerprint(uncompressed) == sparsityFingerprint(extended))) {
+        return "fingerprint of an uncompressed matrix differs from the compressed one";
+    }
+    if (pattern_changes && sparsityFingerprint(extended) == fingerprint) {
+        out << "fingerprint did not change after inserting (" << input.extra_row << ", " << input.extra_col << ")";
+        return out.str();
+    }
+
+    // 2. 符号分析：排序是置换，消去树的父节点编号更大，L 的非零元个数与 Eigen 在同一排序上的结果相同
+    SparseSymbolic symbolic;
+    if (!analyzeSparseCholesky(input.A, symbolic)) {
+        return "analyzeSparseCholesky failed on a square matrix";
+    }
+    std::vector<int> sorted = symbolic.permutation;
+    std::sort(sorted.begin(), sorted.end());
+    for (int k = 0; k < n; ++k) {
+        if (sorted[k] != k || (symbolic.parent[k] != -1 && symbolic.parent[k] <= k)) {
+            return "ordering is not a permutation or the elimination tree is not topologically ordered";
+        }
+    }
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> order(n);
+    std::copy(symbolic.permutation.begin(), symbolic.permutation.end(), order.indices().data());
+    SparseMatrix permuted(n, n);
+    permuted.selfadjointView<Eigen::Lower>() = input.A.selfadjointView<Eigen::Lower>().twistedBy(order.inverse());
+    Eigen::SimplicialLLT<SparseMatrix, Eigen::Lower, Eigen::NaturalOrdering<int>> natural;
+    natural.analyzePattern(permuted);
+    natural.factorize(permuted);
+    if (natural.info() == Eigen::Success && natural.matrixL().nestedExpression().nonZeros()
+        != symbolic.column_pointers.back()) {
+        out << "nnz(L) " << symbolic.column_pointers.back() << ", Eigen on the same ordering "
+            << natural.matrixL().nestedExpression().nonZeros();
+        return out.str();
+    }
+
+    // 3. 求解：成功与否与稠密 LLT 一致，解一致到舍入误差
+    auto compare = [&](const char* name, const SparseMatrix& M, const SolveResult& result) {
+        const Eigen::MatrixXd dense = Eigen::MatrixXd(M).selfadjointView<Eigen::Lower>();
+        const Eigen::LLT<Eigen::MatrixXd> llt(dense);
+        const bool definite = llt.info() == Eigen::Success;
+        if (result.success != definite) {
+            out << name << ": success " << result.success << ", dense LLT success " << definite;
+            return false;
+        }
+        if (definite) {
+            const Eigen::VectorXd reference = llt.solve(input.b);
+            const double diff = (result.solution - reference).norm() / std::max(1.0, reference.norm());
+            if (!(diff <= 1e-10)) {
+                out << name << ": relative difference to dense LLT " << diff;
+                return false;
+            }
+        }
+        return true;
+    };
+    const SolveResult first = solveWithSparseLLT(input.A, input.b);
+    if (!compare("uncached", input.A, first)) {
+        return out.str();
+    }
+
+    // 4. 缓存：第二次（模式相同）命中且与不用缓存的结果完全相同，第三次（模式改变）重新分析
+    SparseAnalysisCache cache;
+    solveWithSparseLLT(input.A, input.b, &cache);
+    const SolveResult second = solveWithSparseLLT(scaled, input.b, &cache);
+    const SolveResult second_uncached = solveWithSparseLLT(scaled, input.b);
+    if (cache.hits() != 1 || cache.misses() != 1) {
+        out << "after two solves with the same pattern: " << cache.hits() << " hits, " << cache.misses()
+            << " misses";
+        return out.str();
+    }
+    if (second.success != second_uncached.success
+        || (second.success && second.solution != second_uncached.solution)) {
+        return "cached analysis gives a different result than a fresh analysis";
+    }
+    const SolveResult third = solveWithSparseLLT(uncompressed, input.b, &cache);
+    if (cache.misses() != (pattern_changes ? 2 : 1)) {
+        out << "pattern " << (pattern_changes ? "changed" : "unchanged") << " but " << cache.misses() << " misses";
+        return out.str();
+    }
+    if (!compare("cached, scaled", scaled, second) || !compare("cached, extra entry", extended, third)) {
+        return out.str();
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// a0 超节点稀疏 Cholesky 与稀疏求解器的自动选择：与稠密 LLT / LU 比较，线程数不影响结果
+// ---------------------------------------------------------------------------
+
+struct SupernodalInput {
+    Eigen::MatrixXd A; // 对称，块大小为 block 的随机图（超节点较宽）；可能不正定或不对称
+    bool store_upper = false; // solveSparse 收到完整的矩阵而不只是下三角
+    bool unsymmetric = false; // 在一个严格上三角元素上加扰动
+    unsigned threads = 1;
+    Eigen::VectorXd b;
+};
+
+/**
+ * @brief 随机图的加权拉普拉斯，每个节点是 block 个未知量（与 SE(3) 法方程的块结构相同），转成稠密存储便于收缩
+ */
+SupernodalInput generateSupernodal(WorkloadRng& rng, int size)
+{
+    SupernodalInput input;
+    const int block = 1 + static_cast<int>(rng.index(4));
+    const int nodes = 1 + static_cast<int>(rng.index(static_cast<std::size_t>(std::min(size, 30))));
+    const double density = rng.uniform(0.0, 6.0) / nodes;
+    const int n = nodes * block;
+    input.A = Eigen::MatrixXd::Zero(n, n);
+    auto add = [&](int i, int j, double weight) { // 节点 i、j 之间的边：A += weight · (e_i - e_j)(e_i - e_j)ᵀ ⊗ I
+        for (int k = 0; k < block; ++k) {
+            input.A(block * i + k, block * i + k) += weight;
+            input.A(block * j + k, block * j + k) += weight;
+            input.A(block * i + k, block * j + k) -= weight;
+            input.A(block * j + k, block * i + k) -= weight;
+        }
+    };
+    for (int j = 0; j < nodes; ++j) {
+        for (int i = j + 1; i < nodes; ++i) {
+            if (rng.uniform() < density) {
+                add(i, j, rng.uniform(0.1, 2.0));
+            }
+        }
+        for (int k = 0; k < block; ++k) {
+            input.A(block * j + k, block * j + k) += rng.uniform(0.01, 1.0);
+        }
+    }
+    for (int j = 0; j < n; ++j) { // 块内耦合：对角块加一个小的对称扰动，仍然对角占优
+        for (int i = j + 1; i < (j / block + 1) * block; ++i) {
+            input.A(i, j) = input.A(j, i) = rng.uniform(-0.005, 0.005);
+        }
+    }
+    if (rng.uniform() < 0.1) {
+        const int k = static_cast<int>(rng.index(static_cast<std::size_t>(n)));
+        input.A(k, k) -= 10.0 * input.A.diagonal().maxCoeff();
+    }
+    input.store_upper = rng.uniform() < 0.3;
+    input.unsymmetric = n > 1 && rng.uniform() < 0.1;
+    input.threads = 1 + static_cast<unsigned>(rng.index(4));
+    input.b = Eigen::VectorXd::NullaryExpr(n, [&](Eigen::Index) { return rng.normal(); });
+    return input;
+}
+
+std::vector<SupernodalInput> shrinkSupernodal(const SupernodalInput& input)
+{
+    std::vector<SupernodalInput> candidates;
+    const Eigen::Index n = input.b.size();
+    if (n > 1) {
+        SupernodalInput smaller = input;
+        smaller.A = input.A.topLeftCorner(n - 1, n - 1);
+        smaller.b = input.b.head(n - 1);
+        smaller.unsymmetric = input.unsymmetric && n > 2;
+        candidates.push_back(std::move(smaller));
+    }
+    if (input.threads > 1) {
+        SupernodalInput serial = input;
+        serial.threads = 1;
+        candidates.push_back(std::move(serial));
+    }
+    return candidates;
+}
+
+std::string describeSupernodal(const SupernodalInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    n = " << input.b.size() << ", threads " << input.threads << ", store upper " << input.store_upper
+        << ", unsymmetric " << input.unsymmetric << "\n    A =\n"
+        << input.A << "\n    b = " << input.b.transpose();
+    return out.str();
+}
+
+std::string checkSupernodal(const SupernodalInput& input)
+{
+    ScopedSilentStderr silent;
+    std::ostringstream out;
+    out.precision(17);
+    const int n = static_cast<int>(input.b.size());
+    using SparseMatrix = Eigen::SparseMatrix<double>;
+    const SparseMatrix lower = input.A.triangularView<Eigen::Lower>().toDenseMatrix().sparseView();
+    const Eigen::LLT<Eigen::MatrixXd> llt(input.A);
+    const bool definite = llt.info() == Eigen::Success;
+    const Eigen::VectorXd reference = definite ? Eigen::VectorXd(llt.solve(input.b)) : Eigen::VectorXd();
+    auto matches = [&](const Eigen::VectorXd& x, const Eigen::VectorXd& expected) {
+        return (x - expected).norm() <= 1e-10 * std::max(1.0, expected.norm());
+    };
+
+    // 1. 超节点划分：覆盖所有列，行结构升序且以自己的列开头，父超节点编号更大，面板大小与数值数组一致
+    SparseSymbolic symbolic;
+    SupernodalSymbolic supernodal;
+    if (!analyzeSparseCholesky(lower, symbolic) || !analyzeSupernodal(lower, symbolic, supernodal)) {
+        return "symbolic analysis failed on a square matrix";
+    }
+    const int supernodes = static_cast<int>(supernodal.supernode_parent.size());
+    if (supernodal.supernode_columns.front() != 0 || supernodal.supernode_columns.back() != n) {
+        return "supernodes do not cover all columns";
+    }
+    std::size_t values = 0;
+    for (int s = 0; s < supernodes; ++s) {
+        const int first = supernodal.supernode_columns[s], width = supernodal.supernode_columns[s + 1] - first;
+        const int* rows = supernodal.rows.data() + supernodal.row_pointers[s];
+        const int height = supernodal.row_pointers[s + 1] - supernodal.row_pointers[s];
+        if (width <= 0 || height < width || !std::is_sorted(rows, rows + height) || rows[0] != first
+            || rows[width - 1] != first + width - 1 || supernodal.value_pointers[s] != values
+            || (supernodal.supernode_parent[s] != -1 && supernodal.supernode_parent[s] <= s)) {
+            out << "supernode " << s << " (columns " << first << "–" << first + width - 1 << ", " << height
+                << " rows) is malformed";
+            return out.str();
+        }
+        for (int c = 0; c < width; ++c) { // 超节点内每一列的非零元个数与逐列分析的一致
+            if (symbolic.column_pointers[first + c + 1] - symbolic.column_pointers[first + c] != height - c) {
+                out << "column " << first + c << " has " << height - c << " rows in supernode " << s
+                    << " but the column count is "
+                    << symbolic.column_pointers[first + c + 1] - symbolic.column_pointers[first + c];
+                return out.str();
+            }
+        }
+        values += static_cast<std::size_t>(height) * width;
+    }
+    if (supernodal.value_pointers.back() != values) {
+        return "value_pointers do not add up to the panel sizes";
+    }
+
+    // 2. 超节点分解：成功与否与稠密 LLT 一致；每个超节点的运算顺序固定，所以线程数不影响结果（逐位相同）
+    robotics::ThreadPool serial(1), pool(input.threads);
+    const SolveResult one = solveWithSupernodalLLT(lower, input.b, serial);
+    const SolveResult many = solveWithSupernodalLLT(lower, input.b, pool);
+    if (one.success != definite || many.success != definite) {
+        out << "supernodal success " << one.success << " / " << many.success << " with " << input.threads
+            << " threads, dense LLT success " << definite;
+        return out.str();
+    }
+    if (definite && (!matches(one.solution, reference) || one.solution != many.solution)) {
+        out << "supernodal relative difference to dense LLT "
+            << (one.solution - reference).norm() / std::max(1.0, reference.norm()) << ", 1 vs " << input.threads
+            << " threads " << (one.solution - many.solution).norm();
+        return out.str();
+    }
+
+    // 3. solveSparse：对称正定时用 Cholesky，不对称或不正定时改用稀疏 LU，解与稠密 LU 一致
+    Eigen::MatrixXd full = input.A;
+    if (input.unsymmetric) {
+        full(0, n - 1) += 0.5;
+    }
+    const SparseMatrix stored = input.store_upper || input.unsymmetric ? SparseMatrix(full.sparseView()) : lower;
+    SparseAnalysisCache cache;
+    const SolveResult first = solveSparse(stored, input.b, pool, &cache);
+    const SolveResult second = solveSparse(stored, input.b, pool, &cache);
+    const bool cholesky = definite && !input.unsymmetric;
+    const bool lu_method = first.method == "Sparse LU (COLAMD)";
+    if (lu_method == cholesky) {
+        out << "solveSparse chose " << first.method << ", symmetric positive definite " << cholesky;
+        return out.str();
+    }
+    const Eigen::FullPivLU<Eigen::MatrixXd> dense_lu(full);
+    if (dense_lu.isInvertible() && dense_lu.rcond() > 1e-8) {
+        const Eigen::VectorXd expected = dense_lu.solve(input.b);
+        if (!first.success || !matches(first.solution, expected)) {
+            out << first.method << ": success " << first.success << ", relative difference to dense LU "
+                << (first.solution - expected).norm() / std::max(1.0, expected.norm());
+            return out.str();
+        }
+    }
+    if (cholesky && (cache.hits() != 1 || cache.misses() != 1 || second.solution != first.solution)) {
+        out << "solveSparse with a cache: " << cache.hits() << " hits, " << cache.misses()
+            << " misses over two solves";
+        return out.str();
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// alignment：流式累加器的各种累加方式与闭式解
+// ---------------------------------------------------------------------------
+
+double squaredNorm(const Vector3& v)
+{
+    return v.x * v.x + v.y * v.y + v.z * v.z;
+}
+
+struct AlignInput {
+    robotics::Similarity truth;
+    std::vector<Vector3> source;
+    std::vector<Vector3> target;
+};
+
+AlignInput generateAlign(WorkloadRng& rng, int size)
+{
+    AlignInput input;
+    input.truth.transform = { rng.normalVector(100.0), randomQuaternion(rng) };
+    input.truth.scale = std::pow(10.0, rng.uniform(-1.0, 1.0));
+    Vector3 center = rng.normalVector(std::pow(10.0, rng.uniform(0.0, 6.0))); // 包括远离原点的坐标
+    double spread = std::pow(10.0, rng.uniform(-1.0, 2.0));
+    double noise = spread * std::pow(10.0, rng.uniform(-6.0, -1.0));
+    bool collinear = rng.uniform() < 0.1; // 退化情形：绕直线的旋转不确定，但残差仍应一致
+    Vector3 direction = rng.normalVector(1.0);
+    std::size_t n = rng.index(static_cast<std::size_t>(size) * 2 + 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        Vector3 offset = collinear ? direction * (spread * rng.normal()) : rng.normalVector(spread);
+        input.source.push_back(center + offset);
+        input.target.push_back(input.truth.apply(input.source.back()) + rng.normalVector(noise));
+    }
+    return input;
+}
+
+std::vector<AlignInput> shrinkAlign(const AlignInput& input)
+{
+    std::vector<AlignInput> candidates;
+    for (std::size_t i = 0; i < input.source.size(); ++i) {
+        AlignInput smaller = input;
+        smaller.source.erase(smaller.source.begin() + i);
+        smaller.target.erase(smaller.target.begin() + i);
+        candidates.push_back(std::move(smaller));
+    }
+    return candidates;
+}
+
+std::string describeAlign(const AlignInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    truth = " << formatPose(input.truth.transform) << ", scale " << input.truth.scale << "\n    pairs =";
+    for (std::size_t i = 0; i < input.source.size(); ++i) {
+        const Vector3& s = input.source[i];
+        const Vector3& t = input.target[i];
+        out << "\n      { " << s.x << ", " << s.y << ", " << s.z << " } -> { " << t.x << ", " << t.y << ", " << t.z
+            << " }";
+    }
+    return out.str();
+}
+
+std::string checkAlign(const AlignInput& input)
+{
+    using robotics::AlignmentAccumulator;
+    using robotics::Similarity;
+    const std::vector<Vector3>& source = input.source;
+    const std::vector<Vector3>& target = input.target;
+
+    // 直接遍历点对的残差平方和，作为比较的标准
+    auto direct_ss = [&](const Similarity& similarity) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            sum += squaredNorm(similarity.apply(source[i]) - target[i]);
+        }
+        return sum;
+    };
+    // 平移不影响最优性，用中心化的总方差作为容差的尺度
+    Vector3 mean_source, mean_target;
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        mean_source = mean_source + source[i] * (1.0 / static_cast<double>(source.size()));
+        mean_target = mean_target + target[i] * (1.0 / static_cast<double>(source.size()));
+    }
+    double spread = 0.0, magnitude = 0.0;
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        spread += squaredNorm(target[i] - mean_target)
+            + input.truth.scale * input.truth.scale * squaredNorm(source[i] - mean_source);
+        magnitude = std::max(magnitude, target[i].norm() + input.truth.scale * source[i].norm());
+    }
+    // 远离原点时，逐点计算残差本身就有 ~eps * |坐标| 的舍入误差
+    double n = static_cast<double>(source.size());
+    double delta = 1e-14 * magnitude;
+    double tolerance = 1e-9 * spread + 2.0 * std::sqrt(n * spread) * delta + n * delta * delta;
+
+    auto per_point = [&] {
+        AlignmentAccumulator accumulator;
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            accumulator.add(source[i], target[i]);
+        }
+        return accumulator;
+    };
+    auto split_merge = [&] {
+        AlignmentAccumulator head, tail;
+        std::size_t half = source.size() / 3;
+        for (std::size_t i = 0; i < half; ++i) {
+            head.add(source[i], target[i]);
+        }
+        tail.add(source.data() + half, target.data() + half, source.size() - half);
+        head.merge(tail);
+        return head;
+    };
+    auto pooled = [&] {
+        robotics::ThreadPool pool(3);
+        return robotics::accumulateAlignment(source.data(), target.data(), source.size(), pool);
+    };
+
+    for (bool with_scale : { true, false }) {
+        Outcome<Similarity> reference = capture([&] { return robotics::umeyamaAlignment(source, target, with_scale); });
+        if (reference.value) {
+            // Umeyama 是最小二乘最优解，不应比生成数据用的真实变换差
+            Similarity truth = input.truth;
+            if (!with_scale) {
+                truth.scale = 1.0;
+            }
+            double optimal = direct_ss(*reference.value);
+            if (!(optimal <= direct_ss(truth) + tolerance)) {
+                std::ostringstream out;
+                out << "umeyamaAlignment residual " << optimal << " exceeds that of the true transform "
+                    << direct_ss(truth);
+                return out.str();
+            }
+            double streamed = per_point().rmsResidual(*reference.value);
+            if (!close(streamed * streamed * n, optimal, 0.0, tolerance)) {
+                std::ostringstream out;
+                out.precision(17);
+                out << "rmsResidual " << streamed << " vs direct " << std::sqrt(optimal / n);
+                return out.str();
+            }
+        }
+        const std::vector<std::pair<std::string, std::function<Similarity()>>> candidates = {
+            { "add(pair)", [&] { return per_point().solve(with_scale); } },
+            { "add(pair)+add(block) merged", [&] { return split_merge().solve(with_scale); } },
+            { "accumulateAlignment", [&] { return pooled().solve(with_scale); } },
+            { "solveHorn", [&] { return per_point().solveHorn(with_scale); } },
+        };
+        for (const auto& [name, solve] : candidates) {
+            std::string diff = compareOutcome(std::string("umeyamaAlignment") + (with_scale ? " Sim(3)" : " SE(3)"),
+                reference, name, capture(solve), [&](const Similarity& a, const Similarity& b) -> std::string {
+                    // 退化输入的变换不唯一，比较残差而不是变换本身
+                    double ss_a = direct_ss(a), ss_b = direct_ss(b);
+                    if (close(ss_a, ss_b, 0.0, tolerance)) {
+                        return {};
+                    }
+                    std::ostringstream out;
+                    out.precision(17);
+                    out << "residual sum of squares " << ss_a << " vs " << ss_b;
+                    return out.str();
+                });
+            if (!diff.empty()) {
+                return diff;
+            }
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// imu：预积分的零偏雅可比、预测与残差、批量接口
+// ---------------------------------------------------------------------------
+
+struct ImuInput {
+    std::vector<robotics::imu::ImuSample> samples; // samples[i].time 为累计时间，最后一个采样之后再保持 tail 秒
+    double tail { 0.0 };
+    robotics::imu::ImuBias bias;
+};
+
+ImuInput generateImu(WorkloadRng& rng, int size)
+{
+    ImuInput input;
+    double time = rng.uniform(-10.0, 10.0);
+    double rate = std::pow(10.0, rng.uniform(0.0, 1.0)); // 0.5–5 rad/s 量级的转动
+    std::size_t n = 1 + rng.index(static_cast<std::size_t>(size) * 2);
+    for (std::size_t i = 0; i < n; ++i) {
+        input.samples.push_back({ time, rng.normalVector(rate), rng.normalVector(3.0) + Vector3 { 0.0, 0.0, 9.81 } });
+        time += rng.uniform(5e-4, 5e-3);
+    }
+    input.tail = rng.uniform(5e-4, 5e-3);
+    input.bias = { rng.normalVector(0.01), rng.normalVector(0.1) };
+    return input;
+}
+
+std::vector<ImuInput> shrinkImu(const ImuInput& input)
+{
+    std::vector<ImuInput> candidates;
+    for (std::size_t i = 0; i + 1 < input.samples.size(); ++i) {
+        ImuInput smaller = input;
+        smaller.samples.erase(smaller.samples.begin() + i);
+        candidates.push_back(std::move(smaller));
+    }
+    if (input.bias.gyro.norm() != 0.0 || input.bias.accel.norm() != 0.0) {
+        ImuInput no_bias = input;
+        no_bias.bias = {};
+        candidates.push_back(std::move(no_bias));
+    }
+    return candidates;
+}
+
+std::string describeImu(const ImuInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    bias = gyro { " << input.bias.gyro.x << ", " << input.bias.gyro.y << ", " << input.bias.gyro.z
+        << " }, accel { " << input.bias.accel.x << ", " << input.bias.accel.y << ", " << input.bias.accel.z
+        << " }\n    tail = " << input.tail << "\n    samples =";
+    for (const auto& s : input.samples) {
+        out << "\n      t " << s.time << ": gyro { " << s.gyro.x << ", " << s.gyro.y << ", " << s.gyro.z
+            << " }, accel { " << s.accel.x << ", " << s.accel.y << ", " << s.accel.z << " }";
+    }
+    return out.str();
+}
+
+std::string checkImu(const ImuInput& input)
+{
+    using robotics::imu::ImuBias;
+    using robotics::imu::PreintegratedImu;
+    namespace lie = robotics::lie;
+    const double t0 = input.samples.front().time;
+    const double t1 = input.samples.back().time + input.tail;
+    auto integrate = [&](const ImuBias& bias) {
+        PreintegratedImu preintegrated(bias);
+        preintegrated.integrate(input.samples, t0, t1);
+        return preintegrated;
+    };
+    const PreintegratedImu nominal = integrate(input.bias);
+    auto fail = [](const std::string& what, double value, double tolerance) {
+        std::ostringstream out;
+        out << what << ": " << value << " exceeds " << tolerance;
+        return out.str();
+    };
+
+    // 1. 零偏雅可比与中心差分一致
+    const double eps = 1e-5;
+    for (int axis = 0; axis < 6; ++axis) {
+        ImuBias plus = input.bias, minus = input.bias;
+        Vector3& plus_part = axis < 3 ? plus.gyro : plus.accel;
+        Vector3& minus_part = axis < 3 ? minus.gyro : minus.accel;
+        double* p = axis % 3 == 0 ? &plus_part.x : axis % 3 == 1 ? &plus_part.y : &plus_part.z;
+        double* m = axis % 3 == 0 ? &minus_part.x : axis % 3 == 1 ? &minus_part.y : &minus_part.z;
+        *p += eps;
+        *m -= eps;
+        PreintegratedImu a = integrate(plus), b = integrate(minus);
+        Eigen::Vector3d d_rotation = lie::toEigen(lie::log(b.deltaRotation().conjugate() * a.deltaRotation()))
+            / (2.0 * eps);
+        Eigen::Vector3d d_velocity = lie::toEigen(a.deltaVelocity() - b.deltaVelocity()) / (2.0 * eps);
+        Eigen::Vector3d d_position = lie::toEigen(a.deltaPosition() - b.deltaPosition()) / (2.0 * eps);
+        int column = axis % 3;
+        // ΔR(b ± ε) ≈ ΔR(b) Exp(±J ε)，所以 Log(ΔR(b - ε)ᵀ ΔR(b + ε)) / 2ε ≈ J 的对应列
+        Eigen::Vector3d analytic_rotation = axis < 3 ? Eigen::Vector3d(nominal.dRotationDGyroBias().col(column))
+                                                     : Eigen::Vector3d::Zero();
+        Eigen::Vector3d analytic_velocity = axis < 3 ? nominal.dVelocityDGyroBias().col(column)
+                                                     : nominal.dVelocityDAccelBias().col(column);
+        Eigen::Vector3d analytic_position = axis < 3 ? nominal.dPositionDGyroBias().col(column)
+                                                     : nominal.dPositionDAccelBias().col(column);
+        const char* names[6] = { "bg.x", "bg.y", "bg.z", "ba.x", "ba.y", "ba.z" };
+        const double tol = 1e-5;
+        double e = (d_rotation - analytic_rotation).norm();
+        if (!(e <= tol * (1.0 + analytic_rotation.norm()))) {
+            return fail(std::string("dΔR/d") + names[axis] + " vs central difference", e, tol);
+        }
+        e = (d_velocity - analytic_velocity).norm();
+        if (!(e <= tol * (1.0 + analytic_velocity.norm()))) {
+            return fail(std::string("dΔv/d") + names[axis] + " vs central difference", e, tol);
+        }
+        e = (d_position - analytic_position).norm();
+        if (!(e <= tol * (1.0 + analytic_position.norm()))) {
+            return fail(std::string("dΔp/d") + names[axis] + " vs central difference", e, tol);
+        }
+    }
+
+    // 2. predict 得到的终点状态残差为零
+    const Vector3 gravity { 0.0, 0.0, -9.81 };
+    robotics::imu::NavState start { { Vector3 { 3.0, -1.0, 2.0 }, Quaternion::fromEuler(0.3, -0.1, 2.0) },
+        Vector3 { 1.5, 0.5, -0.2 } };
+    ImuBias other { input.bias.gyro + Vector3 { 1e-3, -2e-3, 5e-4 }, input.bias.accel + Vector3 { 0.02, 0.0, -0.01 } };
+    robotics::imu::NavState end = nominal.predict(start, other, gravity);
+    double residual = nominal.residual(start, end, other, gravity).norm();
+    double scale = 1.0 + end.velocity.norm() + (end.pose.position - start.pose.position).norm();
+    if (!(residual <= 1e-9 * scale)) {
+        return fail("residual of predicted state", residual, 1e-9 * scale);
+    }
+
+    // 3. 批量接口与逐个区间积分逐位相同
+    double middle = input.samples[input.samples.size() / 2].time + 0.3 * input.tail;
+    robotics::ThreadPool pool(3);
+    std::vector<PreintegratedImu> batched = robotics::imu::preintegrateKeyframes(input.samples,
+        { t0, middle, t1 }, { input.bias }, robotics::imu::ImuNoise {}, pool);
+    PreintegratedImu first(input.bias), second(input.bias);
+    first.integrate(input.samples, t0, middle);
+    second.integrate(input.samples, middle, t1);
+    for (int k = 0; k < 2; ++k) {
+        const PreintegratedImu& expected = k == 0 ? first : second;
+        const PreintegratedImu& actual = batched[k];
+        if (comparePose({ expected.deltaPosition(), expected.deltaRotation() },
+                { actual.deltaPosition(), actual.deltaRotation() }, 0.0)
+                != ""
+            || (expected.covariance() - actual.covariance()).norm() != 0.0) {
+            return "preintegrateKeyframes differs from integrate() on interval " + std::to_string(k);
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// pose covariance：SE(3) 运算与插值协方差的一阶传播
+// ---------------------------------------------------------------------------
+
+struct PoseCovarianceInput {
+    Pose start;
+    Pose end;
+    robotics::Matrix6d start_covariance;
+    robotics::Matrix6d end_covariance;
+    double t { 0.5 };
+};
+
+PoseCovarianceInput generatePoseCovariance(WorkloadRng& rng, int size)
+{
+    PoseCovarianceInput input;
+    double extent = 0.1 * size;
+    input.start = { rng.normalVector(extent), randomQuaternion(rng) };
+    // 相对转角限制在 2.8 rad 以内，避免差分时 Log 跨过 π 的分支
+    Vector3 axis = rng.normalVector(1.0);
+    double angle = rng.uniform(0.0, 2.8);
+    Vector3 phi = axis * (angle / std::max(axis.norm(), 1e-12));
+    input.end = { input.start.position + rng.normalVector(extent), input.start.orientation * robotics::lie::exp(phi) };
+    for (robotics::Matrix6d* covariance : { &input.start_covariance, &input.end_covariance }) {
+        robotics::Matrix6d m;
+        for (int i = 0; i < 6; ++i) {
+            for (int j = 0; j < 6; ++j) {
+                m(i, j) = rng.normal();
+            }
+        }
+        *covariance = m * m.transpose() + 0.1 * robotics::Matrix6d::Identity();
+    }
+    input.t = rng.uniform(0.0, 1.0);
+    return input;
+}
+
+std::vector<PoseCovarianceInput> shrinkPoseCovariance(const PoseCovarianceInput& input)
+{
+    std::vector<PoseCovarianceInput> candidates;
+    if (input.t != 0.5) {
+        PoseCovarianceInput half = input;
+        half.t = 0.5;
+        candidates.push_back(half);
+    }
+    if (input.start.position.norm() != 0.0) {
+        PoseCovarianceInput origin = input;
+        origin.end.position = origin.end.position - origin.start.position;
+        origin.start.position = {};
+        candidates.push_back(origin);
+    }
+    for (robotics::Matrix6d PoseCovarianceInput::*member :
+        { &PoseCovarianceInput::start_covariance, &PoseCovarianceInput::end_covariance }) {
+        if (!(input.*member).isIdentity()) {
+            PoseCovarianceInput identity = input;
+            identity.*member = robotics::Matrix6d::Identity();
+            candidates.push_back(identity);
+        }
+    }
+    return candidates;
+}
+
+std::string describePoseCovariance(const PoseCovarianceInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    start = " << formatPose(input.start) << "\n    end = " << formatPose(input.end) << "\n    t = "
+        << input.t << "\n    start_covariance =\n" << input.start_covariance << "\n    end_covariance =\n"
+        << input.end_covariance;
+    return out.str();
+}
+
+std::string checkPoseCovariance(const PoseCovarianceInput& input)
+{
+    namespace lie = robotics::lie;
+    using robotics::CovarianceModel;
+    using robotics::Matrix6d;
+    using robotics::PoseWithCovariance;
+    auto fail = [](const std::string& what, double value, double tolerance) {
+        std::ostringstream out;
+        out << what << ": " << value << " exceeds " << tolerance;
+        return out.str();
+    };
+
+    // 1. expSE3 / logSE3 互逆，伴随满足 T Exp(ξ) T⁻¹ = Exp(Ad(T) ξ)
+    const Pose relative = input.start.inverse() * input.end;
+    std::string difference = comparePose(lie::expSE3(lie::logSE3(relative)), relative, 1e-9);
+    if (!difference.empty()) {
+        return "expSE3(logSE3(T)) != T: " + difference;
+    }
+    lie::Vector6d xi;
+    xi << 0.3, -0.2, 0.1, 1.0, -2.0, 0.5;
+    difference = comparePose(input.start * lie::expSE3(xi) * input.start.inverse(),
+        lie::expSE3(lie::adjoint(input.start) * xi), 1e-9 * (1.0 + input.start.position.norm()));
+    if (!difference.empty()) {
+        return "adjoint identity: " + difference;
+    }
+
+    // 2. 传播的协方差与中心差分雅可比得到的协方差一致
+    const PoseWithCovariance start { input.start, input.start_covariance };
+    const PoseWithCovariance end { input.end, input.end_covariance };
+    for (CovarianceModel model : { CovarianceModel::Decoupled, CovarianceModel::SE3 }) {
+        const char* name = model == CovarianceModel::SE3 ? "SE3" : "Decoupled";
+        PoseWithCovariance nominal = robotics::interpolatePoseWithCovariance(start, end, input.t, model);
+        auto perturbation = [&](const Pose& sample) {
+            if (model == CovarianceModel::SE3) {
+                return lie::Vector6d(lie::logSE3(nominal.pose.inverse() * sample));
+            }
+            lie::Vector6d delta;
+            delta << lie::toEigen(lie::log(nominal.pose.orientation.conjugate() * sample.orientation)),
+                lie::toEigen(nominal.pose.orientation.conjugate().rotate(sample.position - nominal.pose.position));
+            return delta;
+        };
+        const double h = 1e-6;
+        Matrix6d a, b;
+        for (int i = 0; i < 6; ++i) {
+            lie::Vector6d e = lie::Vector6d::Zero();
+            e(i) = h;
+            for (int side = 0; side < 2; ++side) {
+                PoseWithCovariance plus = side == 0 ? start : end;
+                PoseWithCovariance minus = plus;
+                plus.pose = plus.pose * lie::expSE3(e);
+                minus.pose = minus.pose * lie::expSE3(-e);
+                const PoseWithCovariance& other = side == 0 ? end : start;
+                Pose p = side == 0 ? robotics::interpolatePoseWithCovariance(plus, other, input.t, model).pose
+                                   : robotics::interpolatePoseWithCovariance(other, plus, input.t, model).pose;
+                Pose m = side == 0 ? robotics::interpolatePoseWithCovariance(minus, other, input.t, model).pose
+                                   : robotics::interpolatePoseWithCovariance(other, minus, input.t, model).pose;
+                (side == 0 ? a : b).col(i) = (perturbation(p) - perturbation(m)) / (2.0 * h);
+            }
+        }
+        Matrix6d expected = a * input.start_covariance * a.transpose() + b * input.end_covariance * b.transpose();
+        double e = (nominal.covariance - expected).norm();
+        // slerp 在转角小于约 3.6° 时退化为 nlerp，与传播所用的 SLERP 雅可比相差 O(θ²)
+        double angle = relative.orientation.angle();
+        double tol = (1e-5 + (model == CovarianceModel::Decoupled ? angle * angle : 0.0)) * expected.norm();
+        if (!(e <= tol)) {
+            return fail(std::string(name) + " covariance vs central-difference Jacobians", e, tol);
+        }
+
+        // 3. 端点处退化为端点自身的协方差
+        for (double t : { 0.0, 1.0 }) {
+            const Matrix6d& endpoint = t == 0.0 ? input.start_covariance : input.end_covariance;
+            e = (robotics::interpolatePoseWithCovariance(start, end, t, model).covariance - endpoint).norm();
+            if (!(e <= 1e-9 * endpoint.norm())) {
+                return fail(std::string(name) + " covariance at t = " + std::to_string(t) + " vs endpoint", e,
+                    1e-9 * endpoint.norm());
+            }
+        }
+    }
+
+    // 4. 批量接口（线程池、float 输出）与单次查询一致
+    using robotics::PackedCovariance;
+    using robotics::TimedPoseWithCovariance;
+    std::vector<TimedPoseWithCovariance<double>> keyframes {
+        { 0.0, input.start, PackedCovariance<double>::pack(input.start_covariance) },
+        { 1.0, input.end, PackedCovariance<double>::pack(input.end_covariance) },
+        { 2.5, input.start, PackedCovariance<double>::pack(input.end_covariance) },
+    };
+    std::vector<double> times { 0.0, input.t, 1.0, 1.0 + input.t, 2.5, 0.5 * input.t };
+    std::vector<TimedPoseWithCovariance<float>> batched(times.size());
+    robotics::ThreadPool pool(3);
+    robotics::interpolateTimedPosesWithCovariance(keyframes, times.data(), times.size(), batched.data(), pool);
+    for (std::size_t k = 0; k < times.size(); ++k) {
+        PoseWithCovariance single = robotics::interpolateTimedPoseWithCovariance(keyframes, times[k]);
+        difference = comparePose(single.pose, batched[k].pose, 0.0);
+        double e = (single.covariance - batched[k].covariance.unpack()).norm();
+        if (!difference.empty() || !(e <= 1e-6 * single.covariance.norm())) {
+            return "batched query " + std::to_string(k) + " differs from single query";
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// pose graph：稀疏组装 + Cholesky 的一步 Gauss-Newton 与稠密数值雅可比参考实现
+// ---------------------------------------------------------------------------
+
+struct PoseGraphInput {
+    std::vector<Pose> poses; // 节点 0 固定
+    std::vector<robotics::graph::Edge> edges;
+    robotics::graph::RobustLoss loss;
+};
+
+PoseGraphInput generatePoseGraph(WorkloadRng& rng, int size)
+{
+    namespace lie = robotics::lie;
+    PoseGraphInput input;
+    std::size_t n = 2 + rng.index(static_cast<std::size_t>(std::min(size, 30)) + 1);
+    std::vector<Pose> truth;
+    for (std::size_t i = 0; i < n; ++i) {
+        truth.push_back({ rng.normalVector(3.0), randomQuaternion(rng) });
+        lie::Vector6d noise;
+        for (int k = 0; k < 6; ++k) {
+            noise(k) = 0.2 * rng.normal();
+        }
+        Pose guess = truth.back() * lie::expSE3(noise);
+        guess.orientation.normalize();
+        input.poses.push_back(guess);
+    }
+    auto add_edge = [&](std::size_t from, std::size_t to) {
+        lie::Vector6d noise;
+        for (int k = 0; k < 6; ++k) {
+            noise(k) = 0.1 * rng.normal();
+        }
+        robotics::Matrix6d m;
+        for (int i = 0; i < 6; ++i) {
+            for (int j = 0; j < 6; ++j) {
+                m(i, j) = rng.normal();
+            }
+        }
+        Pose z = truth[from].inverse() * truth[to] * lie::expSE3(noise);
+        z.orientation.normalize();
+        input.edges.push_back({ from, to, z, m * m.transpose() + 0.5 * robotics::Matrix6d::Identity() });
+    };
+    for (std::size_t i = 1; i < n; ++i) {
+        add_edge(rng.index(i), i); // 随机生成树，保证连通
+    }
+    for (std::size_t e = rng.index(n + 1); e > 0; --e) {
+        std::size_t a = rng.index(n), b = rng.index(n);
+        if (a != b) {
+            add_edge(a, b);
+        }
+    }
+    input.loss = { static_cast<robotics::graph::RobustKernel>(rng.index(3)), rng.uniform(0.5, 3.0) };
+    return input;
+}
+
+std::vector<PoseGraphInput> shrinkPoseGraph(const PoseGraphInput& input)
+{
+    std::vector<PoseGraphInput> candidates;
+    if (input.poses.size() > 2) {
+        // 去掉最后一个节点及其边；若图因此不连通则 Hessian 奇异，check 会把它当成失败，这里只保留仍连通的候选
+        PoseGraphInput smaller = input;
+        std::size_t last = input.poses.size() - 1;
+        smaller.poses.pop_back();
+        std::erase_if(smaller.edges, [&](const auto& e) { return e.from == last || e.to == last; });
+        std::vector<std::size_t> component(smaller.poses.size());
+        std::iota(component.begin(), component.end(), 0);
+        std::function<std::size_t(std::size_t)> find = [&](std::size_t x) {
+            return component[x] == x ? x : component[x] = find(component[x]);
+        };
+        for (const auto& e : smaller.edges) {
+            component[find(e.from)] = find(e.to);
+        }
+        bool connected = true;
+        for (std::size_t i = 0; i < smaller.poses.size(); ++i) {
+            connected = connected && find(i) == find(0);
+        }
+        if (connected) {
+            candidates.push_back(std::move(smaller));
+        }
+    }
+    if (input.loss.kernel != robotics::graph::RobustKernel::None) {
+        PoseGraphInput plain = input;
+        plain.loss = {};
+        candidates.push_back(std::move(plain));
+    }
+    for (std::size_t e = 0; e < input.edges.size(); ++e) {
+        if (!input.edges[e].information.isIdentity()) {
+            PoseGraphInput identity = input;
+            identity.edges[e].information = robotics::Matrix6d::Identity();
+            candidates.push_back(std::move(identity));
+        }
+    }
+    return candidates;
+}
+
+std::string describePoseGraph(const PoseGraphInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    const char* kernels[3] = { "None", "Huber", "Cauchy" };
+    out << "    loss = { " << kernels[static_cast<int>(input.loss.kernel)] << ", " << input.loss.delta
+        << " }\n    poses =";
+    for (std::size_t i = 0; i < input.poses.size(); ++i) {
+        out << "\n      " << i << ": " << formatPose(input.poses[i]);
+    }
+    out << "\n    edges =";
+    for (const auto& e : input.edges) {
+        out << "\n      " << e.from << " -> " << e.to << ": " << formatPose(e.measurement);
+        if (!e.information.isIdentity()) {
+            out << " (information not identity)";
+        }
+    }
+    return out.str();
+}
+
+std::string checkPoseGraph(const PoseGraphInput& input)
+{
+    namespace lie = robotics::lie;
+    using namespace robotics::graph;
+    auto build = [&] {
+        PoseGraph graph;
+        for (std::size_t i = 0; i < input.poses.size(); ++i) {
+            graph.addNode(input.poses[i], i == 0);
+        }
+        for (const Edge& edge : input.edges) {
+            graph.addEdge(edge);
+        }
+        return graph;
+    };
+    OptimizerOptions options;
+    options.method = Method::GaussNewton;
+    options.max_iterations = 1;
+    options.loss = input.loss;
+
+    // 1. 稀疏实现的一步 GN，1 个线程与 3 个线程逐位相同
+    PoseGraph serial_graph = build(), parallel_graph = build();
+    robotics::ThreadPool serial(1), pool(3);
+    PoseGraphOptimizer(serial_graph, options).optimize(serial);
+    PoseGraphOptimizer(parallel_graph, options).optimize(pool);
+    for (std::size_t i = 0; i < input.poses.size(); ++i) {
+        if (comparePose(serial_graph.poses()[i], parallel_graph.poses()[i], 0.0) != "") {
+            return "1 thread and 3 threads differ at node " + std::to_string(i);
+        }
+    }
+
+    // 2. 参考实现：中心差分的稠密雅可比，稠密 LDLT
+    const std::size_t free = input.poses.size() - 1;
+    const std::size_t rows = 6 * input.edges.size();
+    auto residuals = [&](const std::vector<Pose>& poses) {
+        Eigen::VectorXd r(rows);
+        for (std::size_t e = 0; e < input.edges.size(); ++e) {
+            const Edge& edge = input.edges[e];
+            r.segment<6>(6 * e) = edgeResidual(poses[edge.from], poses[edge.to], edge.measurement);
+        }
+        return r;
+    };
+    Eigen::VectorXd r0 = residuals(input.poses);
+    Eigen::MatrixXd jacobian(rows, 6 * free);
+    const double h = 1e-6;
+    for (std::size_t i = 1; i < input.poses.size(); ++i) {
+        for (int k = 0; k < 6; ++k) {
+            lie::Vector6d delta = lie::Vector6d::Zero();
+            delta(k) = h;
+            std::vector<Pose> plus = input.poses, minus = input.poses;
+            plus[i] = plus[i] * lie::expSE3(delta);
+            minus[i] = minus[i] * lie::expSE3(-delta);
+            jacobian.col(6 * (i - 1) + k) = (residuals(plus) - residuals(minus)) / (2.0 * h);
+        }
+    }
+    Eigen::MatrixXd weight = Eigen::MatrixXd::Zero(rows, rows);
+    for (std::size_t e = 0; e < input.edges.size(); ++e) {
+        const Matrix6d& information = input.edges[e].information;
+        lie::Vector6d r = r0.segment<6>(6 * e);
+        weight.block<6, 6>(6 * e, 6 * e) = input.loss.weight(r.dot(information * r)) * information;
+    }
+    Eigen::MatrixXd hessian = jacobian.transpose() * weight * jacobian;
+    Eigen::VectorXd step = hessian.ldlt().solve(-jacobian.transpose() * weight * r0);
+    for (std::size_t i = 1; i < input.poses.size(); ++i) {
+        Pose expected = input.poses[i] * lie::expSE3(step.segment<6>(6 * (i - 1)));
+        double tol = 1e-5 * (1.0 + step.norm()) * (1.0 + expected.position.norm());
+        std::string difference = comparePose(expected, serial_graph.poses()[i], tol);
+        if (!difference.empty()) {
+            return "node " + std::to_string(i) + " after one Gauss-Newton step vs dense reference: " + difference;
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// trajectory store：事务序列 + 快照与 std::vector 模型逐位一致，旧快照不受之后写入影响
+// ---------------------------------------------------------------------------
+
+struct StoreTransaction {
+    std::size_t appends { 0 }; // 从 later 中依次取出追加的位姿数
+    std::vector<std::pair<std::size_t, Pose>> edits; // (下标, 左乘的修正)，下标对事务开始时的大小取模
+    bool commit { true };
+};
+
+struct TrajectoryStoreInput {
+    std::vector<TimedPose> initial;
+    std::vector<TimedPose> later; // 时间戳都不早于 initial 的最后一个
+    std::size_t chunk_size { 1 };
+    std::vector<StoreTransaction> transactions;
+    std::vector<double> queries;
+};
+
+TrajectoryStoreInput generateTrajectoryStore(WorkloadRng& rng, int size)
+{
+    TrajectoryStoreInput input;
+    robotics::workload::JerkyTrajectoryOptions options;
+    options.count = 2 + rng.index(static_cast<std::size_t>(2 * size) + 1);
+    options.rate_hz = rng.uniform(10.0, 1000.0);
+    options.start_time = rng.uniform(-100.0, 1e6);
+    options.timestamp_jitter = rng.uniform() < 0.5 ? 0.0 : 0.2 / options.rate_hz;
+    options.seed = rng.next();
+    std::vector<TimedPose> poses = rng.uniform() < 0.5 ? robotics::workload::smoothTrajectory(options)
+                                                       : robotics::workload::jerkyTrajectory(options);
+    std::size_t split = rng.uniform() < 0.1 ? 0 : rng.index(poses.size() + 1);
+    input.initial.assign(poses.begin(), poses.begin() + static_cast<std::ptrdiff_t>(split));
+    input.later.assign(poses.begin() + static_cast<std::ptrdiff_t>(split), poses.end());
+    input.chunk_size = std::size_t { 1 } << rng.index(5);
+
+    std::size_t remaining = input.later.size();
+    for (std::size_t k = 1 + rng.index(8); k > 0; --k) {
+        StoreTransaction transaction;
+        transaction.appends = rng.index(remaining + 1);
+        remaining -= transaction.appends;
+        for (std::size_t e = rng.index(4); e > 0; --e) {
+            Pose correction { rng.normalVector(0.5), randomQuaternion(rng) };
+            transaction.edits.push_back({ rng.index(1000000), correction });
+        }
+        transaction.commit = rng.uniform() < 0.85;
+        input.transactions.push_back(std::move(transaction));
+    }
+
+    double t0 = poses.front().time_stamp, t1 = poses.back().time_stamp;
+    for (std::size_t k = 1 + rng.index(static_cast<std::size_t>(size)); k > 0; --k) {
+        input.queries.push_back(rng.uniform() < 0.2 ? poses[rng.index(poses.size())].time_stamp
+                                                    : rng.uniform(t0 - 0.05 * (t1 - t0), t1));
+    }
+    return input;
+}
+
+std::vector<TrajectoryStoreInput> shrinkTrajectoryStore(const TrajectoryStoreInput& input)
+{
+    std::vector<TrajectoryStoreInput> candidates;
+    for (std::size_t k = 0; k < input.transactions.size(); ++k) {
+        TrajectoryStoreInput fewer = input;
+        fewer.transactions.erase(fewer.transactions.begin() + static_cast<std::ptrdiff_t>(k));
+        candidates.push_back(std::move(fewer));
+    }
+    if (input.queries.size() > 1) {
+        for (double t : input.queries) {
+            TrajectoryStoreInput one = input;
+            one.queries = { t };
+            candidates.push_back(std::move(one));
+        }
+    }
+    if (input.chunk_size > 1) {
+        TrajectoryStoreInput smaller = input;
+        smaller.chunk_size /= 2;
+        candidates.push_back(std::move(smaller));
+    }
+    if (!input.initial.empty()) {
+        TrajectoryStoreInput shorter = input;
+        shorter.initial.pop_back();
+        candidates.push_back(std::move(shorter));
+    }
+    return candidates;
+}
+
+std::string describeTrajectoryStore(const TrajectoryStoreInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    chunk_size = " << input.chunk_size << ", " << input.initial.size() << " initial poses, "
+        << input.later.size() << " later poses\n";
+    for (const StoreTransaction& transaction : input.transactions) {
+        out << "    transaction: append " << transaction.appends << ", edit {";
+        for (const auto& [index, correction] : transaction.edits) {
+            out << " " << index;
+        }
+        out << " }, " << (transaction.commit ? "commit" : "abort") << "\n";
+    }
+    out << "    queries = " << formatVector(input.queries);
+    return out.str();
+}
+
+std::string checkTrajectoryStore(const TrajectoryStoreInput& input)
+{
+    using robotics::TrajectoryStore;
+    auto same = [](const TimedPose& a, const TimedPose& b) {
+        return a.time_stamp == b.time_stamp ? comparePose(a.pose, b.pose, 0.0) : std::string("time_stamp differs");
+    };
+
+    TrajectoryStore store(input.initial, input.chunk_size);
+    std::vector<TrajectoryStore::Snapshot> snapshots { store.snapshot() };
+    std::vector<std::vector<TimedPose>> models { input.initial };
+    std::size_t next_later = 0;
+    for (const StoreTransaction& transaction : input.transactions) {
+        std::vector<TimedPose> model = models.back();
+        std::vector<bool> touched((model.size() + transaction.appends + input.chunk_size - 1) / input.chunk_size);
+        {
+            TrajectoryStore::Transaction writer = store.begin();
+            for (const auto& [index, correction] : transaction.edits) {
+                if (!model.empty()) {
+                    std::size_t i = index % model.size();
+                    model[i].pose = correction * model[i].pose;
+                    writer.at(i).pose = correction * writer[i].pose;
+                    touched[i / input.chunk_size] = true;
+                }
+            }
+            for (std::size_t k = 0; k < transaction.appends; ++k) {
+                touched[model.size() / input.chunk_size] = true;
+                model.push_back(input.later[next_later]);
+                writer.append(input.later[next_later++]);
+            }
+            if (capture([&] { return writer.at(model.size()); }).error != "out_of_range") {
+                return "Transaction::at(size()) should throw out_of_range";
+            }
+            if (transaction.commit) {
+                std::uint64_t number = writer.commit();
+                if (number != snapshots.back().version() + 1) {
+                    return "commit returned version " + std::to_string(number) + " after "
+                        + std::to_string(snapshots.back().version());
+                }
+            } else {
+                next_later -= transaction.appends; // 放弃的事务不消耗 later 中的位姿
+                model = models.back();
+            }
+        }
+        TrajectoryStore::Snapshot snapshot = store.snapshot();
+        if (!transaction.commit && snapshot.version() != snapshots.back().version()) {
+            return "aborted transaction published version " + std::to_string(snapshot.version());
+        }
+        // 写时复制：没有被改写或追加的块必须与上一版本共享
+        for (std::size_t c = 0; transaction.commit && c < snapshots.back().chunkCount(); ++c) {
+            if (!touched[c] && !snapshot.sharesChunk(snapshots.back(), c)) {
+                return "untouched chunk " + std::to_string(c) + " was copied by a commit";
+            }
+        }
+        snapshots.push_back(std::move(snapshot));
+        models.push_back(std::move(model));
+    }
+
+    // 所有写入完成后再检查每个快照：内容、逐个插值与批量插值都必须与当时的模型逐位一致
+    std::vector<double> sorted = input.queries;
+    std::sort(sorted.begin(), sorted.end());
+    const std::vector<double>* orders[] = { &input.queries, &sorted };
+    for (std::size_t s = 0; s < snapshots.size(); ++s) {
+        const TrajectoryStore::Snapshot& snapshot = snapshots[s];
+        const std::vector<TimedPose>& model = models[s];
+        std::string where = "snapshot " + std::to_string(s) + " (v" + std::to_string(snapshot.version()) + ")";
+        if (snapshot.size() != model.size()) {
+            return where + " has " + std::to_string(snapshot.size()) + " poses, model "
+                + std::to_string(model.size());
+        }
+        std::vector<TimedPose> flat = snapshot.toVector();
+        for (std::size_t i = 0; i < model.size(); ++i) {
+            std::string diff = same(model[i], snapshot[i]);
+            diff = diff.empty() ? same(model[i], flat[i]) : diff;
+            if (!diff.empty()) {
+                return where + " pose " + std::to_string(i) + ": " + diff;
+            }
+        }
+        for (double t : input.queries) {
+            std::string diff = compareOutcome("interpolateTimedPose",
+                capture([&] { return robotics::interpolateTimedPose(model, t); }), "Snapshot::interpolate",
+                capture([&] { return snapshot.interpolate(t); }), same);
+            if (!diff.empty()) {
+                return where + ": " + diff;
+            }
+        }
+        for (const std::vector<double>* times : orders) {
+            auto expected = capture([&] { return robotics::interpolateTimedPoses(model, *times); });
+            auto actual = capture([&] {
+                std::vector<TimedPose> out(times->size());
+                snapshot.interpolate(times->data(), times->size(), out.data());
+                return out;
+            });
+            std::string diff = compareOutcome("interpolateTimedPoses", expected, "batched Snapshot::interpolate",
+                actual, [&](const std::vector<TimedPose>& a, const std::vector<TimedPose>& b) {
+                    for (std::size_t k = 0; k < a.size(); ++k) {
+                        std::string d = same(a[k], b[k]);
+                        if (!d.empty()) {
+                            return "query " + std::to_string(k) + ": " + d;
+                        }
+                    }
+                    return std::string();
+                });
+            if (!diff.empty()) {
+                return where + (times == &sorted ? " (sorted queries): " : ": ") + diff;
+            }
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// correction propagation：区间批量修正与逐个位姿 interpolateTimedPose 后左乘的参考实现
+// ---------------------------------------------------------------------------
+
+struct CorrectionInput {
+    std::vector<TimedPose> poses;
+    std::vector<TimedPose> corrections;
+    std::size_t chunk_size { 1 };
+};
+
+CorrectionInput generateCorrection(WorkloadRng& rng, int size)
+{
+    CorrectionInput input;
+    robotics::workload::JerkyTrajectoryOptions options;
+    options.count = rng.index(static_cast<std::size_t>(4 * size) + 1);
+    options.rate_hz = rng.uniform(10.0, 1000.0);
+    options.start_time = rng.uniform(-100.0, 1e5);
+    options.timestamp_jitter = rng.uniform() < 0.5 ? 0.0 : 0.2 / options.rate_hz;
+    options.gap_probability = rng.uniform() < 0.5 ? 0.0 : 0.2;
+    options.seed = rng.next();
+    input.poses = rng.uniform() < 0.5 ? robotics::workload::smoothTrajectory(options)
+                                      : robotics::workload::jerkyTrajectory(options);
+    input.chunk_size = std::size_t { 1 } << rng.index(5);
+
+    // 关键帧时间可以落在稠密轨迹之外；修正有单位变换、小修正（nlerp）和任意大的修正（slerp）
+    double t0 = input.poses.empty() ? 0.0 : input.poses.front().time_stamp;
+    double t1 = input.poses.empty() ? 1.0 : input.poses.back().time_stamp;
+    double margin = 0.1 * (t1 - t0) + 1e-3;
+    std::vector<double> times;
+    for (std::size_t k = 1 + rng.index(static_cast<std::size_t>(std::min(size, 20))); k > 0; --k) {
+        times.push_back(rng.uniform() < 0.2 && !input.poses.empty()
+                ? input.poses[rng.index(input.poses.size())].time_stamp
+                : rng.uniform(t0 - margin, t1 + margin));
+    }
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+    if (times.size() > 1 && rng.uniform() < 0.03) {
+        times[1] = times[0]; // 偶尔给出不严格递增的时间戳，所有接口都应抛出 invalid_argument
+    }
+    for (double t : times) {
+        double pick = rng.uniform();
+        Pose correction;
+        if (pick < 0.4) {
+            correction = { rng.normalVector(0.1), Quaternion::fromRotationVector(rng.normalVector(0.01)) };
+        } else if (pick < 0.7) {
+            correction = { rng.normalVector(10.0), randomQuaternion(rng) };
+        }
+        input.corrections.push_back({ t, correction });
+    }
+    return input;
+}
+
+std::vector<CorrectionInput> shrinkCorrection(const CorrectionInput& input)
+{
+    std::vector<CorrectionInput> candidates;
+    for (std::size_t k = 0; k < input.corrections.size() && input.corrections.size() > 1; ++k) {
+        CorrectionInput fewer = input;
+        fewer.corrections.erase(fewer.corrections.begin() + static_cast<std::ptrdiff_t>(k));
+        candidates.push_back(std::move(fewer));
+    }
+    for (std::size_t i = 0; i < input.poses.size(); ++i) {
+        CorrectionInput fewer = input;
+        fewer.poses.erase(fewer.poses.begin() + static_cast<std::ptrdiff_t>(i));
+        candidates.push_back(std::move(fewer));
+    }
+    for (std::size_t k = 0; k < input.corrections.size(); ++k) {
+        if (input.corrections[k].pose.orientation.w != 1.0 || input.corrections[k].pose.position.x != 0.0) {
+            CorrectionInput identity = input;
+            identity.corrections[k].pose = Pose {};
+            candidates.push_back(std::move(identity));
+        }
+    }
+    if (input.chunk_size > 1) {
+        CorrectionInput smaller = input;
+        smaller.chunk_size /= 2;
+        candidates.push_back(std::move(smaller));
+    }
+    return candidates;
+}
+
+std::string describeCorrection(const CorrectionInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    chunk_size = " << input.chunk_size << "\n    poses = {\n";
+    for (const TimedPose& p : input.poses) {
+        out << "        { " << p.time_stamp << ", " << formatPose(p.pose) << " },\n";
+    }
+    out << "    };\n    corrections = {\n";
+    for (const TimedPose& c : input.corrections) {
+        out << "        { " << c.time_stamp << ", " << formatPose(c.pose) << " },\n";
+    }
+    out << "    };";
+    return out.str();
+}
+
+std::string checkCorrection(const CorrectionInput& input)
+{
+    using robotics::CorrectionSchedule;
+    bool increasing = true;
+    for (std::size_t k = 0; k + 1 < input.corrections.size(); ++k) {
+        increasing = increasing && input.corrections[k].time_stamp < input.corrections[k + 1].time_stamp;
+    }
+    robotics::ThreadPool pool(3);
+    if (!increasing) {
+        std::vector<TimedPose> poses = input.poses;
+        std::list<TimedPose> as_list(poses.begin(), poses.end());
+        robotics::TrajectoryStore store(poses, input.chunk_size);
+        robotics::TrajectoryStore::Transaction transaction = store.begin();
+        const std::vector<std::pair<std::string, std::function<int()>>> calls = {
+            { "vector", [&] { robotics::propagateCorrections(poses, input.corrections); return 0; } },
+            { "vector (pool)", [&] { robotics::propagateCorrections(poses, input.corrections, pool); return 0; } },
+            { "list", [&] { robotics::propagateCorrections(as_list, input.corrections); return 0; } },
+            { "store", [&] { return static_cast<int>(robotics::propagateCorrections(transaction, input.corrections,
+                                 pool)); } },
+        };
+        for (const auto& [name, call] : calls) {
+            if (capture(call).error != "invalid_argument") {
+                return name + " should reject non-increasing correction timestamps";
+            }
+        }
+        return {};
+    }
+
+    // 参考：逐个位姿求 C(t)（时间截断到关键帧范围）后左乘
+    double first = input.corrections.front().time_stamp, last = input.corrections.back().time_stamp;
+    std::vector<TimedPose> expected = input.poses;
+    for (TimedPose& p : expected) {
+        p.pose = robotics::interpolateTimedPose(input.corrections, std::clamp(p.time_stamp, first, last)).pose
+            * p.pose;
+    }
+    auto compare = [&](const std::string& name, const std::vector<TimedPose>& actual) -> std::string {
+        if (actual.size() != expected.size()) {
+            return name + " changed the number of poses";
+        }
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            if (actual[i].time_stamp != input.poses[i].time_stamp) {
+                return name + " changed the time stamp of pose " + std::to_string(i);
+            }
+            double tol = 1e-11 * (1.0 + expected[i].pose.position.norm());
+            std::string diff = comparePose(expected[i].pose, actual[i].pose, tol);
+            if (!diff.empty()) {
+                return "per-pose reference vs " + name + " at pose " + std::to_string(i) + ": " + diff;
+            }
+        }
+        return {};
+    };
+
+    CorrectionSchedule schedule(input.corrections);
+    for (const auto& variant : robotics::kernels::correct_poses_kernel.supportedVariants()) {
+        std::vector<TimedPose> poses = input.poses;
+        schedule.apply(poses.data(), poses.size(), variant.function);
+        std::string diff = compare(std::string("correct_poses ") + robotics::isaName(variant.isa), poses);
+        if (!diff.empty()) {
+            return diff;
+        }
+    }
+
+    std::vector<TimedPose> serial = input.poses;
+    robotics::propagateCorrections(serial, input.corrections);
+    std::vector<TimedPose> parallel = input.poses;
+    robotics::propagateCorrections(parallel, input.corrections, pool);
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        if (comparePose(serial[i].pose, parallel[i].pose, 0.0) != "") {
+            return "propagateCorrections with 3 threads differs from serial at pose " + std::to_string(i);
+        }
+    }
+
+    std::list<TimedPose> as_list(input.poses.begin(), input.poses.end());
+    robotics::propagateCorrections(as_list, input.corrections);
+    std::string diff = compare("std::list", std::vector<TimedPose>(as_list.begin(), as_list.end()));
+    if (!diff.empty()) {
+        return diff;
+    }
+    std::map<double, TimedPose> as_map;
+    for (const TimedPose& p : input.poses) {
+        as_map.emplace(p.time_stamp, p);
+    }
+    if (as_map.size() == input.poses.size()) { // 时间戳重复时 map 会丢掉位姿，无法逐个对应
+        robotics::propagateCorrections(as_map, input.corrections);
+        std::vector<TimedPose> from_map;
+        for (const auto& [time, pose] : as_map) {
+            from_map.push_back(pose);
+        }
+        diff = compare("std::map", from_map);
+        if (!diff.empty()) {
+            return diff;
+        }
+    }
+
+    // 存储：结果一致，只落在单位修正区间内的块仍与旧版本共享
+    robotics::TrajectoryStore store(input.poses, input.chunk_size);
+    robotics::TrajectoryStore::Snapshot before = store.snapshot();
+    robotics::TrajectoryStore::Transaction transaction = store.begin();
+    std::size_t rewritten = robotics::propagateCorrections(transaction, input.corrections, pool);
+    transaction.commit();
+    robotics::TrajectoryStore::Snapshot after = store.snapshot();
+    diff = compare("TrajectoryStore", after.toVector());
+    if (!diff.empty()) {
+        return diff;
+    }
+    std::size_t shared = 0;
+    for (std::size_t c = 0; c < before.chunkCount(); ++c) {
+        std::span<const TimedPose> chunk = before.chunk(c);
+        bool all_identity = std::all_of(chunk.begin(), chunk.end(), [&](const TimedPose& p) {
+            return schedule.segments()[schedule.segmentFor(p.time_stamp)].identity;
+        });
+        if (all_identity != after.sharesChunk(before, c)) {
+            return "chunk " + std::to_string(c) + (all_identity ? " only has identity corrections but was copied"
+                                                                : " needs a correction but is still shared");
+        }
+        shared += all_identity ? 1 : 0;
+    }
+    if (rewritten != before.chunkCount() - shared) {
+        return "propagateCorrections(transaction) reported " + std::to_string(rewritten) + " rewritten chunks";
+    }
+
+    // keyframeCorrections：C_k T_k = T_k'，未改变的关键帧给出严格的单位修正
+    std::vector<Pose> optimized;
+    for (std::size_t k = 0; k < input.poses.size(); ++k) {
+        optimized.push_back(k % 2 == 0 ? input.poses[k].pose : input.corrections[k % input.corrections.size()].pose
+                * input.poses[k].pose);
+    }
+    std::vector<TimedPose> corrections = robotics::keyframeCorrections(input.poses, optimized);
+    for (std::size_t k = 0; k < corrections.size(); ++k) {
+        const Pose& c = corrections[k].pose;
+        if (k % 2 == 0 && comparePose(c, Pose {}, 0.0) != "") {
+            return "keyframeCorrections of an unchanged keyframe " + std::to_string(k) + " is not the identity";
+        }
+        std::string d = comparePose(optimized[k], c * input.poses[k].pose,
+            1e-12 * (1.0 + optimized[k].position.norm() + input.poses[k].pose.position.norm()));
+        if (!d.empty()) {
+            return "keyframeCorrections " + std::to_string(k) + ": C * before vs after: " + d;
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// interpolation cache：经缓存的查询与在当前轨迹上、量化时间处直接插值逐位一致，提交之后也一样
+// ---------------------------------------------------------------------------
+
+struct CacheOperation {
+    bool is_commit { false };
+    double time { 0.0 }; // 查询
+    StoreTransaction transaction; // 提交（或放弃）
+};
+
+struct InterpolationCacheInput {
+    std::vector<TimedPose> initial;
+    std::vector<TimedPose> later; // 时间戳都不早于 initial 的最后一个
+    std::size_t chunk_size { 1 };
+    robotics::InterpolationCacheOptions options;
+    std::vector<CacheOperation> operations;
+};
+
+InterpolationCacheInput generateInterpolationCache(WorkloadRng& rng, int size)
+{
+    InterpolationCacheInput input;
+    robotics::workload::JerkyTrajectoryOptions options;
+    options.count = 2 + rng.index(static_cast<std::size_t>(2 * size) + 1);
+    options.rate_hz = rng.uniform(10.0, 1000.0);
+    options.start_time = rng.uniform(-100.0, 1e5);
+    options.timestamp_jitter = rng.uniform() < 0.5 ? 0.0 : 0.2 / options.rate_hz;
+    options.seed = rng.next();
+    std::vector<TimedPose> poses = rng.uniform() < 0.5 ? robotics::workload::smoothTrajectory(options)
+                                                       : robotics::workload::jerkyTrajectory(options);
+    std::size_t split = rng.uniform() < 0.1 ? 0 : rng.index(poses.size() + 1);
+    input.initial.assign(poses.begin(), poses.begin() + static_cast<std::ptrdiff_t>(split));
+    input.later.assign(poses.begin() + static_cast<std::ptrdiff_t>(split), poses.end());
+    input.chunk_size = std::size_t { 1 } << rng.index(5);
+
+    // 很小的槽位表和桶表，让冲突、覆盖和整表失效都经常发生
+    input.options.resolution = rng.uniform(0.01, 2.0) / options.rate_hz;
+    input.options.capacity = 1 + rng.index(64);
+    input.options.invalidation_granularity = input.options.resolution * std::pow(10.0, rng.uniform(0.0, 3.0));
+    input.options.invalidation_buckets = 1 + rng.index(8);
+
+    // 查询集中在少数几个时刻附近（抖动小于半个量化步长），重复的查询才会命中
+    double t0 = poses.front().time_stamp, t1 = poses.back().time_stamp;
+    std::vector<double> hot;
+    for (std::size_t k = 1 + rng.index(6); k > 0; --k) {
+        hot.push_back(rng.uniform() < 0.2 ? poses[rng.index(poses.size())].time_stamp
+                                          : rng.uniform(t0 - 0.05 * (t1 - t0), t1 + 0.01 * (t1 - t0)));
+    }
+    std::size_t remaining = input.later.size();
+    for (std::size_t k = 1 + rng.index(static_cast<std::size_t>(2 * size)); k > 0; --k) {
+        CacheOperation operation;
+        if (rng.uniform() < 0.15) {
+            operation.is_commit = true;
+            operation.transaction.appends = rng.index(remaining + 1);
+            remaining -= operation.transaction.appends;
+            for (std::size_t e = rng.index(3); e > 0; --e) {
+                Pose correction { rng.normalVector(0.5), randomQuaternion(rng) };
+                operation.transaction.edits.push_back({ rng.index(1000000), correction });
+            }
+            operation.transaction.commit = rng.uniform() < 0.85;
+        } else {
+            operation.time = hot[rng.index(hot.size())] + rng.uniform(-0.45, 0.45) * input.options.resolution;
+        }
+        input.operations.push_back(std::move(operation));
+    }
+    return input;
+}
+
+std::vector<InterpolationCacheInput> shrinkInterpolationCache(const InterpolationCacheInput& input)
+{
+    std::vector<InterpolationCacheInput> candidates;
+    for (std::size_t k = 0; k < input.operations.size(); ++k) {
+        InterpolationCacheInput fewer = input;
+        fewer.operations.erase(fewer.operations.begin() + static_cast<std::ptrdiff_t>(k));
+        candidates.push_back(std::move(fewer));
+    }
+    if (input.options.capacity > 1) {
+        InterpolationCacheInput smaller = input;
+        smaller.options.capacity = 1;
+        candidates.push_back(std::move(smaller));
+    }
+    if (input.options.invalidation_buckets > 1) {
+        InterpolationCacheInput smaller = input;
+        smaller.options.invalidation_buckets = 1;
+        candidates.push_back(std::move(smaller));
+    }
+    if (input.chunk_size > 1) {
+        InterpolationCacheInput smaller = input;
+        smaller.chunk_size /= 2;
+        candidates.push_back(std::move(smaller));
+    }
+    if (!input.initial.empty()) {
+        InterpolationCacheInput shorter = input;
+        shorter.initial.pop_back();
+        candidates.push_back(std::move(shorter));
+    }
+    return candidates;
+}
+
+std::string describeInterpolationCache(const InterpolationCacheInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    chunk_size = " << input.chunk_size << ", " << input.initial.size() << " initial poses, "
+        << input.later.size() << " later poses\n";
+    out << "    resolution = " << input.options.resolution << ", capacity = " << input.options.capacity
+        << ", granularity = " << input.options.invalidation_granularity
+        << ", buckets = " << input.options.invalidation_buckets << "\n";
+    for (const CacheOperation& operation : input.operations) {
+        if (!operation.is_commit) {
+            out << "    query " << operation.time << "\n";
+            continue;
+        }
+        out << "    transaction: append " << operation.transaction.appends << ", edit {";
+        for (const auto& [index, correction] : operation.transaction.edits) {
+            out << " " << index;
+        }
+        out << " }, " << (operation.transaction.commit ? "commit" : "abort") << "\n";
+    }
+    return out.str();
+}
+
+std::string checkInterpolationCache(const InterpolationCacheInput& input)
+{
+    using robotics::TrajectoryStore;
+    auto same = [](const TimedPose& a, const TimedPose& b) {
+        return a.time_stamp == b.time_stamp ? comparePose(a.pose, b.pose, 0.0) : std::string("time_stamp differs");
+    };
+
+    TrajectoryStore store(input.initial, input.chunk_size);
+    robotics::CachedTrajectory cached(store, input.options);
+    std::vector<TimedPose> model = input.initial;
+    std::size_t next_later = 0;
+    for (std::size_t k = 0; k < input.operations.size(); ++k) {
+        const CacheOperation& operation = input.operations[k];
+        if (operation.is_commit) {
+            const StoreTransaction& transaction = operation.transaction;
+            std::vector<TimedPose> edited = model;
+            TrajectoryStore::Transaction writer = store.begin();
+            for (const auto& [index, correction] : transaction.edits) {
+                if (!edited.empty()) {
+                    std::size_t i = index % edited.size();
+                    edited[i].pose = correction * edited[i].pose;
+                    writer.at(i).pose = correction * writer[i].pose;
+                }
+            }
+            for (std::size_t a = 0; a < transaction.appends; ++a) {
+                edited.push_back(input.later[next_later]);
+                writer.append(input.later[next_later++]);
+            }
+            if (transaction.commit) {
+                cached.commit(writer);
+                model = std::move(edited);
+            } else {
+                next_later -= transaction.appends;
+            }
+            continue;
+        }
+
+        // 参考：量化时间落在轨迹范围内时在量化时间上插值，否则在原时间上插值
+        double time = operation.time;
+        double quantized = static_cast<double>(std::llround(time / input.options.resolution))
+            * input.options.resolution;
+        bool in_range = !model.empty() && quantized >= model.front().time_stamp
+            && quantized <= model.back().time_stamp;
+        auto expected = capture([&] { return robotics::interpolateTimedPose(model, in_range ? quantized : time); });
+        // 连续查询两次：第二次在范围内必须命中缓存，且结果相同
+        for (int repeat = 0; repeat < 2; ++repeat) {
+            bool hit = false;
+            std::string diff = compareOutcome("interpolateTimedPose", expected, "CachedTrajectory::interpolate",
+                capture([&] { return cached.interpolate(time, &hit); }), same);
+            if (!diff.empty()) {
+                return "operation " + std::to_string(k) + (repeat == 0 ? "" : " (repeated)") + ": " + diff;
+            }
+            if (repeat == 1 && in_range && !hit) {
+                return "operation " + std::to_string(k) + ": repeated query missed the cache";
+            }
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// time bucket index：增量建立的分桶索引与 findSegmentIndex 的二分查找逐位一致
+// ---------------------------------------------------------------------------
+
+struct TimeBucketInput {
+    std::vector<TimedPose> poses;
+    double period { 1.0 };
+    std::vector<std::size_t> extends; // 每次 extend 之前追加的位姿数
+    std::vector<double> queries;
+};
+
+TimeBucketInput generateTimeBucket(WorkloadRng& rng, int size)
+{
+    TimeBucketInput input;
+    robotics::workload::JerkyTrajectoryOptions options;
+    options.count = 1 + rng.index(static_cast<std::size_t>(4 * size) + 1);
+    options.rate_hz = rng.uniform(10.0, 1000.0);
+    options.start_time = rng.uniform(-100.0, 1e6);
+    options.timestamp_jitter = rng.uniform() < 0.5 ? 0.0 : 0.3 / options.rate_hz;
+    options.gap_probability = rng.uniform() < 0.5 ? 0.0 : 0.3;
+    options.seed = rng.next();
+    input.poses = robotics::workload::smoothTrajectory(options);
+    // 突发：重复的时间戳和密集的一簇采样；离群：一段很长的间隙
+    for (std::size_t k = rng.index(3); k > 0; --k) {
+        std::size_t at = rng.index(input.poses.size());
+        std::size_t burst = 1 + rng.index(20);
+        double step = rng.uniform() < 0.5 ? 0.0 : rng.uniform(0.0, 0.05) / options.rate_hz;
+        std::vector<TimedPose> extra(burst, input.poses[at]);
+        for (std::size_t e = 0; e < burst; ++e) {
+            extra[e].time_stamp += step * static_cast<double>(e);
+        }
+        input.poses.insert(input.poses.begin() + static_cast<std::ptrdiff_t>(at), extra.begin(), extra.end());
+        std::sort(input.poses.begin(), input.poses.end(),
+            [](const TimedPose& a, const TimedPose& b) { return a.time_stamp < b.time_stamp; });
+    }
+    if (input.poses.size() > 2 && rng.uniform() < 0.2) {
+        double gap = rng.uniform(10.0, 1e4) / options.rate_hz;
+        for (std::size_t i = 1 + rng.index(input.poses.size() - 1); i < input.poses.size(); ++i) {
+            input.poses[i].time_stamp += gap;
+        }
+    }
+    // 桶宽在标称周期的 1/30 到 30 倍之间
+    input.period = std::pow(10.0, rng.uniform(-1.5, 1.5)) / options.rate_hz;
+    for (std::size_t remaining = input.poses.size(); remaining > 0;) {
+        std::size_t n = 1 + rng.index(std::min<std::size_t>(remaining, 1 + static_cast<std::size_t>(size)));
+        input.extends.push_back(n);
+        remaining -= n;
+    }
+
+    double t0 = input.poses.front().time_stamp, t1 = input.poses.back().time_stamp;
+    double margin = 0.05 * (t1 - t0) + 1e-3;
+    for (std::size_t k = 1 + rng.index(static_cast<std::size_t>(size)); k > 0; --k) {
+        input.queries.push_back(rng.uniform() < 0.3 ? input.poses[rng.index(input.poses.size())].time_stamp
+                                                    : rng.uniform(t0 - margin, t1 + margin));
+    }
+    return input;
+}
+
+std::vector<TimeBucketInput> shrinkTimeBucket(const TimeBucketInput& input)
+{
+    std::vector<TimeBucketInput> candidates;
+    if (input.queries.size() > 1) {
+        for (double t : input.queries) {
+            TimeBucketInput one = input;
+            one.queries = { t };
+            candidates.push_back(std::move(one));
+        }
+    }
+    if (input.extends.size() > 1) {
+        TimeBucketInput once = input;
+        once.extends = { input.poses.size() };
+        candidates.push_back(std::move(once));
+    }
+    if (input.poses.size() > 1) {
+        for (bool front : { true, false }) {
+            TimeBucketInput shorter = input;
+            shorter.poses.erase(front ? shorter.poses.begin() : shorter.poses.end() - 1);
+            shorter.extends = { shorter.poses.size() };
+            candidates.push_back(std::move(shorter));
+        }
+    }
+    return candidates;
+}
+
+std::string describeTimeBucket(const TimeBucketInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    std::vector<double> times;
+    for (const TimedPose& pose : input.poses) {
+        times.push_back(pose.time_stamp);
+    }
+    out << "    times = " << formatVector(times) << "\n";
+    out << "    period = " << input.period << ", extends = {";
+    for (std::size_t n : input.extends) {
+        out << " " << n;
+    }
+    out << " }\n    queries = " << formatVector(input.queries);
+    return out.str();
+}
+
+std::string checkTimeBucket(const TimeBucketInput& input)
+{
+    auto same_index = [](std::size_t a, std::size_t b) {
+        return a == b ? std::string() : std::to_string(a) + " vs " + std::to_string(b);
+    };
+    robotics::TimeBucketIndex index(input.period);
+    std::vector<TimedPose> poses;
+    for (std::size_t n : input.extends) {
+        poses.insert(poses.end(), input.poses.begin() + static_cast<std::ptrdiff_t>(poses.size()),
+            input.poses.begin() + static_cast<std::ptrdiff_t>(poses.size() + n));
+        // 追加之后、extend 之前的索引已过期
+        if (capture([&] { return index.findSegmentIndex(poses, poses.back().time_stamp); }).error
+            != "invalid_argument") {
+            return "lookup on an out-of-date index did not throw invalid_argument";
+        }
+        index.extend(poses);
+        double limit = static_cast<double>(robotics::TimeBucketIndex::kMinBuckets
+            + robotics::TimeBucketIndex::kBucketsPerPose * poses.size());
+        if (static_cast<double>(index.bucketCount()) > limit) {
+            return std::to_string(index.bucketCount()) + " buckets for " + std::to_string(poses.size()) + " poses";
+        }
+        for (double t : input.queries) {
+            std::string diff = compareOutcome("findSegmentIndex",
+                capture([&] { return robotics::findSegmentIndex(poses, t); }), "TimeBucketIndex",
+                capture([&] { return index.findSegmentIndex(poses, t); }), same_index);
+            if (diff.empty()) {
+                diff = compareOutcome("interpolateTimedPose",
+                    capture([&] { return robotics::interpolateTimedPose(poses, t); }), "indexed interpolateTimedPose",
+                    capture([&] { return robotics::interpolateTimedPose(poses, index, t); }),
+                    [](const TimedPose& a, const TimedPose& b) { return comparePose(a.pose, b.pose, 0.0); });
+            }
+            if (!diff.empty()) {
+                std::ostringstream where;
+                where.precision(17);
+                where << "after indexing " << poses.size() << " poses, t = " << t << ": ";
+                return where.str() + diff;
+            }
+        }
+    }
+    std::vector<TimedPose> unsorted = poses;
+    unsorted.push_back(poses.front());
+    unsorted.back().time_stamp = std::nextafter(poses.back().time_stamp, -1e300);
+    if (unsorted.back().time_stamp < poses.back().time_stamp
+        && capture([&] {
+               index.extend(unsorted);
+               return 0;
+           }).error
+            != "invalid_argument") {
+        return "extend() accepted an unsorted timestamp";
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// 旋转表示的批量转换内核：各实现与标量参考比较，参考实现自身做往返检查
+// ---------------------------------------------------------------------------
+
+struct RotationInput {
+    std::vector<Quaternion> rotations;
+    std::vector<Vector3> rotation_vectors;
+    std::vector<Vector3> euler; // (roll, pitch, yaw)
+    std::vector<robotics::RotationMatrix> matrices; // 由 rotations 得到，部分对角元被改成与迹或其他对角元相等
+};
+
+RotationInput generateRotation(WorkloadRng& rng, int size)
+{
+    RotationInput input;
+    std::size_t n = rng.index(static_cast<std::size_t>(size) * 4 + 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        Quaternion q = randomQuaternion(rng);
+        switch (rng.index(6)) {
+        case 1: // 接近单位旋转
+            q = Quaternion::fromRotationVector(rng.normalVector(std::pow(10.0, rng.uniform(-12.0, -4.0))));
+            break;
+        case 2: // 接近 180°，w 很小，符号随机
+            q = Quaternion::fromRotationVector(randomQuaternion(rng).rotate({ 1.0, 0.0, 0.0 })
+                * (M_PI - std::pow(10.0, rng.uniform(-12.0, -2.0))));
+            break;
+        case 3: // 万向节锁附近
+            q = Quaternion::fromEuler(rng.uniform(-M_PI, M_PI),
+                (rng.uniform() < 0.5 ? -1.0 : 1.0) * (M_PI / 2 - std::pow(10.0, rng.uniform(-12.0, -2.0))),
+                rng.uniform(-M_PI, M_PI));
+            break;
+        case 4: { // 绕坐标轴 90° / 180° 等：矩阵的对角元并列；最后一个恰在万向节锁上，欧拉角公式出现 atan2(0, 0)
+            static const Quaternion axis_aligned[] = { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0, 0.0 },
+                { 0.0, 0.0, 1.0, 0.0 }, { 0.0, 0.0, 0.0, 1.0 }, { M_SQRT1_2, M_SQRT1_2, 0.0, 0.0 },
+                { M_SQRT1_2, 0.0, -M_SQRT1_2, 0.0 }, { 0.0, M_SQRT1_2, M_SQRT1_2, 0.0 }, { 0.5, 0.5, 0.5, 0.5 },
+                { 0.5, -0.5, 0.5, 0.5 } };
+            q = axis_aligned[rng.index(std::size(axis_aligned))];
+            break;
+        }
+        default:
+            break;
+        }
+        if (rng.uniform() < 0.5) {
+            q = q * -1.0;
+        }
+        input.rotations.push_back(q);
+
+        robotics::RotationMatrix r(q);
+        switch (rng.index(8)) {
+        case 0:
+            r.m[4] = r.m[0];
+            break;
+        case 1:
+            r.m[8] = r.m[4];
+            break;
+        case 2:
+            r.m[8] = -r.m[4]; // 迹通常恰好等于 m00
+            break;
+        default:
+            break;
+        }
+        input.matrices.push_back(r);
+
+        double magnitude = rng.uniform() < 0.05 ? 0.0 : std::pow(10.0, rng.uniform(-12.0, 1.3));
+        input.rotation_vectors.push_back(randomQuaternion(rng).rotate({ magnitude, 0.0, 0.0 }));
+
+        double pitch = rng.uniform() < 0.1 ? (rng.uniform() < 0.5 ? -M_PI / 2 : M_PI / 2)
+                                           : rng.uniform(-M_PI / 2, M_PI / 2);
+        double range = rng.uniform() < 0.1 ? 10.0 : M_PI;
+        input.euler.push_back({ rng.uniform(-range, range), pitch, rng.uniform(-range, range) });
+    }
+    return input;
+}
+
+std::vector<RotationInput> shrinkRotation(const RotationInput& input)
+{
+    std::vector<RotationInput> candidates;
+    for (std::size_t i = 0; i < input.rotations.size(); ++i) {
+        RotationInput smaller = input;
+        smaller.rotations.erase(smaller.rotations.begin() + static_cast<std::ptrdiff_t>(i));
+        smaller.rotation_vectors.erase(smaller.rotation_vectors.begin() + static_cast<std::ptrdiff_t>(i));
+        smaller.euler.erase(smaller.euler.begin() + static_cast<std::ptrdiff_t>(i));
+        smaller.matrices.erase(smaller.matrices.begin() + static_cast<std::ptrdiff_t>(i));
+        candidates.push_back(std::move(smaller));
+    }
+    return candidates;
+}
+
+std::string describeRotation(const RotationInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    rotations = {";
+    for (const Quaternion& q : input.rotations) {
+        out << " { " << q.w << ", " << q.x << ", " << q.y << ", " << q.z << " }";
+    }
+    out << " }\n    rotation vectors = {";
+    for (const Vector3& v : input.rotation_vectors) {
+        out << " { " << v.x << ", " << v.y << ", " << v.z << " }";
+    }
+    out << " }\n    euler = {";
+    for (const Vector3& e : input.euler) {
+        out << " { " << e.x << ", " << e.y << ", " << e.z << " }";
+    }
+    out << " }\n    matrices = {";
+    for (const robotics::RotationMatrix& r : input.matrices) {
+        std::vector<double> elements(r.m.begin(), r.m.end());
+        out << " " << formatVector(elements);
+    }
+    out << " }";
+    return out.str();
+}
+
+/**
+ * @brief 两组 SoA 数据逐元素比较，第 k 个分量的第 i 个元素误差超过 tol(k, i) × max(1, |参考值|) 时返回描述
+ */
+std::string compareComponents(const std::string& what, const std::vector<const std::vector<double>*>& expected,
+    const std::vector<const std::vector<double>*>& actual, const std::function<double(std::size_t, std::size_t)>& tol)
+{
+    for (std::size_t k = 0; k < expected.size(); ++k) {
+        for (std::size_t i = 0; i < expected[k]->size(); ++i) {
+            double a = (*expected[k])[i], b = (*actual[k])[i];
+            if (!(std::fabs(a - b) <= tol(k, i) * std::max(1.0, std::fabs(a)))) {
+                std::ostringstream out;
+                out.precision(17);
+                out << what << ", element " << i << " component " << k << ": " << a << " vs " << b;
+                return out.str();
+            }
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief q 与 ±reference 的最大分量误差（q 与 -q 表示同一旋转）
+ */
+double rotationDistance(const Quaternion& q, const Quaternion& reference)
+{
+    auto max_diff = [&](double sign) {
+        return std::max({ std::fabs(q.w - sign * reference.w), std::fabs(q.x - sign * reference.x),
+            std::fabs(q.y - sign * reference.y), std::fabs(q.z - sign * reference.z) });
+    };
+    return std::min(max_diff(1.0), max_diff(-1.0));
+}
+
+std::string checkRotation(const RotationInput& input)
+{
+    namespace k = robotics::kernels;
+    using robotics::RotationMatrix;
+    std::ostringstream out;
+    out.precision(17);
+
+    // 参考实现：与 Quaternion::rotate 一致，矩阵 → 四元数和三种往返在舍入误差内还原
+    for (std::size_t i = 0; i < input.rotations.size(); ++i) {
+        const Quaternion& q = input.rotations[i];
+        RotationMatrix r(q);
+        Vector3 probe { 0.3, -1.7, 2.9 };
+        Quaternion from_matrix = r.toQuaternion();
+        Quaternion from_log = Quaternion::fromRotationVector(q.toRotationVector());
+        Vector3 euler = q.toEuler();
+        Quaternion from_euler = Quaternion::fromEuler(euler.x, euler.y, euler.z);
+        if ((r * probe - q.rotate(probe)).norm() > 1e-14 || (r.transpose() * (r * probe) - probe).norm() > 1e-14
+            || rotationDistance(from_matrix, q) > 1e-15 || from_matrix.w < 0.0
+            || rotationDistance(from_log, q) > 1e-14 || rotationDistance(from_euler, q) > 1e-14
+            || std::fabs(euler.y) > M_PI / 2 || std::fabs(euler.x) > M_PI || std::fabs(euler.z) > M_PI) {
+            out << "round trip of rotation " << i << " { " << q.w << ", " << q.x << ", " << q.y << ", " << q.z
+                << " }: matrix -> { " << from_matrix.w << ", " << from_matrix.x << ", " << from_matrix.y << ", "
+                << from_matrix.z << " }, log -> { " << from_log.w << ", " << from_log.x << ", " << from_log.y
+                << ", " << from_log.z << " }, euler (" << euler.x << ", " << euler.y << ", " << euler.z
+                << ") -> { " << from_euler.w << ", " << from_euler.x << ", " << from_euler.y << ", " << from_euler.z
+                << " }";
+            return out.str();
+        }
+        if (i > 0) {
+            const Quaternion& p = input.rotations[i - 1];
+            RotationMatrix product = RotationMatrix(p) * r, composed(p * q);
+            for (int e = 0; e < 9; ++e) {
+                if (std::fabs(product.m[e] - composed.m[e]) > 1e-14) {
+                    out << "R(p) * R(q) differs from R(p * q) at element " << e << " for rotations " << i - 1
+                        << " and " << i;
+                    return out.str();
+                }
+            }
+        }
+    }
+    for (std::size_t i = 0; i < input.rotation_vectors.size(); ++i) {
+        const Vector3& v = input.rotation_vectors[i];
+        Vector3 back = Quaternion::fromRotationVector(v).toRotationVector();
+        if (v.norm() < 3.0 && (back - v).norm() > 1e-14 * std::max(1.0, v.norm())) {
+            out << "log(exp(v)) != v for v = { " << v.x << ", " << v.y << ", " << v.z << " }: { " << back.x << ", "
+                << back.y << ", " << back.z << " }";
+            return out.str();
+        }
+    }
+
+    const robotics::QuaternionSoA rotations(input.rotations);
+    const robotics::Vector3SoA rotation_vectors(input.rotation_vectors), euler(input.euler);
+    robotics::RotationMatrixSoA matrices;
+    matrices.resize(input.matrices.size());
+    for (std::size_t i = 0; i < input.matrices.size(); ++i) {
+        matrices.set(i, input.matrices[i]);
+    }
+    auto components = [](const auto& soa) {
+        std::vector<const std::vector<double>*> result;
+        if constexpr (std::is_same_v<std::decay_t<decltype(soa)>, robotics::QuaternionSoA>) {
+            result = { &soa.w, &soa.x, &soa.y, &soa.z };
+        } else if constexpr (std::is_same_v<std::decay_t<decltype(soa)>, robotics::Vector3SoA>) {
+            result = { &soa.x, &soa.y, &soa.z };
+        } else {
+            for (const auto& element : soa.m) {
+                result.push_back(&element);
+            }
+        }
+        return result;
+    };
+
+    // 每个内核：先跑标量参考，再把其余实现逐个与它比较。纯代数的两个内核要求逐位相同
+    auto check_kernel = [&](const auto& kernel, const auto& in, auto out,
+                            const std::function<double(std::size_t, std::size_t)>& tol) -> std::string {
+        auto run = [&](const auto& variant) {
+            decltype(out) result = out;
+            result.resize(in.size());
+            variant.function(in.data().data(), result.data().data(), in.size());
+            return result;
+        };
+        auto variants = kernel.supportedVariants();
+        decltype(out) reference = run(variants.front());
+        for (std::size_t v = 1; v < variants.size(); ++v) {
+            std::string diff = compareComponents(kernel.name() + " scalar vs " + robotics::isaName(variants[v].isa),
+                components(reference), components(run(variants[v])), tol);
+            if (!diff.empty()) {
+                return diff;
+            }
+        }
+        return {};
+    };
+    auto exact = [](std::size_t, std::size_t) { return 0.0; };
+    auto ulps = [](std::size_t, std::size_t) { return 1e-15; };
+    std::vector<double> pitch;
+    for (const Quaternion& q : input.rotations) {
+        pitch.push_back(q.toEuler().y);
+    }
+    // 万向节锁附近 roll、yaw 各自不确定（只有和或差确定），误差按 1/cos(pitch) 放大
+    auto euler_tol = [&](std::size_t component, std::size_t i) {
+        return component == 1 ? 1e-15 : 1e-15 + 4e-15 / std::max(std::cos(pitch[i]), 1e-300);
+    };
+    std::string diff = check_kernel(k::quaternion_to_matrix_kernel, rotations, robotics::RotationMatrixSoA {}, exact);
+    if (diff.empty()) {
+        diff = check_kernel(k::matrix_to_quaternion_kernel, matrices, robotics::QuaternionSoA {}, exact);
+    }
+    if (diff.empty()) {
+        // 角度本身的舍入误差与 |v| 成正比
+        diff = check_kernel(k::rotation_vector_to_quaternion_kernel, rotation_vectors, robotics::QuaternionSoA {},
+            [&](std::size_t, std::size_t i) { return 1e-15 * std::max(1.0, input.rotation_vectors[i].norm()); });
+    }
+    if (diff.empty()) {
+        diff = check_kernel(k::quaternion_to_rotation_vector_kernel, rotations, robotics::Vector3SoA {}, ulps);
+    }
+    if (diff.empty()) {
+        diff = check_kernel(k::euler_to_quaternion_kernel, euler, robotics::QuaternionSoA {}, ulps);
+    }
+    if (diff.empty()) {
+        diff = check_kernel(k::quaternion_to_euler_kernel, rotations, robotics::Vector3SoA {}, euler_tol);
+    }
+    return diff;
+}
+
+// ---------------------------------------------------------------------------
+// 对偶四元数：与 Pose 的运算一致，ScLERP 与 SE(3) 测地线一致，DLB 的性质，去畸变内核各实现与标量比较
+// ---------------------------------------------------------------------------
+
+struct DualQuaternionInput {
+    robotics::Pose a;
+    robotics::Pose b;
+    std::vector<double> factors;
+    std::vector<Vector3> points;
+};
+
+DualQuaternionInput generateDualQuaternion(WorkloadRng& rng, int size)
+{
+    DualQuaternionInput input;
+    input.a = { rng.normalVector(std::pow(10.0, rng.uniform(-3.0, 2.0))), randomQuaternion(rng) };
+    Vector3 axis = randomQuaternion(rng).rotate({ 1.0, 0.0, 0.0 });
+    Quaternion rotation;
+    switch (rng.index(5)) {
+    case 0: // 纯平移
+        break;
+    case 1: // 转角很小
+        rotation = Quaternion::fromRotationVector(axis * std::pow(10.0, rng.uniform(-12.0, -3.0)));
+        break;
+    case 2: // 接近 180°
+        rotation = Quaternion::fromRotationVector(axis * (M_PI - std::pow(10.0, rng.uniform(-8.0, -1.0))));
+        break;
+    default:
+        rotation = randomQuaternion(rng);
+        break;
+    }
+    double distance = rng.uniform() < 0.1 ? 0.0 : std::pow(10.0, rng.uniform(-3.0, 2.0));
+    Vector3 translation = rng.uniform() < 0.2 ? axis * distance // 沿转轴：纯螺旋
+                                              : randomQuaternion(rng).rotate({ distance, 0.0, 0.0 });
+    input.b = input.a * robotics::Pose { translation, rotation };
+    if (rng.uniform() < 0.5) {
+        input.b.orientation = input.b.orientation * -1.0;
+    }
+
+    std::size_t n = rng.index(static_cast<std::size_t>(size) * 4 + 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        double u = rng.uniform();
+        input.factors.push_back(u < 0.1 ? 0.0 : u < 0.2 ? 1.0 : rng.uniform(-0.2, 1.2));
+        input.points.push_back(rng.normalVector(std::pow(10.0, rng.uniform(-2.0, 2.0))));
+    }
+    return input;
+}
+
+std::vector<DualQuaternionInput> shrinkDualQuaternion(const DualQuaternionInput& input)
+{
+    std::vector<DualQuaternionInput> candidates;
+    for (std::size_t i = 0; i < input.factors.size(); ++i) {
+        DualQuaternionInput smaller = input;
+        smaller.factors.erase(smaller.factors.begin() + static_cast<std::ptrdiff_t>(i));
+        smaller.points.erase(smaller.points.begin() + static_cast<std::ptrdiff_t>(i));
+        candidates.push_back(std::move(smaller));
+    }
+    return candidates;
+}
+
+std::string describeDualQuaternion(const DualQuaternionInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    a = " << formatPose(input.a) << "\n    b = " << formatPose(input.b) << "\n    factors = "
+        << formatVector(input.factors) << "\n    points = {";
+    for (const Vector3& p : input.points) {
+        out << " { " << p.x << ", " << p.y << ", " << p.z << " }";
+    }
+    out << " }";
+    return out.str();
+}
+
+/**
+ * @brief 位置与姿态分别给容差的 comparePose：平移的舍入误差与参与运算的位置的模长成正比，不与各分量成正比
+ */
+std::string comparePoseWithin(const robotics::Pose& a, const robotics::Pose& b, double position_tol,
+    double rotation_tol)
+{
+    if (!((a.position - b.position).norm() <= position_tol)) {
+        return comparePose(a, b, 0.0);
+    }
+    return comparePose({ b.position, a.orientation }, b, rotation_tol);
+}
+
+std::string checkDualQuaternion(const DualQuaternionInput& input)
+{
+    namespace lie = robotics::lie;
+    using robotics::DualQuaternion;
+    using robotics::Pose;
+    const DualQuaternion a = DualQuaternion::fromPose(input.a), b = DualQuaternion::fromPose(input.b);
+    double scale = 1.0 + input.a.position.norm() + input.b.position.norm();
+
+    // 与 Pose 的运算一致
+    std::string diff = comparePoseWithin(a.toPose(), input.a, 1e-14 * scale, 1e-14);
+    if (diff.empty()) {
+        diff = comparePoseWithin((a * b).toPose(), input.a * input.b, 1e-13 * scale, 1e-13);
+    }
+    if (diff.empty()) {
+        diff = comparePoseWithin(a.conjugate().toPose(), input.a.inverse(), 1e-13 * scale, 1e-13);
+    }
+    if (!diff.empty()) {
+        return "dual quaternion vs Pose: " + diff;
+    }
+    for (const Vector3& p : input.points) {
+        if ((a.transformPoint(p) - input.a.transform(p)).norm() > 1e-14 * (scale + p.norm())) {
+            return "transformPoint differs from Pose::transform";
+        }
+    }
+
+    // ScLERP：端点精确，中间与 SE(3) 测地线 a · Exp(t · Log(a⁻¹ b)) 一致（lie.hpp 的雅可比在小角度下只有约 1e-11 的相对精度）
+    diff = comparePoseWithin(sclerp(a, b, 0.0).toPose(), input.a, 1e-13 * scale, 1e-13);
+    if (diff.empty()) {
+        diff = comparePoseWithin(sclerp(a, b, 1.0).toPose(), input.b, 1e-13 * scale, 1e-13);
+    }
+    if (!diff.empty()) {
+        return "sclerp endpoint: " + diff;
+    }
+    Pose relative = input.a.inverse() * input.b;
+    const Quaternion& delta = relative.orientation;
+    double angle = 2.0 * std::atan2(std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z),
+                             std::fabs(delta.w));
+    for (double t : input.factors) {
+        double clamped = std::clamp(t, 0.0, 1.0);
+        Pose result = sclerp(a, b, t).toPose();
+        if (angle < M_PI - 1e-6) { // 接近 180° 时两个方向的螺旋几乎一样短，Log 不唯一
+            Pose geodesic = input.a * lie::expSE3(lie::logSE3(relative) * clamped);
+            diff = comparePoseWithin(result, geodesic, 1e-9 * scale, 1e-13);
+            if (!diff.empty()) {
+                std::ostringstream out;
+                out.precision(17);
+                out << "sclerp vs SE(3) geodesic at t = " << t << ": " << diff;
+                return out.str();
+            }
+        }
+
+        // DLB：结果是单位对偶四元数，实部是两个姿态的 nlerp，两端的姿态相同时平移是线性插值
+        DualQuaternion blended = dlb(a, b, t);
+        const Quaternion& r = blended.real;
+        const Quaternion& d = blended.dual;
+        double norm = std::sqrt(r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
+        double orthogonality = r.w * d.w + r.x * d.x + r.y * d.y + r.z * d.z;
+        Quaternion q1 = input.a.orientation, q2 = input.b.orientation;
+        if (q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z < 0.0) {
+            q2 = q2 * -1.0;
+        }
+        Quaternion nlerp = q1 * (1.0 - clamped) + q2 * clamped;
+        nlerp.normalize();
+        if (std::fabs(norm - 1.0) > 1e-15 || std::fabs(orthogonality) > 1e-15 * scale
+            || quaternionDistance(r, nlerp) > 1e-15) {
+            std::ostringstream out;
+            out.precision(17);
+            out << "dlb at t = " << t << ": |real| = " << norm << ", real . dual = " << orthogonality
+                << ", distance to nlerp " << quaternionDistance(r, nlerp);
+            return out.str();
+        }
+        if (quaternionDistance(q1, q2) == 0.0) {
+            Vector3 lerp = input.a.position * (1.0 - clamped) + input.b.position * clamped;
+            if ((blended.translation() - lerp).norm() > 1e-14 * scale) {
+                return "dlb of a pure translation is not a linear interpolation";
+            }
+        }
+    }
+    diff = comparePoseWithin(dlb(a, b, 0.0).toPose(), input.a, 1e-13 * scale, 1e-13);
+    if (diff.empty()) {
+        diff = comparePoseWithin(dlb(a, b, 1.0).toPose(), input.b, 1e-13 * scale, 1e-13);
+    }
+    if (!diff.empty()) {
+        return "dlb endpoint: " + diff;
+    }
+
+    // 去畸变内核：每个实现与标量参考比较，原地变换与非原地结果逐位相同
+    const auto& kernel = robotics::kernels::deskew_points_kernel;
+    auto variants = kernel.supportedVariants();
+    std::size_t n = input.points.size();
+    std::vector<Vector3> reference(n);
+    variants.front().function(a, b, input.factors.data(), input.points.data(), reference.data(), n);
+    for (const auto& variant : variants) {
+        std::vector<Vector3> out(n), in_place = input.points;
+        variant.function(a, b, input.factors.data(), input.points.data(), out.data(), n);
+        variant.function(a, b, input.factors.data(), in_place.data(), in_place.data(), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            double error = (out[i] - reference[i]).norm();
+            if (!(error <= 1e-14 * (scale + input.points[i].norm())) || out[i].x != in_place[i].x
+                || out[i].y != in_place[i].y || out[i].z != in_place[i].z) {
+                std::ostringstream out_text;
+                out_text.precision(17);
+                out_text << kernel.name() << " scalar vs " << robotics::isaName(variant.isa) << ", point " << i
+                         << ": error " << error << (out[i].x != in_place[i].x ? " (in place differs)" : "");
+                return out_text.str();
+            }
+        }
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// 四元数归一化：参考实现的性质，批量内核各实现与标量比较（包括零和极小模长）
+// ---------------------------------------------------------------------------
+
+struct NormalizationInput {
+    std::vector<Quaternion> arbitrary; // 模长 0、1e-10 附近或 1e-12–1e15
+    std::vector<Quaternion> near_unit; // |q|² = 1 + δ，|δ| ≤ 1e-4
+};
+
+NormalizationInput generateNormalization(WorkloadRng& rng, int size)
+{
+    NormalizationInput input;
+    std::size_t n = rng.index(static_cast<std::size_t>(size) * 4 + 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        Quaternion direction = randomQuaternion(rng);
+        double u = rng.uniform();
+        if (u < 0.1) {
+            input.arbitrary.push_back({ rng.uniform() < 0.5 ? 0.0 : -0.0, 0.0, -0.0, 0.0 });
+        } else if (u < 0.3) { // 落在 normalize 的阈值 1e-10 两侧
+            input.arbitrary.push_back(direction * std::pow(10.0, rng.uniform(-10.5, -9.5)));
+        } else {
+            input.arbitrary.push_back(direction * std::pow(10.0, rng.uniform(-12.0, 15.0)));
+        }
+        double delta = (rng.uniform() < 0.5 ? -1.0 : 1.0) * std::pow(10.0, rng.uniform(-16.0, -4.0));
+        input.near_unit.push_back(randomQuaternion(rng) * std::sqrt(1.0 + delta));
+    }
+    return input;
+}
+
+std::vector<NormalizationInput> shrinkNormalization(const NormalizationInput& input)
+{
+    std::vector<NormalizationInput> candidates;
+    for (std::size_t i = 0; i < input.arbitrary.size(); ++i) {
+        NormalizationInput smaller = input;
+        smaller.arbitrary.erase(smaller.arbitrary.begin() + static_cast<std::ptrdiff_t>(i));
+        smaller.near_unit.erase(smaller.near_unit.begin() + static_cast<std::ptrdiff_t>(i));
+        candidates.push_back(std::move(smaller));
+    }
+    return candidates;
+}
+
+std::string describeNormalization(const NormalizationInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    arbitrary = {";
+    for (const Quaternion& q : input.arbitrary) {
+        out << " { " << q.w << ", " << q.x << ", " << q.y << ", " << q.z << " }";
+    }
+    out << " }\n    near unit = {";
+    for (const Quaternion& q : input.near_unit) {
+        out << " { " << q.w << ", " << q.x << ", " << q.y << ", " << q.z << " }";
+    }
+    out << " }";
+    return out.str();
+}
+
+std::string checkNormalization(const NormalizationInput& input)
+{
+    namespace k = robotics::kernels;
+    std::ostringstream out;
+    out.precision(17);
+    auto norm = [](const Quaternion& q) { return std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z); };
+    auto is_identity = [](const Quaternion& q) { return q.w == 1.0 && q.x == 0.0 && q.y == 0.0 && q.z == 0.0; };
+    auto max_diff = [](const Quaternion& a, const Quaternion& b) {
+        return std::max({ std::fabs(a.w - b.w), std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) });
+    };
+
+    // 参考实现：normalize 得到与 q 同向的单位四元数；renormalize 的残差不超过 δ²（一阶方法的截断）加舍入
+    for (std::size_t i = 0; i < input.arbitrary.size(); ++i) {
+        const Quaternion& q = input.arbitrary[i];
+        Quaternion unit = q;
+        unit.normalize();
+        double length = norm(q);
+        bool ok = length > 1e-10
+            ? std::fabs(norm(unit) - 1.0) <= 4e-16 && max_diff(unit * length, q) <= 1e-15 * length
+            : is_identity(unit);
+        if (!ok) {
+            out << "normalize of arbitrary " << i << ": { " << unit.w << ", " << unit.x << ", " << unit.y << ", "
+                << unit.z << " }";
+            return out.str();
+        }
+    }
+    for (std::size_t i = 0; i < input.near_unit.size(); ++i) {
+        const Quaternion& q = input.near_unit[i];
+        Quaternion fixed = q;
+        fixed.renormalize();
+        double delta = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z - 1.0;
+        if (!(std::fabs(norm(fixed) - 1.0) <= delta * delta + 4e-16)) {
+            out << "renormalize of near unit " << i << " (delta " << delta << "): ||q| - 1| = "
+                << std::fabs(norm(fixed) - 1.0);
+            return out.str();
+        }
+    }
+
+    // 各实现与标量参考比较。阈值 1e-10 上，标量比较开方后的模长，SIMD 比较模长平方，恰在边界上的几个 ulp 内允许不同
+    auto check_kernel = [&](const auto& kernel, const std::vector<Quaternion>& in) -> std::string {
+        auto variants = kernel.supportedVariants();
+        std::vector<Quaternion> reference = in;
+        variants.front().function(reference.data(), reference.size());
+        for (const auto& variant : variants) {
+            std::vector<Quaternion> result = in;
+            variant.function(result.data(), result.size());
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                const Quaternion &a = reference[i], &b = result[i];
+                bool on_threshold = std::fabs(norm(in[i]) / 1e-10 - 1.0) < 1e-14;
+                bool same = is_identity(a) == is_identity(b) && max_diff(a, b) <= 4e-16;
+                if (!same && !on_threshold) {
+                    out << kernel.name() << " scalar vs " << robotics::isaName(variant.isa) << ", element " << i
+                        << ": { " << a.w << ", " << a.x << ", " << a.y << ", " << a.z << " } vs { " << b.w << ", "
+                        << b.x << ", " << b.y << ", " << b.z << " }";
+                    return out.str();
+                }
+            }
+        }
+        return {};
+    };
+    std::string diff = check_kernel(k::normalize_quaternions_kernel, input.arbitrary);
+    if (diff.empty()) {
+        diff = check_kernel(k::renormalize_quaternions_kernel, input.near_unit);
+    }
+    return diff;
+}
+
+// ---------------------------------------------------------------------------
+// ekf.hpp：定长滤波器与 long double 的完整矩阵乘积比较（预测、堆叠后的 Joseph 更新、门限）
+// ---------------------------------------------------------------------------
+
+constexpr int kEkfStates = 6;
+constexpr int kEkfMeasurement = 2;
+using EkfMeasurement = robotics::ekf::Measurement<kEkfMeasurement, kEkfStates>;
+using EkfMatrix = robotics::ekf::MatrixNd<kEkfStates>;
+using LongMatrix = Eigen::Matrix<long double, Eigen::Dynamic, Eigen::Dynamic>;
+
+struct EkfInput {
+    EkfMatrix covariance; // 特征值 1e-2–1e2
+    EkfMatrix transition;
+    EkfMatrix process_noise;
+    std::vector<EkfMeasurement> measurements; // 噪声方差 1e-4–1
+    double gate { 0.0 }; // NIS 门限，检查拒绝的测量不改变状态
+};
+
+EkfMatrix randomSpd(WorkloadRng& rng, int exponent_min, int exponent_max)
+{
+    Eigen::HouseholderQR<EkfMatrix> qr(EkfMatrix::NullaryExpr([&](Eigen::Index, Eigen::Index) { return rng.normal(); }));
+    EkfMatrix q = qr.householderQ();
+    robotics::ekf::VectorNd<kEkfStates> eigenvalues;
+    for (int i = 0; i < kEkfStates; ++i) {
+        eigenvalues(i) = std::pow(10.0, rng.uniform(exponent_min, exponent_max));
+    }
+    EkfMatrix result = q * eigenvalues.asDiagonal() * q.transpose();
+    return 0.5 * (result + result.transpose());
+}
+
+EkfInput generateEkf(WorkloadRng& rng, int size)
+{
+    EkfInput input;
+    input.covariance = randomSpd(rng, -2, 2);
+    input.transition = EkfMatrix::Identity() + 0.1 * EkfMatrix::NullaryExpr([&](Eigen::Index, Eigen::Index) {
+        return rng.normal();
+    });
+    input.process_noise = 1e-3 * randomSpd(rng, -2, 0);
+    std::size_t count = 1 + rng.index(static_cast<std::size_t>(std::min(size, 40)) / 4 + 1);
+    for (std::size_t k = 0; k < count; ++k) {
+        EkfMeasurement m;
+        for (int i = 0; i < kEkfMeasurement; ++i) {
+            m.residual(i) = rng.normal();
+            for (int j = 0; j < kEkfStates; ++j) {
+                m.jacobian(i, j) = rng.uniform() < 0.3 ? 0.0 : rng.normal();
+            }
+        }
+        Eigen::Matrix2d a = Eigen::Matrix2d::NullaryExpr([&](Eigen::Index, Eigen::Index) { return rng.normal(); });
+        m.noise = a * a.transpose() * 0.1 + std::pow(10.0, rng.uniform(-4.0, 0.0)) * Eigen::Matrix2d::Identity();
+        input.measurements.push_back(m);
+    }
+    input.gate = rng.uniform(0.5, 6.0);
+    return input;
+}
+
+std::vector<EkfInput> shrinkEkf(const EkfInput& input)
+{
+    std::vector<EkfInput> candidates;
+    for (std::size_t i = 0; input.measurements.size() > 1 && i < input.measurements.size(); ++i) {
+        EkfInput smaller = input;
+        smaller.measurements.erase(smaller.measurements.begin() + static_cast<std::ptrdiff_t>(i));
+        candidates.push_back(std::move(smaller));
+    }
+    if (!input.transition.isIdentity(0.0)) {
+        EkfInput simpler = input;
+        simpler.transition.setIdentity();
+        candidates.push_back(std::move(simpler));
+    }
+    return candidates;
+}
+
+std::string describeEkf(const EkfInput& input)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "    P =\n"
+        << input.covariance << "\n    F =\n"
+        << input.transition << "\n    Q =\n"
+        << input.process_noise << "\n    gate = " << input.gate;
+    for (const EkfMeasurement& m : input.measurements) {
+        out << "\n    r = " << m.residual.transpose() << ", H =\n"
+            << m.jacobian << "\n      R =\n"
+            << m.noise;
+    }
+    return out.str();
+}
+
+/**
+ * @brief 相对于 reference 最大元素的最大差
+ */
+double relativeDifference(const Eigen::MatrixXd& value, const LongMatrix& reference)
+{
+    long double scale = std::max(reference.cwiseAbs().maxCoeff(), 1e-300L);
+    return static_cast<double>((value.cast<long double>() - reference).cwiseAbs().maxCoeff() / scale);
+}
+
+std::string checkEkf(const EkfInput& input)
+{
+    using Filter = robotics::ekf::ErrorStateFilter<kEkfStates>;
+    std::ostringstream out;
+    auto asymmetry = [](const EkfMatrix& p) { return (p - p.transpose()).cwiseAbs().maxCoeff(); };
+
+    // 1. 预测与完整乘积 F P Fᵀ + Q 比较，且严格对称
+    Filter filter(input.covariance);
+    filter.predict(input.transition, input.process_noise);
+    const LongMatrix f = input.transition.cast<long double>();
+    LongMatrix p = f * input.covariance.cast<long double>() * f.transpose() + input.process_noise.cast<long double>();
+    double diff = relativeDifference(filter.covariance(), p);
+    if (!(diff <= 1e-14) || asymmetry(filter.covariance()) != 0.0) {
+        out << "predict: relative difference " << diff << ", asymmetry " << asymmetry(filter.covariance());
+        return out.str();
+    }
+
+    // 2. 依次更新与把全部测量堆成一个测量的 Joseph 更新比较（R 块对角）
+    const int m = kEkfMeasurement * static_cast<int>(input.measurements.size());
+    LongMatrix h = LongMatrix::Zero(m, kEkfStates), r = LongMatrix::Zero(m, m), z(m, 1);
+    for (std::size_t k = 0; k < input.measurements.size(); ++k) {
+        const int row = kEkfMeasurement * static_cast<int>(k);
+        h.middleRows(row, kEkfMeasurement) = input.measurements[k].jacobian.cast<long double>();
+        r.block(row, row, kEkfMeasurement, kEkfMeasurement) = input.measurements[k].noise.cast<long double>();
+        z.middleRows(row, kEkfMeasurement) = input.measurements[k].residual.cast<long double>();
+    }
+    const LongMatrix s = h * p * h.transpose() + r;
+    const LongMatrix gain = p * h.transpose() * s.inverse();
+    const LongMatrix a = LongMatrix::Identity(kEkfStates, kEkfStates) - gain * h;
+    const LongMatrix joseph = a * p * a.transpose() + gain * r * gain.transpose();
+    const LongMatrix correction_reference = gain * z;
+
+    Filter batch = filter;
+    Filter::State correction = Filter::State::Zero();
+    std::vector<robotics::ekf::UpdateResult> results(input.measurements.size());
+    std::size_t accepted = batch.update<kEkfMeasurement>(input.measurements.data(), input.measurements.size(),
+        correction, std::numeric_limits<double>::infinity(), results.data());
+    diff = relativeDifference(batch.covariance(), joseph);
+    double correction_diff = relativeDifference(correction, correction_reference);
+    if (accepted != input.measurements.size() || !(diff <= 1e-9) || !(correction_diff <= 1e-9)
+        || asymmetry(batch.covariance()) != 0.0) {
+        out << "sequential vs stacked Joseph: " << accepted << " of " << input.measurements.size()
+            << " accepted, covariance " << diff << ", correction " << correction_diff << ", asymmetry "
+            << asymmetry(batch.covariance());
+        return out.str();
+    }
+
+    // 3. 门限：NIS 与 νᵀ S⁻¹ ν 一致；被拒绝的测量不改变协方差和修正量
+    Filter gated = filter;
+    correction.setZero();
+    for (std::size_t k = 0; k < input.measurements.size(); ++k) {
+        const EkfMeasurement& measurement = input.measurements[k];
+        const Filter before = gated;
+        const Filter::State correction_before = correction;
+        robotics::ekf::UpdateResult result = gated.update<kEkfMeasurement>(measurement, correction, input.gate);
+        const LongMatrix hk = measurement.jacobian.cast<long double>();
+        const LongMatrix sk = hk * before.covariance().cast<long double>() * hk.transpose()
+            + measurement.noise.cast<long double>();
+        const LongMatrix nu = (measurement.residual - measurement.jacobian * correction_before).cast<long double>();
+        const double nis = static_cast<double>((nu.transpose() * sk.inverse() * nu)(0, 0));
+        bool unchanged = gated.covariance() == before.covariance() && correction == correction_before;
+        if (!(std::fabs(result.nis - nis) <= 1e-9 * std::max(1.0, nis)) || result.accepted != (result.nis <= input.gate)
+            || result.accepted == unchanged) {
+            out << "gated update " << k << ": nis " << result.nis << " vs " << nis << ", accepted " << result.accepted
+                << ", unchanged " << unchanged;
+            return out.str();
+        }
+    }
+
+    // 4. 新息协方差不正定时拒绝，NIS 为 NaN
+    EkfMeasurement invalid = input.measurements.front();
+    invalid.noise = -(invalid.jacobian * filter.covariance() * invalid.jacobian.transpose())
+        - robotics::ekf::MatrixNd<kEkfMeasurement>::Identity();
+    Filter rejected = filter;
+    correction.setZero();
+    robotics::ekf::UpdateResult result = rejected.update<kEkfMeasurement>(invalid, correction);
+    if (result.accepted || !std::isnan(result.nis) || rejected.covariance() != filter.covariance()
+        || !correction.isZero(0.0)) {
+        return "update with an indefinite innovation covariance was not rejected";
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// 自检：注入一个只在维数大于 3 时才出现的错误
+// ---------------------------------------------------------------------------
+
+double distance_injected_bug(const std::vector<double>& p1, const std::vector<double>& p2)
+{
+    if (p1.size() != p2.size()) {
+        throw std::invalid_argument("Points must have the same dimension.");
+    }
+    double sum = 0.0;
+    for (std::size_t i = 0; i < p1.size() && i < 3; ++i) {
+        sum += (p1[i] - p2[i]) * (p1[i] - p2[i]);
+    }
+    return std::sqrt(sum);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    RunOptions options;
+    bool self_test = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            options.iterations = std::stoi(argv[++i]);
+        } else if (arg == "--max-size" && i + 1 < argc) {
+            options.max_size = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::stoull(argv[++i]);
+        } else if (arg == "--only" && i + 1 < argc) {
+            options.only = argv[++i];
+        } else if (arg == "--self-test") {
+            self_test = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--iterations N] [--max-size N] [--seed S] [--only NAME] [--self-test]" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Differential testing: " << options.iterations << " cases per property, seed " << options.seed
+              << std::endl;
+
+    Runner runner(options);
+    runner.run(Property<DistanceInput> { "a1 distance", generateDistance, shrinkDistance,
+        [impls = distanceImplementations()](const DistanceInput& input) { return checkDistances(input, impls); },
+        describeDistance });
+    runner.run(Property<TransformInput> { "transform_points kernels", generateTransform, shrinkTransform,
+        checkTransform, describeTransform });
+    runner.run(Property<PosePairInput> { "a2/a3 pose interpolation", generatePosePair, shrinkPosePair,
+        checkPosePair, describePosePair });
+    runner.run(Property<TimedInput> { "a2/a3 timed interpolation", generateTimed, shrinkTimed, checkTimed,
+        describeTimed });
+    runner.run(Property<ForEachInput> { "a4 parallel for_each", generateForEach, shrinkForEach, checkForEach,
+        describeForEach });
+    runner.run(Property<SolverInput> { "a0 dense SPD solvers", generateSolver, shrinkSolver, checkSolver,
+        describeSolver });
+    runner.run(Property<BandedInput> { "banded solvers", generateBanded, shrinkBanded, checkBanded, describeBanded });
+    runner.run(Property<TiledInput> { "tiled dense solvers", generateTiled, shrinkTiled, checkTiled,
+        describeTiled });
+    runner.run(Property<SymmetricInput> { "symmetric indefinite solvers", generateSymmetric, shrinkSymmetric,
+        checkSymmetric, describeSymmetric });
+    runner.run(Property<SparseInput> { "sparse LLT analysis cache", generateSparse, shrinkSparse, checkSparse,
+        describeSparse });
+    runner.run(Property<SupernodalInput> { "supernodal sparse Cholesky", generateSupernodal, shrinkSupernodal,
+        checkSupernodal, describeSupernodal });
+    runner.run(Property<AlignInput> { "alignment accumulator", generateAlign, shrinkAlign, checkAlign,
+        describeAlign });
+    runner.run(Property<ImuInput> { "imu preintegration", generateImu, shrinkImu, checkImu, describeImu });
+    runner.run(Property<PoseCovarianceInput> { "pose covariance", generatePoseCovariance, shrinkPoseCovariance,
+        checkPoseCovariance, describePoseCovariance });
+    runner.run(Property<PoseGraphInput> { "pose graph", generatePoseGraph, shrinkPoseGraph, checkPoseGraph,
+        describePoseGraph });
+    runner.run(Property<TrajectoryStoreInput> { "trajectory store", generateTrajectoryStore,
+        shrinkTrajectoryStore, checkTrajectoryStore, describeTrajectoryStore });
+    runner.run(Property<CorrectionInput> { "correction propagation", generateCorrection, shrinkCorrection,
+        checkCorrection, describeCorrection });
+    runner.run(Property<InterpolationCacheInput> { "interpolation cache", generateInterpolationCache,
+        shrinkInterpolationCache, checkInterpolationCache, describeInterpolationCache });
+    runner.run(Property<TimeBucketInput> { "time bucket index", generateTimeBucket, shrinkTimeBucket,
+        checkTimeBucket, describeTimeBucket });
+    runner.run(Property<RotationInput> { "rotation conversions", generateRotation, shrinkRotation, checkRotation,
+        describeRotation });
+    runner.run(Property<DualQuaternionInput> { "dual quaternion", generateDualQuaternion, shrinkDualQuaternion,
+        checkDualQuaternion, describeDualQuaternion });
+    runner.run(Property<NormalizationInput> { "quaternion normalization", generateNormalization, shrinkNormalization,
+        checkNormalization, describeNormalization });
+    runner.run(Property<EkfInput> { "extended kalman filter", generateEkf, shrinkEkf, checkEkf, describeEkf });
+
+    int failed = runner.failed();
+    if (self_test) {
+        std::cout << "\n=== Self-test (the next property must fail) ===" << std::endl;
+        Runner self_runner(options);
+        bool caught = !self_runner.run(Property<DistanceInput> { "self-test: injected bug", generateDistance,
+            shrinkDistance,
+            [](const DistanceInput& input) {
+                return checkDistances(input, { { "injected bug", distance_injected_bug } });
+            },
+            describeDistance });
+        std::cout << (caught ? "Injected bug detected." : "Error: injected bug was NOT detected.") << std::endl;
+        failed += caught ? 0 : 1;
+    }
+
+    std::cout << "\n"
+              << runner.passed() << " properties passed, " << runner.failed() << " failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
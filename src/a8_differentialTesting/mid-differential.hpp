@@ -0,0 +1,271 @@
+#pragma once
+/**
+ * @file mid-differential.hpp
+ * @brief 随机差分测试的最小框架：生成输入、比较多个实现、失败时收缩到最小反例。
+ *
+ * 一个 Property 描述一类输入以及在这类输入上必须一致的实现：
+ *   - generate(rng, size) 生成规模约为 size 的随机输入
+ *   - shrink(input) 给出若干"更小"的候选输入（可以为空）
+ *   - check(input) 在输入上运行所有实现，一致返回空字符串，否则返回差异描述
+ *   - describe(input) 把输入打印成可直接抄进单元测试的形式
+ *
+ * 失败时贪心收缩：反复在候选中取第一个仍然失败的输入，直到没有候选失败为止。
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pose.hpp"
+#include "workload.hpp"
+
+namespace differential {
+
+using robotics::workload::WorkloadRng;
+
+/**
+ * @brief 一个差分性质
+ */
+template <typename Input>
+struct Property {
+    std::string name;
+    std::function<Input(WorkloadRng&, int size)> generate;
+    std::function<std::vector<Input>(const Input&)> shrink;
+    std::function<std::string(const Input&)> check;
+    std::function<std::string(const Input&)> describe;
+};
+
+/**
+ * @brief 运行参数
+ */
+struct RunOptions {
+    int iterations { 300 }; // 每个性质生成的随机输入数
+    int max_size { 64 }; // 输入规模从 1 线性增长到 max_size
+    std::uint64_t seed { 20240601 };
+    int max_shrink_steps { 2000 };
+    std::string only; // 非空时只运行名字包含该子串的性质
+};
+
+/**
+ * @brief 一次实现调用的结果：返回值，或者抛出的异常类别
+ *
+ * 差分比较不仅要求正常结果一致，也要求"在同样的输入上抛出同类异常"。
+ */
+template <typename T>
+struct Outcome {
+    std::optional<T> value;
+    std::string error;
+};
+
+template <typename F>
+auto capture(F&& f) -> Outcome<decltype(f())>
+{
+    Outcome<decltype(f())> outcome;
+    try {
+        outcome.value = f();
+    } catch (const std::invalid_argument&) {
+        outcome.error = "invalid_argument";
+    } catch (const std::out_of_range&) {
+        outcome.error = "out_of_range";
+    } catch (const std::runtime_error&) {
+        outcome.error = "runtime_error";
+    } catch (const std::exception&) {
+        outcome.error = "exception";
+    }
+    return outcome;
+}
+
+/**
+ * @brief 浮点数是否在容差内一致（NaN 与 NaN、同号无穷视为一致）
+ *
+ * 容差为 abs_tol + rel_tol * max(|a|, |b|)。
+ */
+inline bool close(double a, double b, double rel_tol, double abs_tol = 0.0)
+{
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    if (std::isinf(a) || std::isinf(b)) {
+        return a == b;
+    }
+    return std::fabs(a - b) <= abs_tol + rel_tol * std::max(std::fabs(a), std::fabs(b));
+}
+
+/**
+ * @brief 四元数的距离，q 与 -q 表示同一旋转
+ */
+inline double quaternionDistance(const robotics::Quaternion& a, const robotics::Quaternion& b)
+{
+    double same = std::sqrt((a.w - b.w) * (a.w - b.w) + (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)
+        + (a.z - b.z) * (a.z - b.z));
+    double flipped = std::sqrt((a.w + b.w) * (a.w + b.w) + (a.x + b.x) * (a.x + b.x) + (a.y + b.y) * (a.y + b.y)
+        + (a.z + b.z) * (a.z + b.z));
+    return std::min(same, flipped);
+}
+
+/**
+ * @brief 比较两个位姿，一致返回空字符串
+ */
+inline std::string comparePose(const robotics::Pose& a, const robotics::Pose& b, double tol)
+{
+    const robotics::Vector3& p = a.position;
+    const robotics::Vector3& q = b.position;
+    if (!close(p.x, q.x, tol, tol) || !close(p.y, q.y, tol, tol) || !close(p.z, q.z, tol, tol)) {
+        std::ostringstream out;
+        out.precision(17);
+        out << "position [" << p.x << ", " << p.y << ", " << p.z << "] vs [" << q.x << ", " << q.y << ", " << q.z
+            << "]";
+        return out.str();
+    }
+    double d = quaternionDistance(a.orientation, b.orientation);
+    if (!(d <= tol)) {
+        std::ostringstream out;
+        out.precision(17);
+        out << "orientation differs by " << d;
+        return out.str();
+    }
+    return {};
+}
+
+/**
+ * @brief 比较两个 Outcome：都抛出同类异常，或都返回且 compare 认为一致
+ */
+template <typename T, typename Compare>
+std::string compareOutcome(const std::string& name_a, const Outcome<T>& a, const std::string& name_b,
+    const Outcome<T>& b, Compare&& compare)
+{
+    if (a.value.has_value() != b.value.has_value() || a.error != b.error) {
+        auto state = [](const Outcome<T>& o) { return o.value ? std::string("returned") : "threw " + o.error; };
+        return name_a + " " + state(a) + ", " + name_b + " " + state(b);
+    }
+    if (!a.value) {
+        return {};
+    }
+    std::string diff = compare(*a.value, *b.value);
+    return diff.empty() ? diff : name_a + " vs " + name_b + ": " + diff;
+}
+
+inline std::string formatPose(const robotics::Pose& pose)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "{ Vector3 { " << pose.position.x << ", " << pose.position.y << ", " << pose.position.z
+        << " }, Quaternion { " << pose.orientation.w << ", " << pose.orientation.x << ", " << pose.orientation.y
+        << ", " << pose.orientation.z << " } }";
+    return out.str();
+}
+
+/**
+ * @brief 依次运行所有性质并汇总
+ */
+class Runner {
+public:
+    explicit Runner(RunOptions options)
+        : options_(std::move(options))
+    {
+    }
+
+    /**
+     * @brief 运行一个性质，返回是否全部通过
+     */
+    template <typename Input>
+    bool run(const Property<Input>& property)
+    {
+        if (!options_.only.empty() && property.name.find(options_.only) == std::string::npos) {
+            return true;
+        }
+        auto start = std::chrono::steady_clock::now();
+        // 每个性质使用独立的随机流：增删性质不会改变其他性质的输入
+        WorkloadRng rng(options_.seed ^ nameHash(property.name));
+        for (int i = 0; i < options_.iterations; ++i) {
+            int size = 1 + static_cast<int>(static_cast<long long>(i) * (options_.max_size - 1)
+                    / std::max(1, options_.iterations - 1));
+            Input input = property.generate(rng, size);
+            std::string failure = runCheck(property, input);
+            if (failure.empty()) {
+                continue;
+            }
+            int steps = shrink(property, input, failure);
+            std::cout << "FAIL  " << property.name << " (iteration " << i << ", size " << size << ", shrunk in "
+                      << steps << " steps)" << std::endl;
+            std::cout << "  difference: " << failure << std::endl;
+            std::cout << "  minimal input:" << std::endl
+                      << property.describe(input) << std::endl;
+            ++failed_;
+            return false;
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "ok    " << property.name << " (" << options_.iterations << " cases, " << elapsed.count()
+                  << " ms)" << std::endl;
+        ++passed_;
+        return true;
+    }
+
+    int passed() const { return passed_; }
+    int failed() const { return failed_; }
+    const RunOptions& options() const { return options_; }
+
+private:
+    // FNV-1a；不用 std::hash，它的结果随标准库而变，会破坏 --seed 的可复现性
+    static std::uint64_t nameHash(const std::string& name)
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : name) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    template <typename Input>
+    static std::string runCheck(const Property<Input>& property, const Input& input)
+    {
+        // 实现抛出了 check 没有捕获的异常本身也是一种失败
+        try {
+            return property.check(input);
+        } catch (const std::exception& e) {
+            return std::string("unexpected exception: ") + e.what();
+        }
+    }
+
+    template <typename Input>
+    int shrink(const Property<Input>& property, Input& input, std::string& failure)
+    {
+        if (!property.shrink) {
+            return 0;
+        }
+        int steps = 0;
+        bool progress = true;
+        while (progress && steps < options_.max_shrink_steps) {
+            progress = false;
+            for (Input& candidate : property.shrink(input)) {
+                ++steps;
+                std::string candidate_failure = runCheck(property, candidate);
+                if (!candidate_failure.empty()) {
+                    input = std::move(candidate);
+                    failure = std::move(candidate_failure);
+                    progress = true;
+                    break;
+                }
+                if (steps >= options_.max_shrink_steps) {
+                    break;
+                }
+            }
+        }
+        return steps;
+    }
+
+    RunOptions options_;
+    int passed_ { 0 };
+    int failed_ { 0 };
+};
+
+} // namespace differential
@@ -0,0 +1,105 @@
+/**
+ * @file main.cpp
+ * @brief 演示运行时 CPU 特性检测与内核分派：打印选择结果，并比较各实现的速度与结果。
+ *
+ * 运行方式：
+ *   ./a9_kernelDispatch-main
+ *   PRESLAM_ISA=scalar ./a9_kernelDispatch-main              所有内核限制为标量实现
+ *   PRESLAM_KERNEL_DISTANCE=avx2 ./a9_kernelDispatch-main    只指定 distance 内核
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "dispatch.hpp"
+#include "kernels.hpp"
+#include "pose.hpp"
+#include "workload.hpp"
+
+using namespace robotics;
+
+template <typename F>
+double bestOfMs(F&& f, int repeats = 5)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void printRow(const char* kernel, const char* variant, double ms, double scalar_ms, double max_error, bool selected)
+{
+    std::cout << std::left << std::setw(20) << kernel << std::setw(10) << variant << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << ms << " ms" << std::setprecision(2) << std::setw(8)
+              << scalar_ms / ms << "x" << std::scientific << std::setprecision(1) << std::setw(12) << max_error
+              << std::defaultfloat << (selected ? "  <- selected" : "") << std::endl;
+}
+
+int main()
+{
+    KernelRegistry::instance().report(std::cout);
+
+    std::cout << "\n"
+              << std::left << std::setw(20) << "Kernel" << std::setw(10) << "Variant" << std::right << std::setw(13)
+              << "Time" << std::setw(9) << "Speedup" << std::setw(12) << "Max error" << std::endl;
+
+    // --- distance：描述子两两距离 ---
+    workload::DescriptorOptions descriptor_options;
+    descriptor_options.count = 2000;
+    workload::DescriptorSet descriptors = workload::descriptorSet(descriptor_options);
+    std::vector<double> reference(descriptors.count * descriptors.count);
+    std::vector<double> result(reference.size());
+
+    auto all_pairs = [&](auto function, std::vector<double>& out) {
+        for (std::size_t i = 0; i < descriptors.count; ++i) {
+            for (std::size_t j = 0; j < descriptors.count; ++j) {
+                out[i * descriptors.count + j] = function(descriptors.row(i), descriptors.row(j), descriptors.dim);
+            }
+        }
+    };
+
+    double scalar_ms = 0.0;
+    for (const auto& variant : kernels::distance_kernel.supportedVariants()) {
+        std::vector<double>& out = variant.isa == IsaLevel::Scalar ? reference : result;
+        double ms = bestOfMs([&] { all_pairs(variant.function, out); });
+        if (variant.isa == IsaLevel::Scalar) {
+            scalar_ms = ms;
+        }
+        double max_error = 0.0;
+        for (std::size_t k = 0; k < out.size(); ++k) {
+            max_error = std::max(max_error, std::fabs(out[k] - reference[k]) / std::max(1e-300, reference[k]));
+        }
+        printRow("distance (128-d)", isaName(variant.isa), ms, scalar_ms, max_error,
+            variant.isa == kernels::distance_kernel.selectedIsa());
+    }
+
+    // --- transform_points：把一帧 LiDAR 点云变换到世界系 ---
+    std::vector<Vector3> cloud = workload::lidarScan(workload::LidarOptions {});
+    Pose pose { Vector3 { 12.5, -3.0, 1.8 }, Quaternion::fromEuler(0.02, -0.01, 1.2) };
+    std::vector<Vector3> expected(cloud.size()), transformed(cloud.size());
+
+    for (const auto& variant : kernels::transform_points_kernel.supportedVariants()) {
+        std::vector<Vector3>& out = variant.isa == IsaLevel::Scalar ? expected : transformed;
+        double ms = bestOfMs([&] { variant.function(pose, cloud.data(), out.data(), cloud.size()); });
+        if (variant.isa == IsaLevel::Scalar) {
+            scalar_ms = ms;
+        }
+        double max_error = 0.0;
+        for (std::size_t k = 0; k < cloud.size(); ++k) {
+            Vector3 direct = pose.orientation.rotate(cloud[k]) + pose.position;
+            max_error = std::max(max_error, (out[k] - direct).norm() / std::max(1.0, direct.norm()));
+        }
+        printRow("transform_points", isaName(variant.isa), ms, scalar_ms, max_error,
+            variant.isa == kernels::transform_points_kernel.selectedIsa());
+    }
+    std::cout << "(" << cloud.size() << " points per transform; error measured against Quaternion::rotate)"
+              << std::endl;
+    return 0;
+}